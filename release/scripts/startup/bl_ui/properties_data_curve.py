@@ -99,6 +99,11 @@ class DATA_PT_shape_curve(CurveButtonsPanel, Panel):
         col.label(text="Resolution:")
         sub = col.column(align=True)
         sub.prop(curve, "resolution_u", text="Preview U")
+        if is_curve or is_text:
+            sub.prop(curve, "use_resolution_adaptive", text="Adaptive")
+            subsub = sub.row(align=True)
+            subsub.active = curve.use_resolution_adaptive
+            subsub.prop(curve, "resolution_tolerance", text="Tolerance")
         if is_curve:
             col.label(text="Twisting:")
             col.prop(curve, "twist_mode", text="")
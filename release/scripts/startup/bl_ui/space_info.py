@@ -159,6 +159,7 @@ class INFO_MT_file_import(Menu):
 
     def draw(self, context):
         layout = self.layout
+        layout.operator("wm.gcode_import", text="G-code (.gcode, .nc)")
         layout.separator()
 
 class INFO_MT_file_export(Menu):
@@ -68,6 +68,7 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_compiler_attrs.h"
+#include "BLI_threads.h"
 
 #include "BKE_customdata.h"
 #include "BKE_bvhutils.h"
@@ -164,6 +165,10 @@ typedef enum DMDirtyFlag {
 
 	/* check this with modifier dependsOnNormals callback to see if normals need recalculation */
 	DM_DIRTY_NORMALS = 1 << 2,
+
+	/* Display-only poly normals (the poly CD_NORMAL layer) have not been built yet,
+	 * they are computed on first access through #DM_get_poly_data_layer. */
+	DM_DIRTY_DISPLAY_NORMALS = 1 << 3,
 }  DMDirtyFlag;
 
 typedef struct DerivedMesh DerivedMesh;
@@ -178,6 +183,8 @@ struct DerivedMesh {
 	DerivedMeshType type;
 	float auto_bump_scale;
 	DMDirtyFlag dirty;
+	/* Guards the layers computed on first access (see #DM_ensure_normals, #DM_ensure_tessface). */
+	ThreadMutex lazy_layers_lock;
 	int totmat; /* total materials. Will be valid only before object drawing. */
 	struct Material **mat; /* material array. Will be valid only before object drawing */
 
@@ -616,6 +623,7 @@ void DM_free_poly_data(struct DerivedMesh *dm, int index, int count);
 void DM_DupPolys(DerivedMesh *source, DerivedMesh *target);
 
 void DM_ensure_normals(DerivedMesh *dm);
+void DM_ensure_display_normals_lazy(DerivedMesh *dm);
 void DM_ensure_tessface(DerivedMesh *dm);
 
 void DM_ensure_looptri_data(DerivedMesh *dm);
@@ -32,7 +32,8 @@ struct bContext;
 #define BKE_UNDO_STR_MAX 64
 
 struct MemFileUndoData *BKE_memfile_undo_encode(struct Main *bmain, struct MemFileUndoData *mfu_prev);
-bool                    BKE_memfile_undo_decode(struct MemFileUndoData *mfu, struct bContext *C);
+bool                    BKE_memfile_undo_decode(
+        struct MemFileUndoData *mfu, const bool use_id_reuse, struct bContext *C);
 void                    BKE_memfile_undo_free(struct MemFileUndoData *mfu);
 
 #ifdef __cplusplus
@@ -47,7 +47,7 @@ bool BKE_blendfile_read_from_memory(
         const struct BlendFileReadParams *params,
         struct ReportList *reports);
 bool BKE_blendfile_read_from_memfile(
-        struct bContext *C, struct MemFile *memfile,
+        struct bContext *C, struct MemFile *memfile, struct MemFile *memfile_live,
         const struct BlendFileReadParams *params,
         struct ReportList *reports);
 void BKE_blendfile_read_make_empty(struct bContext *C);
@@ -25,6 +25,7 @@
  *  \author nzc
  */
 
+struct BevelListCache;
 struct BezTriple;
 struct Curve;
 struct EditNurb;
@@ -138,10 +139,19 @@ struct ListBase *BKE_curve_editNurbs_get(struct Curve *cu);
 
 void BKE_curve_bevelList_free(struct ListBase *bev);
 void BKE_curve_bevelList_make(struct Object *ob, struct ListBase *nurbs);
+void BKE_curve_bevelList_cache_free(struct BevelListCache *cache);
 void BKE_curve_bevel_make(struct Scene *scene, struct Object *ob,  struct ListBase *disp);
 
 void BKE_curve_forward_diff_bezier(float q0, float q1, float q2, float q3, float *p, int it, int stride);
+void BKE_curve_forward_diff_bezier_v3(
+        const float q0[3], const float q1[3], const float q2[3], const float q3[3],
+        float *p, int it, int stride);
 void BKE_curve_forward_diff_tangent_bezier(float q0, float q1, float q2, float q3, float *p, int it, int stride);
+int BKE_curve_bezier_resolu_adaptive(
+        const float q0[3], const float q1[3], const float q2[3], const float q3[3],
+        const float tolerance, const int resolu);
+int BKE_curve_bezier_segment_resolu(
+        const struct Curve *cu, const struct BezTriple *bezt_a, const struct BezTriple *bezt_b, const int resolu);
 
 void BKE_curve_rect_from_textbox(const struct Curve *cu, const struct TextBox *tb, struct rctf *r_rect);
 
@@ -375,6 +375,11 @@ void CustomData_bmesh_update_active_layers(struct CustomData *fdata, struct Cust
 void CustomData_bmesh_do_versions_update_active_layers(struct CustomData *fdata, struct CustomData *pdata, struct CustomData *ldata);
 void CustomData_bmesh_init_pool(struct CustomData *data, int totelem, const char htype);
 
+bool CustomData_bmesh_soa_begin(struct BMesh *bm, struct CustomData *data, const char htype, const CustomDataMask mask);
+void CustomData_bmesh_soa_end(struct BMesh *bm, struct CustomData *data, const char htype, const bool use_write_back);
+bool CustomData_bmesh_soa_is_enabled(const struct CustomData *data);
+void CustomData_bmesh_soa_to_layers(const struct CustomData *source, struct CustomData *dest, int totelem);
+
 #ifndef NDEBUG
 bool CustomData_from_bmeshpoly_test(CustomData *fdata, CustomData *pdata, CustomData *ldata, bool fallback);
 #endif
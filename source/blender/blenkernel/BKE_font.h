@@ -85,6 +85,9 @@ bool BKE_vfont_to_curve_ex(struct Object *ob, struct Curve *cu, int mode,
 bool BKE_vfont_to_curve_nubase(struct Object *ob, int mode,
                                struct ListBase *r_nubase);
 bool BKE_vfont_to_curve(struct Object *ob, int mode);
+bool BKE_vfont_to_curve_batch(
+        struct Object *ob, struct Curve *cu, const char **strings, const int strings_len,
+        const int columns, const float margin, struct ListBase *r_nubase);
 
 int BKE_vfont_select_get(struct Object *ob, int *r_start, int *r_end);
 void BKE_vfont_select_clamp(struct Object *ob);
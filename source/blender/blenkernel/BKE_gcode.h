@@ -0,0 +1,107 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef __BKE_GCODE_H__
+#define __BKE_GCODE_H__
+
+/** \file BKE_gcode.h
+ *  \ingroup bke
+ *  \brief Reading G-code (RS-274) programs into tool paths.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct Mesh;
+
+/* GCodePath.flag, for the move ending at a point */
+enum {
+	/* rapid positioning (G0), not cutting */
+	GCODE_POINT_RAPID = (1 << 0),
+	/* part of a subdivided arc (G2/G3) */
+	GCODE_POINT_ARC   = (1 << 1),
+};
+
+/**
+ * Tool positions in machine coordinates (millimeters), in the order they're visited.
+ * The first point is the start position, each following point ends a straight move.
+ */
+typedef struct GCodePath {
+	float (*co)[3];
+	/* feed rate of the move ending at each point (millimeters per minute), zero for rapids */
+	float *feed;
+	/* GCODE_POINT_ flags of the move ending at each point */
+	char *flag;
+	int co_len, co_alloc;
+
+	/* statistics */
+	int lines_len;
+	/* motion commands, arcs and canned cycles count once */
+	int moves_len;
+	/* blocks skipped because they use features that aren't supported
+	 * (parameters, expressions, subroutines) */
+	int blocks_skipped_len;
+} GCodePath;
+
+typedef struct GCodeParseSettings {
+	/* maximum distance of the segments of subdivided arcs from the arc (millimeters) */
+	float arc_tolerance;
+	bool use_threading;
+} GCodeParseSettings;
+
+/* Kinematic limits of the machine, as configured in grbl */
+typedef struct GCodeMachineSettings {
+	/* per axis maximum rate (millimeters per minute) */
+	float max_rate[3];
+	/* per axis acceleration (millimeters per second squared) */
+	float acceleration[3];
+	/* how far the tool may leave the path at corners (millimeters), sets the cornering speed */
+	float junction_deviation;
+	/* number of moves the planner looks ahead, it stops at the end of them */
+	int planner_blocks_len;
+} GCodeMachineSettings;
+
+typedef struct GCodeEstimate {
+	/* seconds, including the rapid moves */
+	double duration;
+	double duration_rapid;
+	/* millimeters, including the rapid moves */
+	double length;
+	double length_rapid;
+} GCodeEstimate;
+
+void BKE_gcode_parse_settings_defaults(GCodeParseSettings *settings);
+void BKE_gcode_machine_settings_defaults(GCodeMachineSettings *machine);
+
+struct GCodePath *BKE_gcode_path_from_buffer(
+        const char *buf, const size_t buf_len, const GCodeParseSettings *settings);
+struct GCodePath *BKE_gcode_path_from_file(
+        const char *filepath, const GCodeParseSettings *settings);
+void BKE_gcode_path_free(struct GCodePath *path);
+
+void BKE_gcode_path_estimate(
+        const struct GCodePath *path, const GCodeMachineSettings *machine,
+        float *r_feed_achieved, GCodeEstimate *r_estimate);
+
+void BKE_gcode_path_to_mesh(
+        const struct GCodePath *path, struct Mesh *me,
+        const float scale, const bool use_rapid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BKE_GCODE_H__ */
@@ -93,6 +93,10 @@ typedef enum {
 
 	/* For modifiers that use CD_PREVIEW_MCOL for preview. */
 	eModifierTypeFlag_UsesPreview = (1 << 9),
+
+	/* For slow modifiers, keep a copy of the result to re-use
+	 * while the input doesn't change, see modifier_cache.c */
+	eModifierTypeFlag_CacheResult = (1 << 10),
 } ModifierTypeFlag;
 
 /* IMPORTANT! Keep ObjectWalkFunc and IDWalkFunc signatures compatible. */
@@ -437,4 +441,14 @@ void modwrap_deformVertsEM(
         struct BMEditMesh *em, struct DerivedMesh *dm,
         float (*vertexCos)[3], int numVerts);
 
+/* modifier_cache.c */
+
+struct DerivedMesh *modwrap_applyModifier_cached(
+        ModifierData *md, struct Object *ob,
+        struct DerivedMesh *dm,
+        ModifierApplyFlag flag);
+
+void BKE_modifier_cache_free_modifier(struct ModifierData *md);
+void BKE_modifier_cache_exit(void);
+
 #endif
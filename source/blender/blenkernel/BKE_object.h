@@ -28,6 +28,7 @@ extern "C" {
 #include "BLI_compiler_attrs.h"
 
 struct Base;
+struct BevelListCache;
 struct BoundBox;
 struct HookModifierData;
 struct Main;
@@ -211,6 +212,7 @@ void BKE_object_rotMode_change_values(float quat[4], float eul[3], float axis[3]
 void BKE_object_clear_curve_cache(struct Object *ob);
 ListBase *BKE_object_curve_displist(struct Object *ob);
 ListBase *BKE_object_curve_bevlist(struct Object *ob);
+struct BevelListCache **BKE_object_curve_bevlist_cache(struct Object *ob);
 ListBase *BKE_object_curve_deformed_nurbs(struct Object *ob);
 int BKE_object_has_path(struct Object *ob);
 struct Path *BKE_object_new_path(struct Object *ob);
@@ -57,6 +57,8 @@ void	txt_order_cursors	(struct Text *text, const bool reverse);
 int		txt_find_string		(struct Text *text, const char *findstr, int wrap, int match_case);
 bool	txt_has_sel			(struct Text *text);
 int		txt_get_span		(struct TextLine *from, struct TextLine *to);
+int		txt_get_line_index	(struct Text *text, const struct TextLine *line);
+struct TextLine *txt_get_line_from_index(struct Text *text, int index);
 int		txt_utf8_offset_to_index(const char *str, int offset);
 int		txt_utf8_index_to_offset(const char *str, int index);
 int		txt_utf8_offset_to_column(const char *str, int offset);
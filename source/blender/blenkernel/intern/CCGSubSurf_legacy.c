@@ -653,311 +653,389 @@ static void ccgSubSurf__calcSubdivLevel_verts_copydata_cb(
 	}
 }
 
-static void ccgSubSurf__calcSubdivLevel(
-        CCGSubSurf *ss,
-        CCGVert **effectedV, CCGEdge **effectedE, CCGFace **effectedF,
-        const int numEffectedV, const int numEffectedE, const int numEffectedF, const int curLvl)
+static void ccgSubSurf__calcSubdivLevel_edges_midpoints_cb(
+        void *__restrict userdata,
+        const int ptrIdx,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
 {
+	CCGSubSurfCalcSubdivData *data = userdata;
+
+	CCGSubSurf *ss = data->ss;
+	CCGEdge *e = data->effectedE[ptrIdx];
+
 	const int subdivLevels = ss->subdivLevels;
+	const int curLvl = data->curLvl;
 	const int nextLvl = curLvl + 1;
-	int edgeSize = ccg_edgesize(curLvl);
-	int ptrIdx, i;
+	const int edgeSize = ccg_edgesize(curLvl);
 	const int vertDataSize = ss->meshIFC.vertDataSize;
-	float *q = ss->q, *r = ss->r;
 
-	CCGSubSurfCalcSubdivData data = {
-	    .ss = ss,
-	    .effectedV = effectedV,
-	    .effectedE = effectedE,
-	    .effectedF = effectedF,
-	    .numEffectedV = numEffectedV,
-	    .numEffectedE = numEffectedE,
-	    .numEffectedF = numEffectedF,
-	    .curLvl = curLvl
-	};
+	float *q_thread = alloca(vertDataSize);
+	float *r_thread = alloca(vertDataSize);
 
-	{
-		ParallelRangeSettings settings;
-		BLI_parallel_range_settings_defaults(&settings);
-		settings.min_iter_per_thread = CCG_TASK_LIMIT;
-		BLI_task_parallel_range(0, numEffectedF,
-		                        &data,
-		                        ccgSubSurf__calcSubdivLevel_interior_faces_edges_midpoints_cb,
-		                        &settings);
-	}
+	float sharpness = EDGE_getSharpness(e, curLvl);
+	int x, j;
 
 	/* exterior edge midpoints
 	 * - old exterior edge points
 	 * - new interior face midpoints
 	 */
-	/* Not worth parallelizing. */
-	for (ptrIdx = 0; ptrIdx < numEffectedE; ptrIdx++) {
-		CCGEdge *e = (CCGEdge *) effectedE[ptrIdx];
-		float sharpness = EDGE_getSharpness(e, curLvl);
-		int x, j;
+	if (_edge_isBoundary(e) || sharpness > 1.0f) {
+		for (x = 0; x < edgeSize - 1; x++) {
+			int fx = x * 2 + 1;
+			const float *co0 = EDGE_getCo(e, curLvl, x + 0);
+			const float *co1 = EDGE_getCo(e, curLvl, x + 1);
+			float *co  = EDGE_getCo(e, nextLvl, fx);
 
-		if (_edge_isBoundary(e) || sharpness > 1.0f) {
-			for (x = 0; x < edgeSize - 1; x++) {
-				int fx = x * 2 + 1;
-				const float *co0 = EDGE_getCo(e, curLvl, x + 0);
-				const float *co1 = EDGE_getCo(e, curLvl, x + 1);
-				float *co  = EDGE_getCo(e, nextLvl, fx);
+			VertDataCopy(co, co0, ss);
+			VertDataAdd(co, co1, ss);
+			VertDataMulN(co, 0.5f, ss);
+		}
+	}
+	else {
+		for (x = 0; x < edgeSize - 1; x++) {
+			int fx = x * 2 + 1;
+			const float *co0 = EDGE_getCo(e, curLvl, x + 0);
+			const float *co1 = EDGE_getCo(e, curLvl, x + 1);
+			float *co  = EDGE_getCo(e, nextLvl, fx);
+			int numFaces = 0;
 
-				VertDataCopy(co, co0, ss);
-				VertDataAdd(co, co1, ss);
-				VertDataMulN(co, 0.5f, ss);
+			VertDataCopy(q_thread, co0, ss);
+			VertDataAdd(q_thread, co1, ss);
+
+			for (j = 0; j < e->numFaces; j++) {
+				CCGFace *f = e->faces[j];
+				const int f_ed_idx = ccg_face_getEdgeIndex(f, e);
+				VertDataAdd(q_thread, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx, 1, subdivLevels, vertDataSize), ss);
+				numFaces++;
 			}
-		}
-		else {
-			for (x = 0; x < edgeSize - 1; x++) {
-				int fx = x * 2 + 1;
-				const float *co0 = EDGE_getCo(e, curLvl, x + 0);
-				const float *co1 = EDGE_getCo(e, curLvl, x + 1);
-				float *co  = EDGE_getCo(e, nextLvl, fx);
-				int numFaces = 0;
-
-				VertDataCopy(q, co0, ss);
-				VertDataAdd(q, co1, ss);
-
-				for (j = 0; j < e->numFaces; j++) {
-					CCGFace *f = e->faces[j];
-					const int f_ed_idx = ccg_face_getEdgeIndex(f, e);
-					VertDataAdd(q, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx, 1, subdivLevels, vertDataSize), ss);
-					numFaces++;
-				}
 
-				VertDataMulN(q, 1.0f / (2.0f + numFaces), ss);
+			VertDataMulN(q_thread, 1.0f / (2.0f + numFaces), ss);
 
-				VertDataCopy(r, co0, ss);
-				VertDataAdd(r, co1, ss);
-				VertDataMulN(r, 0.5f, ss);
+			VertDataCopy(r_thread, co0, ss);
+			VertDataAdd(r_thread, co1, ss);
+			VertDataMulN(r_thread, 0.5f, ss);
 
-				VertDataCopy(co, q, ss);
-				VertDataSub(r, q, ss);
-				VertDataMulN(r, sharpness, ss);
-				VertDataAdd(co, r, ss);
-			}
+			VertDataCopy(co, q_thread, ss);
+			VertDataSub(r_thread, q_thread, ss);
+			VertDataMulN(r_thread, sharpness, ss);
+			VertDataAdd(co, r_thread, ss);
 		}
 	}
+}
+
+static void ccgSubSurf__calcSubdivLevel_verts_shift_cb(
+        void *__restrict userdata,
+        const int ptrIdx,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	CCGSubSurfCalcSubdivData *data = userdata;
+
+	CCGSubSurf *ss = data->ss;
+	CCGVert *v = data->effectedV[ptrIdx];
+
+	const int subdivLevels = ss->subdivLevels;
+	const int curLvl = data->curLvl;
+	const int nextLvl = curLvl + 1;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+
+	float *q_thread = alloca(vertDataSize);
+	float *r_thread = alloca(vertDataSize);
+
+	const float *co = VERT_getCo(v, curLvl);
+	float *nCo = VERT_getCo(v, nextLvl);
+	int sharpCount = 0, allSharp = 1;
+	float avgSharpness = 0.0;
+	int j, seam = VERT_seam(v), seamEdges = 0;
 
 	/* exterior vertex shift
 	 * - old vertex points (shifting)
 	 * - old exterior edge points
 	 * - new interior face midpoints
 	 */
-	/* Not worth parallelizing. */
-	for (ptrIdx = 0; ptrIdx < numEffectedV; ptrIdx++) {
-		CCGVert *v = (CCGVert *) effectedV[ptrIdx];
-		const float *co = VERT_getCo(v, curLvl);
-		float *nCo = VERT_getCo(v, nextLvl);
-		int sharpCount = 0, allSharp = 1;
-		float avgSharpness = 0.0;
-		int j, seam = VERT_seam(v), seamEdges = 0;
+	for (j = 0; j < v->numEdges; j++) {
+		CCGEdge *e = v->edges[j];
+		float sharpness = EDGE_getSharpness(e, curLvl);
 
-		for (j = 0; j < v->numEdges; j++) {
-			CCGEdge *e = v->edges[j];
-			float sharpness = EDGE_getSharpness(e, curLvl);
+		if (seam && _edge_isBoundary(e))
+			seamEdges++;
 
-			if (seam && _edge_isBoundary(e))
-				seamEdges++;
-
-			if (sharpness != 0.0f) {
-				sharpCount++;
-				avgSharpness += sharpness;
-			}
-			else {
-				allSharp = 0;
-			}
+		if (sharpness != 0.0f) {
+			sharpCount++;
+			avgSharpness += sharpness;
+		}
+		else {
+			allSharp = 0;
 		}
+	}
 
-		if (sharpCount) {
-			avgSharpness /= sharpCount;
-			if (avgSharpness > 1.0f) {
-				avgSharpness = 1.0f;
-			}
+	if (sharpCount) {
+		avgSharpness /= sharpCount;
+		if (avgSharpness > 1.0f) {
+			avgSharpness = 1.0f;
 		}
+	}
 
-		if (seamEdges < 2 || seamEdges != v->numEdges)
-			seam = 0;
+	if (seamEdges < 2 || seamEdges != v->numEdges)
+		seam = 0;
 
-		if (!v->numEdges || ss->meshIFC.simpleSubdiv) {
-			VertDataCopy(nCo, co, ss);
-		}
-		else if (_vert_isBoundary(v)) {
-			int numBoundary = 0;
+	if (!v->numEdges || ss->meshIFC.simpleSubdiv) {
+		VertDataCopy(nCo, co, ss);
+	}
+	else if (_vert_isBoundary(v)) {
+		int numBoundary = 0;
 
-			VertDataZero(r, ss);
-			for (j = 0; j < v->numEdges; j++) {
-				CCGEdge *e = v->edges[j];
-				if (_edge_isBoundary(e)) {
-					VertDataAdd(r, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
-					numBoundary++;
-				}
+		VertDataZero(r_thread, ss);
+		for (j = 0; j < v->numEdges; j++) {
+			CCGEdge *e = v->edges[j];
+			if (_edge_isBoundary(e)) {
+				VertDataAdd(r_thread, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
+				numBoundary++;
 			}
+		}
 
-			VertDataCopy(nCo, co, ss);
-			VertDataMulN(nCo, 0.75f, ss);
-			VertDataMulN(r, 0.25f / numBoundary, ss);
-			VertDataAdd(nCo, r, ss);
+		VertDataCopy(nCo, co, ss);
+		VertDataMulN(nCo, 0.75f, ss);
+		VertDataMulN(r_thread, 0.25f / numBoundary, ss);
+		VertDataAdd(nCo, r_thread, ss);
+	}
+	else {
+		const int cornerIdx = (1 + (1 << (curLvl))) - 2;
+		int numEdges = 0, numFaces = 0;
+
+		VertDataZero(q_thread, ss);
+		for (j = 0; j < v->numFaces; j++) {
+			CCGFace *f = v->faces[j];
+			VertDataAdd(q_thread, FACE_getIFCo(f, nextLvl, ccg_face_getVertIndex(f, v), cornerIdx, cornerIdx), ss);
+			numFaces++;
 		}
-		else {
-			const int cornerIdx = (1 + (1 << (curLvl))) - 2;
-			int numEdges = 0, numFaces = 0;
+		VertDataMulN(q_thread, 1.0f / numFaces, ss);
+		VertDataZero(r_thread, ss);
+		for (j = 0; j < v->numEdges; j++) {
+			CCGEdge *e = v->edges[j];
+			VertDataAdd(r_thread, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
+			numEdges++;
+		}
+		VertDataMulN(r_thread, 1.0f / numEdges, ss);
 
-			VertDataZero(q, ss);
-			for (j = 0; j < v->numFaces; j++) {
-				CCGFace *f = v->faces[j];
-				VertDataAdd(q, FACE_getIFCo(f, nextLvl, ccg_face_getVertIndex(f, v), cornerIdx, cornerIdx), ss);
-				numFaces++;
-			}
-			VertDataMulN(q, 1.0f / numFaces, ss);
-			VertDataZero(r, ss);
-			for (j = 0; j < v->numEdges; j++) {
-				CCGEdge *e = v->edges[j];
-				VertDataAdd(r, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
-				numEdges++;
-			}
-			VertDataMulN(r, 1.0f / numEdges, ss);
+		VertDataCopy(nCo, co, ss);
+		VertDataMulN(nCo, numEdges - 2.0f, ss);
+		VertDataAdd(nCo, q_thread, ss);
+		VertDataAdd(nCo, r_thread, ss);
+		VertDataMulN(nCo, 1.0f / numEdges, ss);
+	}
 
-			VertDataCopy(nCo, co, ss);
-			VertDataMulN(nCo, numEdges - 2.0f, ss);
-			VertDataAdd(nCo, q, ss);
-			VertDataAdd(nCo, r, ss);
-			VertDataMulN(nCo, 1.0f / numEdges, ss);
+	if ((sharpCount > 1 && v->numFaces) || seam) {
+		VertDataZero(q_thread, ss);
+
+		if (seam) {
+			avgSharpness = 1.0f;
+			sharpCount = seamEdges;
+			allSharp = 1;
 		}
 
-		if ((sharpCount > 1 && v->numFaces) || seam) {
-			VertDataZero(q, ss);
+		for (j = 0; j < v->numEdges; j++) {
+			CCGEdge *e = v->edges[j];
+			float sharpness = EDGE_getSharpness(e, curLvl);
 
 			if (seam) {
-				avgSharpness = 1.0f;
-				sharpCount = seamEdges;
-				allSharp = 1;
+				if (_edge_isBoundary(e))
+					VertDataAdd(q_thread, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
 			}
-
-			for (j = 0; j < v->numEdges; j++) {
-				CCGEdge *e = v->edges[j];
-				float sharpness = EDGE_getSharpness(e, curLvl);
-
-				if (seam) {
-					if (_edge_isBoundary(e))
-						VertDataAdd(q, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
-				}
-				else if (sharpness != 0.0f) {
-					VertDataAdd(q, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
-				}
+			else if (sharpness != 0.0f) {
+				VertDataAdd(q_thread, _edge_getCoVert(e, v, curLvl, 1, vertDataSize), ss);
 			}
+		}
 
-			VertDataMulN(q, (float) 1 / sharpCount, ss);
+		VertDataMulN(q_thread, (float) 1 / sharpCount, ss);
 
-			if (sharpCount != 2 || allSharp) {
-				/* q = q + (co - q) * avgSharpness */
-				VertDataCopy(r, co, ss);
-				VertDataSub(r, q, ss);
-				VertDataMulN(r, avgSharpness, ss);
-				VertDataAdd(q, r, ss);
-			}
+		if (sharpCount != 2 || allSharp) {
+			/* q = q + (co - q) * avgSharpness */
+			VertDataCopy(r_thread, co, ss);
+			VertDataSub(r_thread, q_thread, ss);
+			VertDataMulN(r_thread, avgSharpness, ss);
+			VertDataAdd(q_thread, r_thread, ss);
+		}
 
-			/* r = co * 0.75 + q * 0.25 */
-			VertDataCopy(r, co, ss);
-			VertDataMulN(r, 0.75f, ss);
-			VertDataMulN(q, 0.25f, ss);
-			VertDataAdd(r, q, ss);
+		/* r = co * 0.75 + q * 0.25 */
+		VertDataCopy(r_thread, co, ss);
+		VertDataMulN(r_thread, 0.75f, ss);
+		VertDataMulN(q_thread, 0.25f, ss);
+		VertDataAdd(r_thread, q_thread, ss);
 
-			/* nCo = nCo + (r - nCo) * avgSharpness */
-			VertDataSub(r, nCo, ss);
-			VertDataMulN(r, avgSharpness, ss);
-			VertDataAdd(nCo, r, ss);
-		}
+		/* nCo = nCo + (r - nCo) * avgSharpness */
+		VertDataSub(r_thread, nCo, ss);
+		VertDataMulN(r_thread, avgSharpness, ss);
+		VertDataAdd(nCo, r_thread, ss);
 	}
+}
+
+static void ccgSubSurf__calcSubdivLevel_edges_interior_shift_cb(
+        void *__restrict userdata,
+        const int ptrIdx,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	CCGSubSurfCalcSubdivData *data = userdata;
+
+	CCGSubSurf *ss = data->ss;
+	CCGEdge *e = data->effectedE[ptrIdx];
+
+	const int subdivLevels = ss->subdivLevels;
+	const int curLvl = data->curLvl;
+	const int nextLvl = curLvl + 1;
+	const int edgeSize = ccg_edgesize(curLvl);
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+
+	float *q_thread = alloca(vertDataSize);
+	float *r_thread = alloca(vertDataSize);
+
+	float sharpness = EDGE_getSharpness(e, curLvl);
+	int sharpCount = 0;
+	float avgSharpness = 0.0;
+	int x, j;
 
 	/* exterior edge interior shift
 	 * - old exterior edge midpoints (shifting)
 	 * - old exterior edge midpoints
 	 * - new interior face midpoints
 	 */
-	/* Not worth parallelizing. */
-	for (ptrIdx = 0; ptrIdx < numEffectedE; ptrIdx++) {
-		CCGEdge *e = (CCGEdge *) effectedE[ptrIdx];
-		float sharpness = EDGE_getSharpness(e, curLvl);
-		int sharpCount = 0;
-		float avgSharpness = 0.0;
-		int x, j;
+	if (sharpness != 0.0f) {
+		sharpCount = 2;
+		avgSharpness += sharpness;
 
-		if (sharpness != 0.0f) {
-			sharpCount = 2;
-			avgSharpness += sharpness;
-
-			if (avgSharpness > 1.0f) {
-				avgSharpness = 1.0f;
-			}
-		}
-		else {
-			sharpCount = 0;
-			avgSharpness = 0;
+		if (avgSharpness > 1.0f) {
+			avgSharpness = 1.0f;
 		}
+	}
+	else {
+		sharpCount = 0;
+		avgSharpness = 0;
+	}
 
-		if (_edge_isBoundary(e)) {
-			for (x = 1; x < edgeSize - 1; x++) {
-				int fx = x * 2;
-				const float *co = EDGE_getCo(e, curLvl, x);
-				float *nCo = EDGE_getCo(e, nextLvl, fx);
+	if (_edge_isBoundary(e)) {
+		for (x = 1; x < edgeSize - 1; x++) {
+			int fx = x * 2;
+			const float *co = EDGE_getCo(e, curLvl, x);
+			float *nCo = EDGE_getCo(e, nextLvl, fx);
 
-				/* Average previous level's endpoints */
-				VertDataCopy(r, EDGE_getCo(e, curLvl, x - 1), ss);
-				VertDataAdd(r, EDGE_getCo(e, curLvl, x + 1), ss);
-				VertDataMulN(r, 0.5f, ss);
+			/* Average previous level's endpoints */
+			VertDataCopy(r_thread, EDGE_getCo(e, curLvl, x - 1), ss);
+			VertDataAdd(r_thread, EDGE_getCo(e, curLvl, x + 1), ss);
+			VertDataMulN(r_thread, 0.5f, ss);
 
-				/* nCo = nCo * 0.75 + r * 0.25 */
-				VertDataCopy(nCo, co, ss);
-				VertDataMulN(nCo, 0.75f, ss);
-				VertDataMulN(r, 0.25f, ss);
-				VertDataAdd(nCo, r, ss);
-			}
+			/* nCo = nCo * 0.75 + r * 0.25 */
+			VertDataCopy(nCo, co, ss);
+			VertDataMulN(nCo, 0.75f, ss);
+			VertDataMulN(r_thread, 0.25f, ss);
+			VertDataAdd(nCo, r_thread, ss);
 		}
-		else {
-			for (x = 1; x < edgeSize - 1; x++) {
-				int fx = x * 2;
-				const float *co = EDGE_getCo(e, curLvl, x);
-				float *nCo = EDGE_getCo(e, nextLvl, fx);
-				int numFaces = 0;
-
-				VertDataZero(q, ss);
-				VertDataZero(r, ss);
-				VertDataAdd(r, EDGE_getCo(e, curLvl, x - 1), ss);
-				VertDataAdd(r, EDGE_getCo(e, curLvl, x + 1), ss);
-				for (j = 0; j < e->numFaces; j++) {
-					CCGFace *f = e->faces[j];
-					int f_ed_idx = ccg_face_getEdgeIndex(f, e);
-					VertDataAdd(q, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx - 1, 1, subdivLevels, vertDataSize), ss);
-					VertDataAdd(q, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx + 1, 1, subdivLevels, vertDataSize), ss);
-
-					VertDataAdd(r, ccg_face_getIFCoEdge(f, e, f_ed_idx, curLvl, x, 1, subdivLevels, vertDataSize), ss);
-					numFaces++;
-				}
-				VertDataMulN(q, 1.0f / (numFaces * 2.0f), ss);
-				VertDataMulN(r, 1.0f / (2.0f + numFaces), ss);
+	}
+	else {
+		for (x = 1; x < edgeSize - 1; x++) {
+			int fx = x * 2;
+			const float *co = EDGE_getCo(e, curLvl, x);
+			float *nCo = EDGE_getCo(e, nextLvl, fx);
+			int numFaces = 0;
 
-				VertDataCopy(nCo, co, ss);
-				VertDataMulN(nCo, (float) numFaces, ss);
-				VertDataAdd(nCo, q, ss);
-				VertDataAdd(nCo, r, ss);
-				VertDataMulN(nCo, 1.0f / (2 + numFaces), ss);
-
-				if (sharpCount == 2) {
-					VertDataCopy(q, co, ss);
-					VertDataMulN(q, 6.0f, ss);
-					VertDataAdd(q, EDGE_getCo(e, curLvl, x - 1), ss);
-					VertDataAdd(q, EDGE_getCo(e, curLvl, x + 1), ss);
-					VertDataMulN(q, 1 / 8.0f, ss);
-
-					VertDataSub(q, nCo, ss);
-					VertDataMulN(q, avgSharpness, ss);
-					VertDataAdd(nCo, q, ss);
-				}
+			VertDataZero(q_thread, ss);
+			VertDataZero(r_thread, ss);
+			VertDataAdd(r_thread, EDGE_getCo(e, curLvl, x - 1), ss);
+			VertDataAdd(r_thread, EDGE_getCo(e, curLvl, x + 1), ss);
+			for (j = 0; j < e->numFaces; j++) {
+				CCGFace *f = e->faces[j];
+				int f_ed_idx = ccg_face_getEdgeIndex(f, e);
+				VertDataAdd(q_thread, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx - 1, 1, subdivLevels, vertDataSize), ss);
+				VertDataAdd(q_thread, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx + 1, 1, subdivLevels, vertDataSize), ss);
+
+				VertDataAdd(r_thread, ccg_face_getIFCoEdge(f, e, f_ed_idx, curLvl, x, 1, subdivLevels, vertDataSize), ss);
+				numFaces++;
+			}
+			VertDataMulN(q_thread, 1.0f / (numFaces * 2.0f), ss);
+			VertDataMulN(r_thread, 1.0f / (2.0f + numFaces), ss);
+
+			VertDataCopy(nCo, co, ss);
+			VertDataMulN(nCo, (float) numFaces, ss);
+			VertDataAdd(nCo, q_thread, ss);
+			VertDataAdd(nCo, r_thread, ss);
+			VertDataMulN(nCo, 1.0f / (2 + numFaces), ss);
+
+			if (sharpCount == 2) {
+				VertDataCopy(q_thread, co, ss);
+				VertDataMulN(q_thread, 6.0f, ss);
+				VertDataAdd(q_thread, EDGE_getCo(e, curLvl, x - 1), ss);
+				VertDataAdd(q_thread, EDGE_getCo(e, curLvl, x + 1), ss);
+				VertDataMulN(q_thread, 1 / 8.0f, ss);
+
+				VertDataSub(q_thread, nCo, ss);
+				VertDataMulN(q_thread, avgSharpness, ss);
+				VertDataAdd(nCo, q_thread, ss);
 			}
 		}
 	}
+}
+
+/* Calculates level \a curLvl + 1 of the effected elements from level \a curLvl.
+ * All levels are calculated again on every sync, also when only coordinates changed
+ * (there are no cached stencils for unchanged topology), each pass is threaded per element. */
+static void ccgSubSurf__calcSubdivLevel(
+        CCGSubSurf *ss,
+        CCGVert **effectedV, CCGEdge **effectedE, CCGFace **effectedF,
+        const int numEffectedV, const int numEffectedE, const int numEffectedF, const int curLvl)
+{
+	const int nextLvl = curLvl + 1;
+	int edgeSize;
+	int i;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+
+	CCGSubSurfCalcSubdivData data = {
+	    .ss = ss,
+	    .effectedV = effectedV,
+	    .effectedE = effectedE,
+	    .effectedF = effectedF,
+	    .numEffectedV = numEffectedV,
+	    .numEffectedE = numEffectedE,
+	    .numEffectedF = numEffectedF,
+	    .curLvl = curLvl
+	};
+
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.min_iter_per_thread = CCG_TASK_LIMIT;
+		BLI_task_parallel_range(0, numEffectedF,
+		                        &data,
+		                        ccgSubSurf__calcSubdivLevel_interior_faces_edges_midpoints_cb,
+		                        &settings);
+	}
+
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.min_iter_per_thread = CCG_TASK_LIMIT;
+		BLI_task_parallel_range(0, numEffectedE,
+		                        &data,
+		                        ccgSubSurf__calcSubdivLevel_edges_midpoints_cb,
+		                        &settings);
+	}
+
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.min_iter_per_thread = CCG_TASK_LIMIT;
+		BLI_task_parallel_range(0, numEffectedV,
+		                        &data,
+		                        ccgSubSurf__calcSubdivLevel_verts_shift_cb,
+		                        &settings);
+	}
+
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.min_iter_per_thread = CCG_TASK_LIMIT;
+		BLI_task_parallel_range(0, numEffectedE,
+		                        &data,
+		                        ccgSubSurf__calcSubdivLevel_edges_interior_shift_cb,
+		                        &settings);
+	}
 
 	{
 		ParallelRangeSettings settings;
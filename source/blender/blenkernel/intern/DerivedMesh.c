@@ -73,6 +73,8 @@
 
 static ThreadRWMutex loops_cache_lock = PTHREAD_RWLOCK_INITIALIZER;
 
+static void dm_ensure_display_normals(DerivedMesh *dm);
+
 
 /* -------------------------------------------------------------------- */
 
@@ -301,6 +303,7 @@ void DM_init_funcs(DerivedMesh *dm)
 	dm->getLoopDataArray = DM_get_loop_data_layer;
 
 	bvhcache_init(&dm->bvhCache);
+	BLI_mutex_init(&dm->lazy_layers_lock);
 }
 
 /**
@@ -396,6 +399,8 @@ int DM_release(DerivedMesh *dm)
 		dm->looptris.num = 0;
 		dm->looptris.num_alloc = 0;
 
+		BLI_mutex_end(&dm->lazy_layers_lock);
+
 		return 1;
 	}
 	else {
@@ -431,14 +436,38 @@ void DM_DupPolys(DerivedMesh *source, DerivedMesh *target)
 	}
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Lazy Layers
+ *
+ * Derived layers are only built when they are first needed,
+ * the dirty flags are checked with the mesh's own lock held,
+ * so a mesh shared between threads only computes them once, without blocking other meshes.
+ * \{ */
+
 void DM_ensure_normals(DerivedMesh *dm)
 {
+	BLI_mutex_lock(&dm->lazy_layers_lock);
 	if (dm->dirty & DM_DIRTY_NORMALS) {
 		dm->calcNormals(dm);
 	}
+	BLI_mutex_unlock(&dm->lazy_layers_lock);
 	BLI_assert((dm->dirty & DM_DIRTY_NORMALS) == 0);
 }
 
+/**
+ * Ensure the display-only poly normals tagged with #DM_DIRTY_DISPLAY_NORMALS exist.
+ * Use this (or #DM_get_poly_data_layer) before reading the poly #CD_NORMAL layer directly.
+ */
+void DM_ensure_display_normals_lazy(DerivedMesh *dm)
+{
+	BLI_mutex_lock(&dm->lazy_layers_lock);
+	if (dm->dirty & DM_DIRTY_DISPLAY_NORMALS) {
+		dm_ensure_display_normals(dm);
+		dm->dirty &= ~DM_DIRTY_DISPLAY_NORMALS;
+	}
+	BLI_mutex_unlock(&dm->lazy_layers_lock);
+}
+
 static void DM_calc_loop_normals(DerivedMesh *dm, const bool use_split_normals, float split_angle)
 {
 	dm->calcLoopNormals(dm, use_split_normals, split_angle);
@@ -449,8 +478,12 @@ static void DM_calc_loop_normals(DerivedMesh *dm, const bool use_split_normals,
  * use this at the start of modifiers  */
 void DM_ensure_tessface(DerivedMesh *dm)
 {
-	const int numTessFaces = dm->getNumTessFaces(dm);
-	const int numPolys =     dm->getNumPolys(dm);
+	int numTessFaces, numPolys;
+
+	BLI_mutex_lock(&dm->lazy_layers_lock);
+
+	numTessFaces = dm->getNumTessFaces(dm);
+	numPolys =     dm->getNumPolys(dm);
 
 	if ((numTessFaces == 0) && (numPolys != 0)) {
 		dm->recalcTessellation(dm);
@@ -470,8 +503,12 @@ void DM_ensure_tessface(DerivedMesh *dm)
 	}
 
 	dm->dirty &= ~DM_DIRTY_TESS_CDLAYERS;
+
+	BLI_mutex_unlock(&dm->lazy_layers_lock);
 }
 
+/** \} */
+
 /**
  * Ensure the array is large enough
  *
@@ -892,6 +929,9 @@ void *DM_get_tessface_data_layer(DerivedMesh *dm, int type)
 
 void *DM_get_poly_data_layer(DerivedMesh *dm, int type)
 {
+	if (type == CD_NORMAL) {
+		DM_ensure_display_normals_lazy(dm);
+	}
 	return CustomData_get_layer(&dm->polyData, type);
 }
 
@@ -1575,6 +1615,7 @@ static void mesh_calc_modifiers(
 
 	const bool do_loop_normals = (me->flag & ME_AUTOSMOOTH) != 0;
 	const float loop_normals_split_angle = me->smoothresh;
+	const bool use_lazy_display_normals = !useRenderParams && (ob->dt < OB_SOLID);
 
 	VirtualModifierData virtualModifierData;
 
@@ -1804,7 +1845,7 @@ static void mesh_calc_modifiers(
 				}
 			}
 
-			ndm = modwrap_applyModifier(md, ob, dm, app_flags);
+			ndm = modwrap_applyModifier_cached(md, ob, dm, app_flags);
 			ASSERT_IS_VALID_DM(ndm);
 
 			if (ndm) {
@@ -1831,7 +1872,7 @@ static void mesh_calc_modifiers(
 				                 (mti->requiredDataMask ?
 				                  mti->requiredDataMask(ob, md) : 0));
 
-				ndm = modwrap_applyModifier(md, ob, orcodm, (app_flags & ~MOD_APPLY_USECACHE) | MOD_APPLY_ORCO);
+				ndm = modwrap_applyModifier_cached(md, ob, orcodm, (app_flags & ~MOD_APPLY_USECACHE) | MOD_APPLY_ORCO);
 				ASSERT_IS_VALID_DM(ndm);
 
 				if (ndm) {
@@ -1938,7 +1979,17 @@ static void mesh_calc_modifiers(
 		 * If using loop normals, poly nors have already been computed.
 		 */
 		if (!do_loop_normals) {
-			dm_ensure_display_normals(finaldm);
+			if (use_lazy_display_normals) {
+				/* Objects which are never drawn shaded (wire, bounds) only get their display
+				 * normals built if something actually asks for them. */
+				DM_ensure_normals(finaldm);
+				if (finaldm->type == DM_TYPE_CDDM) {
+					finaldm->dirty |= DM_DIRTY_DISPLAY_NORMALS;
+				}
+			}
+			else {
+				dm_ensure_display_normals(finaldm);
+			}
 		}
 	}
 
@@ -3131,7 +3182,7 @@ void DM_calc_loop_tangents(
 				 * have to check this is valid...
 				 */
 				mesh2tangent->precomputedLoopNormals = dm->getLoopDataArray(dm, CD_NORMAL);
-				mesh2tangent->precomputedFaceNormals = CustomData_get_layer(&dm->polyData, CD_NORMAL);
+				mesh2tangent->precomputedFaceNormals = DM_get_poly_data_layer(dm, CD_NORMAL);
 
 				mesh2tangent->orco = NULL;
 				mesh2tangent->mloopuv = CustomData_get_layer_named(&dm->loopData, CD_MLOOPUV, dm->loopData.layers[index].name);
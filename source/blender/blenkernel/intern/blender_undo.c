@@ -60,7 +60,11 @@
 
 #define UNDO_DISK   0
 
-bool BKE_memfile_undo_decode(MemFileUndoData *mfu, bContext *C)
+/**
+ * \param use_id_reuse: Keep data-blocks of the current state which are the same in \a mfu,
+ * instead of reading them again.
+ */
+bool BKE_memfile_undo_decode(MemFileUndoData *mfu, const bool use_id_reuse, bContext *C)
 {
 	Main *bmain = CTX_data_main(C);
 	char mainstr[sizeof(bmain->name)];
@@ -75,10 +79,20 @@ bool BKE_memfile_undo_decode(MemFileUndoData *mfu, bContext *C)
 		success = (BKE_blendfile_read(C, mfu->filename, NULL, 0) != BKE_BLENDFILE_READ_FAIL);
 	}
 	else {
+		/* The current state, written like an undo step (sharing the buffers of the step being read),
+		 * so data-blocks are only kept when they didn't change since any undo push. */
+		MemFile memfile_live = {{NULL}};
+
+		if (use_id_reuse) {
+			BLO_write_file_mem(bmain, &mfu->memfile, &memfile_live, fileflags);
+		}
+
 		success = BKE_blendfile_read_from_memfile(
-		        C, &mfu->memfile,
+		        C, &mfu->memfile, use_id_reuse ? &memfile_live : NULL,
 		        &(const struct BlendFileReadParams){0},
 		        NULL);
+
+		BLO_memfile_free(&memfile_live);
 	}
 
 	/* Restore, bmain has been re-allocated. */
@@ -385,16 +385,22 @@ bool BKE_blendfile_read_from_memory(
 	return (bfd != NULL);
 }
 
-/* memfile is the undo buffer */
+/**
+ * memfile is the undo buffer.
+ *
+ * \param memfile_live: The current state written with \a memfile as reference (may be NULL),
+ * used to keep unchanged data-blocks instead of reading them again.
+ */
 bool BKE_blendfile_read_from_memfile(
-        bContext *C, struct MemFile *memfile,
+        bContext *C, struct MemFile *memfile, struct MemFile *memfile_live,
         const struct BlendFileReadParams *params,
         ReportList *reports)
 {
 	Main *bmain = CTX_data_main(C);
 	BlendFileData *bfd;
 
-	bfd = BLO_read_from_memfile(bmain, BKE_main_blendfile_path(bmain), memfile, params->skip_flags, reports);
+	bfd = BLO_read_from_memfile(
+	        bmain, BKE_main_blendfile_path(bmain), memfile, memfile_live, params->skip_flags, reports);
 	if (bfd) {
 		/* remove the unused screens and wm */
 		while (bfd->main->wm.first)
@@ -241,7 +241,7 @@ static void cdDM_update_normals_from_pbvh(DerivedMesh *dm)
 		return;
 	}
 
-	face_nors = CustomData_get_layer(&dm->polyData, CD_NORMAL);
+	face_nors = dm->getPolyDataArray(dm, CD_NORMAL);
 
 	BKE_pbvh_update(cddm->pbvh, PBVH_UpdateNormals, face_nors);
 }
@@ -342,7 +342,7 @@ static void cdDM_drawFacesSolid(
 
 	if (cddm->pbvh) {
 		if (cddm->pbvh_draw && BKE_pbvh_has_faces(cddm->pbvh)) {
-			float (*face_nors)[3] = CustomData_get_layer(&dm->polyData, CD_NORMAL);
+			float (*face_nors)[3] = dm->getPolyDataArray(dm, CD_NORMAL);
 
 			BKE_pbvh_draw(cddm->pbvh, partial_redraw_planes, face_nors,
 			              setMaterial, false, false);
@@ -2119,6 +2119,7 @@ static DerivedMesh *cddm_from_bmesh_ex(
 	const int cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
 	const int cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
 	const int cd_edge_crease_offset  = CustomData_get_offset(&bm->edata, CD_CREASE);
+	const bool use_soa = (bm->totloop >= BM_OMP_LIMIT);
 
 	dm->deformedOnly = 1;
 
@@ -2130,6 +2131,16 @@ static DerivedMesh *cddm_from_bmesh_ex(
 	/* don't process shapekeys, we only feed them through the modifier stack as needed,
 	 * e.g. for applying modifiers or the like*/
 	mask &= ~CD_MASK_SHAPEKEY;
+
+	/* for large meshes, plain data layers are gathered from the blocks in one threaded pass,
+	 * then copied as arrays (CustomData_from_bmesh_block skips them) */
+	if (use_soa) {
+		CustomData_bmesh_soa_begin(bm, &bm->vdata, BM_VERT, mask);
+		CustomData_bmesh_soa_begin(bm, &bm->edata, BM_EDGE, mask);
+		CustomData_bmesh_soa_begin(bm, &bm->ldata, BM_LOOP, mask);
+		CustomData_bmesh_soa_begin(bm, &bm->pdata, BM_FACE, mask);
+	}
+
 	CustomData_merge(&bm->vdata, &dm->vertData, mask,
 	                 CD_CALLOC, dm->numVertData);
 	CustomData_merge(&bm->edata, &dm->edgeData, mask,
@@ -2250,6 +2261,18 @@ static DerivedMesh *cddm_from_bmesh_ex(
 	}
 	bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP);
 
+	if (use_soa) {
+		CustomData_bmesh_soa_to_layers(&bm->vdata, &dm->vertData, dm->numVertData);
+		CustomData_bmesh_soa_to_layers(&bm->edata, &dm->edgeData, dm->numEdgeData);
+		CustomData_bmesh_soa_to_layers(&bm->ldata, &dm->loopData, dm->numLoopData);
+		CustomData_bmesh_soa_to_layers(&bm->pdata, &dm->polyData, dm->numPolyData);
+
+		CustomData_bmesh_soa_end(bm, &bm->vdata, BM_VERT, false);
+		CustomData_bmesh_soa_end(bm, &bm->edata, BM_EDGE, false);
+		CustomData_bmesh_soa_end(bm, &bm->ldata, BM_LOOP, false);
+		CustomData_bmesh_soa_end(bm, &bm->pdata, BM_FACE, false);
+	}
+
 	dm->cd_flag = BM_mesh_cd_flag_from_bmesh(bm);
 
 	return dm;
@@ -2488,7 +2511,7 @@ void CDDM_calc_normals_mapping_ex(DerivedMesh *dm, const bool only_face_normals)
 
 	CustomData_add_layer(&dm->polyData, CD_NORMAL, CD_ASSIGN, face_nors, dm->numPolyData);
 
-	cddm->dm.dirty &= ~DM_DIRTY_NORMALS;
+	cddm->dm.dirty &= ~(DM_DIRTY_NORMALS | DM_DIRTY_DISPLAY_NORMALS);
 }
 
 void CDDM_calc_normals_mapping(DerivedMesh *dm)
@@ -2520,7 +2543,7 @@ void CDDM_calc_normals(DerivedMesh *dm)
 	BKE_mesh_calc_normals_poly(cddm->mvert, dm->numVertData, CDDM_get_loops(dm), CDDM_get_polys(dm),
 	                               dm->numLoopData, dm->numPolyData, poly_nors, false);
 
-	cddm->dm.dirty &= ~DM_DIRTY_NORMALS;
+	cddm->dm.dirty &= ~(DM_DIRTY_NORMALS | DM_DIRTY_DISPLAY_NORMALS);
 }
 #else
 
@@ -2587,7 +2610,7 @@ void CDDM_calc_loop_normals_spacearr(
 	BKE_mesh_calc_normals_poly(mverts, NULL, numVerts, mloops, mpolys, numLoops, numPolys, pnors,
 	                           (dm->dirty & DM_DIRTY_NORMALS) ? false : true);
 
-	dm->dirty &= ~DM_DIRTY_NORMALS;
+	dm->dirty &= ~(DM_DIRTY_NORMALS | DM_DIRTY_DISPLAY_NORMALS);
 
 	clnor_data = CustomData_get_layer(ldata, CD_CUSTOMLOOPNORMAL);
 
@@ -26,12 +26,18 @@
 #include <string.h>
 #include <stdlib.h>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_task.h"
 
 #include "DNA_curve_types.h"
 #include "DNA_material_types.h"
@@ -248,6 +254,7 @@ void BKE_curve_init(Curve *cu)
 	cu->flag = CU_FRONT | CU_BACK | CU_DEFORM_BOUNDS_OFF | CU_PATH_RADIUS;
 	cu->pathlen = 100;
 	cu->resolu = cu->resolv = (cu->type == OB_SURF) ? 4 : 12;
+	cu->resolu_tolerance = 0.001f;
 	cu->width = 1.0;
 	cu->wordspace = 1.0;
 	cu->spacing = cu->linedist = 1.0;
@@ -773,12 +780,10 @@ float BKE_nurb_calc_length(const Nurb *nu, int resolution)
 				length += len_v3v3(prevbezt->vec[1], bezt->vec[1]);
 			}
 			else {
-				for (int j = 0; j < 3; j++) {
-					BKE_curve_forward_diff_bezier(
-					        prevbezt->vec[1][j], prevbezt->vec[2][j],
-					        bezt->vec[0][j], bezt->vec[1][j],
-					        points + j, resolu, 3 * sizeof(float));
-				}
+				BKE_curve_forward_diff_bezier_v3(
+				        prevbezt->vec[1], prevbezt->vec[2],
+				        bezt->vec[0], bezt->vec[1],
+				        points, resolu, 3 * sizeof(float));
 
 				prevpntsit = pntsit = points;
 				b = resolu;
@@ -1661,6 +1666,105 @@ void BKE_curve_forward_diff_bezier(float q0, float q1, float q2, float q3, float
 	}
 }
 
+/**
+ * Forward differencing of all three axes at once, matches calling #BKE_curve_forward_diff_bezier
+ * for each axis (the results are identical).
+ *
+ * \param p: Has to be (it + 1) * stride in size, each point is written to the first 3 floats.
+ */
+void BKE_curve_forward_diff_bezier_v3(
+        const float q0[3], const float q1[3], const float q2[3], const float q3[3],
+        float *p, int it, int stride)
+{
+#ifdef __SSE2__
+	/* the fourth lane is unused, the same operations as the scalar version on each axis */
+	const __m128 q0_r = _mm_setr_ps(q0[0], q0[1], q0[2], 0.0f);
+	const __m128 q1_r = _mm_setr_ps(q1[0], q1[1], q1[2], 0.0f);
+	const __m128 q2_r = _mm_setr_ps(q2[0], q2[1], q2[2], 0.0f);
+	const __m128 q3_r = _mm_setr_ps(q3[0], q3[1], q3[2], 0.0f);
+	const __m128 two = _mm_set1_ps(2.0f), three = _mm_set1_ps(3.0f), six = _mm_set1_ps(6.0f);
+	__m128 rt1, rt2, rt3, d0, d1, d2, d3;
+	float f;
+	int a;
+
+	f = (float)it;
+	rt1 = _mm_div_ps(_mm_mul_ps(three, _mm_sub_ps(q1_r, q0_r)), _mm_set1_ps(f));
+	f *= f;
+	rt2 = _mm_div_ps(
+	        _mm_mul_ps(three, _mm_add_ps(_mm_sub_ps(q0_r, _mm_mul_ps(two, q1_r)), q2_r)),
+	        _mm_set1_ps(f));
+	f *= it;
+	rt3 = _mm_div_ps(
+	        _mm_add_ps(_mm_sub_ps(q3_r, q0_r), _mm_mul_ps(three, _mm_sub_ps(q1_r, q2_r))),
+	        _mm_set1_ps(f));
+
+	d0 = q0_r;
+	d1 = _mm_add_ps(_mm_add_ps(rt1, rt2), rt3);
+	d2 = _mm_add_ps(_mm_mul_ps(two, rt2), _mm_mul_ps(six, rt3));
+	d3 = _mm_mul_ps(six, rt3);
+
+	for (a = 0; a <= it; a++) {
+		_mm_storel_pi((__m64 *)p, d0);
+		_mm_store_ss(p + 2, _mm_movehl_ps(d0, d0));
+		p = POINTER_OFFSET(p, stride);
+		d0 = _mm_add_ps(d0, d1);
+		d1 = _mm_add_ps(d1, d2);
+		d2 = _mm_add_ps(d2, d3);
+	}
+#else
+	for (int j = 0; j < 3; j++) {
+		BKE_curve_forward_diff_bezier(q0[j], q1[j], q2[j], q3[j], p + j, it, stride);
+	}
+#endif
+}
+
+/**
+ * The number of segments a cubic bezier needs so no point of it is further than \a tolerance
+ * from the segments, from the bound of the second derivative (Wang's formula).
+ *
+ * \return At least 1, at most \a resolu.
+ */
+int BKE_curve_bezier_resolu_adaptive(
+        const float q0[3], const float q1[3], const float q2[3], const float q3[3],
+        const float tolerance, const int resolu)
+{
+	float d0[3], d1[3], len_sq, n;
+
+	/* q0 - 2 * q1 + q2 and q1 - 2 * q2 + q3, the second derivative (over 6) at the ends */
+	sub_v3_v3v3(d0, q0, q1);
+	sub_v3_v3(d0, q1);
+	add_v3_v3(d0, q2);
+	sub_v3_v3v3(d1, q1, q2);
+	sub_v3_v3(d1, q2);
+	add_v3_v3(d1, q3);
+
+	len_sq = max_ff(len_squared_v3(d0), len_squared_v3(d1));
+	if (len_sq == 0.0f) {
+		return 1;
+	}
+	if (!(tolerance > 0.0f)) {
+		return resolu;
+	}
+
+	/* the distance is at most (6 * len) / (8 * n^2) */
+	n = ceilf(sqrtf(0.75f * sqrtf(len_sq) / tolerance));
+	return (n < (float)resolu) ? max_ii((int)n, 1) : resolu;
+}
+
+/**
+ * Resolution of the bezier segment from \a bezt_a to \a bezt_b, see #CU_RESOLU_ADAPTIVE.
+ */
+int BKE_curve_bezier_segment_resolu(
+        const Curve *cu, const BezTriple *bezt_a, const BezTriple *bezt_b, const int resolu)
+{
+	if (cu->flag & CU_RESOLU_ADAPTIVE) {
+		return BKE_curve_bezier_resolu_adaptive(
+		        bezt_a->vec[1], bezt_a->vec[2], bezt_b->vec[0], bezt_b->vec[1],
+		        cu->resolu_tolerance, resolu);
+	}
+	return resolu;
+}
+
 /* forward differencing method for first derivative of cubic bezier curve */
 void BKE_curve_forward_diff_tangent_bezier(float q0, float q1, float q2, float q3, float *p, int it, int stride)
 {
@@ -1991,8 +2095,18 @@ struct BevelSort {
 	BevList *bl;
 	float left;
 	int dir;
+	/* bounds of the poly, for a quick test before 'bevelinside' */
+	float min[2], max[2];
+	struct BevelListMakeItem *item;
 };
 
+/* 'bevelinside' only finds points inside the bounds of the poly */
+static bool bevel_sort_bounds_contain(const struct BevelSort *sd, const float co[2])
+{
+	return ((co[0] >= sd->min[0]) && (co[0] <= sd->max[0]) &&
+	        (co[1] >= sd->min[1]) && (co[1] <= sd->max[1]));
+}
+
 static int vergxcobev(const void *a1, const void *a2)
 {
 	const struct BevelSort *x1 = a1, *x2 = a2;
@@ -2592,154 +2706,274 @@ static void bevlist_firstlast_direction_calc_from_bpoint(Nurb *nu, BevList *bl)
 	}
 }
 
+static void bevel_list_free(BevList *bl)
+{
+	if (bl->seglen != NULL) {
+		MEM_freeN(bl->seglen);
+	}
+	if (bl->segbevcount != NULL) {
+		MEM_freeN(bl->segbevcount);
+	}
+	if (bl->bevpoints != NULL) {
+		MEM_freeN(bl->bevpoints);
+	}
+	MEM_freeN(bl);
+}
+
 void BKE_curve_bevelList_free(ListBase *bev)
 {
 	BevList *bl, *blnext;
 	for (bl = bev->first; bl != NULL; bl = blnext) {
 		blnext = bl->next;
-		if (bl->seglen != NULL) {
-			MEM_freeN(bl->seglen);
-		}
-		if (bl->segbevcount != NULL) {
-			MEM_freeN(bl->segbevcount);
-		}
-		if (bl->bevpoints != NULL) {
-			MEM_freeN(bl->bevpoints);
-		}
-		MEM_freeN(bl);
+		bevel_list_free(bl);
 	}
 
 	BLI_listbase_clear(bev);
 }
 
-void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
+static BevList *bevel_list_duplicate(const BevList *bl)
 {
-	/*
-	 * - convert all curves to polys, with indication of resol and flags for double-vertices
-	 * - possibly; do a smart vertice removal (in case Nurb)
-	 * - separate in individual blocks with BoundBox
-	 * - AutoHole detection
-	 */
+	BevList *bl_dst = MEM_dupallocN(bl);
 
-	/* this function needs an object, because of tflag and upflag */
-	Curve *cu = ob->data;
-	Nurb *nu;
+	bl_dst->next = bl_dst->prev = NULL;
+	bl_dst->bevpoints = MEM_dupallocN(bl->bevpoints);
+	if (bl->seglen != NULL) {
+		bl_dst->seglen = MEM_dupallocN(bl->seglen);
+	}
+	if (bl->segbevcount != NULL) {
+		bl_dst->segbevcount = MEM_dupallocN(bl->segbevcount);
+	}
+
+	return bl_dst;
+}
+
+/**
+ * Convert a spline to a poly, with indication of resol and flags for double-vertices.
+ *
+ * \return NULL for surfaces.
+ */
+static BevList *bevel_list_from_nurb(const Curve *cu, Nurb *nu, const bool need_seglen)
+{
 	BezTriple *bezt, *prevbezt;
 	BPoint *bp;
-	BevList *bl, *blnew, *blnext;
-	BevPoint *bevp2, *bevp1 = NULL, *bevp0;
+	BevList *bl = NULL;
+	BevPoint *bevp0;
 	const float treshold = 0.00001f;
-	float min, inp;
 	float *seglen = NULL;
-	struct BevelSort *sortdata, *sd, *sd1;
-	int a, b, nr, poly, resolu = 0, len = 0, segcount;
+	int a, nr, resolu, len, segcount;
 	int *segbevcount;
 	bool do_tilt, do_radius, do_weight;
-	bool is_editmode = false;
-	ListBase *bev;
 
-	/* segbevcount alsp requires seglen. */
-	const bool need_seglen =
-		ELEM(cu->bevfac1_mapping, CU_BEVFAC_MAP_SEGMENT, CU_BEVFAC_MAP_SPLINE) ||
-		ELEM(cu->bevfac2_mapping, CU_BEVFAC_MAP_SEGMENT, CU_BEVFAC_MAP_SPLINE);
+	/* check if we will calculate tilt data */
+	do_tilt = CU_DO_TILT(cu, nu);
+	do_radius = CU_DO_RADIUS(cu, nu); /* normal display uses the radius, better just to calculate them */
+	do_weight = true;
 
+	/* check we are a single point? also check we are not a surface and that the orderu is sane,
+	 * enforced in the UI but can go wrong possibly */
+	if (!BKE_nurb_check_valid_u(nu)) {
+		bl = MEM_callocN(sizeof(BevList), "makeBevelList1");
+		bl->bevpoints = MEM_calloc_arrayN(1, sizeof(BevPoint), "makeBevelPoints1");
+		bl->nr = 0;
+		bl->charidx = nu->charidx;
+	}
+	else {
+		BevPoint *bevp;
 
-	bev = BKE_object_curve_bevlist(ob);
+		resolu = nu->resolu;
 
-	/* do we need to calculate the radius for each point? */
-	/* do_radius = (cu->bevobj || cu->taperobj || (cu->flag & CU_FRONT) || (cu->flag & CU_BACK)) ? 0 : 1; */
+		segcount = SEGMENTSU(nu);
 
-	/* STEP 1: MAKE POLYS  */
+		if (nu->type == CU_POLY) {
+			len = nu->pntsu;
+			bl = MEM_callocN(sizeof(BevList), "makeBevelList2");
+			bl->bevpoints = MEM_calloc_arrayN(len, sizeof(BevPoint), "makeBevelPoints2");
+			if (need_seglen && (nu->flagu & CU_NURB_CYCLIC) == 0) {
+				bl->seglen = MEM_malloc_arrayN(segcount, sizeof(float), "makeBevelList2_seglen");
+				bl->segbevcount = MEM_malloc_arrayN(segcount, sizeof(int), "makeBevelList2_segbevcount");
+			}
 
-	BKE_curve_bevelList_free(bev);
-	nu = nurbs->first;
-	if (cu->editnurb && ob->type != OB_FONT) {
-		is_editmode = 1;
-	}
+			bl->poly = (nu->flagu & CU_NURB_CYCLIC) ? 0 : -1;
+			bl->nr = len;
+			bl->dupe_nr = 0;
+			bl->charidx = nu->charidx;
+			bevp = bl->bevpoints;
+			bevp->offset = 0;
+			bp = nu->bp;
+			seglen = bl->seglen;
+			segbevcount = bl->segbevcount;
+
+			while (len--) {
+				copy_v3_v3(bevp->vec, bp->vec);
+				bevp->alfa = bp->alfa;
+				bevp->radius = bp->radius;
+				bevp->weight = bp->weight;
+				bevp->split_tag = true;
+				bp++;
+				if (seglen != NULL && len != 0) {
+					*seglen = len_v3v3(bevp->vec, bp->vec);
+					bevp++;
+					bevp->offset = *seglen;
+					if (*seglen > treshold) *segbevcount = 1;
+					else *segbevcount = 0;
+					seglen++;
+					segbevcount++;
+				}
+				else {
+					bevp++;
+				}
+			}
 
-	for (; nu; nu = nu->next) {
+			if ((nu->flagu & CU_NURB_CYCLIC) == 0) {
+				bevlist_firstlast_direction_calc_from_bpoint(nu, bl);
+			}
+		}
+		else if (nu->type == CU_BEZIER) {
+			/* in case last point is not cyclic (at most, segments may use less with CU_RESOLU_ADAPTIVE) */
+			len = segcount * resolu + 1;
 
-		if (nu->hide && is_editmode)
-			continue;
+			bl = MEM_callocN(sizeof(BevList), "makeBevelBPoints");
+			bl->bevpoints = MEM_calloc_arrayN(len, sizeof(BevPoint), "makeBevelBPointsPoints");
+			if (need_seglen && (nu->flagu & CU_NURB_CYCLIC) == 0) {
+				bl->seglen = MEM_malloc_arrayN(segcount, sizeof(float), "makeBevelBPoints_seglen");
+				bl->segbevcount = MEM_malloc_arrayN(segcount, sizeof(int), "makeBevelBPoints_segbevcount");
+			}
 
-		/* check if we will calculate tilt data */
-		do_tilt = CU_DO_TILT(cu, nu);
-		do_radius = CU_DO_RADIUS(cu, nu); /* normal display uses the radius, better just to calculate them */
-		do_weight = true;
-
-		/* check we are a single point? also check we are not a surface and that the orderu is sane,
-		 * enforced in the UI but can go wrong possibly */
-		if (!BKE_nurb_check_valid_u(nu)) {
-			bl = MEM_callocN(sizeof(BevList), "makeBevelList1");
-			bl->bevpoints = MEM_calloc_arrayN(1, sizeof(BevPoint), "makeBevelPoints1");
-			BLI_addtail(bev, bl);
-			bl->nr = 0;
+			bl->poly = (nu->flagu & CU_NURB_CYCLIC) ? 0 : -1;
 			bl->charidx = nu->charidx;
-		}
-		else {
-			BevPoint *bevp;
 
-			resolu = nu->resolu;
+			bevp = bl->bevpoints;
+			seglen = bl->seglen;
+			segbevcount = bl->segbevcount;
 
-			segcount = SEGMENTSU(nu);
+			bevp->offset = 0;
+			if (seglen != NULL) {
+				*seglen = 0;
+				*segbevcount = 0;
+			}
 
-			if (nu->type == CU_POLY) {
-				len = nu->pntsu;
-				bl = MEM_callocN(sizeof(BevList), "makeBevelList2");
-				bl->bevpoints = MEM_calloc_arrayN(len, sizeof(BevPoint), "makeBevelPoints2");
-				if (need_seglen && (nu->flagu & CU_NURB_CYCLIC) == 0) {
-					bl->seglen = MEM_malloc_arrayN(segcount, sizeof(float), "makeBevelList2_seglen");
-					bl->segbevcount = MEM_malloc_arrayN(segcount, sizeof(int), "makeBevelList2_segbevcount");
-				}
-				BLI_addtail(bev, bl);
+			a = nu->pntsu - 1;
+			bezt = nu->bezt;
+			if (nu->flagu & CU_NURB_CYCLIC) {
+				a++;
+				prevbezt = nu->bezt + (nu->pntsu - 1);
+			}
+			else {
+				prevbezt = bezt;
+				bezt++;
+			}
 
-				bl->poly = (nu->flagu & CU_NURB_CYCLIC) ? 0 : -1;
-				bl->nr = len;
-				bl->dupe_nr = 0;
-				bl->charidx = nu->charidx;
-				bevp = bl->bevpoints;
-				bevp->offset = 0;
-				bp = nu->bp;
-				seglen = bl->seglen;
-				segbevcount = bl->segbevcount;
+			sub_v3_v3v3(bevp->dir, prevbezt->vec[2], prevbezt->vec[1]);
+			normalize_v3(bevp->dir);
+
+			BLI_assert(segcount >= a);
 
-				while (len--) {
-					copy_v3_v3(bevp->vec, bp->vec);
-					bevp->alfa = bp->alfa;
-					bevp->radius = bp->radius;
-					bevp->weight = bp->weight;
+			while (a--) {
+				if (prevbezt->h2 == HD_VECT && bezt->h1 == HD_VECT) {
+
+					copy_v3_v3(bevp->vec, prevbezt->vec[1]);
+					bevp->alfa = prevbezt->alfa;
+					bevp->radius = prevbezt->radius;
+					bevp->weight = prevbezt->weight;
 					bevp->split_tag = true;
-					bp++;
-					if (seglen != NULL && len != 0) {
-						*seglen = len_v3v3(bevp->vec, bp->vec);
-						bevp++;
+					bevp->dupe_tag = false;
+					bevp++;
+					bl->nr++;
+					bl->dupe_nr = 1;
+					if (seglen != NULL) {
+						*seglen = len_v3v3(prevbezt->vec[1], bezt->vec[1]);
 						bevp->offset = *seglen;
-						if (*seglen > treshold) *segbevcount = 1;
-						else *segbevcount = 0;
 						seglen++;
+						/* match segbevcount to the cleaned up bevel lists (see STEP 2) */
+						if (bevp->offset > treshold) *segbevcount = 1;
 						segbevcount++;
 					}
+				}
+				else {
+					const int resolu_seg = BKE_curve_bezier_segment_resolu(cu, prevbezt, bezt, resolu);
+					int j;
+
+					/* always do all three, to prevent data hanging around */
+					BKE_curve_forward_diff_bezier_v3(prevbezt->vec[1], prevbezt->vec[2],
+					                                 bezt->vec[0],     bezt->vec[1],
+					                                 bevp->vec, resolu_seg, sizeof(BevPoint));
+
+					/* if both arrays are NULL do nothiong */
+					alfa_bezpart(prevbezt, bezt, nu,
+					             do_tilt    ? &bevp->alfa : NULL,
+					             do_radius  ? &bevp->radius : NULL,
+					             do_weight  ? &bevp->weight : NULL,
+					             resolu_seg, sizeof(BevPoint));
+
+
+					if (cu->twist_mode == CU_TWIST_TANGENT) {
+						forward_diff_bezier_cotangent(prevbezt->vec[1], prevbezt->vec[2],
+						                              bezt->vec[0],     bezt->vec[1],
+						                              bevp->tan, resolu_seg, sizeof(BevPoint));
+					}
+
+					/* indicate with handlecodes double points */
+					if (prevbezt->h1 == prevbezt->h2) {
+						if (prevbezt->h1 == 0 || prevbezt->h1 == HD_VECT)
+							bevp->split_tag = true;
+					}
 					else {
-						bevp++;
+						if (prevbezt->h1 == 0 || prevbezt->h1 == HD_VECT)
+							bevp->split_tag = true;
+						else if (prevbezt->h2 == 0 || prevbezt->h2 == HD_VECT)
+							bevp->split_tag = true;
 					}
-				}
 
-				if ((nu->flagu & CU_NURB_CYCLIC) == 0) {
-					bevlist_firstlast_direction_calc_from_bpoint(nu, bl);
+					/* seglen */
+					if (seglen != NULL) {
+						*seglen = 0;
+						*segbevcount = 0;
+						for (j = 0; j < resolu_seg; j++) {
+							bevp0 = bevp;
+							bevp++;
+							bevp->offset = len_v3v3(bevp0->vec, bevp->vec);
+							/* match seglen and segbevcount to the cleaned up bevel lists (see STEP 2) */
+							if (bevp->offset > treshold) {
+								*seglen += bevp->offset;
+								*segbevcount += 1;
+							}
+						}
+						seglen++;
+						segbevcount++;
+					}
+					else {
+						bevp += resolu_seg;
+					}
+					bl->nr += resolu_seg;
 				}
+				prevbezt = bezt;
+				bezt++;
 			}
-			else if (nu->type == CU_BEZIER) {
-				/* in case last point is not cyclic */
-				len = segcount * resolu + 1;
 
-				bl = MEM_callocN(sizeof(BevList), "makeBevelBPoints");
-				bl->bevpoints = MEM_calloc_arrayN(len, sizeof(BevPoint), "makeBevelBPointsPoints");
+			if ((nu->flagu & CU_NURB_CYCLIC) == 0) {      /* not cyclic: endpoint */
+				copy_v3_v3(bevp->vec, prevbezt->vec[1]);
+				bevp->alfa = prevbezt->alfa;
+				bevp->radius = prevbezt->radius;
+				bevp->weight = prevbezt->weight;
+
+				sub_v3_v3v3(bevp->dir, prevbezt->vec[1], prevbezt->vec[0]);
+				normalize_v3(bevp->dir);
+
+				bl->nr++;
+			}
+		}
+		else if (nu->type == CU_NURBS) {
+			if (nu->pntsv == 1) {
+				len = (resolu * segcount);
+
+				bl = MEM_callocN(sizeof(BevList), "makeBevelList3");
+				bl->bevpoints = MEM_calloc_arrayN(len, sizeof(BevPoint), "makeBevelPoints3");
 				if (need_seglen && (nu->flagu & CU_NURB_CYCLIC) == 0) {
-					bl->seglen = MEM_malloc_arrayN(segcount, sizeof(float), "makeBevelBPoints_seglen");
-					bl->segbevcount = MEM_malloc_arrayN(segcount, sizeof(int), "makeBevelBPoints_segbevcount");
+					bl->seglen = MEM_malloc_arrayN(segcount, sizeof(float), "makeBevelList3_seglen");
+					bl->segbevcount = MEM_malloc_arrayN(segcount, sizeof(int), "makeBevelList3_segbevcount");
 				}
-				BLI_addtail(bev, bl);
-
+				bl->nr = len;
+				bl->dupe_nr = 0;
 				bl->poly = (nu->flagu & CU_NURB_CYCLIC) ? 0 : -1;
 				bl->charidx = nu->charidx;
 
@@ -2747,257 +2981,486 @@ void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
 				seglen = bl->seglen;
 				segbevcount = bl->segbevcount;
 
-				bevp->offset = 0;
+				BKE_nurb_makeCurve(nu, &bevp->vec[0],
+				                   do_tilt      ? &bevp->alfa : NULL,
+				                   do_radius    ? &bevp->radius : NULL,
+				                   do_weight    ? &bevp->weight : NULL,
+				                   resolu, sizeof(BevPoint));
+
+				/* match seglen and segbevcount to the cleaned up bevel lists (see STEP 2) */
 				if (seglen != NULL) {
-					*seglen = 0;
-					*segbevcount = 0;
+					nr = segcount;
+					bevp0 = bevp;
+					bevp++;
+					while (nr) {
+						int j;
+						*seglen = 0;
+						*segbevcount = 0;
+						/* We keep last bevel segment zero-length. */
+						for (j = 0; j < ((nr == 1) ? (resolu - 1) : resolu); j++) {
+							bevp->offset = len_v3v3(bevp0->vec, bevp->vec);
+							if (bevp->offset > treshold) {
+								*seglen += bevp->offset;
+								*segbevcount += 1;
+							}
+							bevp0 = bevp;
+							bevp++;
+						}
+						seglen++;
+						segbevcount++;
+						nr--;
+					}
 				}
 
-				a = nu->pntsu - 1;
-				bezt = nu->bezt;
-				if (nu->flagu & CU_NURB_CYCLIC) {
-					a++;
-					prevbezt = nu->bezt + (nu->pntsu - 1);
-				}
-				else {
-					prevbezt = bezt;
-					bezt++;
+				if ((nu->flagu & CU_NURB_CYCLIC) == 0) {
+					bevlist_firstlast_direction_calc_from_bpoint(nu, bl);
 				}
+			}
+		}
+	}
 
-				sub_v3_v3v3(bevp->dir, prevbezt->vec[2], prevbezt->vec[1]);
-				normalize_v3(bevp->dir);
+	return bl;
+}
 
-				BLI_assert(segcount >= a);
+/* remove double points (they would give zero length segments) */
+static void bevel_list_remove_doubles(BevList *bl)
+{
+	BevPoint *bevp0, *bevp1;
+	int nr;
 
-				while (a--) {
-					if (prevbezt->h2 == HD_VECT && bezt->h1 == HD_VECT) {
-
-						copy_v3_v3(bevp->vec, prevbezt->vec[1]);
-						bevp->alfa = prevbezt->alfa;
-						bevp->radius = prevbezt->radius;
-						bevp->weight = prevbezt->weight;
-						bevp->split_tag = true;
-						bevp->dupe_tag = false;
-						bevp++;
-						bl->nr++;
-						bl->dupe_nr = 1;
-						if (seglen != NULL) {
-							*seglen = len_v3v3(prevbezt->vec[1], bezt->vec[1]);
-							bevp->offset = *seglen;
-							seglen++;
-							/* match segbevcount to the cleaned up bevel lists (see STEP 2) */
-							if (bevp->offset > treshold) *segbevcount = 1;
-							segbevcount++;
+	if (bl->nr) { /* null bevel items come from single points */
+		bool is_cyclic = bl->poly != -1;
+		nr = bl->nr;
+		if (is_cyclic) {
+			bevp1 = bl->bevpoints;
+			bevp0 = bevp1 + (nr - 1);
+		}
+		else {
+			bevp0 = bl->bevpoints;
+			bevp0->offset = 0;
+			bevp1 = bevp0 + 1;
+		}
+		nr--;
+		while (nr--) {
+			if (bl->seglen != NULL) {
+				if (fabsf(bevp1->offset) < 0.00001f) {
+					bevp0->dupe_tag = true;
+					bl->dupe_nr++;
+				}
+			}
+			else {
+				if (fabsf(bevp0->vec[0] - bevp1->vec[0]) < 0.00001f) {
+					if (fabsf(bevp0->vec[1] - bevp1->vec[1]) < 0.00001f) {
+						if (fabsf(bevp0->vec[2] - bevp1->vec[2]) < 0.00001f) {
+							bevp0->dupe_tag = true;
+							bl->dupe_nr++;
 						}
 					}
-					else {
-						/* always do all three, to prevent data hanging around */
-						int j;
-
-						/* BevPoint must stay aligned to 4 so sizeof(BevPoint)/sizeof(float) works */
-						for (j = 0; j < 3; j++) {
-							BKE_curve_forward_diff_bezier(prevbezt->vec[1][j],  prevbezt->vec[2][j],
-							                              bezt->vec[0][j],      bezt->vec[1][j],
-							                              &(bevp->vec[j]), resolu, sizeof(BevPoint));
-						}
+				}
+			}
+			bevp0 = bevp1;
+			bevp1++;
+		}
+	}
 
-						/* if both arrays are NULL do nothiong */
-						alfa_bezpart(prevbezt, bezt, nu,
-						             do_tilt    ? &bevp->alfa : NULL,
-						             do_radius  ? &bevp->radius : NULL,
-						             do_weight  ? &bevp->weight : NULL,
-						             resolu, sizeof(BevPoint));
+	if (bl->nr && bl->dupe_nr) {
+		/* the points are moved down in place, they're never written past where they're read */
+		bevp0 = bevp1 = bl->bevpoints;
+		nr = bl->nr;
+		bl->nr = 0;
+		while (nr--) {
+			if (bevp0->dupe_tag == 0) {
+				if (bevp1 != bevp0) {
+					memcpy(bevp1, bevp0, sizeof(BevPoint));
+				}
+				bevp1++;
+				bl->nr++;
+			}
+			bevp0++;
+		}
+		bl->dupe_nr = 0;
+	}
+}
 
+/* ****************** BEVEL LIST CACHE ************** */
 
-						if (cu->twist_mode == CU_TWIST_TANGENT) {
-							forward_diff_bezier_cotangent(prevbezt->vec[1], prevbezt->vec[2],
-							                              bezt->vec[0],     bezt->vec[1],
-							                              bevp->tan, resolu, sizeof(BevPoint));
-						}
+/* The polys of the splines are kept between updates (in the object's curve cache),
+ * so only splines that changed need to be converted and oriented again, which matters
+ * for curves with thousands of splines (imported drawings, text) where one is edited.
+ *
+ * Splines are matched by everything their poly depends on, their settings and control points. */
 
-						/* indicate with handlecodes double points */
-						if (prevbezt->h1 == prevbezt->h2) {
-							if (prevbezt->h1 == 0 || prevbezt->h1 == HD_VECT)
-								bevp->split_tag = true;
-						}
-						else {
-							if (prevbezt->h1 == 0 || prevbezt->h1 == HD_VECT)
-								bevp->split_tag = true;
-							else if (prevbezt->h2 == 0 || prevbezt->h2 == HD_VECT)
-								bevp->split_tag = true;
-						}
+struct BevelListCache {
+	/* BevelListCacheKey -> BevelListCacheEntry */
+	GHash *entries;
+};
 
-						/* seglen */
-						if (seglen != NULL) {
-							*seglen = 0;
-							*segbevcount = 0;
-							for (j = 0; j < resolu; j++) {
-								bevp0 = bevp;
-								bevp++;
-								bevp->offset = len_v3v3(bevp0->vec, bevp->vec);
-								/* match seglen and segbevcount to the cleaned up bevel lists (see STEP 2) */
-								if (bevp->offset > treshold) {
-									*seglen += bevp->offset;
-									*segbevcount += 1;
-								}
-							}
-							seglen++;
-							segbevcount++;
-						}
-						else {
-							bevp += resolu;
-						}
-						bl->nr += resolu;
-					}
-					prevbezt = bezt;
-					bezt++;
-				}
+typedef struct BevelListCacheKey {
+	unsigned int hash;
+	unsigned int data_len;
+	/* BevelListCacheKeyInfo followed by the control point values and knots */
+	const char *data;
+} BevelListCacheKey;
+
+typedef struct BevelListCacheKeyInfo {
+	short type, flag, flagu, orderu, resolu;
+	short tilt_interp, radius_interp;
+	short do_tilt, do_radius, need_seglen, has_knots, is_resolu_adaptive;
+	float resolu_tolerance;
+	/* orientation settings */
+	short is_3d, twist_mode, twist_resolu;
+	float twist_smooth;
+	int pntsu, pntsv, charidx;
+} BevelListCacheKeyInfo;
+
+/* Only the control point values the poly depends on,
+ * selection and hide flags change without changing the curve. */
+typedef struct BevelListCacheKeyBezt {
+	float vec[3][3];
+	float tilt, weight, radius;
+	char h1, h2, pad[2];
+} BevelListCacheKeyBezt;
+
+typedef struct BevelListCacheKeyBPoint {
+	float vec[4];
+	float tilt, weight, radius;
+} BevelListCacheKeyBPoint;
+
+typedef struct BevelListCacheEntry {
+	/* with double points removed, before holes and orientation (which depend on other splines) */
+	BevList *bl;
+	/* the points after orientation, when it was reversed as a hole or not */
+	BevPoint *bevpoints_final;
+	bool final_is_reversed;
+} BevelListCacheEntry;
+
+static BevelListCacheKey *bevel_list_cache_key_create(
+        const Curve *cu, const Nurb *nu, const bool need_seglen, const int twist_resolu)
+{
+	BevelListCacheKey *key;
+	BevelListCacheKeyInfo info;
+	size_t points_len, knots_len = 0;
+	char *data;
+	int a;
 
-				if ((nu->flagu & CU_NURB_CYCLIC) == 0) {      /* not cyclic: endpoint */
-					copy_v3_v3(bevp->vec, prevbezt->vec[1]);
-					bevp->alfa = prevbezt->alfa;
-					bevp->radius = prevbezt->radius;
-					bevp->weight = prevbezt->weight;
+	memset(&info, 0, sizeof(info));
+	info.type = nu->type;
+	info.flag = nu->flag;
+	info.flagu = nu->flagu;
+	info.orderu = nu->orderu;
+	info.resolu = nu->resolu;
+	info.tilt_interp = nu->tilt_interp;
+	info.radius_interp = nu->radius_interp;
+	info.do_tilt = CU_DO_TILT(cu, nu);
+	info.do_radius = CU_DO_RADIUS(cu, nu);
+	info.need_seglen = need_seglen;
+	info.has_knots = (nu->type == CU_NURBS && nu->knotsu != NULL);
+	info.is_resolu_adaptive = (cu->flag & CU_RESOLU_ADAPTIVE) != 0;
+	info.resolu_tolerance = info.is_resolu_adaptive ? cu->resolu_tolerance : 0.0f;
+	info.is_3d = (cu->flag & CU_3D) != 0;
+	info.twist_mode = cu->twist_mode;
+	info.twist_resolu = (short)twist_resolu;
+	info.twist_smooth = cu->twist_smooth;
+	info.pntsu = nu->pntsu;
+	info.pntsv = nu->pntsv;
+	info.charidx = nu->charidx;
 
-					sub_v3_v3v3(bevp->dir, prevbezt->vec[1], prevbezt->vec[0]);
-					normalize_v3(bevp->dir);
+	if (nu->type == CU_BEZIER) {
+		points_len = nu->bezt ? sizeof(BevelListCacheKeyBezt) * (size_t)nu->pntsu : 0;
+	}
+	else {
+		points_len = nu->bp ? sizeof(BevelListCacheKeyBPoint) * (size_t)nu->pntsu * (size_t)nu->pntsv : 0;
+	}
+	if (info.has_knots) {
+		knots_len = sizeof(float) * (size_t)KNOTSU(nu);
+	}
 
-					bl->nr++;
-				}
+	key = MEM_mallocN(sizeof(*key) + sizeof(info) + points_len + knots_len, __func__);
+	data = (char *)(key + 1);
+	memcpy(data, &info, sizeof(info));
+	if (points_len) {
+		if (nu->type == CU_BEZIER) {
+			const BezTriple *bezt = nu->bezt;
+			BevelListCacheKeyBezt *key_bezt = (BevelListCacheKeyBezt *)(data + sizeof(info));
+			for (a = 0; a < nu->pntsu; a++, bezt++, key_bezt++) {
+				memcpy(key_bezt->vec, bezt->vec, sizeof(key_bezt->vec));
+				key_bezt->tilt = bezt->alfa;
+				key_bezt->weight = bezt->weight;
+				key_bezt->radius = bezt->radius;
+				key_bezt->h1 = bezt->h1;
+				key_bezt->h2 = bezt->h2;
+				key_bezt->pad[0] = key_bezt->pad[1] = 0;
 			}
-			else if (nu->type == CU_NURBS) {
-				if (nu->pntsv == 1) {
-					len = (resolu * segcount);
-
-					bl = MEM_callocN(sizeof(BevList), "makeBevelList3");
-					bl->bevpoints = MEM_calloc_arrayN(len, sizeof(BevPoint), "makeBevelPoints3");
-					if (need_seglen && (nu->flagu & CU_NURB_CYCLIC) == 0) {
-						bl->seglen = MEM_malloc_arrayN(segcount, sizeof(float), "makeBevelList3_seglen");
-						bl->segbevcount = MEM_malloc_arrayN(segcount, sizeof(int), "makeBevelList3_segbevcount");
-					}
-					BLI_addtail(bev, bl);
-					bl->nr = len;
-					bl->dupe_nr = 0;
-					bl->poly = (nu->flagu & CU_NURB_CYCLIC) ? 0 : -1;
-					bl->charidx = nu->charidx;
-
-					bevp = bl->bevpoints;
-					seglen = bl->seglen;
-					segbevcount = bl->segbevcount;
-
-					BKE_nurb_makeCurve(nu, &bevp->vec[0],
-					                   do_tilt      ? &bevp->alfa : NULL,
-					                   do_radius    ? &bevp->radius : NULL,
-					                   do_weight    ? &bevp->weight : NULL,
-					                   resolu, sizeof(BevPoint));
-
-					/* match seglen and segbevcount to the cleaned up bevel lists (see STEP 2) */
-					if (seglen != NULL) {
-						nr = segcount;
-						bevp0 = bevp;
-						bevp++;
-						while (nr) {
-							int j;
-							*seglen = 0;
-							*segbevcount = 0;
-							/* We keep last bevel segment zero-length. */
-							for (j = 0; j < ((nr == 1) ? (resolu - 1) : resolu); j++) {
-								bevp->offset = len_v3v3(bevp0->vec, bevp->vec);
-								if (bevp->offset > treshold) {
-									*seglen += bevp->offset;
-									*segbevcount += 1;
-								}
-								bevp0 = bevp;
-								bevp++;
-							}
-							seglen++;
-							segbevcount++;
-							nr--;
-						}
-					}
-
-					if ((nu->flagu & CU_NURB_CYCLIC) == 0) {
-						bevlist_firstlast_direction_calc_from_bpoint(nu, bl);
-					}
-				}
+		}
+		else {
+			const BPoint *bp = nu->bp;
+			BevelListCacheKeyBPoint *key_bp = (BevelListCacheKeyBPoint *)(data + sizeof(info));
+			for (a = 0; a < nu->pntsu * nu->pntsv; a++, bp++, key_bp++) {
+				copy_v4_v4(key_bp->vec, bp->vec);
+				key_bp->tilt = bp->alfa;
+				key_bp->weight = bp->weight;
+				key_bp->radius = bp->radius;
 			}
 		}
 	}
+	if (knots_len) {
+		memcpy(data + sizeof(info) + points_len, nu->knotsu, knots_len);
+	}
+
+	key->data = data;
+	key->data_len = (unsigned int)(sizeof(info) + points_len + knots_len);
+	key->hash = BLI_hash_mm2((const unsigned char *)data, key->data_len, 0);
+
+	return key;
+}
+
+static unsigned int bevel_list_cache_key_hash(const void *ptr)
+{
+	const BevelListCacheKey *key = ptr;
+	return key->hash;
+}
+
+static bool bevel_list_cache_key_cmp(const void *a, const void *b)
+{
+	const BevelListCacheKey *key_a = a;
+	const BevelListCacheKey *key_b = b;
+	return ((key_a->hash != key_b->hash) ||
+	        (key_a->data_len != key_b->data_len) ||
+	        (memcmp(key_a->data, key_b->data, key_a->data_len) != 0));
+}
+
+static void bevel_list_cache_entry_free(void *ptr)
+{
+	BevelListCacheEntry *entry = ptr;
+	bevel_list_free(entry->bl);
+	if (entry->bevpoints_final) {
+		MEM_freeN(entry->bevpoints_final);
+	}
+	MEM_freeN(entry);
+}
+
+void BKE_curve_bevelList_cache_free(struct BevelListCache *cache)
+{
+	BLI_ghash_free(cache->entries, MEM_freeN, bevel_list_cache_entry_free);
+	MEM_freeN(cache);
+}
+
+struct BevelListMakeItem {
+	Nurb *nu;
+	BevList *bl;
+	BevelListCacheKey *key;
+	BevelListCacheEntry *entry;
+	/* the entry was found in the cache */
+	bool is_cached;
+	/* the first item with this entry, which keeps it up to date */
+	bool is_entry_owner;
+	/* the points were reversed to make the poly turn the right way */
+	bool is_reversed;
+	/* the oriented points are copied from the entry */
+	bool use_final;
+};
+
+typedef struct BevelListMakeData {
+	const Curve *cu;
+	const struct BevelListCache *cache;
+	struct BevelListMakeItem *items;
+	bool need_seglen;
+	/* for twist smoothing, the resolution of the last spline */
+	int resolu;
+} BevelListMakeData;
+
+static void bevel_list_make_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const BevelListMakeData *data = userdata;
+	struct BevelListMakeItem *item = &data->items[i];
+
+	item->key = bevel_list_cache_key_create(data->cu, item->nu, data->need_seglen, data->resolu);
+
+	if (data->cache != NULL) {
+		BevelListCacheEntry *entry = BLI_ghash_lookup(data->cache->entries, item->key);
+		if (entry != NULL) {
+			item->bl = bevel_list_duplicate(entry->bl);
+			item->entry = entry;
+			item->is_cached = true;
+			return;
+		}
+	}
+
+	/* STEP 1: MAKE POLYS  */
+	item->bl = bevel_list_from_nurb(data->cu, item->nu, data->need_seglen);
 
 	/* STEP 2: DOUBLE POINTS AND AUTOMATIC RESOLUTION, REDUCE DATABLOCKS */
-	bl = bev->first;
-	while (bl) {
-		if (bl->nr) { /* null bevel items come from single points */
-			bool is_cyclic = bl->poly != -1;
-			nr = bl->nr;
-			if (is_cyclic) {
-				bevp1 = bl->bevpoints;
-				bevp0 = bevp1 + (nr - 1);
+	if (item->bl != NULL) {
+		bevel_list_remove_doubles(item->bl);
+	}
+}
+
+/**
+ * Replace the cache by the entries of the splines of this update.
+ */
+static void bevel_list_cache_update(
+        struct BevelListCache **cache_p, struct BevelListMakeItem *items, const int items_len)
+{
+	struct BevelListCache *cache_old = *cache_p;
+	struct BevelListCache *cache = MEM_mallocN(sizeof(*cache), __func__);
+	int i;
+
+	cache->entries = BLI_ghash_new_ex(
+	        bevel_list_cache_key_hash, bevel_list_cache_key_cmp, __func__, (unsigned int)items_len);
+
+	for (i = 0; i < items_len; i++) {
+		struct BevelListMakeItem *item = &items[i];
+		void **val_p;
+
+		if (item->bl == NULL) {
+			/* a surface */
+			MEM_freeN(item->key);
+		}
+		else if (BLI_ghash_ensure_p(cache->entries, item->key, &val_p)) {
+			/* a spline identical to one before it */
+			MEM_freeN(item->key);
+			item->entry = *val_p;
+		}
+		else {
+			if (item->is_cached) {
+				/* move it from the old cache */
+				*val_p = BLI_ghash_popkey(cache_old->entries, item->key, MEM_freeN);
 			}
 			else {
-				bevp0 = bl->bevpoints;
-				bevp0->offset = 0;
-				bevp1 = bevp0 + 1;
-			}
-			nr--;
-			while (nr--) {
-				if (seglen != NULL) {
-					if (fabsf(bevp1->offset) < treshold) {
-						bevp0->dupe_tag = true;
-						bl->dupe_nr++;
-					}
-				}
-				else {
-					if (fabsf(bevp0->vec[0] - bevp1->vec[0]) < 0.00001f) {
-						if (fabsf(bevp0->vec[1] - bevp1->vec[1]) < 0.00001f) {
-							if (fabsf(bevp0->vec[2] - bevp1->vec[2]) < 0.00001f) {
-								bevp0->dupe_tag = true;
-								bl->dupe_nr++;
-							}
-						}
-					}
-				}
-				bevp0 = bevp1;
-				bevp1++;
+				BevelListCacheEntry *entry = MEM_callocN(sizeof(*entry), __func__);
+				entry->bl = bevel_list_duplicate(item->bl);
+				*val_p = entry;
 			}
+			item->entry = *val_p;
+			item->is_entry_owner = true;
 		}
-		bl = bl->next;
+		item->key = NULL;
 	}
-	bl = bev->first;
-	while (bl) {
-		blnext = bl->next;
-		if (bl->nr && bl->dupe_nr) {
-			nr = bl->nr - bl->dupe_nr + 1;  /* +1 because vectorbezier sets flag too */
-			blnew = MEM_callocN(sizeof(BevList), "makeBevelList4");
-			memcpy(blnew, bl, sizeof(BevList));
-			blnew->bevpoints = MEM_calloc_arrayN(nr, sizeof(BevPoint), "makeBevelPoints4");
-			if (!blnew->bevpoints) {
-				MEM_freeN(blnew);
-				break;
-			}
-			blnew->segbevcount = bl->segbevcount;
-			blnew->seglen = bl->seglen;
-			blnew->nr = 0;
-			BLI_remlink(bev, bl);
-			BLI_insertlinkbefore(bev, blnext, blnew);    /* to make sure bevlijst is tuned with nurblist */
-			bevp0 = bl->bevpoints;
-			bevp1 = blnew->bevpoints;
-			nr = bl->nr;
-			while (nr--) {
-				if (bevp0->dupe_tag == 0) {
-					memcpy(bevp1, bevp0, sizeof(BevPoint));
-					bevp1++;
-					blnew->nr++;
-				}
-				bevp0++;
-			}
-			if (bl->bevpoints != NULL) {
-				MEM_freeN(bl->bevpoints);
-			}
-			MEM_freeN(bl);
-			blnew->dupe_nr = 0;
+
+	if (cache_old != NULL) {
+		BKE_curve_bevelList_cache_free(cache_old);
+	}
+	*cache_p = cache;
+}
+
+/* STEP 4: 2D-COSINES or 3D ORIENTATION */
+static void bevel_list_orientation_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const BevelListMakeData *data = userdata;
+	const struct BevelListMakeItem *item = &data->items[i];
+	const Curve *cu = data->cu;
+	BevList *bl = item->bl;
+
+	if (bl == NULL) {
+		return;
+	}
+
+	if (item->use_final) {
+		memcpy(bl->bevpoints, item->entry->bevpoints_final, sizeof(BevPoint) * (size_t)bl->nr);
+	}
+	else if (bl->nr < 2) {
+		BevPoint *bevp = bl->bevpoints;
+		unit_qt(bevp->quat);
+	}
+	else if ((cu->flag & CU_3D) == 0) {
+		/* 2D Curves */
+		if (bl->nr == 2) {   /* 2 pnt, treat separate */
+			make_bevel_list_segment_2D(bl);
+		}
+		else {
+			make_bevel_list_2D(bl);
+		}
+	}
+	else {
+		/* 3D Curves */
+		if (bl->nr == 2) {   /* 2 pnt, treat separate */
+			make_bevel_list_segment_3D(bl);
+		}
+		else {
+			make_bevel_list_3D(bl, (int)(data->resolu * cu->twist_smooth), cu->twist_mode);
+		}
+	}
+}
+
+void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
+{
+	/*
+	 * - convert all curves to polys, with indication of resol and flags for double-vertices
+	 * - possibly; do a smart vertice removal (in case Nurb)
+	 * - separate in individual blocks with BoundBox
+	 * - AutoHole detection
+	 */
+
+	/* this function needs an object, because of tflag and upflag */
+	Curve *cu = ob->data;
+	Nurb *nu;
+	BevList *bl;
+	BevPoint *bevp2, *bevp1 = NULL, *bevp0;
+	float min, inp;
+	struct BevelSort *sortdata, *sd, *sd1;
+	int a, b, nr, poly;
+	bool is_editmode = false;
+	ListBase *bev;
+	struct BevelListCache **cache_p;
+	BevelListMakeData data;
+	ParallelRangeSettings settings;
+	int items_len = 0, i;
+
+	/* segbevcount alsp requires seglen. */
+	const bool need_seglen =
+		ELEM(cu->bevfac1_mapping, CU_BEVFAC_MAP_SEGMENT, CU_BEVFAC_MAP_SPLINE) ||
+		ELEM(cu->bevfac2_mapping, CU_BEVFAC_MAP_SEGMENT, CU_BEVFAC_MAP_SPLINE);
+
+
+	bev = BKE_object_curve_bevlist(ob);
+	cache_p = BKE_object_curve_bevlist_cache(ob);
+
+	/* do we need to calculate the radius for each point? */
+	/* do_radius = (cu->bevobj || cu->taperobj || (cu->flag & CU_FRONT) || (cu->flag & CU_BACK)) ? 0 : 1; */
+
+	BKE_curve_bevelList_free(bev);
+	if (cu->editnurb && ob->type != OB_FONT) {
+		is_editmode = 1;
+	}
+
+	for (nu = nurbs->first; nu; nu = nu->next) {
+		if (nu->hide && is_editmode)
+			continue;
+		items_len++;
+	}
+
+	data.cu = cu;
+	data.cache = *cache_p;
+	data.items = MEM_calloc_arrayN(items_len, sizeof(*data.items), __func__);
+	data.need_seglen = need_seglen;
+	data.resolu = 0;
+
+	for (nu = nurbs->first, i = 0; nu; nu = nu->next) {
+		if (nu->hide && is_editmode)
+			continue;
+		if (BKE_nurb_check_valid_u(nu)) {
+			data.resolu = nu->resolu;
+		}
+		data.items[i++].nu = nu;
+	}
+
+	/* STEP 1 and 2, the splines are independent, unchanged ones come from the cache */
+	BLI_parallel_range_settings_defaults(&settings);
+	settings.use_threading = (items_len > 1);
+	BLI_task_parallel_range(0, items_len, &data, bevel_list_make_cb, &settings);
+
+	bevel_list_cache_update(cache_p, data.items, items_len);
+
+	for (i = 0; i < items_len; i++) {
+		if (data.items[i].bl != NULL) {
+			BLI_addtail(bev, data.items[i].bl);
 		}
-		bl = blnext;
 	}
 
 	/* STEP 3: POLYS COUNT AND AUTOHOLE */
@@ -3015,12 +3478,13 @@ void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
 	/* find extreme left points, also test (turning) direction */
 	if (poly > 0) {
 		sd = sortdata = MEM_malloc_arrayN(poly, sizeof(struct BevelSort), "makeBevelList5");
-		bl = bev->first;
-		while (bl) {
-			if (bl->poly > 0) {
+		for (i = 0; i < items_len; i++) {
+			bl = data.items[i].bl;
+			if (bl && bl->poly > 0) {
 				BevPoint *bevp;
 
 				min = 300000.0;
+				INIT_MINMAX2(sd->min, sd->max);
 				bevp = bl->bevpoints;
 				nr = bl->nr;
 				while (nr--) {
@@ -3028,6 +3492,7 @@ void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
 						min = bevp->vec[0];
 						bevp1 = bevp;
 					}
+					minmax_v2v2_v2(sd->min, sd->max, bevp->vec);
 					bevp++;
 				}
 				sd->bl = bl;
@@ -3052,10 +3517,9 @@ void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
 				else
 					sd->dir = 0;
 
+				sd->item = &data.items[i];
 				sd++;
 			}
-
-			bl = bl->next;
 		}
 		qsort(sortdata, poly, sizeof(struct BevelSort), vergxcobev);
 
@@ -3065,7 +3529,7 @@ void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
 			sd1 = sortdata + (a - 1);
 			for (b = a - 1; b >= 0; b--, sd1--) { /* all polys to the left */
 				if (sd1->bl->charidx == bl->charidx) { /* for text, only check matching char */
-					if (bevelinside(sd1->bl, bl)) {
+					if (bevel_sort_bounds_contain(sd1, bl->bevpoints[0].vec) && bevelinside(sd1->bl, bl)) {
 						bl->hole = 1 - sd1->bl->hole;
 						break;
 					}
@@ -3087,6 +3551,7 @@ void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
 						bevp1++;
 						bevp2--;
 					}
+					sd->item->is_reversed = true;
 				}
 			}
 		}
@@ -3094,38 +3559,31 @@ void BKE_curve_bevelList_make(Object *ob, ListBase *nurbs)
 	}
 
 	/* STEP 4: 2D-COSINES or 3D ORIENTATION */
-	if ((cu->flag & CU_3D) == 0) {
-		/* 2D Curves */
-		for (bl = bev->first; bl; bl = bl->next) {
-			if (bl->nr < 2) {
-				BevPoint *bevp = bl->bevpoints;
-				unit_qt(bevp->quat);
-			}
-			else if (bl->nr == 2) {   /* 2 pnt, treat separate */
-				make_bevel_list_segment_2D(bl);
-			}
-			else {
-				make_bevel_list_2D(bl);
-			}
-		}
+	for (i = 0; i < items_len; i++) {
+		struct BevelListMakeItem *item = &data.items[i];
+		item->use_final = (item->entry && item->entry->bevpoints_final &&
+		                   item->entry->final_is_reversed == item->is_reversed);
 	}
-	else {
-		/* 3D Curves */
-		for (bl = bev->first; bl; bl = bl->next) {
-			if (bl->nr < 2) {
-				BevPoint *bevp = bl->bevpoints;
-				unit_qt(bevp->quat);
-			}
-			else if (bl->nr == 2) {   /* 2 pnt, treat separate */
-				make_bevel_list_segment_3D(bl);
-			}
-			else {
-				make_bevel_list_3D(bl, (int)(resolu * cu->twist_smooth), cu->twist_mode);
+
+	BLI_task_parallel_range(0, items_len, &data, bevel_list_orientation_cb, &settings);
+
+	for (i = 0; i < items_len; i++) {
+		struct BevelListMakeItem *item = &data.items[i];
+		if (item->is_entry_owner && !item->use_final) {
+			BevelListCacheEntry *entry = item->entry;
+			if (entry->bevpoints_final) {
+				MEM_freeN(entry->bevpoints_final);
 			}
+			entry->bevpoints_final = MEM_dupallocN(item->bl->bevpoints);
+			entry->final_is_reversed = item->is_reversed;
 		}
 	}
+
+	MEM_freeN(data.items);
 }
 
+
+
 /* ****************** HANDLES ************** */
 
 static void calchandleNurb_intern(
@@ -37,6 +37,7 @@
 #include "BLI_math.h"
 #include "BLI_math_color_blend.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -2536,12 +2537,245 @@ void CustomData_bmesh_init_pool(CustomData *data, int totelem, const char htype)
 			break;
 	}
 
-	/* If there are no layers, no pool is needed just yet */
+	/* If there are no layers, no pool is needed just yet.
+	 * Blocks are never iterated over, allow threads to allocate from the pool (see #BLI_mempool_local). */
 	if (data->totlayer) {
-		data->pool = BLI_mempool_create(data->totsize, totelem, chunksize, BLI_MEMPOOL_NOP);
+		data->pool = BLI_mempool_create(data->totsize, totelem, chunksize, BLI_MEMPOOL_ALLOW_THREADS);
 	}
 }
 
+/* -------------------------------------------------------------------- */
+/** \name BMesh Structure of Arrays
+ *
+ * Layers are normally stored interleaved in each element's block,
+ * so looping over a single layer of all elements touches every block.
+ *
+ * While in "SoA" mode, a layer is also stored as a contiguous array in #CustomDataLayer.data,
+ * indexed by element index (as for mesh layers), so #CustomData_get_layer & friends can be used.
+ * The array is the data to read & write from until #CustomData_bmesh_soa_end,
+ * blocks aren't updated until then.
+ *
+ * The arrays of all layers are filled in one (threaded) pass over the blocks,
+ * #CustomData_bmesh_soa_to_layers then copies each of them at once, as done when
+ * converting a BMesh to a DerivedMesh.
+ *
+ * \note Only layers without copy/free callbacks (plain data) are supported.
+ * \note Element tables and indices must not change while in SoA mode
+ * (don't add or remove elements or layers).
+ * \{ */
+
+typedef struct CustomDataSoAThreadedData {
+	CustomData *data;
+	BMElem **table;
+	char htype;
+	bool is_write_back;
+} CustomDataSoAThreadedData;
+
+static bool customdata_bmesh_soa_layer_supports(const CustomDataLayer *layer)
+{
+	const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+	return (typeInfo->copy == NULL) && (typeInfo->free == NULL);
+}
+
+static void customdata_bmesh_soa_copy_elem(
+        CustomData *data, void *block, const int index, const bool is_write_back)
+{
+	int i;
+
+	for (i = 0; i < data->totlayer; i++) {
+		CustomDataLayer *layer = &data->layers[i];
+		if (layer->flag & CD_FLAG_SOA) {
+			const size_t size = (size_t)layerType_getInfo(layer->type)->size;
+			void *elem = POINTER_OFFSET(layer->data, size * (size_t)index);
+			if (is_write_back) {
+				memcpy(POINTER_OFFSET(block, layer->offset), elem, size);
+			}
+			else {
+				memcpy(elem, POINTER_OFFSET(block, layer->offset), size);
+			}
+		}
+	}
+}
+
+static void customdata_bmesh_soa_copy_cb(
+        void *__restrict userdata,
+        const int index,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	CustomDataSoAThreadedData *soa_data = userdata;
+	BMElem *ele = soa_data->table[index];
+
+	if (soa_data->htype == BM_LOOP) {
+		/* loops have no table, they're reached through the face table */
+		BMLoop *l_iter, *l_first;
+		l_iter = l_first = BM_FACE_FIRST_LOOP((BMFace *)ele);
+		do {
+			customdata_bmesh_soa_copy_elem(
+			        soa_data->data, l_iter->head.data, BM_elem_index_get(l_iter), soa_data->is_write_back);
+		} while ((l_iter = l_iter->next) != l_first);
+	}
+	else {
+		customdata_bmesh_soa_copy_elem(soa_data->data, ele->head.data, index, soa_data->is_write_back);
+	}
+}
+
+static void customdata_bmesh_soa_copy(BMesh *bm, CustomData *data, const char htype, const bool is_write_back)
+{
+	CustomDataSoAThreadedData soa_data = {.data = data, .htype = htype, .is_write_back = is_write_back};
+	ParallelRangeSettings settings;
+	int totelem;
+
+	switch (htype) {
+		case BM_VERT: soa_data.table = (BMElem **)bm->vtable; totelem = bm->totvert; break;
+		case BM_EDGE: soa_data.table = (BMElem **)bm->etable; totelem = bm->totedge; break;
+		case BM_LOOP: /* fall-through */
+		case BM_FACE: soa_data.table = (BMElem **)bm->ftable; totelem = bm->totface; break;
+		default:
+			BLI_assert(0);
+			return;
+	}
+
+	BLI_parallel_range_settings_defaults(&settings);
+	settings.use_threading = (totelem >= BM_OMP_LIMIT);
+	BLI_task_parallel_range(0, totelem, &soa_data, customdata_bmesh_soa_copy_cb, &settings);
+}
+
+/**
+ * Store the layers in \a mask as contiguous arrays (see #CD_FLAG_SOA).
+ *
+ * \param htype: The element type \a data is used for.
+ * \return true when any layer is stored as an array.
+ */
+bool CustomData_bmesh_soa_begin(BMesh *bm, CustomData *data, const char htype, const CustomDataMask mask)
+{
+	const bool is_enabled = CustomData_bmesh_soa_is_enabled(data);
+	const char htype_table = (htype == BM_LOOP) ? BM_FACE : htype;
+	int totelem;
+	bool changed = false;
+	int i;
+
+	switch (htype) {
+		case BM_VERT: totelem = bm->totvert; break;
+		case BM_EDGE: totelem = bm->totedge; break;
+		case BM_LOOP: totelem = bm->totloop; break;
+		case BM_FACE: totelem = bm->totface; break;
+		default:
+			BLI_assert(0);
+			return false;
+	}
+
+	for (i = 0; i < data->totlayer; i++) {
+		const CustomDataLayer *layer = &data->layers[i];
+		if ((mask & CD_TYPE_AS_MASK(layer->type)) &&
+		    !(layer->flag & CD_FLAG_SOA) &&
+		    customdata_bmesh_soa_layer_supports(layer))
+		{
+			changed = true;
+			break;
+		}
+	}
+
+	if (!changed) {
+		return is_enabled;
+	}
+
+	BM_mesh_elem_index_ensure(bm, htype | htype_table);
+	BM_mesh_elem_table_ensure(bm, htype_table);
+
+	/* all arrays are filled from the blocks, don't lose changes made to existing ones. */
+	if (is_enabled) {
+		customdata_bmesh_soa_copy(bm, data, htype, true);
+	}
+
+	for (i = 0; i < data->totlayer; i++) {
+		CustomDataLayer *layer = &data->layers[i];
+		if ((mask & CD_TYPE_AS_MASK(layer->type)) &&
+		    !(layer->flag & CD_FLAG_SOA) &&
+		    customdata_bmesh_soa_layer_supports(layer))
+		{
+			BLI_assert(layer->data == NULL);
+			layer->data = MEM_mallocN((size_t)layerType_getInfo(layer->type)->size * (size_t)MAX2(totelem, 1), __func__);
+			layer->flag |= CD_FLAG_SOA;
+		}
+	}
+
+	customdata_bmesh_soa_copy(bm, data, htype, false);
+
+	return true;
+}
+
+/**
+ * Copy the arrays of all layers in SoA mode back into the blocks and free them.
+ *
+ * \param use_write_back: When false, changes to the arrays are discarded.
+ */
+void CustomData_bmesh_soa_end(BMesh *bm, CustomData *data, const char htype, const bool use_write_back)
+{
+	int i;
+
+	if (!CustomData_bmesh_soa_is_enabled(data)) {
+		return;
+	}
+
+	if (use_write_back) {
+		/* indices & tables must still be valid */
+		BLI_assert((bm->elem_index_dirty & htype) == 0);
+		BLI_assert((bm->elem_table_dirty & ((htype == BM_LOOP) ? BM_FACE : htype)) == 0);
+		customdata_bmesh_soa_copy(bm, data, htype, true);
+	}
+
+	for (i = 0; i < data->totlayer; i++) {
+		CustomDataLayer *layer = &data->layers[i];
+		if (layer->flag & CD_FLAG_SOA) {
+			MEM_freeN(layer->data);
+			layer->data = NULL;
+			layer->flag &= ~CD_FLAG_SOA;
+		}
+	}
+}
+
+bool CustomData_bmesh_soa_is_enabled(const CustomData *data)
+{
+	int i;
+	for (i = 0; i < data->totlayer; i++) {
+		if (data->layers[i].flag & CD_FLAG_SOA) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Copy the arrays of the layers of \a source in SoA mode to the matching layers of \a dest
+ * (mesh or DerivedMesh data), these are skipped by #CustomData_from_bmesh_block.
+ */
+void CustomData_bmesh_soa_to_layers(const CustomData *source, CustomData *dest, int totelem)
+{
+	int dest_i, src_i;
+
+	/* layers are matched as in CustomData_from_bmesh_block */
+	dest_i = 0;
+	for (src_i = 0; src_i < source->totlayer; ++src_i) {
+		const CustomDataLayer *layer = &source->layers[src_i];
+
+		while (dest_i < dest->totlayer && dest->layers[dest_i].type < layer->type) {
+			dest_i++;
+		}
+
+		if (dest_i >= dest->totlayer) return;
+
+		if (dest->layers[dest_i].type == layer->type) {
+			if (layer->flag & CD_FLAG_SOA) {
+				memcpy(dest->layers[dest_i].data, layer->data,
+				       (size_t)layerType_getInfo(layer->type)->size * (size_t)totelem);
+			}
+			dest_i++;
+		}
+	}
+}
+
+/** \} */
+
 bool CustomData_bmesh_merge(
         const CustomData *source, CustomData *dest,
         CustomDataMask mask, int alloctype, BMesh *bm, const char htype)
@@ -2553,6 +2787,9 @@ bool CustomData_bmesh_merge(
 	int iter_type;
 	int totelem;
 
+	/* layout changes aren't supported in SoA mode */
+	BLI_assert(!CustomData_bmesh_soa_is_enabled(dest));
+
 	if (CustomData_number_of_layers_typemask(source, mask) == 0) {
 		return false;
 	}
@@ -3123,6 +3360,13 @@ void CustomData_from_bmesh_block(const CustomData *source, CustomData *dest,
 		if (dest->layers[dest_i].type == source->layers[src_i].type) {
 			const LayerTypeInfo *typeInfo = layerType_getInfo(dest->layers[dest_i].type);
 			int offset = source->layers[src_i].offset;
+
+			/* copied at once by CustomData_bmesh_soa_to_layers */
+			if (source->layers[src_i].flag & CD_FLAG_SOA) {
+				dest_i++;
+				continue;
+			}
+
 			const void *src_data = POINTER_OFFSET(src_block, offset);
 			void *dst_data = POINTER_OFFSET(dest->layers[dest_i].data, (size_t)dst_index * typeInfo->size);
 
@@ -37,6 +37,7 @@
 #include "BLI_memarena.h"
 #include "BLI_math.h"
 #include "BLI_scanfill.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_global.h"
@@ -321,7 +322,7 @@ static void curve_to_displist(Curve *cu, ListBase *nubase, ListBase *dispbase)
 					if (prevbezt->h2 == HD_VECT && bezt->h1 == HD_VECT)
 						len++;
 					else
-						len += resolu;
+						len += BKE_curve_bezier_segment_resolu(cu, prevbezt, bezt, resolu);
 
 					if (a == 0 && (nu->flagu & CU_NURB_CYCLIC) == 0)
 						len++;
@@ -363,16 +364,14 @@ static void curve_to_displist(Curve *cu, ListBase *nubase, ListBase *dispbase)
 						data += 3;
 					}
 					else {
-						int j;
-						for (j = 0; j < 3; j++) {
-							BKE_curve_forward_diff_bezier(prevbezt->vec[1][j],
-							                              prevbezt->vec[2][j],
-							                              bezt->vec[0][j],
-							                              bezt->vec[1][j],
-							                              data + j, resolu, 3 * sizeof(float));
-						}
-
-						data += 3 * resolu;
+						const int resolu_seg = BKE_curve_bezier_segment_resolu(cu, prevbezt, bezt, resolu);
+						BKE_curve_forward_diff_bezier_v3(prevbezt->vec[1],
+						                                 prevbezt->vec[2],
+						                                 bezt->vec[0],
+						                                 bezt->vec[1],
+						                                 data, resolu_seg, 3 * sizeof(float));
+
+						data += 3 * resolu_seg;
 					}
 
 					if (a == 0 && dl->type == DL_SEGM) {
@@ -432,142 +431,215 @@ static void curve_to_displist(Curve *cu, ListBase *nubase, ListBase *dispbase)
 	}
 }
 
-/**
- * \param normal_proj: Optional normal thats used to project the scanfill verts into 2d coords.
- * Pass this along if known since it saves time calculating the normal.
- * \param flipnormal: Flip the normal (same as passing \a normal_proj negated)
- */
-void BKE_displist_fill(ListBase *dispbase, ListBase *to, const float normal_proj[3], const bool flipnormal)
+/* A poly to fill, polys are filled per character and material (a group) */
+typedef struct DispListFillPoly {
+	DispList *dl;
+	/* order in the display list, to keep it within groups */
+	int index;
+} DispListFillPoly;
+
+typedef struct DispListFillData {
+	/* sorted by character and material */
+	const DispListFillPoly *polys;
+	/* the first poly of each group, with the end of the last group after them */
+	const int *group_start;
+	DispList **group_fill;
+	const float *normal_proj;
+	int flag;
+	bool flipnormal;
+} DispListFillData;
+
+static int displist_fill_poly_cmp(const void *a, const void *b)
+{
+	const DispListFillPoly *poly_a = a;
+	const DispListFillPoly *poly_b = b;
+
+	if (poly_a->dl->charidx != poly_b->dl->charidx) {
+		return (poly_a->dl->charidx < poly_b->dl->charidx) ? -1 : 1;
+	}
+	if (poly_a->dl->col != poly_b->dl->col) {
+		return (poly_a->dl->col < poly_b->dl->col) ? -1 : 1;
+	}
+	return (poly_a->index < poly_b->index) ? -1 : (poly_a->index > poly_b->index);
+}
+
+static void displist_fill_group_cb(
+        void *__restrict userdata,
+        const int group,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
 {
+	const DispListFillData *data = userdata;
 	ScanFillContext sf_ctx;
 	ScanFillVert *sf_vert, *sf_vert_new, *sf_vert_last;
 	ScanFillFace *sf_tri;
 	MemArena *sf_arena;
 	DispList *dlnew = NULL, *dl;
 	float *f1;
-	int colnr = 0, charidx = 0, cont = 1, tot, a, *index, nextcol = 0;
-	int totvert;
+	int tot, a, *index, i;
+	int totvert = 0;
 	const int scanfill_flag = BLI_SCANFILL_CALC_REMOVE_DOUBLES | BLI_SCANFILL_CALC_POLYS | BLI_SCANFILL_CALC_HOLES;
 
-	if (dispbase == NULL)
-		return;
-	if (BLI_listbase_is_empty(dispbase))
-		return;
-
 	sf_arena = BLI_memarena_new(BLI_SCANFILL_ARENA_SIZE, __func__);
+	BLI_scanfill_begin_arena(&sf_ctx, sf_arena);
 
-	while (cont) {
-		int dl_flag_accum = 0;
-		cont = 0;
-		totvert = 0;
-		nextcol = 0;
+	for (i = data->group_start[group]; i < data->group_start[group + 1]; i++) {
+		dl = data->polys[i].dl;
 
-		BLI_scanfill_begin_arena(&sf_ctx, sf_arena);
+		sf_ctx.poly_nr++;
 
-		dl = dispbase->first;
-		while (dl) {
-			if (dl->type == DL_POLY) {
-				if (charidx < dl->charidx)
-					cont = 1;
-				else if (charidx == dl->charidx) { /* character with needed index */
-					if (colnr == dl->col) {
+		/* make editverts and edges */
+		f1 = dl->verts;
+		a = dl->nr;
+		sf_vert = sf_vert_new = NULL;
 
-						sf_ctx.poly_nr++;
+		while (a--) {
+			sf_vert_last = sf_vert;
 
-						/* make editverts and edges */
-						f1 = dl->verts;
-						a = dl->nr;
-						sf_vert = sf_vert_new = NULL;
+			sf_vert = BLI_scanfill_vert_add(&sf_ctx, f1);
+			totvert++;
 
-						while (a--) {
-							sf_vert_last = sf_vert;
+			if (sf_vert_last == NULL)
+				sf_vert_new = sf_vert;
+			else {
+				BLI_scanfill_edge_add(&sf_ctx, sf_vert_last, sf_vert);
+			}
+			f1 += 3;
+		}
 
-							sf_vert = BLI_scanfill_vert_add(&sf_ctx, f1);
-							totvert++;
+		if (sf_vert != NULL && sf_vert_new != NULL) {
+			BLI_scanfill_edge_add(&sf_ctx, sf_vert, sf_vert_new);
+		}
+	}
 
-							if (sf_vert_last == NULL)
-								sf_vert_new = sf_vert;
-							else {
-								BLI_scanfill_edge_add(&sf_ctx, sf_vert_last, sf_vert);
-							}
-							f1 += 3;
-						}
+	/* XXX (obedit && obedit->actcol) ? (obedit->actcol - 1) : 0)) { */
+	if (totvert && (tot = BLI_scanfill_calc_ex(&sf_ctx,
+	                                           scanfill_flag,
+	                                           data->normal_proj)))
+	{
+		dlnew = MEM_callocN(sizeof(DispList), "filldisplist");
+		dlnew->type = DL_INDEX3;
+		dlnew->flag = data->flag;
+		dlnew->col = data->polys[data->group_start[group]].dl->col;
+		dlnew->nr = totvert;
+		dlnew->parts = tot;
+
+		dlnew->index = MEM_mallocN(tot * 3 * sizeof(int), "dlindex");
+		dlnew->verts = MEM_mallocN(totvert * 3 * sizeof(float), "dlverts");
+
+		/* vert data */
+		f1 = dlnew->verts;
+		totvert = 0;
 
-						if (sf_vert != NULL && sf_vert_new != NULL) {
-							BLI_scanfill_edge_add(&sf_ctx, sf_vert, sf_vert_new);
-						}
-					}
-					else if (colnr < dl->col) {
-						/* got poly with next material at current char */
-						cont = 1;
-						nextcol = 1;
-					}
-				}
-				dl_flag_accum |= dl->flag;
-			}
-			dl = dl->next;
+		for (sf_vert = sf_ctx.fillvertbase.first; sf_vert; sf_vert = sf_vert->next) {
+			copy_v3_v3(f1, sf_vert->co);
+			f1 += 3;
+
+			/* index number */
+			sf_vert->tmp.i = totvert;
+			totvert++;
 		}
 
-		/* XXX (obedit && obedit->actcol) ? (obedit->actcol - 1) : 0)) { */
-		if (totvert && (tot = BLI_scanfill_calc_ex(&sf_ctx,
-		                                           scanfill_flag,
-		                                           normal_proj)))
-		{
-			if (tot) {
-				dlnew = MEM_callocN(sizeof(DispList), "filldisplist");
-				dlnew->type = DL_INDEX3;
-				dlnew->flag = (dl_flag_accum & (DL_BACK_CURVE | DL_FRONT_CURVE));
-				dlnew->col = colnr;
-				dlnew->nr = totvert;
-				dlnew->parts = tot;
-
-				dlnew->index = MEM_mallocN(tot * 3 * sizeof(int), "dlindex");
-				dlnew->verts = MEM_mallocN(totvert * 3 * sizeof(float), "dlverts");
-
-				/* vert data */
-				f1 = dlnew->verts;
-				totvert = 0;
-
-				for (sf_vert = sf_ctx.fillvertbase.first; sf_vert; sf_vert = sf_vert->next) {
-					copy_v3_v3(f1, sf_vert->co);
-					f1 += 3;
-
-					/* index number */
-					sf_vert->tmp.i = totvert;
-					totvert++;
-				}
+		/* index data */
 
-				/* index data */
+		index = dlnew->index;
+		for (sf_tri = sf_ctx.fillfacebase.first; sf_tri; sf_tri = sf_tri->next) {
+			index[0] = sf_tri->v1->tmp.i;
+			index[1] = sf_tri->v2->tmp.i;
+			index[2] = sf_tri->v3->tmp.i;
 
-				index = dlnew->index;
-				for (sf_tri = sf_ctx.fillfacebase.first; sf_tri; sf_tri = sf_tri->next) {
-					index[0] = sf_tri->v1->tmp.i;
-					index[1] = sf_tri->v2->tmp.i;
-					index[2] = sf_tri->v3->tmp.i;
+			if (data->flipnormal)
+				SWAP(int, index[0], index[2]);
 
-					if (flipnormal)
-						SWAP(int, index[0], index[2]);
+			index += 3;
+		}
+	}
 
-					index += 3;
-				}
-			}
+	data->group_fill[group] = dlnew;
+
+	BLI_scanfill_end_arena(&sf_ctx, sf_arena);
+	BLI_memarena_free(sf_arena);
+}
+
+/**
+ * Fill the polys of \a dispbase, for each character and material separately
+ * (in parallel, text has many characters), adding the fills to the start of \a to.
+ *
+ * \param normal_proj: Optional normal thats used to project the scanfill verts into 2d coords.
+ * Pass this along if known since it saves time calculating the normal.
+ * \param flipnormal: Flip the normal (same as passing \a normal_proj negated)
+ */
+void BKE_displist_fill(ListBase *dispbase, ListBase *to, const float normal_proj[3], const bool flipnormal)
+{
+	DispListFillData data;
+	DispListFillPoly *polys;
+	DispList *dl;
+	int *group_start;
+	int polys_len = 0, groups_len = 0, dl_flag_accum = 0, i;
+
+	if (dispbase == NULL)
+		return;
+	if (BLI_listbase_is_empty(dispbase))
+		return;
 
-			BLI_addhead(to, dlnew);
+	for (dl = dispbase->first; dl; dl = dl->next) {
+		if (dl->type == DL_POLY) {
+			polys_len++;
 		}
-		BLI_scanfill_end_arena(&sf_ctx, sf_arena);
+	}
+	if (polys_len == 0) {
+		return;
+	}
 
-		if (nextcol) {
-			/* stay at current char but fill polys with next material */
-			colnr++;
+	polys = MEM_malloc_arrayN(polys_len, sizeof(*polys), __func__);
+	polys_len = 0;
+	for (dl = dispbase->first, i = 0; dl; dl = dl->next, i++) {
+		if (dl->type == DL_POLY) {
+			/* polys with negative indices are never filled */
+			if (dl->charidx >= 0 && dl->col >= 0) {
+				polys[polys_len].dl = dl;
+				polys[polys_len].index = i;
+				polys_len++;
+			}
+			dl_flag_accum |= dl->flag;
 		}
-		else {
-			/* switch to next char and start filling from first material */
-			charidx++;
-			colnr = 0;
+	}
+
+	qsort(polys, polys_len, sizeof(*polys), displist_fill_poly_cmp);
+
+	group_start = MEM_malloc_arrayN(polys_len + 1, sizeof(*group_start), __func__);
+	for (i = 0; i < polys_len; i++) {
+		if (i == 0 ||
+		    polys[i].dl->charidx != polys[i - 1].dl->charidx ||
+		    polys[i].dl->col != polys[i - 1].dl->col)
+		{
+			group_start[groups_len++] = i;
 		}
 	}
+	group_start[groups_len] = polys_len;
 
-	BLI_memarena_free(sf_arena);
+	data.polys = polys;
+	data.group_start = group_start;
+	data.group_fill = MEM_calloc_arrayN(groups_len, sizeof(*data.group_fill), __func__);
+	data.normal_proj = normal_proj;
+	data.flag = (dl_flag_accum & (DL_BACK_CURVE | DL_FRONT_CURVE));
+	data.flipnormal = flipnormal;
+
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (groups_len > 1);
+		BLI_task_parallel_range(0, groups_len, &data, displist_fill_group_cb, &settings);
+	}
+
+	for (i = 0; i < groups_len; i++) {
+		if (data.group_fill[i]) {
+			BLI_addhead(to, data.group_fill[i]);
+		}
+	}
+
+	MEM_freeN(data.group_fill);
+	MEM_freeN(group_start);
+	MEM_freeN(polys);
 
 	/* do not free polys, needed for wireframe display */
 }
@@ -39,6 +39,7 @@
 #include "BLI_string_utf8.h"
 #include "BLI_math.h"
 #include "BLI_threads.h"
+#include "BLI_task.h"
 #include "BLI_vfontdata.h"
 
 #include "DNA_packedFile_types.h"
@@ -354,6 +355,76 @@ static VChar *find_vfont_char(VFontData *vfd, unsigned int character)
 	return BLI_ghash_lookup(vfd->characters, POINTER_FROM_UINT(character));
 }
 
+static int vfont_char_cmp(const void *a, const void *b)
+{
+	const unsigned int char_a = *(const unsigned int *)a;
+	const unsigned int char_b = *(const unsigned int *)b;
+	return (char_a < char_b) ? -1 : (char_a > char_b);
+}
+
+/**
+ * Load the characters of the text that are missing from its fonts, for each font at once.
+ * Loading a character reads the font, doing this for each new character of long texts is slow.
+ */
+static void vfont_load_missing_chars(Curve *cu, const wchar_t *mem, CharInfo *custrinfo, const int slen)
+{
+	VFont *vfonts[4] = {CURVE_VFONT_ANY(cu)};
+	unsigned int *chars = MEM_malloc_arrayN(slen + 1, sizeof(*chars), __func__);
+	int a, i;
+
+	for (a = 0; a < ARRAY_SIZE(vfonts); a++) {
+		VFont *vfont = vfonts[a];
+		VFontData *vfd;
+		int chars_len = 0, chars_missing_len = 0;
+
+		/* skip fonts used twice */
+		for (i = 0; i < a; i++) {
+			if (vfonts[i] == vfont) {
+				vfont = NULL;
+				break;
+			}
+		}
+		if (vfont == NULL || BKE_vfont_is_builtin(vfont)) {
+			continue;
+		}
+
+		for (i = 0; i < slen; i++) {
+			CharInfo *info = &custrinfo[i];
+			wchar_t ascii = mem[i];
+
+			if (ELEM(ascii, '\n', '\0') || which_vfont(cu, info) != vfont) {
+				continue;
+			}
+			if (info->flag & CU_CHINFO_SMALLCAPS) {
+				ascii = towupper(ascii);
+			}
+			chars[chars_len++] = (unsigned int)ascii;
+		}
+
+		if (chars_len == 0 || (vfd = vfont_get_data(vfont)) == NULL) {
+			continue;
+		}
+
+		qsort(chars, chars_len, sizeof(*chars), vfont_char_cmp);
+
+		BLI_rw_mutex_lock(&vfont_rwlock, THREAD_LOCK_READ);
+		for (i = 0; i < chars_len; i++) {
+			if ((i == 0 || chars[i] != chars[i - 1]) && find_vfont_char(vfd, chars[i]) == NULL) {
+				chars[chars_missing_len++] = chars[i];
+			}
+		}
+		BLI_rw_mutex_unlock(&vfont_rwlock);
+
+		if (chars_missing_len != 0) {
+			BLI_rw_mutex_lock(&vfont_rwlock, THREAD_LOCK_WRITE);
+			BLI_vfontchars_from_freetypefont(vfont, chars, chars_missing_len);
+			BLI_rw_mutex_unlock(&vfont_rwlock);
+		}
+	}
+
+	MEM_freeN(chars);
+}
+
 static void build_underline(Curve *cu, ListBase *nubase, const rctf *rect,
                             float yofs, float rot, int charidx, short mat_nr)
 {
@@ -720,6 +791,9 @@ bool BKE_vfont_to_curve_ex(Object *ob, Curve *cu, int mode, ListBase *r_nubase,
 		selboxes = ef->selboxes;
 	}
 
+	/* load the new characters of the text at once, not one at a time in the layout */
+	vfont_load_missing_chars(cu, mem, custrinfo, slen);
+
 	/* calc offset and rotation of each char */
 	ct = chartransdata = MEM_calloc_arrayN((slen + 1), sizeof(struct CharTrans), "buildtext");
 
@@ -1343,6 +1417,206 @@ bool BKE_vfont_to_curve(Object *ob, int mode)
 }
 
 
+/* -------------------------------------------------------------------- */
+
+/** \name VFont Batch
+ *
+ * Many variations of one text (serial numbers, names), laid out in a grid.
+ * \{ */
+
+typedef struct VFontBatchInstance {
+	/* the text object with the text of this instance */
+	Curve cu;
+	ListBase nubase;
+	float min[3], max[3];
+	bool ok;
+} VFontBatchInstance;
+
+typedef struct VFontBatchData {
+	Object *ob;
+	VFontBatchInstance *instances;
+} VFontBatchData;
+
+static void vfont_batch_instance_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const VFontBatchData *data = userdata;
+	VFontBatchInstance *inst = &data->instances[i];
+	Nurb *nu;
+
+	inst->ok = BKE_vfont_to_curve_ex(data->ob, &inst->cu, FO_EDIT, &inst->nubase, NULL, NULL, NULL, NULL);
+
+	INIT_MINMAX(inst->min, inst->max);
+	for (nu = inst->nubase.first; nu; nu = nu->next) {
+		BKE_nurb_minmax(nu, false, inst->min, inst->max);
+	}
+}
+
+static void vfont_batch_nurbs_translate(ListBase *nubase, const float offset[3], const int charidx_offset)
+{
+	Nurb *nu;
+	int a;
+
+	for (nu = nubase->first; nu; nu = nu->next) {
+		if (nu->type == CU_BEZIER) {
+			BezTriple *bezt = nu->bezt;
+			for (a = nu->pntsu; a--; bezt++) {
+				add_v3_v3(bezt->vec[0], offset);
+				add_v3_v3(bezt->vec[1], offset);
+				add_v3_v3(bezt->vec[2], offset);
+			}
+		}
+		else {
+			BPoint *bp = nu->bp;
+			for (a = nu->pntsu * nu->pntsv; a--; bp++) {
+				add_v3_v3(bp->vec, offset);
+			}
+		}
+		nu->charidx += charidx_offset;
+	}
+}
+
+/**
+ * Lay out the text object \a cu with each of \a strings in place of its text (in parallel),
+ * in a grid of \a columns with cells the size of the largest instance plus \a margin.
+ *
+ * All characters use the style of the first character of the text,
+ * the curves are added to \a r_nubase with the characters of all instances numbered in order.
+ *
+ * \return false when the font can't be loaded.
+ */
+bool BKE_vfont_to_curve_batch(
+        Object *ob, Curve *cu, const char **strings, const int strings_len,
+        const int columns, const float margin, ListBase *r_nubase)
+{
+	VFontBatchData data;
+	VFontBatchInstance *instances;
+	CharInfo style;
+	TextBox *tb = NULL;
+	float min[3], max[3], cell[2];
+	int chars_len_all = 0, charidx_offset = 0, i;
+	bool ok = true;
+
+	if (cu->vfont == NULL || vfont_get_data(cu->vfont) == NULL) {
+		return false;
+	}
+
+	if (cu->strinfo && cu->len_wchar > 0) {
+		style = cu->strinfo[0];
+	}
+	else {
+		style = cu->curinfo;
+	}
+
+	/* the layout adds text boxes when there are none, share them between the instances */
+	if (cu->tb == NULL) {
+		tb = MEM_calloc_arrayN(MAXTEXTBOX, sizeof(TextBox), __func__);
+	}
+
+	instances = MEM_calloc_arrayN(strings_len, sizeof(*instances), __func__);
+	for (i = 0; i < strings_len; i++) {
+		VFontBatchInstance *inst = &instances[i];
+		Curve *cu_inst = &inst->cu;
+		int a;
+
+		*cu_inst = *cu;
+		cu_inst->editfont = NULL;
+		cu_inst->textoncurve = NULL;
+		if (tb) {
+			cu_inst->tb = tb;
+		}
+
+		cu_inst->str = (char *)strings[i];
+		cu_inst->len = (int)strlen(strings[i]);
+		cu_inst->len_wchar = (int)BLI_strlen_utf8(strings[i]);
+		cu_inst->strinfo = MEM_malloc_arrayN(cu_inst->len_wchar + 4, sizeof(CharInfo), __func__);
+		for (a = 0; a < cu_inst->len_wchar + 4; a++) {
+			cu_inst->strinfo[a] = style;
+		}
+
+		chars_len_all += cu_inst->len_wchar;
+	}
+
+	/* load the characters of all instances first, so they don't wait for each other to load them */
+	{
+		wchar_t *mem_all = MEM_malloc_arrayN(chars_len_all + 1, sizeof(wchar_t), __func__);
+		CharInfo *custrinfo_all = MEM_malloc_arrayN(chars_len_all + 1, sizeof(CharInfo), __func__);
+		int chars_len = 0;
+
+		for (i = 0; i < strings_len; i++) {
+			BLI_strncpy_wchar_from_utf8(mem_all + chars_len, strings[i], instances[i].cu.len_wchar + 1);
+			chars_len += instances[i].cu.len_wchar;
+		}
+		for (i = 0; i < chars_len_all; i++) {
+			custrinfo_all[i] = style;
+		}
+
+		vfont_load_missing_chars(cu, mem_all, custrinfo_all, chars_len_all);
+
+		MEM_freeN(mem_all);
+		MEM_freeN(custrinfo_all);
+	}
+
+	data.ob = ob;
+	data.instances = instances;
+
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (strings_len > 1);
+		BLI_task_parallel_range(0, strings_len, &data, vfont_batch_instance_cb, &settings);
+	}
+
+	/* the cells fit every instance (relative to its origin) */
+	INIT_MINMAX(min, max);
+	for (i = 0; i < strings_len; i++) {
+		if (instances[i].nubase.first) {
+			minmax_v3v3_v3(min, max, instances[i].min);
+			minmax_v3v3_v3(min, max, instances[i].max);
+		}
+	}
+	if (min[0] > max[0]) {
+		zero_v3(min);
+		zero_v3(max);
+	}
+	cell[0] = (max[0] - min[0]) + margin;
+	cell[1] = (max[1] - min[1]) + margin;
+
+	for (i = 0; i < strings_len; i++) {
+		VFontBatchInstance *inst = &instances[i];
+		const int columns_clamp = max_ii(columns, 1);
+		const float offset[3] = {
+		    (float)(i % columns_clamp) * cell[0],
+		    -(float)(i / columns_clamp) * cell[1],
+		    0.0f};
+
+		if (inst->ok) {
+			vfont_batch_nurbs_translate(&inst->nubase, offset, charidx_offset);
+			BLI_movelisttolist(r_nubase, &inst->nubase);
+		}
+		else {
+			BKE_nurbList_free(&inst->nubase);
+			ok = false;
+		}
+		/* include the line breaks */
+		charidx_offset += inst->cu.len_wchar + 1;
+
+		MEM_freeN(inst->cu.strinfo);
+	}
+
+	MEM_freeN(instances);
+	if (tb) {
+		MEM_freeN(tb);
+	}
+
+	return ok;
+}
+
+/** \} */
+
+
 /* -------------------------------------------------------------------- */
 
 /** \name VFont Clipboard
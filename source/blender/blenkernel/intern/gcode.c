@@ -0,0 +1,1140 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file blender/blenkernel/intern/gcode.c
+ *  \ingroup bke
+ *
+ * Reads G-code programs (as written by CAM software and slicers) into the path of the tool,
+ * to show it in the viewport (a backplot).
+ *
+ * The supported subset is what CAM post-processors commonly write:
+ * rapid, linear and (helical) arc moves in any plane, drilling cycles (G81-G83),
+ * inch and millimeter units, absolute and incremental distances,
+ * G92 and G54-G59 work offsets (set with G10 L2/L20), G53 machine moves and G28/G30.
+ * Blocks using parameters, expressions or subroutines are skipped (and counted).
+ *
+ * Reading is done in two passes, the text is split into words (a letter and a number)
+ * in parallel, a part of the buffer at a time, then the modal state (units, offsets, motion mode)
+ * is applied to the blocks in order, this part can't be threaded since every block depends
+ * on the state left by the blocks before it.
+ *
+ * The time a machine takes to run a path is estimated by simulating grbl's motion planner.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_fileops.h"
+#include "BLI_math.h"
+#include "BLI_task.h"
+
+#include "BKE_customdata.h"
+#include "BKE_gcode.h"
+#include "BKE_mesh.h"
+
+/* size of the parts of the buffer split into words by each task */
+#define GCODE_CHUNK_SIZE (1 << 18)
+/* number of parts split into words before their blocks are run,
+ * so the words of very large files don't all need to be in memory at once */
+#define GCODE_CHUNK_BATCH 64
+
+/* limit for badly written arcs (a tiny tolerance on a huge radius) */
+#define GCODE_ARC_SEGMENTS_MAX 4096
+/* from grbl, arcs ending where they start are full circles */
+#define GCODE_ARC_ANGULAR_TRAVEL_EPSILON 5e-7
+
+#define GCODE_INCH 25.4
+
+/* -------------------------------------------------------------------- */
+/** \name Words
+ *
+ * Splitting text into the words of each block (line).
+ * \{ */
+
+typedef struct GCodeWord {
+	double value;
+	char letter;
+} GCodeWord;
+
+/* the words of the lines in a part of the buffer */
+typedef struct GCodeChunk {
+	const char *buf, *buf_end;
+
+	GCodeWord *words;
+	int words_len, words_alloc;
+	/* the end of each block in words, lines without words aren't stored */
+	int *blocks;
+	int blocks_len, blocks_alloc;
+
+	int lines_len;
+	int blocks_skipped_len;
+} GCodeChunk;
+
+/**
+ * Parse a decimal number (without exponent, which G-code doesn't use),
+ * avoids `strtod` which is slow and depends on the locale.
+ *
+ * \return the end of the number, NULL when there is no number.
+ */
+static const char *gcode_parse_number(const char *p, const char *end, double *r_value)
+{
+	static const double pow10[] = {
+	    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+	    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+	};
+	unsigned long long mantissa = 0;
+	int digits = 0, decimals = 0;
+	bool is_negative = false, has_point = false, has_digit = false;
+
+	if (p != end && ELEM(*p, '+', '-')) {
+		is_negative = (*p == '-');
+		p++;
+	}
+
+	for (; p != end; p++) {
+		if (*p >= '0' && *p <= '9') {
+			has_digit = true;
+			if (digits < 18) {
+				/* leading zeros don't use up precision */
+				if (mantissa != 0 || *p != '0') {
+					digits++;
+				}
+				mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+				if (has_point) {
+					decimals++;
+				}
+			}
+			else if (!has_point) {
+				/* not a coordinate any machine could reach */
+				return NULL;
+			}
+		}
+		else if (*p == '.' && !has_point) {
+			has_point = true;
+		}
+		else {
+			break;
+		}
+
+		if (decimals == (int)ARRAY_SIZE(pow10) - 1) {
+			/* skip the digits past the precision of a double */
+			for (p++; p != end && *p >= '0' && *p <= '9'; p++) {
+				/* pass */
+			}
+			break;
+		}
+	}
+
+	if (!has_digit) {
+		return NULL;
+	}
+
+	*r_value = (double)mantissa / pow10[decimals];
+	if (is_negative) {
+		*r_value = -*r_value;
+	}
+	return p;
+}
+
+static void gcode_chunk_word_add(GCodeChunk *chunk, const char letter, const double value)
+{
+	GCodeWord *word;
+
+	if (UNLIKELY(chunk->words_len == chunk->words_alloc)) {
+		chunk->words_alloc = max_ii(chunk->words_alloc * 2, 1024);
+		chunk->words = MEM_reallocN(chunk->words, sizeof(*chunk->words) * (size_t)chunk->words_alloc);
+	}
+
+	word = &chunk->words[chunk->words_len++];
+	word->letter = letter;
+	word->value = value;
+}
+
+static void gcode_chunk_block_add(GCodeChunk *chunk)
+{
+	if (UNLIKELY(chunk->blocks_len == chunk->blocks_alloc)) {
+		chunk->blocks_alloc = max_ii(chunk->blocks_alloc * 2, 256);
+		chunk->blocks = MEM_reallocN(chunk->blocks, sizeof(*chunk->blocks) * (size_t)chunk->blocks_alloc);
+	}
+
+	chunk->blocks[chunk->blocks_len++] = chunk->words_len;
+}
+
+static const char *gcode_skip_line(const char *p, const char *end)
+{
+	while (p != end && *p != '\n') {
+		p++;
+	}
+	return p;
+}
+
+static void gcode_chunk_tokenize(GCodeChunk *chunk)
+{
+	const char *p = chunk->buf;
+	const char *end = chunk->buf_end;
+
+	while (p != end) {
+		const int words_len_init = chunk->words_len;
+		bool is_skipped = false;
+
+		chunk->lines_len++;
+
+		while (p != end && *p != '\n') {
+			const char c = *p;
+
+			/* whitespace, program start/end and block delete (which is off) */
+			if (ELEM(c, ' ', '\t', '\r', '%', '/')) {
+				p++;
+			}
+			/* comment, or checksum (RepRap firmware) */
+			else if (ELEM(c, ';', '*')) {
+				p = gcode_skip_line(p, end);
+			}
+			/* comment up to the closing parenthesis */
+			else if (c == '(') {
+				while (p != end && !ELEM(*p, '\n', ')')) {
+					p++;
+				}
+				if (p != end && *p == ')') {
+					p++;
+				}
+			}
+			else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+				const char letter = (c >= 'a') ? (char)(c - ('a' - 'A')) : c;
+				const char *p_next;
+				double value;
+
+				for (p++; p != end && ELEM(*p, ' ', '\t'); p++) {
+					/* pass */
+				}
+
+				p_next = gcode_parse_number(p, end, &value);
+
+				/* 'O' words are subroutines and flow control (or program numbers) */
+				if (p_next == NULL || letter == 'O') {
+					is_skipped = true;
+					p = gcode_skip_line(p, end);
+				}
+				else {
+					gcode_chunk_word_add(chunk, letter, value);
+					p = p_next;
+				}
+			}
+			/* parameters, expressions and anything we don't know */
+			else {
+				is_skipped = true;
+				p = gcode_skip_line(p, end);
+			}
+		}
+
+		if (p != end) {
+			p++;
+		}
+
+		if (is_skipped) {
+			chunk->words_len = words_len_init;
+			chunk->blocks_skipped_len++;
+		}
+		else if (chunk->words_len != words_len_init) {
+			gcode_chunk_block_add(chunk);
+		}
+	}
+}
+
+static void gcode_chunk_tokenize_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	GCodeChunk *chunks = userdata;
+	gcode_chunk_tokenize(&chunks[i]);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Modal State
+ *
+ * Running the blocks, adding the moves to the path.
+ * \{ */
+
+#define GCODE_LETTER_BIT(c) (1u << ((c) - 'A'))
+#define GCODE_BLOCK_GCODES_MAX 16
+
+/* motion modes, G-code numbers times ten (so G92.1 is 921) */
+enum {
+	GCODE_MOTION_NONE  = -1,
+	GCODE_MOTION_RAPID = 0,
+	GCODE_MOTION_LINE  = 10,
+	GCODE_MOTION_ARC_CW  = 20,
+	GCODE_MOTION_ARC_CCW = 30,
+	GCODE_MOTION_DRILL = 810,
+	GCODE_MOTION_DRILL_DWELL = 820,
+	GCODE_MOTION_DRILL_PECK  = 830,
+};
+
+#define GCODE_MOTION_IS_CYCLE(motion) ((motion) >= GCODE_MOTION_DRILL)
+
+typedef struct GCodeBlock {
+	/* values of the words other than G and M, indexed by letter */
+	double values[26];
+	unsigned int letters;
+
+	int gcodes[GCODE_BLOCK_GCODES_MAX];
+	int gcodes_len;
+} GCodeBlock;
+
+typedef struct GCodeState {
+	/* machine coordinates (millimeters) */
+	double pos[3];
+
+	/* offsets added to program coordinates, G92 and the work offset of G54-G59 */
+	double offset_g92[3];
+	double offset_work[6][3];
+	int work;
+
+	int motion;
+	/* axes of the arc plane and its normal: G17 (XY), G18 (ZX), G19 (YZ) */
+	int plane[3];
+	/* millimeters per program unit */
+	double unit_scale;
+	bool is_incremental;
+	/* G98, return to the height where the canned cycle started */
+	bool use_retract_initial;
+
+	/* millimeters per minute */
+	double feed;
+
+	/* canned cycle values (program units), they're modal while the cycle is */
+	double cycle_r, cycle_z, cycle_q;
+	double cycle_z_initial;
+} GCodeState;
+
+static void gcode_state_init(GCodeState *state)
+{
+	memset(state, 0, sizeof(*state));
+	state->motion = GCODE_MOTION_NONE;
+	state->plane[0] = 0;
+	state->plane[1] = 1;
+	state->plane[2] = 2;
+	state->unit_scale = 1.0;
+	state->use_retract_initial = true;
+}
+
+static bool gcode_block_has(const GCodeBlock *block, const char letter)
+{
+	return (block->letters & GCODE_LETTER_BIT(letter)) != 0;
+}
+
+static double gcode_block_value(const GCodeBlock *block, const char letter)
+{
+	return block->values[letter - 'A'];
+}
+
+static void gcode_path_point_add(GCodePath *path, GCodeState *state, const double co[3], const char flag)
+{
+	memcpy(state->pos, co, sizeof(state->pos));
+
+	/* zero length moves don't show */
+	if (path->co_len != 0) {
+		const float *co_prev = path->co[path->co_len - 1];
+		if (co_prev[0] == (float)co[0] && co_prev[1] == (float)co[1] && co_prev[2] == (float)co[2]) {
+			return;
+		}
+	}
+
+	if (UNLIKELY(path->co_len == path->co_alloc)) {
+		path->co_alloc = max_ii(path->co_alloc * 2, 1024);
+		path->co = MEM_reallocN(path->co, sizeof(*path->co) * (size_t)path->co_alloc);
+		path->feed = MEM_reallocN(path->feed, sizeof(*path->feed) * (size_t)path->co_alloc);
+		path->flag = MEM_reallocN(path->flag, sizeof(*path->flag) * (size_t)path->co_alloc);
+	}
+
+	path->co[path->co_len][0] = (float)co[0];
+	path->co[path->co_len][1] = (float)co[1];
+	path->co[path->co_len][2] = (float)co[2];
+	path->feed[path->co_len] = (flag & GCODE_POINT_RAPID) ? 0.0f : (float)state->feed;
+	path->flag[path->co_len] = flag;
+	path->co_len++;
+}
+
+/* move along one axis only */
+static void gcode_path_point_add_axis(
+        GCodePath *path, GCodeState *state, const int axis, const double value, const char flag)
+{
+	double co[3];
+	memcpy(co, state->pos, sizeof(co));
+	co[axis] = value;
+	gcode_path_point_add(path, state, co, flag);
+}
+
+/**
+ * Convert a program coordinate (in program units) to machine coordinates.
+ */
+static double gcode_state_axis_to_machine(const GCodeState *state, const int axis, const double value)
+{
+	return (value * state->unit_scale) + state->offset_work[state->work][axis] + state->offset_g92[axis];
+}
+
+/**
+ * Arcs are subdivided into segments that don't deviate further than the tolerance from the arc,
+ * using the same method as grbl (so the path matches what the machine does).
+ */
+static void gcode_block_arc(
+        GCodePath *path, GCodeState *state, const GCodeBlock *block,
+        const double target[3], const bool is_clockwise, const float tolerance)
+{
+	const char offset_letters[3] = {'I', 'J', 'K'};
+	const int axis_0 = state->plane[0], axis_1 = state->plane[1], axis_linear = state->plane[2];
+	double offset[2], center[2], r_start[2], r_end[2];
+	double radius, angular_travel, linear_travel;
+	int segments, i;
+
+	if (gcode_block_has(block, 'R')) {
+		/* find the center from the radius, see grbl's 'gc_execute_line' */
+		const double x = target[axis_0] - state->pos[axis_0];
+		const double y = target[axis_1] - state->pos[axis_1];
+		const double dist = sqrt(x * x + y * y);
+		double r = gcode_block_value(block, 'R') * state->unit_scale;
+		double h_x2_div_d = 4.0 * r * r - x * x - y * y;
+
+		if (dist == 0.0) {
+			/* the center can't be known */
+			gcode_path_point_add(path, state, target, GCODE_POINT_ARC);
+			return;
+		}
+		/* when the end is slightly too far for the radius (rounded values), it's a half circle */
+		h_x2_div_d = (h_x2_div_d > 0.0) ? -sqrt(h_x2_div_d) / dist : 0.0;
+		if (!is_clockwise) {
+			h_x2_div_d = -h_x2_div_d;
+		}
+		/* a negative radius is the arc over 180 degrees */
+		if (r < 0.0) {
+			h_x2_div_d = -h_x2_div_d;
+			r = -r;
+		}
+		offset[0] = 0.5 * (x - (y * h_x2_div_d));
+		offset[1] = 0.5 * (y + (x * h_x2_div_d));
+	}
+	else {
+		offset[0] = gcode_block_has(block, offset_letters[axis_0]) ?
+		            gcode_block_value(block, offset_letters[axis_0]) * state->unit_scale : 0.0;
+		offset[1] = gcode_block_has(block, offset_letters[axis_1]) ?
+		            gcode_block_value(block, offset_letters[axis_1]) * state->unit_scale : 0.0;
+	}
+
+	center[0] = state->pos[axis_0] + offset[0];
+	center[1] = state->pos[axis_1] + offset[1];
+	r_start[0] = -offset[0];
+	r_start[1] = -offset[1];
+	r_end[0] = target[axis_0] - center[0];
+	r_end[1] = target[axis_1] - center[1];
+	radius = sqrt(offset[0] * offset[0] + offset[1] * offset[1]);
+
+	angular_travel = atan2(r_start[0] * r_end[1] - r_start[1] * r_end[0],
+	                       r_start[0] * r_end[0] + r_start[1] * r_end[1]);
+	if (is_clockwise) {
+		if (angular_travel >= -GCODE_ARC_ANGULAR_TRAVEL_EPSILON) {
+			angular_travel -= 2.0 * M_PI;
+		}
+	}
+	else {
+		if (angular_travel <= GCODE_ARC_ANGULAR_TRAVEL_EPSILON) {
+			angular_travel += 2.0 * M_PI;
+		}
+	}
+
+	if (2.0 * radius > (double)tolerance) {
+		const double segments_fl = floor(fabs(0.5 * angular_travel * radius) /
+		                                 sqrt((double)tolerance * (2.0 * radius - (double)tolerance)));
+		segments = (int)MIN2(segments_fl, (double)GCODE_ARC_SEGMENTS_MAX);
+	}
+	else {
+		segments = 1;
+	}
+
+	linear_travel = target[axis_linear] - state->pos[axis_linear];
+
+	if (segments > 1) {
+		const double start_linear = state->pos[axis_linear];
+
+		for (i = 1; i < segments; i++) {
+			const double fac = (double)i / (double)segments;
+			const double angle = angular_travel * fac;
+			const double cos_t = cos(angle), sin_t = sin(angle);
+			double co[3];
+
+			co[axis_0] = center[0] + r_start[0] * cos_t - r_start[1] * sin_t;
+			co[axis_1] = center[1] + r_start[0] * sin_t + r_start[1] * cos_t;
+			co[axis_linear] = start_linear + linear_travel * fac;
+			gcode_path_point_add(path, state, co, GCODE_POINT_ARC);
+		}
+	}
+
+	gcode_path_point_add(path, state, target, GCODE_POINT_ARC);
+}
+
+/**
+ * Drilling cycles (in the XY plane): position over the hole, go down to the R plane,
+ * drill to Z (G83 pecks by Q, leaving the hole after each peck), then retract.
+ */
+static void gcode_block_cycle(
+        GCodePath *path, GCodeState *state, const GCodeBlock *block, const double target[3])
+{
+	double z_r, z_bottom, z_retract;
+
+	if (gcode_block_has(block, 'R')) {
+		state->cycle_r = gcode_block_value(block, 'R');
+	}
+	if (gcode_block_has(block, 'Z')) {
+		state->cycle_z = gcode_block_value(block, 'Z');
+	}
+	if (gcode_block_has(block, 'Q')) {
+		state->cycle_q = fabs(gcode_block_value(block, 'Q'));
+	}
+
+	if (state->is_incremental) {
+		/* R is relative to the initial height, Z to R */
+		z_r = state->pos[2] + state->cycle_r * state->unit_scale;
+		z_bottom = z_r + state->cycle_z * state->unit_scale;
+	}
+	else {
+		z_r = gcode_state_axis_to_machine(state, 2, state->cycle_r);
+		z_bottom = gcode_state_axis_to_machine(state, 2, state->cycle_z);
+	}
+
+	z_retract = state->use_retract_initial ? MAX2(state->cycle_z_initial, z_r) : z_r;
+
+	if (state->pos[2] < z_r) {
+		gcode_path_point_add_axis(path, state, 2, z_r, GCODE_POINT_RAPID);
+	}
+	{
+		double co[3] = {target[0], target[1], state->pos[2]};
+		gcode_path_point_add(path, state, co, GCODE_POINT_RAPID);
+	}
+	gcode_path_point_add_axis(path, state, 2, z_r, GCODE_POINT_RAPID);
+
+	if (state->motion == GCODE_MOTION_DRILL_PECK && state->cycle_q > 0.0) {
+		const double peck = state->cycle_q * state->unit_scale;
+		double z = z_r;
+
+		while (z > z_bottom) {
+			z = MAX2(z - peck, z_bottom);
+			gcode_path_point_add_axis(path, state, 2, z, 0);
+			if (z > z_bottom) {
+				/* clear the chips and go back down */
+				gcode_path_point_add_axis(path, state, 2, z_r, GCODE_POINT_RAPID);
+				gcode_path_point_add_axis(path, state, 2, z, GCODE_POINT_RAPID);
+			}
+		}
+	}
+	else {
+		gcode_path_point_add_axis(path, state, 2, z_bottom, 0);
+	}
+
+	gcode_path_point_add_axis(path, state, 2, z_retract, GCODE_POINT_RAPID);
+}
+
+static void gcode_block_execute(
+        GCodePath *path, GCodeState *state, const GCodeBlock *block, const GCodeParseSettings *settings)
+{
+	const char axis_letters[3] = {'X', 'Y', 'Z'};
+	const unsigned int axis_bits = GCODE_LETTER_BIT('X') | GCODE_LETTER_BIT('Y') | GCODE_LETTER_BIT('Z');
+	const int motion_prev = state->motion;
+	bool use_machine_coords = false;
+	int non_modal = -1;
+	double target[3];
+	int i, axis;
+
+	for (i = 0; i < block->gcodes_len; i++) {
+		const int code = block->gcodes[i];
+		switch (code) {
+			case GCODE_MOTION_RAPID:
+			case GCODE_MOTION_LINE:
+			case GCODE_MOTION_ARC_CW:
+			case GCODE_MOTION_ARC_CCW:
+			case GCODE_MOTION_DRILL:
+			case GCODE_MOTION_DRILL_DWELL:
+			case GCODE_MOTION_DRILL_PECK:
+				state->motion = code;
+				break;
+			case 800:
+				state->motion = GCODE_MOTION_NONE;
+				break;
+			case 170: ARRAY_SET_ITEMS(state->plane, 0, 1, 2); break;
+			case 180: ARRAY_SET_ITEMS(state->plane, 2, 0, 1); break;
+			case 190: ARRAY_SET_ITEMS(state->plane, 1, 2, 0); break;
+			case 200: state->unit_scale = GCODE_INCH; break;
+			case 210: state->unit_scale = 1.0; break;
+			case 900: state->is_incremental = false; break;
+			case 910: state->is_incremental = true; break;
+			case 980: state->use_retract_initial = true; break;
+			case 990: state->use_retract_initial = false; break;
+			case 530:
+				use_machine_coords = true;
+				break;
+			case 540: case 550: case 560: case 570: case 580: case 590:
+				state->work = (code - 540) / 10;
+				break;
+			case 100:
+			case 280:
+			case 300:
+			case 920:
+			case 921:
+				non_modal = code;
+				break;
+			default:
+				/* dwell, cutter compensation, tool length, feed modes... don't change the path */
+				break;
+		}
+	}
+
+	if (gcode_block_has(block, 'F')) {
+		state->feed = gcode_block_value(block, 'F') * state->unit_scale;
+	}
+
+	if (GCODE_MOTION_IS_CYCLE(state->motion) && !GCODE_MOTION_IS_CYCLE(motion_prev)) {
+		state->cycle_z_initial = state->pos[2];
+	}
+
+	/* the target, in machine coordinates */
+	for (axis = 0; axis < 3; axis++) {
+		if (gcode_block_has(block, axis_letters[axis])) {
+			const double value = gcode_block_value(block, axis_letters[axis]);
+			if (use_machine_coords) {
+				target[axis] = value * state->unit_scale;
+			}
+			else if (state->is_incremental) {
+				target[axis] = state->pos[axis] + value * state->unit_scale;
+			}
+			else {
+				target[axis] = gcode_state_axis_to_machine(state, axis, value);
+			}
+		}
+		else {
+			target[axis] = state->pos[axis];
+		}
+	}
+
+	switch (non_modal) {
+		case 920:
+		{
+			/* the current position gets the given coordinates */
+			for (axis = 0; axis < 3; axis++) {
+				if (gcode_block_has(block, axis_letters[axis])) {
+					state->offset_g92[axis] =
+					        state->pos[axis] - state->offset_work[state->work][axis] -
+					        gcode_block_value(block, axis_letters[axis]) * state->unit_scale;
+				}
+			}
+			return;
+		}
+		case 921:
+		{
+			memset(state->offset_g92, 0, sizeof(state->offset_g92));
+			return;
+		}
+		case 100:
+		{
+			/* G10 L2 sets a work offset, G10 L20 sets it so the current position
+			 * gets the given coordinates, P0 is the active one */
+			const int l = gcode_block_has(block, 'L') ? (int)gcode_block_value(block, 'L') : 0;
+			const int p = gcode_block_has(block, 'P') ? (int)gcode_block_value(block, 'P') : 0;
+			const int work = (p == 0) ? state->work : p - 1;
+
+			if (ELEM(l, 2, 20) && work >= 0 && work < 6) {
+				for (axis = 0; axis < 3; axis++) {
+					if (gcode_block_has(block, axis_letters[axis])) {
+						const double value = gcode_block_value(block, axis_letters[axis]) * state->unit_scale;
+						state->offset_work[work][axis] =
+						        (l == 2) ? value : state->pos[axis] - state->offset_g92[axis] - value;
+					}
+				}
+			}
+			return;
+		}
+		case 280:
+		case 300:
+		{
+			/* go home through the given point, only moving the given axes
+			 * (all of them when none are given), the home positions are assumed to be zero */
+			const bool has_axes = (block->letters & axis_bits) != 0;
+
+			path->moves_len++;
+			gcode_path_point_add(path, state, target, GCODE_POINT_RAPID);
+			for (axis = 0; axis < 3; axis++) {
+				if (!has_axes || gcode_block_has(block, axis_letters[axis])) {
+					target[axis] = 0.0;
+				}
+			}
+			gcode_path_point_add(path, state, target, GCODE_POINT_RAPID);
+			return;
+		}
+	}
+
+	/* only blocks with axis words move, canned cycles also repeat on R words */
+	if ((block->letters & axis_bits) == 0) {
+		if (!(GCODE_MOTION_IS_CYCLE(state->motion) && gcode_block_has(block, 'R'))) {
+			return;
+		}
+	}
+
+	switch (state->motion) {
+		case GCODE_MOTION_RAPID:
+			gcode_path_point_add(path, state, target, GCODE_POINT_RAPID);
+			break;
+		case GCODE_MOTION_LINE:
+			gcode_path_point_add(path, state, target, 0);
+			break;
+		case GCODE_MOTION_ARC_CW:
+		case GCODE_MOTION_ARC_CCW:
+			gcode_block_arc(
+			        path, state, block, target,
+			        state->motion == GCODE_MOTION_ARC_CW, settings->arc_tolerance);
+			break;
+		case GCODE_MOTION_DRILL:
+		case GCODE_MOTION_DRILL_DWELL:
+		case GCODE_MOTION_DRILL_PECK:
+			gcode_block_cycle(path, state, block, target);
+			break;
+		default:
+			/* axis words without a motion mode, an error for the machine */
+			return;
+	}
+
+	path->moves_len++;
+}
+
+static void gcode_chunk_execute(
+        GCodePath *path, GCodeState *state, const GCodeChunk *chunk, const GCodeParseSettings *settings)
+{
+	GCodeBlock block;
+	int block_index, word_index = 0;
+
+	for (block_index = 0; block_index < chunk->blocks_len; block_index++) {
+		const int words_end = chunk->blocks[block_index];
+
+		block.letters = 0;
+		block.gcodes_len = 0;
+
+		for (; word_index < words_end; word_index++) {
+			const GCodeWord *word = &chunk->words[word_index];
+			switch (word->letter) {
+				case 'G':
+					if (block.gcodes_len < GCODE_BLOCK_GCODES_MAX) {
+						block.gcodes[block.gcodes_len++] = (int)floor(word->value * 10.0 + 0.5);
+					}
+					break;
+				case 'M':
+					/* spindle, coolant, tool change, program end, don't change the path */
+					break;
+				default:
+					block.values[word->letter - 'A'] = word->value;
+					block.letters |= GCODE_LETTER_BIT(word->letter);
+					break;
+			}
+		}
+
+		gcode_block_execute(path, state, &block, settings);
+	}
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Path API
+ * \{ */
+
+void BKE_gcode_parse_settings_defaults(GCodeParseSettings *settings)
+{
+	settings->arc_tolerance = 0.002f;
+	settings->use_threading = true;
+}
+
+/* grbl's default settings */
+void BKE_gcode_machine_settings_defaults(GCodeMachineSettings *machine)
+{
+	copy_v3_fl(machine->max_rate, 500.0f);
+	copy_v3_fl(machine->acceleration, 10.0f);
+	machine->junction_deviation = 0.01f;
+	machine->planner_blocks_len = 16;
+}
+
+GCodePath *BKE_gcode_path_from_buffer(
+        const char *buf, const size_t buf_len, const GCodeParseSettings *settings)
+{
+	GCodePath *path = MEM_callocN(sizeof(*path), __func__);
+	GCodeChunk *chunks = MEM_mallocN(sizeof(*chunks) * GCODE_CHUNK_BATCH, __func__);
+	GCodeState state;
+	const char *buf_end = buf + buf_len;
+	const char *p = buf;
+	const double co_init[3] = {0.0, 0.0, 0.0};
+
+	gcode_state_init(&state);
+	gcode_path_point_add(path, &state, co_init, GCODE_POINT_RAPID);
+
+	while (p != buf_end) {
+		ParallelRangeSettings range_settings;
+		int chunks_len, i;
+
+		for (chunks_len = 0; chunks_len < GCODE_CHUNK_BATCH && p != buf_end; chunks_len++) {
+			GCodeChunk *chunk = &chunks[chunks_len];
+			const char *chunk_end = ((size_t)(buf_end - p) > GCODE_CHUNK_SIZE) ? p + GCODE_CHUNK_SIZE : buf_end;
+
+			/* parts end with their last line */
+			while (chunk_end != buf_end && *(chunk_end - 1) != '\n') {
+				chunk_end++;
+			}
+
+			memset(chunk, 0, sizeof(*chunk));
+			chunk->buf = p;
+			chunk->buf_end = chunk_end;
+			p = chunk_end;
+		}
+
+		BLI_parallel_range_settings_defaults(&range_settings);
+		range_settings.use_threading = (settings->use_threading && chunks_len > 1);
+		BLI_task_parallel_range(0, chunks_len, chunks, gcode_chunk_tokenize_cb, &range_settings);
+
+		for (i = 0; i < chunks_len; i++) {
+			GCodeChunk *chunk = &chunks[i];
+
+			gcode_chunk_execute(path, &state, chunk, settings);
+
+			path->lines_len += chunk->lines_len;
+			path->blocks_skipped_len += chunk->blocks_skipped_len;
+
+			MEM_SAFE_FREE(chunk->words);
+			MEM_SAFE_FREE(chunk->blocks);
+		}
+	}
+
+	MEM_freeN(chunks);
+
+	return path;
+}
+
+GCodePath *BKE_gcode_path_from_file(const char *filepath, const GCodeParseSettings *settings)
+{
+	GCodePath *path;
+	size_t buf_len = 0;
+	char *buf = BLI_file_read_binary_as_mem(filepath, 0, &buf_len);
+
+	if (buf == NULL) {
+		return NULL;
+	}
+
+	path = BKE_gcode_path_from_buffer(buf, buf_len, settings);
+	MEM_freeN(buf);
+
+	return path;
+}
+
+void BKE_gcode_path_free(GCodePath *path)
+{
+	MEM_SAFE_FREE(path->co);
+	MEM_SAFE_FREE(path->feed);
+	MEM_SAFE_FREE(path->flag);
+	MEM_freeN(path);
+}
+
+/**
+ * Fill an empty mesh with the path as loose edges,
+ * rapid moves are marked as seams so they stand out from cutting moves.
+ *
+ * \param scale: Meters per millimeter, for scenes using metric units this is 0.001.
+ */
+void BKE_gcode_path_to_mesh(
+        const GCodePath *path, Mesh *me,
+        const float scale, const bool use_rapid)
+{
+	MVert *mvert;
+	MEdge *medge;
+	int i, totedge = 0;
+
+	BLI_assert(me->totvert == 0 && me->totedge == 0);
+
+	for (i = 1; i < path->co_len; i++) {
+		if (use_rapid || !(path->flag[i] & GCODE_POINT_RAPID)) {
+			totedge++;
+		}
+	}
+
+	me->totvert = path->co_len;
+	me->totedge = totedge;
+
+	mvert = CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, me->totvert);
+	medge = CustomData_add_layer(&me->edata, CD_MEDGE, CD_CALLOC, NULL, me->totedge);
+
+	for (i = 0; i < path->co_len; i++) {
+		mul_v3_v3fl(mvert[i].co, path->co[i], scale);
+	}
+
+	for (i = 1; i < path->co_len; i++) {
+		const bool is_rapid = (path->flag[i] & GCODE_POINT_RAPID) != 0;
+		if (use_rapid || !is_rapid) {
+			medge->v1 = (unsigned int)(i - 1);
+			medge->v2 = (unsigned int)i;
+			medge->flag = ME_LOOSEEDGE | ME_EDGEDRAW | ME_EDGERENDER;
+			if (is_rapid) {
+				medge->flag |= ME_SEAM;
+			}
+			medge++;
+		}
+	}
+
+	BKE_mesh_update_customdata_pointers(me, false);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Machine Time
+ *
+ * Simulates grbl's motion planner, see grbl's 'planner.c':
+ * each move accelerates up to its feed rate and decelerates for the next one,
+ * corners are taken at the speed the junction deviation allows,
+ * and the moves are planned so the machine can stop at the end of the look-ahead buffer.
+ *
+ * Speeds are in millimeters per minute and accelerations in millimeters per minute squared,
+ * like grbl uses.
+ * \{ */
+
+typedef struct GCodePlanBlock {
+	/* the point at the end of the move */
+	int index;
+	bool is_rapid;
+	double length;
+	double acceleration;
+	double nominal_speed_sqr;
+	/* limited by the junction with the move before */
+	double max_entry_speed_sqr;
+} GCodePlanBlock;
+
+/* ring buffer of the moves looked ahead */
+typedef struct GCodePlanner {
+	GCodePlanBlock *blocks;
+	int blocks_alloc;
+	int blocks_len;
+	int tail;
+	/* entry speed of the oldest block, set by the block executed before it */
+	double entry_speed_sqr;
+} GCodePlanner;
+
+/* the largest value along a direction that doesn't exceed the value of any axis */
+static double gcode_limit_by_axis_maximum(const double max_value[3], const double unit_vec[3])
+{
+	double limit = DBL_MAX;
+	int axis;
+
+	for (axis = 0; axis < 3; axis++) {
+		if (unit_vec[axis] != 0.0) {
+			limit = MIN2(limit, fabs(max_value[axis] / unit_vec[axis]));
+		}
+	}
+	return limit;
+}
+
+static void gcode_planner_block_execute(
+        GCodePlanner *planner, float *r_feed_achieved, GCodeEstimate *r_estimate)
+{
+	const GCodePlanBlock *block = &planner->blocks[planner->tail];
+	const double accel = block->acceleration;
+	const double entry_speed_sqr = planner->entry_speed_sqr;
+	double exit_speed_sqr = 0.0;
+	double entry_speed, exit_speed, peak_speed, time;
+	double accel_dist, decel_dist;
+	int i;
+
+	/* the fastest the next block can be entered while still being able to stop
+	 * at the end of the buffer (grbl's reverse pass) */
+	for (i = planner->blocks_len - 1; i > 0; i--) {
+		const GCodePlanBlock *block_next = &planner->blocks[(planner->tail + i) % planner->blocks_alloc];
+		exit_speed_sqr = MIN2(
+		        block_next->max_entry_speed_sqr,
+		        exit_speed_sqr + 2.0 * block_next->acceleration * block_next->length);
+	}
+	/* and what this block can reach (the forward pass) */
+	exit_speed_sqr = MIN2(exit_speed_sqr, entry_speed_sqr + 2.0 * accel * block->length);
+
+	/* trapezoid, or triangle when the nominal speed isn't reached */
+	accel_dist = (block->nominal_speed_sqr - entry_speed_sqr) / (2.0 * accel);
+	decel_dist = (block->nominal_speed_sqr - exit_speed_sqr) / (2.0 * accel);
+	entry_speed = sqrt(entry_speed_sqr);
+	exit_speed = sqrt(exit_speed_sqr);
+
+	if (accel_dist + decel_dist < block->length) {
+		peak_speed = sqrt(block->nominal_speed_sqr);
+		time = ((peak_speed - entry_speed) + (peak_speed - exit_speed)) / accel +
+		       (block->length - accel_dist - decel_dist) / peak_speed;
+	}
+	else {
+		peak_speed = sqrt(MAX2(0.5 * (2.0 * accel * block->length + entry_speed_sqr + exit_speed_sqr),
+		                         MAX2(entry_speed_sqr, exit_speed_sqr)));
+		time = ((peak_speed - entry_speed) + (peak_speed - exit_speed)) / accel;
+	}
+
+	/* minutes to seconds */
+	time *= 60.0;
+
+	r_estimate->duration += time;
+	r_estimate->length += block->length;
+	if (block->is_rapid) {
+		r_estimate->duration_rapid += time;
+		r_estimate->length_rapid += block->length;
+	}
+	if (r_feed_achieved) {
+		r_feed_achieved[block->index] = (float)peak_speed;
+	}
+
+	planner->entry_speed_sqr = exit_speed_sqr;
+	planner->tail = (planner->tail + 1) % planner->blocks_alloc;
+	planner->blocks_len--;
+}
+
+/**
+ * Estimate the time the machine takes to run the path.
+ *
+ * The path doesn't need to be read from G-code, any polyline with feed rates can be passed in.
+ *
+ * \param r_feed_achieved: When not NULL, the highest speed reached by the move ending at each point
+ * (millimeters per minute), an array of `path->co_len` items.
+ */
+void BKE_gcode_path_estimate(
+        const GCodePath *path, const GCodeMachineSettings *machine,
+        float *r_feed_achieved, GCodeEstimate *r_estimate)
+{
+	GCodePlanner planner = {NULL};
+	double max_rate[3], acceleration[3];
+	double unit_vec_prev[3] = {0.0};
+	double nominal_speed_sqr_prev = 0.0;
+	bool has_prev = false;
+	int i;
+
+	memset(r_estimate, 0, sizeof(*r_estimate));
+	if (r_feed_achieved) {
+		memset(r_feed_achieved, 0, sizeof(*r_feed_achieved) * (size_t)path->co_len);
+	}
+
+	for (i = 0; i < 3; i++) {
+		max_rate[i] = (double)max_ff(machine->max_rate[i], FLT_EPSILON);
+		/* per second squared to per minute squared */
+		acceleration[i] = (double)max_ff(machine->acceleration[i], FLT_EPSILON) * 3600.0;
+	}
+
+	planner.blocks_alloc = max_ii(machine->planner_blocks_len, 1);
+	planner.blocks = MEM_mallocN(sizeof(*planner.blocks) * (size_t)planner.blocks_alloc, __func__);
+
+	for (i = 1; i < path->co_len; i++) {
+		GCodePlanBlock *block;
+		double unit_vec[3], length, rate_limit;
+		int axis;
+
+		for (axis = 0; axis < 3; axis++) {
+			unit_vec[axis] = (double)path->co[i][axis] - (double)path->co[i - 1][axis];
+		}
+		length = sqrt(unit_vec[0] * unit_vec[0] + unit_vec[1] * unit_vec[1] + unit_vec[2] * unit_vec[2]);
+		if (length == 0.0) {
+			continue;
+		}
+		for (axis = 0; axis < 3; axis++) {
+			unit_vec[axis] /= length;
+		}
+
+		if (planner.blocks_len == planner.blocks_alloc) {
+			gcode_planner_block_execute(&planner, r_feed_achieved, r_estimate);
+		}
+
+		block = &planner.blocks[(planner.tail + planner.blocks_len) % planner.blocks_alloc];
+		planner.blocks_len++;
+
+		block->index = i;
+		block->is_rapid = (path->flag[i] & GCODE_POINT_RAPID) != 0;
+		block->length = length;
+		block->acceleration = gcode_limit_by_axis_maximum(acceleration, unit_vec);
+
+		rate_limit = gcode_limit_by_axis_maximum(max_rate, unit_vec);
+		if (block->is_rapid || path->feed[i] <= 0.0f) {
+			block->nominal_speed_sqr = rate_limit * rate_limit;
+		}
+		else {
+			const double feed = MIN2((double)path->feed[i], rate_limit);
+			block->nominal_speed_sqr = feed * feed;
+		}
+
+		if (has_prev) {
+			/* cosine of the angle between the moves, with the previous move reversed */
+			const double junction_cos_theta = -(unit_vec_prev[0] * unit_vec[0] +
+			                                    unit_vec_prev[1] * unit_vec[1] +
+			                                    unit_vec_prev[2] * unit_vec[2]);
+			double junction_speed_sqr;
+
+			if (junction_cos_theta > 0.999999) {
+				/* reversing */
+				junction_speed_sqr = 0.0;
+			}
+			else if (junction_cos_theta < -0.999999) {
+				/* straight */
+				junction_speed_sqr = DBL_MAX;
+			}
+			else {
+				const double sin_theta_d2 = sqrt(0.5 * (1.0 - junction_cos_theta));
+				double junction_unit_vec[3], junction_len;
+
+				for (axis = 0; axis < 3; axis++) {
+					junction_unit_vec[axis] = unit_vec[axis] - unit_vec_prev[axis];
+				}
+				junction_len = sqrt(junction_unit_vec[0] * junction_unit_vec[0] +
+				                    junction_unit_vec[1] * junction_unit_vec[1] +
+				                    junction_unit_vec[2] * junction_unit_vec[2]);
+				for (axis = 0; axis < 3; axis++) {
+					junction_unit_vec[axis] /= junction_len;
+				}
+
+				junction_speed_sqr =
+				        (gcode_limit_by_axis_maximum(acceleration, junction_unit_vec) *
+				         (double)machine->junction_deviation * sin_theta_d2) / (1.0 - sin_theta_d2);
+			}
+
+			block->max_entry_speed_sqr = MIN2(
+			        junction_speed_sqr, MIN2(block->nominal_speed_sqr, nominal_speed_sqr_prev));
+		}
+		else {
+			/* starting from rest */
+			block->max_entry_speed_sqr = 0.0;
+		}
+
+		memcpy(unit_vec_prev, unit_vec, sizeof(unit_vec_prev));
+		nominal_speed_sqr_prev = block->nominal_speed_sqr;
+		has_prev = true;
+	}
+
+	/* the end of the program, the machine stops */
+	while (planner.blocks_len != 0) {
+		gcode_planner_block_execute(&planner, r_feed_achieved, r_estimate);
+	}
+
+	MEM_freeN(planner.blocks);
+}
+
+/** \} */
@@ -284,6 +284,11 @@ void BKE_image_free_buffers_ex(Image *ima, bool do_lock)
 	}
 	image_free_cached_frames(ima);
 
+	if (ima->tiled_ibuf) {
+		IMB_freeImBuf(ima->tiled_ibuf);
+		ima->tiled_ibuf = NULL;
+	}
+
 	if (ima->rr) {
 		ima->rr = NULL;
 	}
@@ -416,6 +421,7 @@ void BKE_image_copy_data(Main *UNUSED(bmain), Image *ima_dst, const Image *ima_s
 
 	/* Cleanup stuff that cannot be copied. */
 	ima_dst->cache = NULL;
+	ima_dst->tiled_ibuf = NULL;
 	ima_dst->rr = NULL;
 
 	BLI_listbase_clear(&ima_dst->anims);
@@ -2217,6 +2223,64 @@ void BKE_image_release_ibuf(Image *ima, ImBuf *ibuf, void *lock)
 	}
 }
 
+/**
+ * Image buffer of which only the header and (empty) mipmap levels are allocated,
+ * the pixels are read per tile by the imbuf tile cache when sampled with
+ * IMB_tile_sampler_bilinear. Avoids decoding and keeping all of large images.
+ *
+ * The values are read as non-color data (no color space conversion, alpha is ignored),
+ * 16 bit images keep their precision. Formats that can't be read per tile are read
+ * entirely, as are packed images. Returns NULL for images that aren't files.
+ *
+ * The buffer is kept in Image.tiled_ibuf, not in the regular cache, so it's never
+ * mistaken for an image buffer with pixels.
+ */
+ImBuf *BKE_image_acquire_ibuf_tiled(Image *ima)
+{
+	ImBuf *ibuf;
+
+	if (ima == NULL || ima->source != IMA_SRC_FILE || ima->type != IMA_TYPE_IMAGE) {
+		return NULL;
+	}
+
+	BLI_spin_lock(&image_spin);
+
+	if (ima->tiled_ibuf == NULL) {
+		/* scene linear is stored as is, byte buffers are never converted */
+		char colorspace[IM_MAX_SPACE];
+		const int flag = IB_rect | IB_ignore_alpha;
+
+		BLI_strncpy(colorspace, IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_SCENE_LINEAR),
+		            sizeof(colorspace));
+
+		if (BKE_image_has_packedfile(ima)) {
+			ImagePackedFile *imapf = ima->packedfiles.first;
+
+			/* tiles are read from the file, so packed images are read entirely */
+			if (imapf->packedfile) {
+				ima->tiled_ibuf = IMB_ibImageFromMemory(
+				        (unsigned char *)imapf->packedfile->data, imapf->packedfile->size, flag,
+				        colorspace, "<packed data>");
+			}
+		}
+		else {
+			char filepath[FILE_MAX];
+
+			BKE_image_user_file_path(NULL, ima, filepath);
+			ima->tiled_ibuf = IMB_loadiffname(filepath, flag | IB_tilecache, colorspace);
+		}
+	}
+
+	ibuf = ima->tiled_ibuf;
+	if (ibuf) {
+		IMB_refImBuf(ibuf);
+	}
+
+	BLI_spin_unlock(&image_spin);
+
+	return ibuf;
+}
+
 /* checks whether there's an image buffer for given image and user */
 bool BKE_image_has_ibuf(Image *ima, ImageUser *iuser)
 {
@@ -131,6 +131,8 @@ void modifier_free_ex(ModifierData *md, const int flag)
 	if (mti->freeData) mti->freeData(md);
 	if (md->error) MEM_freeN(md->error);
 
+	BKE_modifier_cache_free_modifier(md);
+
 	MEM_freeN(md);
 }
 
@@ -0,0 +1,471 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenkernel/intern/modifier_cache.c
+ *  \ingroup bke
+ *
+ * Cache of modifier results between evaluations of the modifier stack.
+ *
+ * Modifiers flagged with #eModifierTypeFlag_CacheResult keep a copy of their last result,
+ * along with a hash of everything the result depends on:
+ * the input geometry and its custom-data layers, the modifier settings,
+ * the object matrix, the vertex group the modifier uses and the objects it references.
+ *
+ * When the stack is re-evaluated with identical input (typically because a modifier further down
+ * the stack was changed), the copy is returned instead of running the modifier again.
+ *
+ * Memory used by the cached results is limited by #MEM_CacheLimiter
+ * (shared with the sequencer & movie clip caches), least recently used results are freed first.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+#include "MEM_CacheLimiterC-Api.h"
+
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_threads.h"
+
+#include "BKE_cdderivedmesh.h"
+#include "BKE_customdata.h"
+#include "BKE_deform.h"
+#include "BKE_DerivedMesh.h"
+#include "BKE_modifier.h"
+#include "BKE_object.h"
+
+/* -------------------------------------------------------------------- */
+/** \name Cache Storage
+ * \{ */
+
+typedef struct ModifierCacheKey {
+	const ModifierData *md;
+	bool is_orco;
+} ModifierCacheKey;
+
+typedef struct ModifierCacheItem {
+	/* first so the item can be used as its own key */
+	ModifierCacheKey key;
+
+	/* hash of the input (see #modifier_cache_hash) */
+	unsigned int hash;
+	/* element counts of the input, to make false positives even less likely */
+	int input_tot[4];
+	/* settings written by the modifier, see #modifier_cache_output_range */
+	char output[8];
+
+	DerivedMesh *dm;
+	MEM_CacheLimiterHandleC *c_handle;
+} ModifierCacheItem;
+
+static MEM_CacheLimiterC *limitor = NULL;
+static GHash *cache_hash = NULL;
+static ThreadMutex limitor_lock = BLI_MUTEX_INITIALIZER;
+
+static unsigned int modifier_cache_keyhash(const void *ptr)
+{
+	const ModifierCacheKey *key = ptr;
+	return BLI_ghashutil_ptrhash(key->md) ^ (unsigned int)key->is_orco;
+}
+
+static bool modifier_cache_keycmp(const void *a, const void *b)
+{
+	const ModifierCacheKey *key_a = a;
+	const ModifierCacheKey *key_b = b;
+	return ((key_a->md != key_b->md) || (key_a->is_orco != key_b->is_orco));
+}
+
+static void modifier_cache_item_free(ModifierCacheItem *item)
+{
+	item->dm->release(item->dm);
+	MEM_freeN(item);
+}
+
+/* called by the cache limiter (with 'limitor_lock' held). */
+static void modifier_cache_destructor(void *ptr)
+{
+	ModifierCacheItem *item = ptr;
+
+	BLI_ghash_remove(cache_hash, &item->key, NULL, NULL);
+	modifier_cache_item_free(item);
+}
+
+static size_t modifier_cache_customdata_size(const CustomData *data, int totelem)
+{
+	size_t size = 0;
+	int i;
+
+	for (i = 0; i < data->totlayer; i++) {
+		size += (size_t)CustomData_sizeof(data->layers[i].type) * (size_t)totelem;
+	}
+	return size;
+}
+
+static size_t modifier_cache_item_size(void *ptr)
+{
+	const ModifierCacheItem *item = ptr;
+	const DerivedMesh *dm = item->dm;
+
+	return (sizeof(*item) +
+	        modifier_cache_customdata_size(&dm->vertData, dm->numVertData) +
+	        modifier_cache_customdata_size(&dm->edgeData, dm->numEdgeData) +
+	        modifier_cache_customdata_size(&dm->faceData, dm->numTessFaceData) +
+	        modifier_cache_customdata_size(&dm->loopData, dm->numLoopData) +
+	        modifier_cache_customdata_size(&dm->polyData, dm->numPolyData));
+}
+
+static void modifier_cache_ensure(void)
+{
+	if (limitor == NULL) {
+		limitor = new_MEM_CacheLimiter(modifier_cache_destructor, modifier_cache_item_size);
+		cache_hash = BLI_ghash_new(modifier_cache_keyhash, modifier_cache_keycmp, __func__);
+	}
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Modifier Settings
+ * \{ */
+
+/**
+ * Members of the settings the modifier writes to when applied (shown in the interface),
+ * they aren't part of the input and are restored from the cached result.
+ */
+static void modifier_cache_output_range(const ModifierData *md, size_t *r_offset, size_t *r_size)
+{
+	switch ((ModifierType)md->type) {
+		case eModifierType_Decimate:
+			*r_offset = offsetof(DecimateModifierData, face_count);
+			*r_size = sizeof(((DecimateModifierData *)NULL)->face_count);
+			break;
+		default:
+			*r_offset = 0;
+			*r_size = 0;
+			break;
+	}
+	BLI_assert(*r_size <= sizeof(((ModifierCacheItem *)NULL)->output));
+}
+
+/* Vertex group the modifier reads weights from, found by name in the object's vertex groups. */
+static const char *modifier_cache_vgroup_name(const ModifierData *md)
+{
+	switch ((ModifierType)md->type) {
+		case eModifierType_Bevel:
+			return ((const BevelModifierData *)md)->defgrp_name;
+		case eModifierType_Decimate:
+			return ((const DecimateModifierData *)md)->defgrp_name;
+		default:
+			return NULL;
+	}
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Input Hashing
+ *
+ * Hash functions return false when the input can't be hashed reliably,
+ * in that case the result isn't cached.
+ * \{ */
+
+static void modifier_cache_hash_customdata(BLI_HashMurmur2A *mm2, const CustomData *data, int totelem)
+{
+	int i;
+
+	BLI_hash_mm2a_add_int(mm2, totelem);
+	BLI_hash_mm2a_add_int(mm2, data->totlayer);
+
+	for (i = 0; i < data->totlayer; i++) {
+		const CustomDataLayer *layer = &data->layers[i];
+
+		BLI_hash_mm2a_add_int(mm2, layer->type);
+		BLI_hash_mm2a_add_int(mm2, layer->flag & CD_FLAG_NOCOPY);
+		BLI_hash_mm2a_add(mm2, (const unsigned char *)layer->name, strlen(layer->name));
+
+		if (layer->data == NULL) {
+			continue;
+		}
+
+		if (layer->type == CD_MDEFORMVERT) {
+			/* weights are stored outside of the layer. */
+			const MDeformVert *dvert = layer->data;
+			int j;
+			for (j = 0; j < totelem; j++, dvert++) {
+				BLI_hash_mm2a_add_int(mm2, dvert->totweight);
+				if (dvert->totweight) {
+					BLI_hash_mm2a_add(
+					        mm2, (const unsigned char *)dvert->dw,
+					        sizeof(*dvert->dw) * (size_t)dvert->totweight);
+				}
+			}
+		}
+		else {
+			BLI_hash_mm2a_add(
+			        mm2, (const unsigned char *)layer->data,
+			        (size_t)CustomData_sizeof(layer->type) * (size_t)totelem);
+		}
+	}
+}
+
+static bool modifier_cache_hash_dm(BLI_HashMurmur2A *mm2, DerivedMesh *dm)
+{
+	/* other types don't store their geometry in custom-data. */
+	if (dm->type != DM_TYPE_CDDM) {
+		return false;
+	}
+
+	modifier_cache_hash_customdata(mm2, &dm->vertData, dm->numVertData);
+	modifier_cache_hash_customdata(mm2, &dm->edgeData, dm->numEdgeData);
+	modifier_cache_hash_customdata(mm2, &dm->loopData, dm->numLoopData);
+	modifier_cache_hash_customdata(mm2, &dm->polyData, dm->numPolyData);
+	return true;
+}
+
+typedef struct ObjectHashData {
+	BLI_HashMurmur2A *mm2;
+	bool is_valid;
+} ObjectHashData;
+
+static void modifier_cache_hash_object_cb(void *userData, Object *UNUSED(ob), Object **obpoin, int UNUSED(cb_flag))
+{
+	ObjectHashData *data = userData;
+	Object *ob_link = *obpoin;
+
+	if (ob_link == NULL) {
+		BLI_hash_mm2a_add_int(data->mm2, 0);
+		return;
+	}
+
+	BLI_hash_mm2a_add(data->mm2, (const unsigned char *)&ob_link, sizeof(ob_link));
+	BLI_hash_mm2a_add(data->mm2, (const unsigned char *)ob_link->obmat, sizeof(ob_link->obmat));
+
+	switch (ob_link->type) {
+		case OB_MESH:
+			if ((ob_link->derivedFinal == NULL) ||
+			    BKE_object_is_in_editmode(ob_link) ||
+			    !modifier_cache_hash_dm(data->mm2, ob_link->derivedFinal))
+			{
+				data->is_valid = false;
+			}
+			break;
+		case OB_CURVE:
+		case OB_SURF:
+		case OB_FONT:
+			/* curve geometry (path length...) may be used, don't attempt to hash it. */
+			data->is_valid = false;
+			break;
+		default:
+			/* only the transform is used. */
+			break;
+	}
+}
+
+/**
+ * \return false when the result of \a md can't be cached.
+ */
+static bool modifier_cache_hash(
+        ModifierData *md, Object *ob, DerivedMesh *dm, ModifierApplyFlag flag,
+        unsigned int *r_hash)
+{
+	const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+	const char *vgroup_name = modifier_cache_vgroup_name(md);
+	BLI_HashMurmur2A mm2;
+	size_t output_offset, output_size;
+
+	BLI_hash_mm2a_init(&mm2, (uint32_t)md->type);
+
+	/* settings, skip the generic header (name, mode, error...) and outputs */
+	modifier_cache_output_range(md, &output_offset, &output_size);
+	if (output_size == 0) {
+		output_offset = (size_t)mti->structSize;
+	}
+	BLI_hash_mm2a_add(
+	        &mm2, (const unsigned char *)(md + 1),
+	        output_offset - sizeof(ModifierData));
+	BLI_hash_mm2a_add(
+	        &mm2, (const unsigned char *)md + output_offset + output_size,
+	        (size_t)mti->structSize - (output_offset + output_size));
+	BLI_hash_mm2a_add_int(&mm2, (int)flag);
+	BLI_hash_mm2a_add(&mm2, (const unsigned char *)ob->obmat, sizeof(ob->obmat));
+
+	/* weights are stored by vertex group index. */
+	if (vgroup_name) {
+		BLI_hash_mm2a_add_int(&mm2, vgroup_name[0] ? defgroup_name_index(ob, vgroup_name) : -1);
+	}
+
+	if (mti->foreachObjectLink) {
+		ObjectHashData data = {&mm2, true};
+		mti->foreachObjectLink(md, ob, modifier_cache_hash_object_cb, &data);
+		if (data.is_valid == false) {
+			return false;
+		}
+	}
+
+	if (!modifier_cache_hash_dm(&mm2, dm)) {
+		return false;
+	}
+
+	*r_hash = BLI_hash_mm2a_end(&mm2);
+	return true;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Public API
+ * \{ */
+
+/**
+ * Same as #modwrap_applyModifier, re-using the previous result of the modifier
+ * when its input didn't change since.
+ *
+ * Only used for modifiers flagged with #eModifierTypeFlag_CacheResult, outside of rendering.
+ */
+struct DerivedMesh *modwrap_applyModifier_cached(
+        ModifierData *md, Object *ob,
+        struct DerivedMesh *dm,
+        ModifierApplyFlag flag)
+{
+	const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+	ModifierCacheItem *item;
+	ModifierCacheKey key;
+	DerivedMesh *ndm;
+	unsigned int hash;
+	const int input_tot[4] = {dm->numVertData, dm->numEdgeData, dm->numLoopData, dm->numPolyData};
+	size_t output_offset, output_size;
+
+	if (((mti->flags & eModifierTypeFlag_CacheResult) == 0) ||
+	    (flag & MOD_APPLY_RENDER) ||
+	    (mti->dependsOnTime && mti->dependsOnTime(md)) ||
+	    !modifier_cache_hash(md, ob, dm, flag, &hash))
+	{
+		return modwrap_applyModifier(md, ob, dm, flag);
+	}
+
+	modifier_cache_output_range(md, &output_offset, &output_size);
+
+	key.md = md;
+	key.is_orco = (flag & MOD_APPLY_ORCO) != 0;
+
+	BLI_mutex_lock(&limitor_lock);
+	item = cache_hash ? BLI_ghash_lookup(cache_hash, &key) : NULL;
+	if (item && (item->hash == hash) && (memcmp(item->input_tot, input_tot, sizeof(input_tot)) == 0)) {
+		/* hit, keep it alive while copying outside the lock. */
+		MEM_CacheLimiter_touch(item->c_handle);
+		MEM_CacheLimiter_ref(item->c_handle);
+		BLI_mutex_unlock(&limitor_lock);
+
+		memcpy((char *)md + output_offset, item->output, output_size);
+		ndm = CDDM_copy(item->dm);
+
+		BLI_mutex_lock(&limitor_lock);
+		MEM_CacheLimiter_unref(item->c_handle);
+		BLI_mutex_unlock(&limitor_lock);
+		return ndm;
+	}
+	BLI_mutex_unlock(&limitor_lock);
+
+	ndm = modwrap_applyModifier(md, ob, dm, flag);
+
+	/* errors are reported while applying, don't hide them behind a cached result. */
+	if ((ndm == NULL) || (ndm == dm) || (ndm->type != DM_TYPE_CDDM) || md->error) {
+		return ndm;
+	}
+
+	item = MEM_mallocN(sizeof(*item), __func__);
+	item->key = key;
+	item->hash = hash;
+	memcpy(item->input_tot, input_tot, sizeof(input_tot));
+	memcpy(item->output, (const char *)md + output_offset, output_size);
+	item->dm = CDDM_copy(ndm);
+
+	BLI_mutex_lock(&limitor_lock);
+	modifier_cache_ensure();
+	{
+		ModifierCacheItem **item_p;
+		if (BLI_ghash_ensure_p(cache_hash, &item->key, (void ***)&item_p)) {
+			MEM_CacheLimiter_unmanage((*item_p)->c_handle);
+			modifier_cache_item_free(*item_p);
+		}
+		*item_p = item;
+	}
+	item->c_handle = MEM_CacheLimiter_insert(limitor, item);
+
+	MEM_CacheLimiter_ref(item->c_handle);
+	MEM_CacheLimiter_enforce_limits(limitor);
+	MEM_CacheLimiter_unref(item->c_handle);
+	BLI_mutex_unlock(&limitor_lock);
+
+	return ndm;
+}
+
+/**
+ * Free cached results of \a md, called when the modifier is freed.
+ */
+void BKE_modifier_cache_free_modifier(ModifierData *md)
+{
+	ModifierCacheKey key;
+	int i;
+
+	if (cache_hash == NULL) {
+		return;
+	}
+
+	key.md = md;
+
+	BLI_mutex_lock(&limitor_lock);
+	for (i = 0; i < 2; i++) {
+		ModifierCacheItem *item;
+		key.is_orco = (i != 0);
+		item = BLI_ghash_popkey(cache_hash, &key, NULL);
+		if (item) {
+			MEM_CacheLimiter_unmanage(item->c_handle);
+			modifier_cache_item_free(item);
+		}
+	}
+	BLI_mutex_unlock(&limitor_lock);
+}
+
+void BKE_modifier_cache_exit(void)
+{
+	if (limitor) {
+		GHashIterator gh_iter;
+
+		GHASH_ITER (gh_iter, cache_hash) {
+			ModifierCacheItem *item = BLI_ghashIterator_getValue(&gh_iter);
+			MEM_CacheLimiter_unmanage(item->c_handle);
+			modifier_cache_item_free(item);
+		}
+		BLI_ghash_free(cache_hash, NULL, NULL);
+		cache_hash = NULL;
+
+		delete_MEM_CacheLimiter(limitor);
+		limitor = NULL;
+	}
+}
+
+/** \} */
@@ -93,6 +93,8 @@ typedef struct CurveCache {
 	ListBase bev;
 	ListBase deformed_nurbs;
 	struct Path *path;
+	/* the bevel lists of the splines, kept when the rest is cleared */
+	struct BevelListCache *bev_cache;
 } CurveCache;
 
 /* Vertex parent modifies original BMesh which is not safe for threading.
@@ -128,6 +130,11 @@ ListBase *BKE_object_curve_bevlist(struct Object *ob)
 	return &(object_curve_cache(ob)->bev);
 }
 
+struct BevelListCache **BKE_object_curve_bevlist_cache(struct Object *ob)
+{
+	return &(object_curve_cache(ob)->bev_cache);
+}
+
 ListBase *BKE_object_curve_deformed_nurbs(struct Object *ob)
 {
 	return &(object_curve_cache(ob)->deformed_nurbs);
@@ -215,6 +222,9 @@ void BKE_object_free_curve_cache(Object *ob)
 {
 	if (ob->curve_cache) {
 		BKE_object_clear_curve_cache(ob);
+		if (ob->curve_cache->bev_cache) {
+			BKE_curve_bevelList_cache_free(ob->curve_cache->bev_cache);
+		}
 		MEM_freeN(ob->curve_cache);
 		ob->curve_cache = NULL;
 	}
@@ -21,6 +21,7 @@
  *  \ingroup bke
  */
 
+#include <limits.h> /* INT_MAX */
 #include <stdlib.h> /* abort */
 #include <string.h> /* strstr */
 #include <sys/types.h>
@@ -156,6 +157,7 @@ static void txt_undo_add_blockop(Text *text, TextUndoBuf *utxt, int op, const ch
 static void txt_delete_line(Text *text, TextLine *line);
 static void txt_delete_sel(Text *text, TextUndoBuf *utxt);
 static void txt_make_dirty(Text *text);
+static void txt_line_index_free(Text *text);
 
 /***/
 
@@ -181,6 +183,7 @@ void BKE_text_free_lines(Text *text)
 	}
 
 	BLI_listbase_clear(&text->lines);
+	txt_line_index_free(text);
 
 	text->curl = text->sell = NULL;
 }
@@ -288,16 +291,28 @@ int txt_extended_ascii_as_utf8(char **str)
 
 static void cleanup_textline(TextLine *tl)
 {
-	int i;
+	char *line = tl->line;
+	bool is_ascii = true;
+	int i, len = 0;
 
+	/* single pass, large generated files can have control characters on every line */
 	for (i = 0; i < tl->len; i++) {
-		if (tl->line[i] < ' ' && tl->line[i] != '\t') {
-			memmove(tl->line + i, tl->line + i + 1, tl->len - i);
-			tl->len--;
-			i--;
+		const char c = line[i];
+		if (c < ' ' && c != '\t') {
+			continue;
 		}
+		if ((unsigned char)c & 0x80) {
+			is_ascii = false;
+		}
+		line[len++] = c;
+	}
+	line[len] = '\0';
+	tl->len = len;
+
+	/* plain ascii is always valid utf-8, skip the validation */
+	if (!is_ascii) {
+		tl->len += txt_extended_ascii_as_utf8(&tl->line);
 	}
-	tl->len += txt_extended_ascii_as_utf8(&tl->line);
 }
 
 /**
@@ -474,6 +489,7 @@ void BKE_text_copy_data(Main *UNUSED(bmain), Text *ta_dst, const Text *ta_src, c
 	BLI_listbase_clear(&ta_dst->lines);
 	ta_dst->curl = ta_dst->sell = NULL;
 	ta_dst->compiled = NULL;
+	ta_dst->line_index = NULL;
 
 	/* Walk down, reconstructing */
 	for (TextLine *line_src = ta_src->lines.first; line_src; line_src = line_src->next) {
@@ -639,6 +655,7 @@ void txt_clean_text(Text *text)
 	if (!text->lines.first) {
 		if (text->lines.last) text->lines.first = text->lines.last;
 		else text->lines.first = text->lines.last = txt_new_line(NULL);
+		txt_line_index_free(text);
 	}
 
 	if (!text->lines.last) text->lines.last = text->lines.first;
@@ -661,34 +678,233 @@ void txt_clean_text(Text *text)
 	}
 }
 
+/**
+ * Number of lines from \a from to \a to, negative when \a to comes first.
+ *
+ * Walks both directions at once so the cost depends on the distance between the lines,
+ * not on the size of the text. For positions relative to the start of the text
+ * use #txt_get_line_index instead.
+ */
 int txt_get_span(TextLine *from, TextLine *to)
 {
+	TextLine *fwd = from, *bwd = from;
 	int ret = 0;
-	TextLine *tmp = from;
 
 	if (!to || !from) return 0;
 	if (from == to) return 0;
 
-	/* Look forwards */
-	while (tmp) {
-		if (tmp == to) return ret;
+	while (fwd || bwd) {
 		ret++;
-		tmp = tmp->next;
+		if (fwd) {
+			fwd = fwd->next;
+			if (fwd == to) return ret;
+		}
+		if (bwd) {
+			bwd = bwd->prev;
+			if (bwd == to) return -ret;
+		}
+	}
+
+	return 0;
+}
+
+/*****************************/
+/* Line index functions      */
+/*****************************/
+
+/* Lookup table between line indices and lines, so jumping to a line, storing undo positions
+ * and drawing don't have to walk the whole list (noticeable with files of millions of lines).
+ *
+ * The table is built on first access and kept up to date for single line edits,
+ * bulk edits free it so it's rebuilt on next access. */
+
+typedef struct TextLineIndexItem {
+	const TextLine *line;
+	int index;
+} TextLineIndexItem;
+
+typedef struct TextLineIndex {
+	/* lines in list order */
+	TextLine **lines;
+	/* the same lines sorted by address, for line to index lookups */
+	TextLineIndexItem *items;
+	int lines_len, lines_alloc;
+} TextLineIndex;
+
+static int txt_line_index_item_cmp(const void *a, const void *b)
+{
+	const uintptr_t line_a = (uintptr_t)((const TextLineIndexItem *)a)->line;
+	const uintptr_t line_b = (uintptr_t)((const TextLineIndexItem *)b)->line;
+
+	if (line_a < line_b) return -1;
+	if (line_a > line_b) return 1;
+	return 0;
+}
+
+static TextLineIndex *txt_line_index_ensure(Text *text)
+{
+	TextLineIndex *tli = text->line_index;
+	TextLine *line;
+	int i;
+
+	if (tli) {
+		return tli;
+	}
+
+	tli = MEM_mallocN(sizeof(*tli), __func__);
+	tli->lines_len = BLI_listbase_count(&text->lines);
+	tli->lines_alloc = MAX2(tli->lines_len, 1);
+	tli->lines = MEM_mallocN(sizeof(*tli->lines) * tli->lines_alloc, __func__);
+	tli->items = MEM_mallocN(sizeof(*tli->items) * tli->lines_alloc, __func__);
+
+	for (line = text->lines.first, i = 0; line; line = line->next, i++) {
+		tli->lines[i] = line;
+		tli->items[i].line = line;
+		tli->items[i].index = i;
+	}
+
+	qsort(tli->items, tli->lines_len, sizeof(*tli->items), txt_line_index_item_cmp);
+
+	text->line_index = tli;
+	return tli;
+}
+
+static void txt_line_index_free(Text *text)
+{
+	TextLineIndex *tli = text->line_index;
+
+	if (tli) {
+		MEM_freeN(tli->lines);
+		MEM_freeN(tli->items);
+		MEM_freeN(tli);
+		text->line_index = NULL;
+	}
+}
+
+/* Adding or removing lines updates the index in linear time,
+ * past this many lines rebuilding it on next access is cheaper. */
+#define TXT_LINE_INDEX_EDIT_MAX 16
+
+static void txt_line_index_edit_begin(Text *text, int lines_num)
+{
+	if (lines_num > TXT_LINE_INDEX_EDIT_MAX) {
+		txt_line_index_free(text);
+	}
+}
+
+/* position of the first item with an address not below \a line */
+static int txt_line_index_item_find(const TextLineIndex *tli, const TextLine *line)
+{
+	int lo = 0, hi = tli->lines_len;
+
+	while (lo < hi) {
+		const int mid = (lo + hi) / 2;
+		if ((uintptr_t)tli->items[mid].line < (uintptr_t)line) lo = mid + 1;
+		else hi = mid;
 	}
 
-	/* Look backwards */
-	if (!tmp) {
-		tmp = from;
-		ret = 0;
-		while (tmp) {
-			if (tmp == to) break;
-			ret--;
-			tmp = tmp->prev;
+	return lo;
+}
+
+/* call after \a line has been linked into the list */
+static void txt_line_index_insert(Text *text, TextLine *line)
+{
+	TextLineIndex *tli = text->line_index;
+	int index, item, i;
+
+	if (tli == NULL) {
+		return;
+	}
+
+	index = line->prev ? txt_get_line_index(text, line->prev) + 1 : 0;
+
+	if (tli->lines_len == tli->lines_alloc) {
+		tli->lines_alloc *= 2;
+		tli->lines = MEM_reallocN(tli->lines, sizeof(*tli->lines) * tli->lines_alloc);
+		tli->items = MEM_reallocN(tli->items, sizeof(*tli->items) * tli->lines_alloc);
+	}
+
+	memmove(&tli->lines[index + 1], &tli->lines[index], sizeof(*tli->lines) * (tli->lines_len - index));
+	tli->lines[index] = line;
+
+	for (i = 0; i < tli->lines_len; i++) {
+		if (tli->items[i].index >= index) {
+			tli->items[i].index++;
+		}
+	}
+
+	item = txt_line_index_item_find(tli, line);
+	memmove(&tli->items[item + 1], &tli->items[item], sizeof(*tli->items) * (tli->lines_len - item));
+	tli->items[item].line = line;
+	tli->items[item].index = index;
+
+	tli->lines_len++;
+}
+
+/* call before \a line is removed from the list */
+static void txt_line_index_remove(Text *text, TextLine *line)
+{
+	TextLineIndex *tli = text->line_index;
+	int index, item, i;
+
+	if (tli == NULL) {
+		return;
+	}
+
+	item = txt_line_index_item_find(tli, line);
+	if (item == tli->lines_len || tli->items[item].line != line) {
+		BLI_assert(0);
+		txt_line_index_free(text);
+		return;
+	}
+
+	index = tli->items[item].index;
+	tli->lines_len--;
+
+	memmove(&tli->items[item], &tli->items[item + 1], sizeof(*tli->items) * (tli->lines_len - item));
+	memmove(&tli->lines[index], &tli->lines[index + 1], sizeof(*tli->lines) * (tli->lines_len - index));
+
+	for (i = 0; i < tli->lines_len; i++) {
+		if (tli->items[i].index > index) {
+			tli->items[i].index--;
 		}
-		if (!tmp) ret = 0;
 	}
+}
+
+/**
+ * Index of \a line from the start of the text (same as `txt_get_span(text->lines.first, line)`),
+ * zero when the line isn't part of the text.
+ */
+int txt_get_line_index(Text *text, const TextLine *line)
+{
+	const TextLineIndex *tli;
+	int item;
 
-	return ret;
+	if (line == NULL) {
+		return 0;
+	}
+
+	tli = txt_line_index_ensure(text);
+	item = txt_line_index_item_find(tli, line);
+	if (item != tli->lines_len && tli->items[item].line == line) {
+		return tli->items[item].index;
+	}
+
+	return 0;
+}
+
+/**
+ * Line at \a index from the start of the text, NULL when out of range.
+ */
+TextLine *txt_get_line_from_index(Text *text, int index)
+{
+	const TextLineIndex *tli = txt_line_index_ensure(text);
+
+	if (index < 0 || index >= tli->lines_len) {
+		return NULL;
+	}
+
+	return tli->lines[index];
 }
 
 static void txt_make_dirty(Text *text)
@@ -1023,16 +1239,14 @@ void txt_move_to(Text *text, unsigned int line, unsigned int ch, const bool sel)
 {
 	TextLine **linep;
 	int *charp;
-	unsigned int i;
 
 	if (sel) txt_curs_sel(text, &linep, &charp);
 	else txt_curs_cur(text, &linep, &charp);
 	if (!*linep) return;
 
-	*linep = text->lines.first;
-	for (i = 0; i < line; i++) {
-		if ((*linep)->next) *linep = (*linep)->next;
-		else break;
+	*linep = txt_get_line_from_index(text, (int)MIN2(line, (unsigned int)INT_MAX));
+	if (*linep == NULL) {
+		*linep = text->lines.last;
 	}
 	if (ch > (unsigned int)((*linep)->len))
 		ch = (unsigned int)((*linep)->len);
@@ -1140,6 +1354,8 @@ static void txt_delete_sel(Text *text, TextUndoBuf *utxt)
 
 	make_new_line(text->curl, buf);
 
+	txt_line_index_edit_begin(text, txt_get_span(text->curl, text->sell));
+
 	tmpl = text->sell;
 	while (tmpl != text->curl) {
 		tmpl = tmpl->prev;
@@ -1279,7 +1495,7 @@ int txt_find_string(Text *text, const char *findstr, int wrap, int match_case)
 	}
 
 	if (s) {
-		int newl = txt_get_span(text->lines.first, tl);
+		int newl = txt_get_line_index(text, tl);
 		int newc = (int)(s - tl->line);
 		txt_move_to(text, newl, newc, 0);
 		txt_move_to(text, newl, newc + strlen(findstr), 1);
@@ -1396,6 +1612,12 @@ void txt_insert_buf(Text *text, TextUndoBuf *utxt, const char *in_buffer)
 	}
 
 	if (buffer[i] == '\n') {
+		int lines_num = 0;
+		for (j = i; buffer[j] && lines_num <= TXT_LINE_INDEX_EDIT_MAX; j++) {
+			lines_num += (buffer[j] == '\n');
+		}
+		txt_line_index_edit_begin(text, lines_num);
+
 		txt_split_curline(text, utxt);
 		i++;
 
@@ -1410,6 +1632,7 @@ void txt_insert_buf(Text *text, TextUndoBuf *utxt, const char *in_buffer)
 			if (buffer[i] == '\n') {
 				add = txt_new_linen(buffer + (i - l), l);
 				BLI_insertlinkbefore(&text->lines, text->curl, add);
+				txt_line_index_insert(text, add);
 				i++;
 			}
 			else {
@@ -1655,14 +1878,14 @@ static void txt_undo_store_uint32(char *undo_buf, int *undo_pos, unsigned int va
 static void txt_undo_store_cur(Text *text, TextUndoBuf *utxt)
 {
 	txt_undo_store_uint16(utxt->buf, &utxt->pos, text->curc);
-	txt_undo_store_uint32(utxt->buf, &utxt->pos, txt_get_span(text->lines.first, text->curl));
+	txt_undo_store_uint32(utxt->buf, &utxt->pos, txt_get_line_index(text, text->curl));
 }
 
 /* store the sel cursor to the undo buffer (6 bytes) */
 static void txt_undo_store_sel(Text *text, TextUndoBuf *utxt)
 {
 	txt_undo_store_uint16(utxt->buf, &utxt->pos, text->selc);
-	txt_undo_store_uint32(utxt->buf, &utxt->pos, txt_get_span(text->lines.first, text->sell));
+	txt_undo_store_uint32(utxt->buf, &utxt->pos, txt_get_line_index(text, text->sell));
 }
 
 /* store both cursors to the undo buffer (12 bytes) */
@@ -2422,6 +2645,7 @@ void txt_split_curline(Text *text, TextUndoBuf *utxt)
 	text->curl->len = text->curl->len - text->curc;
 
 	BLI_insertlinkbefore(&text->lines, text->curl, ins);
+	txt_line_index_insert(text, ins);
 
 	text->curc = 0;
 
@@ -2435,6 +2659,7 @@ static void txt_delete_line(Text *text, TextLine *line)
 {
 	if (!text->curl) return;
 
+	txt_line_index_remove(text, line);
 	BLI_remlink(&text->lines, line);
 
 	if (line->line) MEM_freeN(line->line);
@@ -2477,6 +2702,7 @@ void txt_duplicate_line(Text *text, TextUndoBuf *utxt)
 	if (text->curl == text->sell) {
 		textline = txt_new_line(text->curl->line);
 		BLI_insertlinkafter(&text->lines, text->curl, textline);
+		txt_line_index_insert(text, textline);
 
 		txt_make_dirty(text);
 		txt_clean_text(text);
@@ -2781,7 +3007,7 @@ static void txt_select_unprefix(
 	*r_line_index_mask_len = 0;
 
 	if (!undoing) {
-		curl_span_init = txt_get_span(text->lines.first, text->curl);
+		curl_span_init = txt_get_line_index(text, text->curl);
 	}
 
 	while (true) {
@@ -2798,7 +3024,7 @@ static void txt_select_unprefix(
 				/* Create list element for 0 indent line */
 				struct LinkInt *idata = MEM_mallocN(sizeof(struct LinkInt), __func__);
 				idata->value = curl_span_init + num;
-				BLI_assert(idata->value == txt_get_span(text->lines.first, text->curl));
+				BLI_assert(idata->value == txt_get_line_index(text, text->curl));
 				BLI_addtail(r_line_index_mask, idata);
 				(*r_line_index_mask_len) += 1;
 			}
@@ -2913,6 +3139,7 @@ void txt_move_lines(struct Text *text, TextUndoBuf *utxt, const int direction)
 
 	if (!line_other) return;
 
+	txt_line_index_remove(text, line_other);
 	BLI_remlink(&text->lines, line_other);
 
 	if (direction == TXT_MOVE_LINE_DOWN) {
@@ -2921,6 +3148,7 @@ void txt_move_lines(struct Text *text, TextUndoBuf *utxt, const int direction)
 	else {
 		BLI_insertlinkafter(&text->lines, text->sell, line_other);
 	}
+	txt_line_index_insert(text, line_other);
 
 	txt_make_dirty(text);
 	txt_clean_text(text);
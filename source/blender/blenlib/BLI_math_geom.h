@@ -84,6 +84,11 @@ bool is_poly_convex_v2(const float verts[][2], unsigned int nr);
 int  is_quad_flip_v3(const float v1[3], const float v2[3], const float v3[3], const float v4[3]);
 bool is_quad_flip_v3_first_third_fast(const float v0[3], const float v1[3], const float v2[3], const float v3[3]);
 
+/********************************* Orientation **********************************/
+
+int orient2d_exact_v2(const float a[2], const float b[2], const float c[2]);
+int orient3d_exact_v3(const float a[3], const float b[3], const float c[3], const float d[3]);
+
 /********************************* Distance **********************************/
 
 float dist_squared_to_line_v2(const float p[2], const float l1[2], const float l2[2]);
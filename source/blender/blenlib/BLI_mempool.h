@@ -76,6 +76,12 @@ enum {
 	 * \note order of iteration is only assured to be the order of allocation when no chunks have been freed.
 	 */
 	BLI_MEMPOOL_ALLOW_ITER = (1 << 0),
+	/** allow allocating and freeing from multiple threads at once, through #BLI_mempool_local.
+	 *
+	 * \note when elements are allocated from multiple threads,
+	 * iteration order no longer matches the order of allocation.
+	 */
+	BLI_MEMPOOL_ALLOW_THREADS = (1 << 1),
 };
 
 void  BLI_mempool_iternew(BLI_mempool *pool, BLI_mempool_iter *iter) ATTR_NONNULL();
@@ -84,6 +90,25 @@ void *BLI_mempool_iterstep(BLI_mempool_iter *iter) ATTR_WARN_UNUSED_RESULT ATTR_
 BLI_mempool_iter *BLI_mempool_iter_threadsafe_create(BLI_mempool *pool, const size_t num_iter) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 void  BLI_mempool_iter_threadsafe_free(BLI_mempool_iter *iter_arr) ATTR_NONNULL();
 
+/**
+ * Thread-local allocator, see #BLI_mempool_local_init.
+ *
+ * While any #BLI_mempool_local is in use, the pool must not be used directly
+ * (#BLI_mempool_alloc, #BLI_mempool_free, iteration...).
+ */
+typedef struct BLI_mempool_local {
+	BLI_mempool *pool;
+	struct BLI_freenode *free;
+	/* elements allocated minus elements freed, applied to the pool on finalize */
+	int totused_delta;
+} BLI_mempool_local;
+
+void  BLI_mempool_local_init(BLI_mempool *pool, BLI_mempool_local *local) ATTR_NONNULL();
+void *BLI_mempool_local_alloc(BLI_mempool_local *local) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void *BLI_mempool_local_calloc(BLI_mempool_local *local) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void  BLI_mempool_local_free(BLI_mempool_local *local, void *addr) ATTR_NONNULL(1, 2);
+void  BLI_mempool_local_finalize(BLI_mempool_local *local) ATTR_NONNULL();
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,204 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#ifndef __BLI_OHASH_H__
+#define __BLI_OHASH_H__
+
+/** \file BLI_ohash.h
+ *  \ingroup bli
+ *
+ * OHash is an open-addressing hash-map (unordered key, value pairs),
+ * with the same API as #GHash.
+ *
+ * Keys, values and hashes are stored inline in flat arrays, so a lookup
+ * does not need to chase a pointer per entry. Prefer it over #GHash for hot maps
+ * with cheap hash/compare callbacks (pointers, integers...).
+ *
+ * \note Removing entries while iterating is not supported (except through #BLI_ohash_pop).
+ */
+
+#include "BLI_ghash.h"  /* for callback types */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct OHash OHash;
+
+typedef struct OHashIterator {
+	OHash *oh;
+	void *curr_key;
+	void **curr_val_p;
+	unsigned int curr_slot;
+	unsigned int slots_len;
+} OHashIterator;
+
+typedef struct OHashIterState {
+	unsigned int curr_slot;
+} OHashIterState;
+
+/** \name OHash API
+ *
+ * Defined in ``BLI_ohash.c``
+ * \{ */
+
+OHash *BLI_ohash_new_ex(
+        GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+        const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_new(
+        GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_copy(
+        OHash *oh, GHashKeyCopyFP keycopyfp,
+        GHashValCopyFP valcopyfp) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void   BLI_ohash_free(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_ohash_reserve(OHash *oh, const unsigned int nentries_reserve);
+void   BLI_ohash_insert(OHash *oh, void *key, void *val);
+bool   BLI_ohash_reinsert(OHash *oh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void  *BLI_ohash_lookup(OHash *oh, const void *key) ATTR_WARN_UNUSED_RESULT;
+void  *BLI_ohash_lookup_default(OHash *oh, const void *key, void *val_default) ATTR_WARN_UNUSED_RESULT;
+void **BLI_ohash_lookup_p(OHash *oh, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_ohash_ensure_p(OHash *oh, void *key, void ***r_val) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_ohash_remove(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_ohash_clear(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_ohash_clear_ex(
+        OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+        const unsigned int nentries_reserve);
+void  *BLI_ohash_popkey(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_ohash_haskey(OHash *oh, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_ohash_pop(OHash *oh, OHashIterState *state, void **r_key, void **r_val) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
+unsigned int BLI_ohash_len(OHash *oh) ATTR_WARN_UNUSED_RESULT;
+
+OHash *BLI_ohash_ptr_new_ex(
+        const char *info,
+        const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_ptr_new(
+        const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_str_new_ex(
+        const char *info,
+        const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_str_new(
+        const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_int_new_ex(
+        const char *info,
+        const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_int_new(
+        const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/** \} */
+
+/** \name OHash Iterator
+ * \{ */
+
+void BLI_ohashIterator_init(OHashIterator *ohi, OHash *oh);
+void BLI_ohashIterator_step(OHashIterator *ohi);
+
+BLI_INLINE void  *BLI_ohashIterator_getKey(OHashIterator *ohi)     { return ohi->curr_key; }
+BLI_INLINE void  *BLI_ohashIterator_getValue(OHashIterator *ohi)   { return *ohi->curr_val_p; }
+BLI_INLINE void **BLI_ohashIterator_getValue_p(OHashIterator *ohi) { return ohi->curr_val_p; }
+BLI_INLINE bool   BLI_ohashIterator_done(OHashIterator *ohi)       { return ohi->curr_slot >= ohi->slots_len; }
+
+#define OHASH_ITER(oh_iter_, ohash_) \
+	for (BLI_ohashIterator_init(&oh_iter_, ohash_); \
+	     BLI_ohashIterator_done(&oh_iter_) == false; \
+	     BLI_ohashIterator_step(&oh_iter_))
+
+/** \} */
+
+/** \name OSet API
+ * A 'set' implementation using open-addressing, see #GSet.
+ *
+ * Internally this is an 'OHash' without any value storage.
+ * \{ */
+
+typedef struct OSet OSet;
+
+typedef OHashIterState OSetIterState;
+
+OSet  *BLI_oset_new_ex(
+        GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+        const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet  *BLI_oset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet  *BLI_oset_copy(OSet *os, GSetKeyCopyFP keycopyfp) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+unsigned int BLI_oset_len(OSet *os) ATTR_WARN_UNUSED_RESULT;
+void   BLI_oset_free(OSet *os, GSetKeyFreeFP keyfreefp);
+void   BLI_oset_reserve(OSet *os, const unsigned int nentries_reserve);
+void   BLI_oset_insert(OSet *os, void *key);
+bool   BLI_oset_add(OSet *os, void *key);
+bool   BLI_oset_haskey(OSet *os, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_oset_pop(OSet *os, OSetIterState *state, void **r_key) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
+bool   BLI_oset_remove(OSet *os, const void *key, GSetKeyFreeFP keyfreefp);
+void   BLI_oset_clear_ex(OSet *os, GSetKeyFreeFP keyfreefp, const unsigned int nentries_reserve);
+void   BLI_oset_clear(OSet *os, GSetKeyFreeFP keyfreefp);
+
+/* When set's are used for key & value. */
+void  *BLI_oset_lookup(OSet *os, const void *key) ATTR_WARN_UNUSED_RESULT;
+
+OSet *BLI_oset_ptr_new_ex(
+        const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet *BLI_oset_ptr_new(
+        const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet *BLI_oset_str_new_ex(
+        const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet *BLI_oset_str_new(
+        const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/** \} */
+
+/** \name OSet Iterator
+ * \{ */
+
+typedef struct OSetIterator {
+	OHashIterator _ohi
+#ifdef __GNUC__
+	__attribute__ ((deprecated))
+#endif
+	;
+} OSetIterator;
+
+BLI_INLINE void BLI_osetIterator_init(OSetIterator *osi, OSet *os) { BLI_ohashIterator_init((OHashIterator *)osi, (OHash *)os); }
+BLI_INLINE void *BLI_osetIterator_getKey(OSetIterator *osi) { return BLI_ohashIterator_getKey((OHashIterator *)osi); }
+BLI_INLINE void BLI_osetIterator_step(OSetIterator *osi) { BLI_ohashIterator_step((OHashIterator *)osi); }
+BLI_INLINE bool BLI_osetIterator_done(OSetIterator *osi) { return BLI_ohashIterator_done((OHashIterator *)osi); }
+
+#define OSET_ITER(os_iter_, oset_) \
+	for (BLI_osetIterator_init(&os_iter_, oset_); \
+	     BLI_osetIterator_done(&os_iter_) == false; \
+	     BLI_osetIterator_step(&os_iter_))
+
+/** \} */
+
+/** \name OHash/OSet Debugging API's
+ * \{ */
+
+/* For testing, debugging only */
+#ifdef GHASH_INTERNAL_API
+double BLI_ohash_calc_quality_ex(
+        OHash *oh, double *r_load, double *r_mean_probe_len, unsigned int *r_max_probe_len);
+double BLI_oset_calc_quality_ex(
+        OSet *os, double *r_load, double *r_mean_probe_len, unsigned int *r_max_probe_len);
+#endif  /* GHASH_INTERNAL_API */
+
+/** \} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_OHASH_H__ */
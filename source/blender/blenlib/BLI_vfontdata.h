@@ -47,6 +47,7 @@ VFontData *BLI_vfontdata_from_freetypefont(struct PackedFile *pf);
 VFontData *BLI_vfontdata_copy(const VFontData *vfont_src, const int flag);
 
 VChar *BLI_vfontchar_from_freetypefont(struct VFont *vfont, unsigned long character);
+void BLI_vfontchars_from_freetypefont(struct VFont *vfont, const unsigned int *characters, const int characters_len);
 VChar *BLI_vfontchar_copy(const VChar *vchar_src, const int flag);
 
 #endif
@@ -28,6 +28,8 @@
  * - Freeing chunks.
  * - Iterating over allocated chunks
  *   (optionally when using the #BLI_MEMPOOL_ALLOW_ITER flag).
+ * - Allocating from multiple threads through #BLI_mempool_local
+ *   (optionally when using the #BLI_MEMPOOL_ALLOW_THREADS flag).
  */
 
 #include <string.h>
@@ -133,6 +135,10 @@ struct BLI_mempool {
 #ifdef USE_TOTALLOC
 	uint totalloc;          /* number of elements allocated in total */
 #endif
+
+	/* only used with BLI_MEMPOOL_ALLOW_THREADS, see #mempool_lock,
+	 * protects 'chunks', 'chunk_tail', 'free' & 'totused' while there are #BLI_mempool_local users */
+	uint32_t lock;
 };
 
 #define MEMPOOL_ELEM_SIZE_MIN (sizeof(void *) * 2)
@@ -328,6 +334,8 @@ BLI_mempool *BLI_mempool_create(uint esize, uint totelem,
 #endif
 	pool->totused = 0;
 
+	pool->lock = 0;
+
 	if (totelem) {
 		/* allocate the actual chunks */
 		for (i = 0; i < maxchunks; i++) {
@@ -770,6 +778,206 @@ void BLI_mempool_destroy(BLI_mempool *pool)
 	MEM_freeN(pool);
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Thread-Local Allocation
+ *
+ * Each #BLI_mempool_local keeps its own free list, so allocating and freeing
+ * elements doesn't touch the pool at all. When the local free list runs out,
+ * it's refilled with (up to) a chunk worth of elements, either taken from the pool's free list
+ * or from a new chunk, which is allocated and initialized outside the lock.
+ *
+ * \{ */
+
+/* This file is also built into makesdna/makesrna without the rest of blenlib (threads.c),
+ * so a minimal spin lock on top of atomics is used instead of #SpinLock. */
+BLI_INLINE void mempool_lock(BLI_mempool *pool)
+{
+	while (atomic_cas_uint32(&pool->lock, 0, 1) != 0) {
+		/* pass */
+	}
+}
+
+BLI_INLINE void mempool_unlock(BLI_mempool *pool)
+{
+	atomic_cas_uint32(&pool->lock, 1, 0);
+}
+
+/**
+ * Refill the (empty) local free list, the only place a #BLI_mempool_local accesses the pool
+ * (besides #BLI_mempool_local_finalize).
+ */
+static void mempool_local_refill(BLI_mempool_local *local)
+{
+	BLI_mempool *pool = local->pool;
+	const uint esize = pool->esize;
+	BLI_mempool_chunk *mpchunk;
+	BLI_freenode *curnode;
+	uint j;
+
+	BLI_assert(local->free == NULL);
+
+	/* re-use elements the pool already has free. */
+	mempool_lock(pool);
+	if (pool->free) {
+		curnode = local->free = pool->free;
+		for (j = pool->pchunk; (--j != 0) && curnode->next; curnode = curnode->next) {
+			/* pass */
+		}
+		pool->free = curnode->next;
+		curnode->next = NULL;
+		mempool_unlock(pool);
+		return;
+	}
+	mempool_unlock(pool);
+
+	/* need to allocate a new chunk, the free list is built without holding the lock. */
+	mpchunk = mempool_chunk_alloc(pool);
+	mpchunk->next = NULL;
+
+	curnode = local->free = CHUNK_DATA(mpchunk);
+	j = pool->pchunk;
+	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		while (j--) {
+			curnode->next = NODE_STEP_NEXT(curnode);
+			curnode->freeword = FREEWORD;
+			curnode = curnode->next;
+		}
+	}
+	else {
+		while (j--) {
+			curnode->next = NODE_STEP_NEXT(curnode);
+			curnode = curnode->next;
+		}
+	}
+	curnode = NODE_STEP_PREV(curnode);
+	curnode->next = NULL;
+
+	mempool_lock(pool);
+	if (pool->chunk_tail) {
+		pool->chunk_tail->next = mpchunk;
+	}
+	else {
+		BLI_assert(pool->chunks == NULL);
+		pool->chunks = mpchunk;
+	}
+	pool->chunk_tail = mpchunk;
+#ifdef USE_TOTALLOC
+	pool->totalloc += pool->pchunk;
+#endif
+	mempool_unlock(pool);
+}
+
+/**
+ * Initialize a thread-local allocator for \a pool, \a BLI_MEMPOOL_ALLOW_THREADS flag must be set.
+ *
+ * Each thread should have its own, and must call #BLI_mempool_local_finalize once done.
+ */
+void BLI_mempool_local_init(BLI_mempool *pool, BLI_mempool_local *local)
+{
+	BLI_assert(pool->flag & BLI_MEMPOOL_ALLOW_THREADS);
+
+	local->pool = pool;
+	local->free = NULL;
+	local->totused_delta = 0;
+}
+
+void *BLI_mempool_local_alloc(BLI_mempool_local *local)
+{
+	BLI_freenode *free_pop;
+
+	if (UNLIKELY(local->free == NULL)) {
+		mempool_local_refill(local);
+	}
+
+	free_pop = local->free;
+
+	if (local->pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		free_pop->freeword = USEDWORD;
+	}
+
+	local->free = free_pop->next;
+	local->totused_delta++;
+
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_ALLOC(local->pool, free_pop, local->pool->esize);
+#endif
+
+	return (void *)free_pop;
+}
+
+void *BLI_mempool_local_calloc(BLI_mempool_local *local)
+{
+	void *retval = BLI_mempool_local_alloc(local);
+	memset(retval, 0, (size_t)local->pool->esize);
+	return retval;
+}
+
+/**
+ * Free an element, it's kept in the local free list for re-use.
+ *
+ * \note unlike #BLI_mempool_free, chunks are never freed here.
+ */
+void BLI_mempool_local_free(BLI_mempool_local *local, void *addr)
+{
+	BLI_freenode *newhead = addr;
+
+#ifndef NDEBUG
+	/* enable for debugging */
+	if (UNLIKELY(mempool_debug_memset)) {
+		memset(addr, 255, local->pool->esize);
+	}
+#endif
+
+	if (local->pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+#ifndef NDEBUG
+		/* this will detect double free's */
+		BLI_assert(newhead->freeword != FREEWORD);
+#endif
+		newhead->freeword = FREEWORD;
+	}
+
+	newhead->next = local->free;
+	local->free = newhead;
+	local->totused_delta--;
+
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_FREE(local->pool, addr);
+#endif
+}
+
+/**
+ * Give unused elements back to the pool and update its element count.
+ *
+ * Once all thread-local allocators are finalized, the pool can be used
+ * as usual again (iterated over, converted to an array...).
+ */
+void BLI_mempool_local_finalize(BLI_mempool_local *local)
+{
+	BLI_mempool *pool = local->pool;
+	BLI_freenode *tail = NULL;
+
+	/* find the tail outside the lock. */
+	if (local->free) {
+		for (tail = local->free; tail->next; tail = tail->next) {
+			/* pass */
+		}
+	}
+
+	mempool_lock(pool);
+	if (tail) {
+		tail->next = pool->free;
+		pool->free = local->free;
+	}
+	BLI_assert((int)pool->totused + local->totused_delta >= 0);
+	pool->totused = (uint)((int)pool->totused + local->totused_delta);
+	mempool_unlock(pool);
+
+	local->free = NULL;
+	local->totused_delta = 0;
+}
+
+/** \} */
+
 #ifndef NDEBUG
 void BLI_mempool_set_memory_debug(void)
 {
@@ -0,0 +1,891 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/BLI_ohash.c
+ *  \ingroup bli
+ *
+ * An open-addressing (pointer -> pointer) hash table, using linear probing
+ * with 'Robin Hood' insertion and backward shift deletion.
+ *
+ * See: https://en.wikipedia.org/wiki/Hash_table#Robin_Hood_hashing
+ *
+ * Each slot stores the key, value, full hash and probe length inline,
+ * so a lookup usually touches a single cache line.
+ * Robin Hood insertion keeps probe lengths short and even at high load,
+ * and lets lookups of missing keys stop early.
+ * Since hashes are stored, resizing never calls the hash callback
+ * and the compare callback is only called on a full hash match.
+ *
+ * \note Unlike #GHash, the table never shrinks.
+ */
+
+#include <string.h>
+#include <limits.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_sys_types.h"
+#include "BLI_utildefines.h"
+
+#define GHASH_INTERNAL_API
+#include "BLI_ohash.h"  /* own include */
+
+/* keep last */
+#include "BLI_strict_flags.h"
+
+/* -------------------------------------------------------------------- */
+/** \name Structs & Constants
+ * \{ */
+
+#define OHASH_SLOTS_BIT_MIN 3
+#define OHASH_SLOTS_BIT_MAX 30
+
+/**
+ * Max load, same as #GHash.
+ * Robin Hood probing would allow higher loads, but lookups measurably suffer past this.
+ */
+#define OHASH_LIMIT_GROW(_nslots) (((_nslots) * 3) >> 2)
+
+#define OHASH_SLOT_NONE UINT_MAX
+
+typedef struct OHashSlot {
+	void *key;
+	/* Unused for sets. */
+	void *val;
+	uint hash;
+	/* Probe length + 1, zero for free slots. */
+	uint dist;
+} OHashSlot;
+
+struct OHash {
+	GHashHashFP hashfp;
+	GHashCmpFP cmpfp;
+
+	OHashSlot *slots;
+	uint slot_mask;
+	uint limit_grow;
+
+	uint nentries;
+	bool is_oset;
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Internal Utility API
+ * \{ */
+
+/**
+ * Tables use a power of two size, scramble the hash so weak hashes
+ * (pointers, small integers) still use all slots evenly.
+ * This is the finalizer of MurmurHash3.
+ */
+BLI_INLINE uint ohash_keyhash(OHash *oh, const void *key)
+{
+	uint hash = oh->hashfp(key);
+
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+BLI_INLINE uint ohash_slots_len(OHash *oh)
+{
+	return oh->slot_mask + 1;
+}
+
+static uint ohash_slots_len_for_reserve(const uint nentries_reserve)
+{
+	uint bit = OHASH_SLOTS_BIT_MIN;
+
+	while ((bit < OHASH_SLOTS_BIT_MAX) && (OHASH_LIMIT_GROW(1u << bit) < nentries_reserve)) {
+		bit++;
+	}
+	return 1u << bit;
+}
+
+static void ohash_buffers_alloc(OHash *oh, const uint slots_len)
+{
+	BLI_assert((slots_len & (slots_len - 1)) == 0);
+
+	oh->slots = MEM_callocN(sizeof(*oh->slots) * (size_t)slots_len, "OHash slots");
+	oh->slot_mask = slots_len - 1;
+	oh->limit_grow = OHASH_LIMIT_GROW(slots_len);
+}
+
+static void ohash_buffers_free(OHash *oh)
+{
+	MEM_freeN(oh->slots);
+}
+
+/**
+ * Internal lookup, returns the slot index of \a key or #OHASH_SLOT_NONE.
+ */
+BLI_INLINE uint ohash_lookup_slot(OHash *oh, const void *key, const uint hash)
+{
+	const OHashSlot *slots = oh->slots;
+	const uint mask = oh->slot_mask;
+	uint i = hash & mask;
+	uint dist = 1;
+
+	for (;; i = (i + 1) & mask, dist++) {
+		const OHashSlot *slot = &slots[i];
+		/* A free slot, or an entry closer to its ideal slot than we are: the key cannot be further. */
+		if (slot->dist < dist) {
+			return OHASH_SLOT_NONE;
+		}
+		if ((slot->hash == hash) && (oh->cmpfp(key, slot->key) == false)) {
+			return i;
+		}
+	}
+}
+
+/**
+ * Internal insert, \a key is expected not to be in \a oh and space must be available.
+ *
+ * \return the slot index \a key ends up in.
+ */
+static uint ohash_insert_slot(OHash *oh, void *key, void *val, const uint hash)
+{
+	OHashSlot *slots = oh->slots;
+	const uint mask = oh->slot_mask;
+	OHashSlot slot_curr = {key, val, hash, 1};
+	uint i = hash & mask;
+	uint i_result = OHASH_SLOT_NONE;
+
+	BLI_assert(oh->nentries < ohash_slots_len(oh));
+
+	for (;; i = (i + 1) & mask, slot_curr.dist++) {
+		OHashSlot *slot = &slots[i];
+		if (slot->dist == 0) {
+			*slot = slot_curr;
+			return (i_result != OHASH_SLOT_NONE) ? i_result : i;
+		}
+		if (slot->dist < slot_curr.dist) {
+			/* Take the slot from the entry that is closer to its ideal slot,
+			 * and carry on inserting the displaced entry. */
+			SWAP(OHashSlot, *slot, slot_curr);
+			if (i_result == OHASH_SLOT_NONE) {
+				i_result = i;
+			}
+		}
+	}
+}
+
+static void ohash_resize(OHash *oh, const uint slots_len_new)
+{
+	OHashSlot *slots_old = oh->slots;
+	const uint slots_len_old = ohash_slots_len(oh);
+	uint i;
+
+	ohash_buffers_alloc(oh, slots_len_new);
+
+	for (i = 0; i < slots_len_old; i++) {
+		if (slots_old[i].dist != 0) {
+			ohash_insert_slot(oh, slots_old[i].key, slots_old[i].val, slots_old[i].hash);
+		}
+	}
+
+	MEM_freeN(slots_old);
+}
+
+BLI_INLINE void ohash_ensure_space(OHash *oh, const uint nentries)
+{
+	if (UNLIKELY(nentries > oh->limit_grow)) {
+		ohash_resize(oh, ohash_slots_len_for_reserve(nentries));
+	}
+}
+
+/**
+ * Remove the entry in slot \a i, using backward shift deletion (no tombstones):
+ * following entries which are not in their ideal slot are moved one slot back.
+ */
+static void ohash_remove_slot(OHash *oh, uint i)
+{
+	OHashSlot *slots = oh->slots;
+	const uint mask = oh->slot_mask;
+	uint i_next = (i + 1) & mask;
+
+	while (slots[i_next].dist > 1) {
+		slots[i] = slots[i_next];
+		slots[i].dist--;
+		i = i_next;
+		i_next = (i_next + 1) & mask;
+	}
+
+	slots[i].key = NULL;
+	slots[i].dist = 0;
+	oh->nentries--;
+}
+
+static void ohash_free_cb(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const uint slots_len = ohash_slots_len(oh);
+	uint i;
+
+	BLI_assert(keyfreefp || valfreefp);
+	BLI_assert(!valfreefp || !oh->is_oset);
+
+	for (i = 0; i < slots_len; i++) {
+		if (oh->slots[i].dist != 0) {
+			if (keyfreefp) {
+				keyfreefp(oh->slots[i].key);
+			}
+			if (valfreefp) {
+				valfreefp(oh->slots[i].val);
+			}
+		}
+	}
+}
+
+static OHash *ohash_new(
+        GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+        const uint nentries_reserve, const bool is_oset)
+{
+	OHash *oh = MEM_mallocN(sizeof(*oh), info);
+
+	oh->hashfp = hashfp;
+	oh->cmpfp = cmpfp;
+	oh->nentries = 0;
+	oh->is_oset = is_oset;
+
+	ohash_buffers_alloc(oh, ohash_slots_len_for_reserve(nentries_reserve));
+
+	return oh;
+}
+
+static OHash *ohash_copy(OHash *oh, GHashKeyCopyFP keycopyfp, GHashValCopyFP valcopyfp)
+{
+	OHash *oh_new = MEM_dupallocN(oh);
+
+	oh_new->slots = MEM_dupallocN(oh->slots);
+
+	if (keycopyfp || (valcopyfp && !oh->is_oset)) {
+		const uint slots_len = ohash_slots_len(oh);
+		uint i;
+
+		for (i = 0; i < slots_len; i++) {
+			if (oh_new->slots[i].dist != 0) {
+				if (keycopyfp) {
+					oh_new->slots[i].key = keycopyfp(oh_new->slots[i].key);
+				}
+				if (valcopyfp && !oh->is_oset) {
+					oh_new->slots[i].val = valcopyfp(oh_new->slots[i].val);
+				}
+			}
+		}
+	}
+
+	return oh_new;
+}
+
+/**
+ * Insert \a key, known not to be in \a oh yet.
+ *
+ * \return the slot index \a key is stored in.
+ */
+BLI_INLINE uint ohash_insert_ex(OHash *oh, void *key, void *val, const uint hash)
+{
+	uint i;
+
+	BLI_assert(ohash_lookup_slot(oh, key, hash) == OHASH_SLOT_NONE);
+
+	ohash_ensure_space(oh, oh->nentries + 1);
+	i = ohash_insert_slot(oh, key, val, hash);
+	oh->nentries++;
+
+	return i;
+}
+
+static void ohash_clear_ex(
+        OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+        const uint nentries_reserve)
+{
+	const uint slots_len = ohash_slots_len_for_reserve(nentries_reserve);
+
+	if (keyfreefp || valfreefp) {
+		ohash_free_cb(oh, keyfreefp, valfreefp);
+	}
+
+	if (slots_len == ohash_slots_len(oh)) {
+		memset(oh->slots, 0, sizeof(*oh->slots) * (size_t)slots_len);
+	}
+	else {
+		ohash_buffers_free(oh);
+		ohash_buffers_alloc(oh, slots_len);
+	}
+
+	oh->nentries = 0;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name OHash Public API
+ * \{ */
+
+/**
+ * Creates a new, empty OHash.
+ *
+ * \param hashfp: Hash callback.
+ * \param cmpfp: Comparison callback.
+ * \param info: Identifier string for the OHash.
+ * \param nentries_reserve: Optionally reserve the number of members that the hash will hold.
+ * Use this to avoid resizing buckets if the size is known or can be closely approximated.
+ * \return  An empty OHash.
+ */
+OHash *BLI_ohash_new_ex(
+        GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+        const uint nentries_reserve)
+{
+	return ohash_new(hashfp, cmpfp, info, nentries_reserve, false);
+}
+
+/**
+ * Wraps #BLI_ohash_new_ex with zero entries reserved.
+ */
+OHash *BLI_ohash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+{
+	return BLI_ohash_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Copy given OHash. Keys and values are also copied if relevant callback is provided, else pointers remain the same.
+ */
+OHash *BLI_ohash_copy(OHash *oh, GHashKeyCopyFP keycopyfp, GHashValCopyFP valcopyfp)
+{
+	return ohash_copy(oh, keycopyfp, valcopyfp);
+}
+
+/**
+ * Reserve given amount of entries (resize \a oh accordingly if needed).
+ */
+void BLI_ohash_reserve(OHash *oh, const uint nentries_reserve)
+{
+	ohash_ensure_space(oh, nentries_reserve);
+}
+
+/**
+ * \return size of the OHash.
+ */
+uint BLI_ohash_len(OHash *oh)
+{
+	return oh->nentries;
+}
+
+/**
+ * Insert a key/value pair into the \a oh.
+ *
+ * \note Duplicates are not checked,
+ * the caller is expected to ensure elements are unique.
+ */
+void BLI_ohash_insert(OHash *oh, void *key, void *val)
+{
+	ohash_insert_ex(oh, key, val, ohash_keyhash(oh, key));
+}
+
+/**
+ * Inserts a new value to a key that may already be in ohash.
+ *
+ * Avoids #BLI_ohash_remove, #BLI_ohash_insert calls (double lookups)
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_ohash_reinsert(OHash *oh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const uint hash = ohash_keyhash(oh, key);
+	const uint i = ohash_lookup_slot(oh, key, hash);
+
+	if (i != OHASH_SLOT_NONE) {
+		if (keyfreefp) {
+			keyfreefp(oh->slots[i].key);
+		}
+		if (valfreefp) {
+			valfreefp(oh->slots[i].val);
+		}
+		oh->slots[i].key = key;
+		oh->slots[i].val = val;
+		return false;
+	}
+
+	ohash_insert_ex(oh, key, val, hash);
+	return true;
+}
+
+/**
+ * Lookup the value of \a key in \a oh.
+ *
+ * \returns the value for \a key or NULL.
+ */
+void *BLI_ohash_lookup(OHash *oh, const void *key)
+{
+	const uint i = ohash_lookup_slot(oh, key, ohash_keyhash(oh, key));
+	BLI_assert(!oh->is_oset);
+	return (i != OHASH_SLOT_NONE) ? oh->slots[i].val : NULL;
+}
+
+/**
+ * A version of #BLI_ohash_lookup which accepts a fallback argument.
+ */
+void *BLI_ohash_lookup_default(OHash *oh, const void *key, void *val_default)
+{
+	const uint i = ohash_lookup_slot(oh, key, ohash_keyhash(oh, key));
+	BLI_assert(!oh->is_oset);
+	return (i != OHASH_SLOT_NONE) ? oh->slots[i].val : val_default;
+}
+
+/**
+ * Lookup a pointer to the value of \a key in \a oh.
+ *
+ * \returns the pointer to value for \a key or NULL.
+ *
+ * \note This has 2 main benefits over #BLI_ohash_lookup.
+ * - A NULL return always means that \a key isn't in \a oh.
+ * - The value can be modified in-place without further function calls (faster).
+ *
+ * \warning The pointer is only valid until the next insertion or removal.
+ */
+void **BLI_ohash_lookup_p(OHash *oh, const void *key)
+{
+	const uint i = ohash_lookup_slot(oh, key, ohash_keyhash(oh, key));
+	BLI_assert(!oh->is_oset);
+	return (i != OHASH_SLOT_NONE) ? &oh->slots[i].val : NULL;
+}
+
+/**
+ * Ensure \a key is exists in \a oh.
+ *
+ * This handles the common situation where the caller needs ensure a key is added to \a oh,
+ * constructing a new value in the case the key isn't found.
+ * Otherwise use the existing value.
+ *
+ * Such situations typically incur multiple lookups, however this function
+ * avoids them by ensuring the key is added,
+ * returning a pointer to the value so it can be used or initialized by the caller.
+ *
+ * \returns true when the value didn't need to be added.
+ * (when false, the caller _must_ initialize the value).
+ */
+bool BLI_ohash_ensure_p(OHash *oh, void *key, void ***r_val)
+{
+	const uint hash = ohash_keyhash(oh, key);
+	uint i = ohash_lookup_slot(oh, key, hash);
+	const bool haskey = (i != OHASH_SLOT_NONE);
+
+	BLI_assert(!oh->is_oset);
+
+	if (!haskey) {
+		i = ohash_insert_ex(oh, key, NULL, hash);
+	}
+
+	*r_val = &oh->slots[i].val;
+	return haskey;
+}
+
+/**
+ * Remove \a key from \a oh, or return false if the key wasn't found.
+ *
+ * \param key: The key to remove.
+ * \param keyfreefp: Optional callback to free the key.
+ * \param valfreefp: Optional callback to free the value.
+ * \return true if \a key was removed from \a oh.
+ */
+bool BLI_ohash_remove(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const uint i = ohash_lookup_slot(oh, key, ohash_keyhash(oh, key));
+
+	if (i != OHASH_SLOT_NONE) {
+		if (keyfreefp) {
+			keyfreefp(oh->slots[i].key);
+		}
+		if (valfreefp) {
+			valfreefp(oh->slots[i].val);
+		}
+		ohash_remove_slot(oh, i);
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Remove \a key from \a oh, returning the value or NULL if the key wasn't found.
+ *
+ * \param key: The key to remove.
+ * \param keyfreefp: Optional callback to free the key.
+ * \return the value of \a key int \a oh or NULL.
+ */
+void *BLI_ohash_popkey(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp)
+{
+	const uint i = ohash_lookup_slot(oh, key, ohash_keyhash(oh, key));
+
+	BLI_assert(!oh->is_oset);
+
+	if (i != OHASH_SLOT_NONE) {
+		void *val = oh->slots[i].val;
+		if (keyfreefp) {
+			keyfreefp(oh->slots[i].key);
+		}
+		ohash_remove_slot(oh, i);
+		return val;
+	}
+	return NULL;
+}
+
+/**
+ * \return true if the \a key is in \a oh.
+ */
+bool BLI_ohash_haskey(OHash *oh, const void *key)
+{
+	return (ohash_lookup_slot(oh, key, ohash_keyhash(oh, key)) != OHASH_SLOT_NONE);
+}
+
+/**
+ * Remove a random entry from \a oh, returning true if a key/value pair could be removed, false otherwise.
+ *
+ * \param r_key: The removed key.
+ * \param r_val: The removed value.
+ * \param state: Used for efficient removal.
+ * \return true if there was something to pop, false if ohash was already empty.
+ */
+bool BLI_ohash_pop(OHash *oh, OHashIterState *state, void **r_key, void **r_val)
+{
+	const uint mask = oh->slot_mask;
+	uint i;
+
+	if (oh->nentries == 0) {
+		*r_key = *r_val = NULL;
+		return false;
+	}
+
+	/* Removal only shifts entries back into the slot being removed,
+	 * so starting from the last popped slot avoids scanning free slots again.
+	 * Wrap around since entries may have been inserted since. */
+	for (i = state->curr_slot & mask; oh->slots[i].dist == 0; i = (i + 1) & mask) {
+		/* pass */
+	}
+
+	*r_key = oh->slots[i].key;
+	*r_val = oh->slots[i].val;
+	ohash_remove_slot(oh, i);
+	state->curr_slot = i;
+	return true;
+}
+
+/**
+ * Reset \a oh clearing all entries.
+ *
+ * \param keyfreefp: Optional callback to free the key.
+ * \param valfreefp: Optional callback to free the value.
+ * \param nentries_reserve: Optionally reserve the number of members that the hash will hold.
+ */
+void BLI_ohash_clear_ex(
+        OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+        const uint nentries_reserve)
+{
+	ohash_clear_ex(oh, keyfreefp, valfreefp, nentries_reserve);
+}
+
+/**
+ * Wraps #BLI_ohash_clear_ex with zero entries reserved.
+ */
+void BLI_ohash_clear(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	ohash_clear_ex(oh, keyfreefp, valfreefp, 0);
+}
+
+/**
+ * Frees the OHash and its members.
+ *
+ * \param oh: The OHash to free.
+ * \param keyfreefp: Optional callback to free the key.
+ * \param valfreefp: Optional callback to free the value.
+ */
+void BLI_ohash_free(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	if (keyfreefp || valfreefp) {
+		ohash_free_cb(oh, keyfreefp, valfreefp);
+	}
+
+	ohash_buffers_free(oh);
+	MEM_freeN(oh);
+}
+
+OHash *BLI_ohash_ptr_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_ptr_new(const char *info)
+{
+	return BLI_ohash_ptr_new_ex(info, 0);
+}
+
+OHash *BLI_ohash_str_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_str_new(const char *info)
+{
+	return BLI_ohash_str_new_ex(info, 0);
+}
+
+OHash *BLI_ohash_int_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_int_new(const char *info)
+{
+	return BLI_ohash_int_new_ex(info, 0);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name OHash Iterator API
+ * \{ */
+
+static void ohash_iterator_find(OHashIterator *ohi, uint i)
+{
+	OHashSlot *slots = ohi->oh->slots;
+
+	while ((i < ohi->slots_len) && (slots[i].dist == 0)) {
+		i++;
+	}
+
+	ohi->curr_slot = i;
+	if (i < ohi->slots_len) {
+		ohi->curr_key = slots[i].key;
+		ohi->curr_val_p = &slots[i].val;
+	}
+	else {
+		ohi->curr_key = NULL;
+		ohi->curr_val_p = NULL;
+	}
+}
+
+/**
+ * Init an already allocated OHashIterator. The hash table must not
+ * be mutated while the iterator is in use, and the iterator will
+ * step through the elements in an unspecified order.
+ *
+ * \param ohi: The OHashIterator to initialize.
+ * \param oh: The OHash to iterate over.
+ */
+void BLI_ohashIterator_init(OHashIterator *ohi, OHash *oh)
+{
+	ohi->oh = oh;
+	ohi->slots_len = ohash_slots_len(oh);
+	ohash_iterator_find(ohi, 0);
+}
+
+/**
+ * Steps the iterator to the next index.
+ *
+ * \param ohi: The iterator.
+ */
+void BLI_ohashIterator_step(OHashIterator *ohi)
+{
+	BLI_assert(ohi->curr_slot < ohi->slots_len);
+	ohash_iterator_find(ohi, ohi->curr_slot + 1);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name OSet Public API
+ *
+ * Use ohash API to give 'set' functionality
+ * \{ */
+
+OSet *BLI_oset_new_ex(
+        GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+        const uint nentries_reserve)
+{
+	return (OSet *)ohash_new(hashfp, cmpfp, info, nentries_reserve, true);
+}
+
+OSet *BLI_oset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info)
+{
+	return BLI_oset_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Copy given OSet. Keys are also copied if callback is provided, else pointers remain the same.
+ */
+OSet *BLI_oset_copy(OSet *os, GSetKeyCopyFP keycopyfp)
+{
+	return (OSet *)ohash_copy((OHash *)os, keycopyfp, NULL);
+}
+
+uint BLI_oset_len(OSet *os)
+{
+	return ((OHash *)os)->nentries;
+}
+
+void BLI_oset_reserve(OSet *os, const uint nentries_reserve)
+{
+	ohash_ensure_space((OHash *)os, nentries_reserve);
+}
+
+/**
+ * Adds the key to the set (no checks for unique keys!).
+ * Matching #BLI_ohash_insert
+ */
+void BLI_oset_insert(OSet *os, void *key)
+{
+	OHash *oh = (OHash *)os;
+	ohash_insert_ex(oh, key, NULL, ohash_keyhash(oh, key));
+}
+
+/**
+ * A version of BLI_oset_insert which checks first if the key is in the set.
+ * \returns true if a new key has been added.
+ */
+bool BLI_oset_add(OSet *os, void *key)
+{
+	OHash *oh = (OHash *)os;
+	const uint hash = ohash_keyhash(oh, key);
+
+	if (ohash_lookup_slot(oh, key, hash) != OHASH_SLOT_NONE) {
+		return false;
+	}
+	ohash_insert_ex(oh, key, NULL, hash);
+	return true;
+}
+
+bool BLI_oset_remove(OSet *os, const void *key, GSetKeyFreeFP keyfreefp)
+{
+	return BLI_ohash_remove((OHash *)os, key, keyfreefp, NULL);
+}
+
+bool BLI_oset_haskey(OSet *os, const void *key)
+{
+	return BLI_ohash_haskey((OHash *)os, key);
+}
+
+/**
+ * Remove a random entry from \a os, returning true if a key could be removed, false otherwise.
+ *
+ * \param r_key: The removed key.
+ * \param state: Used for efficient removal.
+ * \return true if there was something to pop, false if oset was already empty.
+ */
+bool BLI_oset_pop(OSet *os, OSetIterState *state, void **r_key)
+{
+	void *val_dummy;
+	return BLI_ohash_pop((OHash *)os, state, r_key, &val_dummy);
+}
+
+void BLI_oset_clear_ex(OSet *os, GSetKeyFreeFP keyfreefp, const uint nentries_reserve)
+{
+	ohash_clear_ex((OHash *)os, keyfreefp, NULL, nentries_reserve);
+}
+
+void BLI_oset_clear(OSet *os, GSetKeyFreeFP keyfreefp)
+{
+	ohash_clear_ex((OHash *)os, keyfreefp, NULL, 0);
+}
+
+void BLI_oset_free(OSet *os, GSetKeyFreeFP keyfreefp)
+{
+	BLI_ohash_free((OHash *)os, keyfreefp, NULL);
+}
+
+/**
+ * Returns the pointer to the key if it's found.
+ */
+void *BLI_oset_lookup(OSet *os, const void *key)
+{
+	OHash *oh = (OHash *)os;
+	const uint i = ohash_lookup_slot(oh, key, ohash_keyhash(oh, key));
+	return (i != OHASH_SLOT_NONE) ? oh->slots[i].key : NULL;
+}
+
+OSet *BLI_oset_ptr_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_oset_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+OSet *BLI_oset_ptr_new(const char *info)
+{
+	return BLI_oset_ptr_new_ex(info, 0);
+}
+
+OSet *BLI_oset_str_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_oset_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+OSet *BLI_oset_str_new(const char *info)
+{
+	return BLI_oset_str_new_ex(info, 0);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Debugging & Introspection
+ * \{ */
+
+/**
+ * Measure how well the hash function performs.
+ *
+ * \return the mean probe length (the lower the better, 1.0 meaning all keys are in their ideal slot).
+ */
+double BLI_ohash_calc_quality_ex(
+        OHash *oh, double *r_load, double *r_mean_probe_len, uint *r_max_probe_len)
+{
+	const uint slots_len = ohash_slots_len(oh);
+	uint64_t dist_sum = 0;
+	uint dist_max = 0;
+	double mean;
+	uint i;
+
+	for (i = 0; i < slots_len; i++) {
+		const uint dist = oh->slots[i].dist;
+		dist_sum += dist;
+		if (dist > dist_max) {
+			dist_max = dist;
+		}
+	}
+
+	mean = oh->nentries ? (double)dist_sum / (double)oh->nentries : 0.0;
+
+	if (r_load) {
+		*r_load = (double)oh->nentries / (double)slots_len;
+	}
+	if (r_mean_probe_len) {
+		*r_mean_probe_len = mean;
+	}
+	if (r_max_probe_len) {
+		*r_max_probe_len = dist_max;
+	}
+
+	return mean;
+}
+
+double BLI_oset_calc_quality_ex(
+        OSet *os, double *r_load, double *r_mean_probe_len, uint *r_max_probe_len)
+{
+	return BLI_ohash_calc_quality_ex((OHash *)os, r_load, r_mean_probe_len, r_max_probe_len);
+}
+
+/** \} */
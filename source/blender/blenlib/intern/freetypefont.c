@@ -243,9 +243,11 @@ static VChar *freetypechar_to_vchar(FT_Face face, FT_ULong charcode, VFontData *
 	return NULL;
 }
 
-static VChar *objchr_to_ftvfontdata(VFont *vfont, FT_ULong charcode)
+/* Loads the characters (those not loaded yet) with one face, the first one is returned. */
+static VChar *objchr_to_ftvfontdata(VFont *vfont, const FT_ULong *charcodes, const int charcodes_len)
 {
-	VChar *che;
+	VChar *che = NULL;
+	int i;
 
 	/* Freetype2 */
 	FT_Face face;
@@ -266,14 +268,23 @@ static VChar *objchr_to_ftvfontdata(VFont *vfont, FT_ULong charcode)
 		return NULL;
 	}
 
-	/* Read the char */
-	che = freetypechar_to_vchar(face, charcode, vfont->data);
+	/* Read the chars */
+	for (i = 0; i < charcodes_len; i++) {
+		VChar *che_iter = BLI_ghash_lookup(vfont->data->characters, POINTER_FROM_UINT(charcodes[i]));
+		if (che_iter == NULL) {
+			che_iter = freetypechar_to_vchar(face, charcodes[i], vfont->data);
+		}
+		if (i == 0) {
+			che = che_iter;
+		}
+	}
+
+	FT_Done_Face(face);
 
 	/* And everything went ok */
 	return che;
 }
 
-
 static VFontData *objfnt_to_ftvfontdata(PackedFile *pf)
 {
 	/* Variables */
@@ -504,7 +515,7 @@ VChar *BLI_vfontchar_from_freetypefont(VFont *vfont, unsigned long character)
 	}
 
 	/* Load the character */
-	che = objchr_to_ftvfontdata(vfont, character);
+	che = objchr_to_ftvfontdata(vfont, &character, 1);
 
 	/* Free Freetype */
 	FT_Done_FreeType(library);
@@ -512,6 +523,37 @@ VChar *BLI_vfontchar_from_freetypefont(VFont *vfont, unsigned long character)
 	return che;
 }
 
+/**
+ * Load many characters at once (the missing characters of a text),
+ * the font is only read once, instead of for each character.
+ */
+void BLI_vfontchars_from_freetypefont(VFont *vfont, const unsigned int *characters, const int characters_len)
+{
+	FT_ULong *charcodes;
+	int i;
+
+	if (!vfont || characters_len == 0) return;
+
+	/* Init Freetype */
+	err = FT_Init_FreeType(&library);
+	if (err) {
+		return;
+	}
+
+	charcodes = MEM_malloc_arrayN(characters_len, sizeof(*charcodes), __func__);
+	for (i = 0; i < characters_len; i++) {
+		charcodes[i] = characters[i];
+	}
+
+	/* Load the characters */
+	objchr_to_ftvfontdata(vfont, charcodes, characters_len);
+
+	MEM_freeN(charcodes);
+
+	/* Free Freetype */
+	FT_Done_FreeType(library);
+}
+
 /* Yeah, this is very bad... But why is this in BLI in the first place, since it uses Nurb data?
  * Anyway, do not feel like duplicating whole Nurb copy code here,
  * so unless someone has a better idea... */
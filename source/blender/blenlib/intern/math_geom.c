@@ -284,6 +284,265 @@ float volume_tetrahedron_signed_v3(const float v1[3], const float v2[3], const f
 	return determinant_m3_array(m) / 6.0f;
 }
 
+/********************************* Orientation **********************************/
+
+/* Exact orientation predicates, see:
+ * Jonathan Richard Shewchuk,
+ * "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+ *
+ * The determinant is first evaluated in double precision,
+ * only when the rounding error bound can't prove its sign is it evaluated again exactly,
+ * using expansions (sums of non-overlapping doubles, stored in increasing magnitude).
+ *
+ * Single precision input is converted to double, so products of three differences never
+ * overflow or underflow, all arithmetic on expansions is then exact. */
+
+/* half the distance between 1.0 and the next double (2^-53) */
+#define ORIENT_EPS 1.1102230246251565e-16
+#define ORIENT_2D_ERRBOUND ((3.0 + 16.0 * ORIENT_EPS) * ORIENT_EPS)
+#define ORIENT_3D_ERRBOUND ((7.0 + 56.0 * ORIENT_EPS) * ORIENT_EPS)
+
+/* 2x2 products of two term differences (8 terms each) summed, scaled by a two term difference (x 4)
+ * and summed three times, is the largest expansion. */
+#define ORIENT_EXPANSION_MAX 192
+
+/* 'a + b' as 'r_x + r_y' without any rounding */
+BLI_INLINE void orient_two_sum(const double a, const double b, double *r_x, double *r_y)
+{
+	const double x = a + b;
+	const double b_virt = x - a;
+	const double a_virt = x - b_virt;
+	*r_x = x;
+	*r_y = (a - a_virt) + (b - b_virt);
+}
+
+/* 'a * b' as 'r_x + r_y' without any rounding */
+BLI_INLINE void orient_two_product(const double a, const double b, double *r_x, double *r_y)
+{
+	const double x = a * b;
+	*r_x = x;
+	*r_y = fma(a, b, -x);
+}
+
+/**
+ * Add \a b to the expansion \a h in place.
+ * \return the new length of \a h, components which are zero are removed.
+ */
+static int orient_expansion_grow(double *h, const int h_len, const double b)
+{
+	double q = b;
+	int len = 0;
+	int i;
+
+	for (i = 0; i < h_len; i++) {
+		double hh;
+		orient_two_sum(q, h[i], &q, &hh);
+		if (hh != 0.0) {
+			h[len++] = hh;
+		}
+	}
+	if ((q != 0.0) || (len == 0)) {
+		h[len++] = q;
+	}
+	return len;
+}
+
+/**
+ * Add the expansion \a e to the expansion \a h in place.
+ */
+static int orient_expansion_add(double *h, int h_len, const double *e, const int e_len, const double e_fac)
+{
+	int i;
+	for (i = 0; i < e_len; i++) {
+		h_len = orient_expansion_grow(h, h_len, e[i] * e_fac);
+	}
+	return h_len;
+}
+
+/**
+ * Scale the expansion \a e by \a b, writing the result into \a h (at most twice the length of \a e).
+ */
+static int orient_expansion_scale(const double *e, const int e_len, const double b, double *h)
+{
+	double q, hh;
+	int len = 0;
+	int i;
+
+	orient_two_product(e[0], b, &q, &hh);
+	if (hh != 0.0) {
+		h[len++] = hh;
+	}
+	for (i = 1; i < e_len; i++) {
+		double p1, p0, sum;
+		orient_two_product(e[i], b, &p1, &p0);
+		orient_two_sum(q, p0, &sum, &hh);
+		if (hh != 0.0) {
+			h[len++] = hh;
+		}
+		orient_two_sum(p1, sum, &q, &hh);
+		if (hh != 0.0) {
+			h[len++] = hh;
+		}
+	}
+	if ((q != 0.0) || (len == 0)) {
+		h[len++] = q;
+	}
+	return len;
+}
+
+/**
+ * Multiply the expansions \a e and \a f, writing the result into \a h.
+ */
+static int orient_expansion_mul(const double *e, const int e_len, const double *f, const int f_len, double *h)
+{
+	double scaled[ORIENT_EXPANSION_MAX];
+	int len = 0;
+	int i;
+
+	BLI_assert(e_len * 2 <= ORIENT_EXPANSION_MAX);
+
+	for (i = 0; i < f_len; i++) {
+		const int scaled_len = orient_expansion_scale(e, e_len, f[i], scaled);
+		len = orient_expansion_add(h, len, scaled, scaled_len, 1.0);
+	}
+	return len;
+}
+
+/**
+ * 'a - b' as a two term expansion.
+ */
+BLI_INLINE void orient_expansion_sub(const float a, const float b, double r_e[2])
+{
+	orient_two_sum((double)a, -(double)b, &r_e[1], &r_e[0]);
+}
+
+/**
+ * Exact 'a * d - b * c' of two term expansions, \a h must hold 16 terms.
+ */
+static int orient_expansion_det2(
+        const double a[2], const double b[2], const double c[2], const double d[2],
+        double *h)
+{
+	double ad[8], bc[8];
+	const int ad_len = orient_expansion_mul(a, 2, d, 2, ad);
+	const int bc_len = orient_expansion_mul(b, 2, c, 2, bc);
+	int len;
+
+	memcpy(h, ad, sizeof(*h) * (size_t)ad_len);
+	len = orient_expansion_add(h, ad_len, bc, bc_len, -1.0);
+	return len;
+}
+
+BLI_INLINE int orient_expansion_sign(const double *e, const int e_len)
+{
+	/* the most significant component is last */
+	const double d = e[e_len - 1];
+	return (d > 0.0) ? 1 : ((d < 0.0) ? -1 : 0);
+}
+
+/**
+ * The side of the line (\a a, \a b) which \a c lies on, computed exactly.
+ *
+ * \return 1 when (\a a, \a b, \a c) are counter-clockwise, -1 when clockwise and 0 when co-linear.
+ */
+int orient2d_exact_v2(const float a[2], const float b[2], const float c[2])
+{
+	const double acx = (double)a[0] - (double)c[0];
+	const double bcx = (double)b[0] - (double)c[0];
+	const double acy = (double)a[1] - (double)c[1];
+	const double bcy = (double)b[1] - (double)c[1];
+	const double det_l = acx * bcy;
+	const double det_r = acy * bcx;
+	const double det = det_l - det_r;
+
+	if (fabs(det) > ORIENT_2D_ERRBOUND * (fabs(det_l) + fabs(det_r))) {
+		return (det > 0.0) ? 1 : -1;
+	}
+	else {
+		double e_acx[2], e_bcx[2], e_acy[2], e_bcy[2];
+		double h[16];
+		int len;
+
+		orient_expansion_sub(a[0], c[0], e_acx);
+		orient_expansion_sub(b[0], c[0], e_bcx);
+		orient_expansion_sub(a[1], c[1], e_acy);
+		orient_expansion_sub(b[1], c[1], e_bcy);
+
+		len = orient_expansion_det2(e_acx, e_acy, e_bcx, e_bcy, h);
+		return orient_expansion_sign(h, len);
+	}
+}
+
+/**
+ * The side of the plane through (\a a, \a b, \a c) which \a d lies on, computed exactly.
+ *
+ * \return 1 when \a d is on the side the normal of (\a a, \a b, \a c) points to
+ * (as calculated by #normal_tri_v3), -1 for the other side and 0 when all points are co-planar.
+ */
+int orient3d_exact_v3(const float a[3], const float b[3], const float c[3], const float d[3])
+{
+	/* evaluated as the determinant of (a - d, b - d, c - d), which has the opposite sign */
+	const double adx = (double)a[0] - (double)d[0];
+	const double bdx = (double)b[0] - (double)d[0];
+	const double cdx = (double)c[0] - (double)d[0];
+	const double ady = (double)a[1] - (double)d[1];
+	const double bdy = (double)b[1] - (double)d[1];
+	const double cdy = (double)c[1] - (double)d[1];
+	const double adz = (double)a[2] - (double)d[2];
+	const double bdz = (double)b[2] - (double)d[2];
+	const double cdz = (double)c[2] - (double)d[2];
+
+	const double bdx_cdy = bdx * cdy, cdx_bdy = cdx * bdy;
+	const double cdx_ady = cdx * ady, adx_cdy = adx * cdy;
+	const double adx_bdy = adx * bdy, bdx_ady = bdx * ady;
+
+	const double det = (adz * (bdx_cdy - cdx_bdy) +
+	                    bdz * (cdx_ady - adx_cdy) +
+	                    cdz * (adx_bdy - bdx_ady));
+	const double permanent = ((fabs(bdx_cdy) + fabs(cdx_bdy)) * fabs(adz) +
+	                          (fabs(cdx_ady) + fabs(adx_cdy)) * fabs(bdz) +
+	                          (fabs(adx_bdy) + fabs(bdx_ady)) * fabs(cdz));
+
+	if (fabs(det) > ORIENT_3D_ERRBOUND * permanent) {
+		return (det > 0.0) ? -1 : 1;
+	}
+	else {
+		double e_ad[3][2], e_bd[3][2], e_cd[3][2];
+		double minor[16], term[ORIENT_EXPANSION_MAX / 3];
+		double h[ORIENT_EXPANSION_MAX];
+		int minor_len, term_len, len = 0;
+		int i;
+
+		for (i = 0; i < 3; i++) {
+			orient_expansion_sub(a[i], d[i], e_ad[i]);
+			orient_expansion_sub(b[i], d[i], e_bd[i]);
+			orient_expansion_sub(c[i], d[i], e_cd[i]);
+		}
+
+		/* adz * (bdx * cdy - cdx * bdy) */
+		minor_len = orient_expansion_det2(e_bd[0], e_cd[0], e_bd[1], e_cd[1], minor);
+		term_len = orient_expansion_mul(minor, minor_len, e_ad[2], 2, term);
+		len = orient_expansion_add(h, len, term, term_len, 1.0);
+
+		/* bdz * (cdx * ady - adx * cdy) */
+		minor_len = orient_expansion_det2(e_cd[0], e_ad[0], e_cd[1], e_ad[1], minor);
+		term_len = orient_expansion_mul(minor, minor_len, e_bd[2], 2, term);
+		len = orient_expansion_add(h, len, term, term_len, 1.0);
+
+		/* cdz * (adx * bdy - bdx * ady) */
+		minor_len = orient_expansion_det2(e_ad[0], e_bd[0], e_ad[1], e_bd[1], minor);
+		term_len = orient_expansion_mul(minor, minor_len, e_cd[2], 2, term);
+		len = orient_expansion_add(h, len, term, term_len, 1.0);
+
+		return -orient_expansion_sign(h, len);
+	}
+}
+
+#undef ORIENT_EPS
+#undef ORIENT_2D_ERRBOUND
+#undef ORIENT_3D_ERRBOUND
+#undef ORIENT_EXPANSION_MAX
+
 
 /********************************* Distance **********************************/
 
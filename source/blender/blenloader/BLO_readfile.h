@@ -87,7 +87,7 @@ BlendFileData *BLO_read_from_memory(
         eBLOReadSkip skip_flags,
         struct ReportList *reports);
 BlendFileData *BLO_read_from_memfile(
-        struct Main *oldmain, const char *filename, struct MemFile *memfile,
+        struct Main *oldmain, const char *filename, struct MemFile *memfile, struct MemFile *memfile_live,
         eBLOReadSkip skip_flags,
         struct ReportList *reports);
 
@@ -25,22 +25,42 @@
  *  \ingroup blenloader
  */
 
+struct GHash;
+struct GSet;
 struct Scene;
 
 typedef struct {
 	void *next, *prev;
+	/** User counted, may be shared with any chunk of other #MemFile's. */
 	const char *buf;
 	/** Size in bytes. */
 	unsigned int size;
-	/** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+	/** Hash of the contents of #MemFileChunk.buf, used to find identical chunks. */
+	unsigned int hash;
+	/** When true, this chunk shares its memory with a chunk of the previous #MemFile. */
 	bool is_identical;
 } MemFileChunk;
 
 typedef struct MemFile {
 	ListBase chunks;
 	size_t size;
+	/** ID name -> chunks written for that ID (undo only), see #BLO_memfile_id_is_identical. */
+	struct GHash *id_chunks;
 } MemFile;
 
+typedef struct MemFileWriteData {
+	MemFile *written_memfile;
+	MemFile *reference_memfile;
+
+	/** Use to de-duplicate chunks at the same position. */
+	MemFileChunk *reference_current_chunk;
+	/** Use to de-duplicate chunks by content (any position), #MemFileChunk's of the reference. */
+	struct GSet *reference_chunks;
+
+	/** Last chunk before the ID being written. */
+	MemFileChunk *id_chunk_prev;
+} MemFileWriteData;
+
 typedef struct MemFileUndoData {
 	char filename[1024];  /* FILE_MAX */
 	MemFile memfile;
@@ -48,16 +68,22 @@ typedef struct MemFileUndoData {
 } MemFileUndoData;
 
 /* actually only used writefile.c */
-extern void memfile_chunk_add(
-        MemFile *memfile, const char *buf, unsigned int size,
-        MemFileChunk **compchunk_step);
+extern void BLO_memfile_write_init(
+        MemFileWriteData *mem_data, MemFile *written_memfile, MemFile *reference_memfile);
+extern void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
+extern void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, unsigned int size);
+extern void BLO_memfile_write_id_begin(MemFileWriteData *mem_data);
+extern void BLO_memfile_write_id_end(MemFileWriteData *mem_data, const char *id_name);
 
 /* exports */
 extern void BLO_memfile_free(MemFile *memfile);
 extern void BLO_memfile_merge(MemFile *first, MemFile *second);
 
 /* utilities */
+extern bool BLO_memfile_id_is_identical(
+        const MemFile *memfile_a, const MemFile *memfile_b, const char *id_name);
 extern struct Main *BLO_memfile_main_get(struct MemFile *memfile, struct Main *bmain, struct Scene **r_scene);
+extern MemFile *BLO_memfile_flatten(const MemFile *memfile);
 extern bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename);
 
 #endif  /* __BLO_UNDOFILE_H__ */
@@ -361,9 +361,11 @@ BlendFileData *BLO_read_from_memory(
  *
  * \param oldmain: old main, from which we will keep libraries and other datablocks that should not have changed.
  * \param filename: current file, only for retrieving library data.
+ * \param memfile_live: \a oldmain written with \a memfile as reference (may be NULL),
+ * local IDs which are identical in both are kept from \a oldmain instead of being read.
  */
 BlendFileData *BLO_read_from_memfile(
-        Main *oldmain, const char *filename, MemFile *memfile,
+        Main *oldmain, const char *filename, MemFile *memfile, MemFile *memfile_live,
         eBLOReadSkip skip_flags,
         ReportList *reports)
 {
@@ -382,6 +384,12 @@ BlendFileData *BLO_read_from_memfile(
 
 		/* separate libraries from old main */
 		blo_split_main(&old_mainlist, oldmain);
+
+		/* find local IDs which can be kept as-is */
+		if (memfile_live) {
+			blo_undo_reuse_ids_find(fd, oldmain, memfile_live);
+		}
+
 		/* add the library pointers in oldmap lookup */
 		blo_add_library_pointer_map(&old_mainlist, fd);
 
@@ -69,6 +69,7 @@
 #include "BLI_threads.h"
 #include "BLI_mempool.h"
 #include "BLI_ghash.h"
+#include "BLI_ohash.h"
 
 #include "BLT_translation.h"
 
@@ -544,7 +545,7 @@ static void read_file_bhead_idname_map_create(FileData *fd)
 
 	BLI_assert(fd->bhead_idname_hash == NULL);
 
-	fd->bhead_idname_hash = BLI_ghash_str_new_ex(__func__, reserve);
+	fd->bhead_idname_hash = BLI_ohash_str_new_ex(__func__, reserve);
 
 	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
 		if (code_prev != bhead->code) {
@@ -553,7 +554,7 @@ static void read_file_bhead_idname_map_create(FileData *fd)
 		}
 
 		if (is_link) {
-			BLI_ghash_insert(fd->bhead_idname_hash, (void *)bhead_id_name(fd, bhead), bhead);
+			BLI_ohash_insert(fd->bhead_idname_hash, (void *)bhead_id_name(fd, bhead), bhead);
 		}
 	}
 }
@@ -1271,10 +1272,14 @@ void blo_freefiledata(FileData *fd)
 
 #ifdef USE_GHASH_BHEAD
 		if (fd->bhead_idname_hash) {
-			BLI_ghash_free(fd->bhead_idname_hash, NULL, NULL);
+			BLI_ohash_free(fd->bhead_idname_hash, NULL, NULL);
 		}
 #endif
 
+		if (fd->undo_reuse_ids) {
+			BLI_ghash_free(fd->undo_reuse_ids, NULL, NULL);
+		}
+
 		MEM_freeN(fd);
 	}
 }
@@ -1519,6 +1524,8 @@ void blo_make_image_pointer_map(FileData *fd, Main *oldmain)
 	for (; ima; ima = ima->id.next) {
 		if (ima->cache)
 			oldnewmap_insert(fd->imamap, ima->cache, ima->cache, 0);
+		if (ima->tiled_ibuf)
+			oldnewmap_insert(fd->imamap, ima->tiled_ibuf, ima->tiled_ibuf, 0);
 		for (a = 0; a < TEXTARGET_COUNT; a++)
 			if (ima->gputexture[a])
 				oldnewmap_insert(fd->imamap, ima->gputexture[a], ima->gputexture[a], 0);
@@ -1557,6 +1564,8 @@ void blo_end_image_pointer_map(FileData *fd, Main *oldmain)
 		for (i = 0; i < IMA_MAX_RENDER_SLOT; i++)
 			ima->renders[i] = newimaadr(fd, ima->renders[i]);
 
+		ima->tiled_ibuf = newimaadr(fd, ima->tiled_ibuf);
+
 		for (i = 0; i < TEXTARGET_COUNT; i++)
 			ima->gputexture[i] = newimaadr(fd, ima->gputexture[i]);
 		ima->rr = newimaadr(fd, ima->rr);
@@ -2163,6 +2172,7 @@ static void direct_link_text(FileData *fd, Text *text)
 	text->name = newdataadr(fd, text->name);
 
 	text->compiled = NULL;
+	text->line_index = NULL;
 
 #if 0
 	if (text->flags & TXT_ISEXT) {
@@ -2209,10 +2219,14 @@ static void direct_link_image(FileData *fd, Image *ima)
 	ImagePackedFile *imapf;
 
 	/* for undo system, pointers could be restored */
-	if (fd->imamap)
+	if (fd->imamap) {
 		ima->cache = newimaadr(fd, ima->cache);
-	else
+		ima->tiled_ibuf = newimaadr(fd, ima->tiled_ibuf);
+	}
+	else {
 		ima->cache = NULL;
+		ima->tiled_ibuf = NULL;
+	}
 
 	/* if not restored, we keep the binded opengl index */
 	if (!ima->cache) {
@@ -3998,6 +4012,118 @@ static void lib_link_group(FileData *fd, Main *bmain)
 	}
 }
 
+/* ************ READ UNDO REUSED IDS ***************** */
+
+/* Types of local IDs which may be kept as-is when unchanged by an undo step.
+ * Limited to geometry, since that's where re-reading and re-evaluating is expensive. */
+static bool undo_id_type_is_reusable(const short idcode)
+{
+	return ELEM(idcode, ID_OB, ID_ME);
+}
+
+/**
+ * Find local IDs of \a oldmain which are identical in \a memfile_live (\a oldmain written as an undo step)
+ * and the memfile being read. Comparing against the current state rather than the last undo step
+ * means changes made since the last undo push are not kept.
+ */
+void blo_undo_reuse_ids_find(FileData *fd, Main *oldmain, MemFile *memfile_live)
+{
+	ListBase *lbarray[MAX_LIBARRAY];
+	int a = set_listbasepointers(oldmain, lbarray);
+
+	while (a--) {
+		ID *id = lbarray[a]->first;
+
+		if ((id == NULL) || !undo_id_type_is_reusable(GS(id->name))) {
+			continue;
+		}
+
+		for (; id; id = id->next) {
+			BLI_assert(!ID_IS_LINKED(id));
+			if (BLO_memfile_id_is_identical(memfile_live, fd->memfile, id->name)) {
+				if (fd->undo_reuse_ids == NULL) {
+					fd->undo_reuse_ids = BLI_ghash_str_new(__func__);
+				}
+				BLI_ghash_insert(fd->undo_reuse_ids, id->name, id);
+			}
+		}
+	}
+}
+
+static int lib_link_undo_reused_id_cb(void *user_data, ID *UNUSED(id_self), ID **id_pointer, int UNUSED(cb_flag))
+{
+	FileData *fd = user_data;
+
+	if (*id_pointer != NULL) {
+		/* The reused ID is byte for byte the one written in the step being read (see blo_undo_reuse_ids_find),
+		 * so its current pointers are the ones written there, which are keys of the ID map of that step. */
+		ID *id_new = newlibadr(fd, NULL, *id_pointer);
+		if (id_new != NULL) {
+			*id_pointer = id_new;
+		}
+		else if (!ID_IS_LINKED(*id_pointer)) {
+			/* Local ID from old main which is about to be freed, should never happen. */
+			BLI_assert(0);
+			*id_pointer = NULL;
+		}
+		/* else: linked IDs are kept from old main with the same address. */
+	}
+	return IDWALK_RET_NOP;
+}
+
+/* Any ID this object uses was read again (its modifiers may use textures, images, materials, other objects...). */
+static int lib_link_undo_reused_ob_depends_cb(void *user_data, ID *id_self, ID **id_pointer, int UNUSED(cb_flag))
+{
+	bool *r_is_dirty = user_data;
+	ID *id = *id_pointer;
+
+	if ((id == NULL) || (id == id_self) || ID_IS_LINKED(id)) {
+		return IDWALK_RET_NOP;
+	}
+	if (((id->tag & LIB_TAG_UNDO_REUSED) == 0) || (id->tag & LIB_TAG_DOIT)) {
+		*r_is_dirty = true;
+		return IDWALK_RET_STOP_ITER;
+	}
+	return IDWALK_RET_NOP;
+}
+
+/**
+ * Reused IDs still point to the IDs of old main, remap them using the ID map of the undo step being read,
+ * then free evaluated data of reused objects depending on data which was read again.
+ */
+static void lib_link_undo_reused_ids(FileData *fd, Main *main)
+{
+	ListBase *lbarray[MAX_LIBARRAY];
+	int a = set_listbasepointers(main, lbarray);
+	bool changed;
+
+	while (a--) {
+		for (ID *id = lbarray[a]->first; id; id = id->next) {
+			if (id->tag & LIB_TAG_UNDO_REUSED) {
+				BKE_library_foreach_ID_link(NULL, id, lib_link_undo_reused_id_cb, fd, IDWALK_NOP);
+			}
+		}
+	}
+
+	/* Dependencies may be reused objects which are dirty themselves (tagged LIB_TAG_DOIT). */
+	do {
+		changed = false;
+		for (Object *ob = main->object.first; ob; ob = ob->id.next) {
+			if ((ob->id.tag & LIB_TAG_UNDO_REUSED) && !(ob->id.tag & LIB_TAG_DOIT)) {
+				bool is_dirty = false;
+				BKE_library_foreach_ID_link(NULL, &ob->id, lib_link_undo_reused_ob_depends_cb, &is_dirty, IDWALK_READONLY);
+				if (is_dirty) {
+					BKE_object_free_derived_caches(ob);
+					ob->id.tag |= LIB_TAG_DOIT;
+					changed = true;
+				}
+			}
+		}
+	} while (changed);
+
+	BKE_main_id_tag_all(main, LIB_TAG_UNDO_REUSED | LIB_TAG_DOIT, false);
+}
+
 /* ************** GENERAL & MAIN ******************** */
 
 
@@ -4115,6 +4241,33 @@ static BHead *read_libblock(FileData *fd, Main *main, BHead *bhead, const int ta
 		}
 	}
 
+	/* In undo case, IDs which did not change between current state and the one being read
+	 * are moved over from old main as-is (keeping their runtime data), skipping their data-blocks. */
+	if (fd->undo_reuse_ids && !ELEM(bhead->code, ID_LI, ID_ID)) {
+		const char *idname = bhead_id_name(fd, bhead);
+
+		if ((id = BLI_ghash_lookup(fd->undo_reuse_ids, idname))) {
+			Main *oldmain = fd->old_mainlist->first;
+
+			BLI_remlink(which_libbase(oldmain, GS(id->name)), id);
+			BLI_addtail(which_libbase(main, GS(id->name)), id);
+			oldnewmap_insert(fd->libmap, bhead->old, id, bhead->code);
+
+			/* Not tagged for linking, see lib_link_undo_reused_ids. */
+			id->tag = tag | LIB_TAG_UNDO_REUSED;
+			id->newid = NULL;
+
+			if (r_id) {
+				*r_id = id;
+			}
+
+			for (bhead = blo_nextbhead(fd, bhead); bhead && bhead->code == DATA; bhead = blo_nextbhead(fd, bhead)) {
+				/* pass */
+			}
+			return bhead;
+		}
+	}
+
 	/* read libblock */
 	id = read_struct(fd, bhead, "lib block");
 
@@ -4345,6 +4498,13 @@ static void do_versions(FileData *fd, Library *lib, Main *main)
 	/* WATCH IT!!!: pointers from libdata have not been converted yet here! */
 	/* WATCH IT 2!: Userdef struct init see do_versions_userdef() above! */
 
+	if (!DNA_struct_elem_find(fd->filesdna, "Curve", "float", "resolu_tolerance")) {
+		Curve *cu;
+		for (cu = main->curve.first; cu; cu = cu->id.next) {
+			cu->resolu_tolerance = 0.001f;
+		}
+	}
+
 	/* don't forget to set version number in BKE_blender_version.h! */
 }
 
@@ -4528,6 +4688,10 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 
 	lib_link_all(fd, bfd->main);
 
+	if (fd->undo_reuse_ids != NULL) {
+		lib_link_undo_reused_ids(fd, bfd->main);
+	}
+
 	/* Skip in undo case. */
 	if (fd->memfile == NULL) {
 		/* Yep, second splitting... but this is a very cheap operation, so no big deal. */
@@ -4546,8 +4710,9 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 		 * libraries (since those are not supposed to change).
 		 * Unfortunately, that means that we do not reset their user count, however we do increase that one when
 		 * doing lib_link on local IDs using linked ones.
-		 * There is no real way to predict amount of changes here, so we have to fully redo refcounting . */
-		BLE_main_id_refcount_recompute(bfd->main, true);
+		 * There is no real way to predict amount of changes here, so we have to fully redo refcounting .
+		 * Reused local IDs kept their user count and were not lib_linked, so they need a full recount too. */
+		BLE_main_id_refcount_recompute(bfd->main, fd->undo_reuse_ids == NULL);
 	}
 
 	fix_relpaths_library(fd->relabase, bfd->main); /* make all relative paths, relative to the open blend file */
@@ -4649,7 +4814,7 @@ static BHead *find_bhead_from_code_name(FileData *fd, const short idcode, const
 	*((short *)idname_full) = idcode;
 	BLI_strncpy(idname_full + 2, name, sizeof(idname_full) - 2);
 
-	return BLI_ghash_lookup(fd->bhead_idname_hash, idname_full);
+	return BLI_ohash_lookup(fd->bhead_idname_hash, idname_full);
 
 #else
 	BHead *bhead;
@@ -4673,7 +4838,7 @@ static BHead *find_bhead_from_code_name(FileData *fd, const short idcode, const
 static BHead *find_bhead_from_idname(FileData *fd, const char *idname)
 {
 #ifdef USE_GHASH_BHEAD
-	return BLI_ghash_lookup(fd->bhead_idname_hash, idname);
+	return BLI_ohash_lookup(fd->bhead_idname_hash, idname);
 #else
 	return find_bhead_from_code_name(fd, GS(idname), idname + 2);
 #endif
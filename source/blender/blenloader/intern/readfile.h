@@ -83,11 +83,15 @@ typedef struct FileData {
 	int tot_bheadmap;
 
 	/* see: USE_GHASH_BHEAD */
-	struct GHash *bhead_idname_hash;
+	struct OHash *bhead_idname_hash;
 
 	ListBase *mainlist;
 	ListBase *old_mainlist;  /* Used for undo. */
 
+	/* Undo: ID name -> ID of old main, for IDs unchanged between the current and read undo steps,
+	 * those are moved into the new main instead of being read again. */
+	struct GHash *undo_reuse_ids;
+
 	/* ick ick, used to return
 	 * data through streamglue.
 	 */
@@ -129,6 +133,7 @@ void blo_end_image_pointer_map(FileData *fd, Main *oldmain);
 void blo_make_packed_pointer_map(FileData *fd, Main *oldmain);
 void blo_end_packed_pointer_map(FileData *fd, Main *oldmain);
 void blo_add_library_pointer_map(ListBase *old_mainlist, FileData *fd);
+void blo_undo_reuse_ids_find(FileData *fd, struct Main *oldmain, struct MemFile *memfile_live);
 
 void blo_freefiledata(FileData *fd);
 
@@ -28,6 +28,7 @@
 #include <math.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <limits.h>
 
 /* open/close */
 #ifndef _WIN32
@@ -41,6 +42,8 @@
 #include "DNA_listBase.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
 
 #include "BLO_undofile.h"
 #include "BLO_readfile.h"
@@ -52,17 +55,74 @@
 
 /* **************** support for memory-write, for undo buffers *************** */
 
+/**
+ * Chunk buffers are shared by content between undo steps (not only at the same position in the file),
+ * so ownership is tracked with a user count stored in front of the data.
+ */
+typedef struct MemFileChunkBuffer {
+	uint users;
+	/* keep the data aligned */
+	uint _pad;
+} MemFileChunkBuffer;
+
+#define CHUNK_BUFFER_FROM_DATA(buf) \
+	((MemFileChunkBuffer *)((char *)(buf) - sizeof(MemFileChunkBuffer)))
+
+static char *memfile_chunk_buffer_alloc(size_t size)
+{
+	MemFileChunkBuffer *chunk_buf = MEM_mallocN(sizeof(MemFileChunkBuffer) + size, "Chunk buffer");
+	chunk_buf->users = 1;
+	return (char *)(chunk_buf + 1);
+}
+
+static void memfile_chunk_buffer_user_add(const char *buf)
+{
+	CHUNK_BUFFER_FROM_DATA(buf)->users++;
+}
+
+static void memfile_chunk_buffer_user_remove(const char *buf)
+{
+	MemFileChunkBuffer *chunk_buf = CHUNK_BUFFER_FROM_DATA(buf);
+	BLI_assert(chunk_buf->users != 0);
+	if (--chunk_buf->users == 0) {
+		MEM_freeN(chunk_buf);
+	}
+}
+
+static uint memfile_chunk_hash(const void *key)
+{
+	const MemFileChunk *chunk = key;
+	return chunk->hash;
+}
+
+static bool memfile_chunk_cmp(const void *a, const void *b)
+{
+	const MemFileChunk *chunk_a = a;
+	const MemFileChunk *chunk_b = b;
+	return !((chunk_a->hash == chunk_b->hash) &&
+	         (chunk_a->size == chunk_b->size) &&
+	         (memcmp(chunk_a->buf, chunk_b->buf, chunk_a->size) == 0));
+}
+
+/** First and last chunk written for a single ID, stored in #MemFile.id_chunks. */
+typedef struct MemFileIDChunks {
+	char id_name[66];  /* MAX_ID_NAME */
+	MemFileChunk *first, *last;
+} MemFileIDChunks;
+
 /* not memfile itself */
 void BLO_memfile_free(MemFile *memfile)
 {
 	MemFileChunk *chunk;
 
 	while ((chunk = BLI_pophead(&memfile->chunks))) {
-		if (chunk->is_identical == false) {
-			MEM_freeN((void *)chunk->buf);
-		}
+		memfile_chunk_buffer_user_remove(chunk->buf);
 		MEM_freeN(chunk);
 	}
+	if (memfile->id_chunks != NULL) {
+		BLI_ghash_free(memfile->id_chunks, NULL, MEM_freeN);
+		memfile->id_chunks = NULL;
+	}
 	memfile->size = 0;
 }
 
@@ -70,28 +130,61 @@ void BLO_memfile_free(MemFile *memfile)
 /* result is that 'first' is being freed */
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
-	MemFileChunk *fc, *sc;
+	MemFileChunk *sc;
 
-	fc = first->chunks.first;
-	sc = second->chunks.first;
-	while (fc || sc) {
-		if (fc && sc) {
-			if (sc->is_identical) {
-				sc->is_identical = false;
-				fc->is_identical = true;
-			}
-		}
-		if (fc) fc = fc->next;
-		if (sc) sc = sc->next;
+	/* buffers are user counted, 'second' keeps the ones it shares with 'first',
+	 * however they are no longer known to be identical to the step before it. */
+	for (sc = second->chunks.first; sc; sc = sc->next) {
+		sc->is_identical = false;
 	}
 
 	BLO_memfile_free(first);
 }
 
-void memfile_chunk_add(
-        MemFile *memfile, const char *buf, uint size,
-        MemFileChunk **compchunk_step)
+/**
+ * Setup writing \a memfile, sharing data with \a reference_memfile (may be NULL).
+ */
+void BLO_memfile_write_init(MemFileWriteData *mem_data, MemFile *written_memfile, MemFile *reference_memfile)
 {
+	mem_data->written_memfile = written_memfile;
+	mem_data->reference_memfile = reference_memfile;
+	mem_data->reference_current_chunk = reference_memfile ? reference_memfile->chunks.first : NULL;
+	mem_data->reference_chunks = NULL;
+	mem_data->id_chunk_prev = NULL;
+
+	if (reference_memfile != NULL) {
+		MemFileChunk *chunk;
+		mem_data->reference_chunks = BLI_gset_new_ex(
+		        memfile_chunk_hash, memfile_chunk_cmp, __func__,
+		        (uint)BLI_listbase_count(&reference_memfile->chunks));
+		for (chunk = reference_memfile->chunks.first; chunk; chunk = chunk->next) {
+			/* first chunk wins when the reference has duplicate content. */
+			BLI_gset_add(mem_data->reference_chunks, chunk);
+		}
+	}
+}
+
+void BLO_memfile_write_finalize(MemFileWriteData *mem_data)
+{
+	if (mem_data->reference_chunks != NULL) {
+		BLI_gset_free(mem_data->reference_chunks, NULL);
+		mem_data->reference_chunks = NULL;
+	}
+	mem_data->id_chunk_prev = NULL;
+}
+
+/**
+ * Add a chunk, sharing its buffer with the reference memfile when the same data exists there.
+ *
+ * The chunk at the same position in the write stream is checked first (the common case),
+ * otherwise chunks are found by content, so inserting or removing data
+ * doesn't cause all following chunks to be duplicated.
+ */
+void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, uint size)
+{
+	MemFile *memfile = mem_data->written_memfile;
+	MemFileChunk **compchunk_step = &mem_data->reference_current_chunk;
+
 	MemFileChunk *curchunk = MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk");
 	curchunk->size = size;
 	curchunk->buf = NULL;
@@ -104,25 +197,124 @@ void memfile_chunk_add(
 		if (compchunk->size == curchunk->size) {
 			if (memcmp(compchunk->buf, buf, size) == 0) {
 				curchunk->buf = compchunk->buf;
+				curchunk->hash = compchunk->hash;
 				curchunk->is_identical = true;
 			}
 		}
 		*compchunk_step = compchunk->next;
 	}
 
-	/* not equal... */
 	if (curchunk->buf == NULL) {
-		char *buf_new = MEM_mallocN(size, "Chunk buffer");
+		curchunk->hash = BLI_hash_mm2((const uchar *)buf, size, 0);
+
+		if (mem_data->reference_chunks != NULL) {
+			const MemFileChunk chunk_key = {.buf = buf, .size = size, .hash = curchunk->hash};
+			const MemFileChunk *compchunk = BLI_gset_lookup(mem_data->reference_chunks, &chunk_key);
+			if (compchunk != NULL) {
+				curchunk->buf = compchunk->buf;
+				curchunk->is_identical = true;
+				/* Re-synchronize positional comparison, data that follows is likely to match too. */
+				mem_data->reference_current_chunk = compchunk->next;
+			}
+		}
+	}
+
+	if (curchunk->buf != NULL) {
+		memfile_chunk_buffer_user_add(curchunk->buf);
+	}
+	else {
+		/* not equal... */
+		char *buf_new = memfile_chunk_buffer_alloc(size);
 		memcpy(buf_new, buf, size);
 		curchunk->buf = buf_new;
 		memfile->size += size;
 	}
 }
 
+/**
+ * Call before writing an ID, the write buffer must be flushed so the ID starts a new chunk.
+ */
+void BLO_memfile_write_id_begin(MemFileWriteData *mem_data)
+{
+	mem_data->id_chunk_prev = mem_data->written_memfile->chunks.last;
+}
+
+/**
+ * Call after writing an ID (and flushing the write buffer),
+ * stores the range of chunks holding this ID's data.
+ */
+void BLO_memfile_write_id_end(MemFileWriteData *mem_data, const char *id_name)
+{
+	MemFile *memfile = mem_data->written_memfile;
+	MemFileChunk *chunk_first = mem_data->id_chunk_prev ? mem_data->id_chunk_prev->next : memfile->chunks.first;
+	MemFileIDChunks *id_chunks;
+	void **id_chunks_p;
+
+	mem_data->id_chunk_prev = NULL;
+
+	if (chunk_first == NULL) {
+		return;
+	}
+
+	if (memfile->id_chunks == NULL) {
+		memfile->id_chunks = BLI_ghash_str_new(__func__);
+	}
+
+	id_chunks = MEM_mallocN(sizeof(*id_chunks), __func__);
+	BLI_strncpy(id_chunks->id_name, id_name, sizeof(id_chunks->id_name));
+	id_chunks->first = chunk_first;
+	id_chunks->last = memfile->chunks.last;
+
+	if (BLI_ghash_ensure_p(memfile->id_chunks, id_chunks->id_name, &id_chunks_p)) {
+		/* Should never happen, local ID names are unique. */
+		BLI_assert(0);
+		MEM_freeN(id_chunks);
+		return;
+	}
+	*id_chunks_p = id_chunks;
+}
+
+/**
+ * \return true when the ID named \a id_name was written with the same data in both memfiles.
+ *
+ * Chunk buffers are shared between undo steps when identical,
+ * so this only compares buffer pointers, not their contents.
+ */
+bool BLO_memfile_id_is_identical(const MemFile *memfile_a, const MemFile *memfile_b, const char *id_name)
+{
+	const MemFileIDChunks *id_chunks_a, *id_chunks_b;
+	const MemFileChunk *chunk_a, *chunk_b;
+
+	if (ELEM(NULL, memfile_a->id_chunks, memfile_b->id_chunks)) {
+		return false;
+	}
+
+	id_chunks_a = BLI_ghash_lookup(memfile_a->id_chunks, id_name);
+	id_chunks_b = BLI_ghash_lookup(memfile_b->id_chunks, id_name);
+	if (ELEM(NULL, id_chunks_a, id_chunks_b)) {
+		return false;
+	}
+
+	for (chunk_a = id_chunks_a->first, chunk_b = id_chunks_b->first;
+	     chunk_a && chunk_b;
+	     chunk_a = chunk_a->next, chunk_b = chunk_b->next)
+	{
+		if ((chunk_a->buf != chunk_b->buf) || (chunk_a->size != chunk_b->size)) {
+			return false;
+		}
+		if ((chunk_a == id_chunks_a->last) || (chunk_b == id_chunks_b->last)) {
+			return ((chunk_a == id_chunks_a->last) && (chunk_b == id_chunks_b->last));
+		}
+	}
+
+	return false;
+}
+
 struct Main *BLO_memfile_main_get(struct MemFile *memfile, struct Main *oldmain, struct Scene **r_scene)
 {
 	struct Main *bmain_undo = NULL;
-	BlendFileData *bfd = BLO_read_from_memfile(oldmain, BKE_main_blendfile_path(oldmain), memfile, BLO_READ_SKIP_NONE, NULL);
+	BlendFileData *bfd = BLO_read_from_memfile(
+	        oldmain, BKE_main_blendfile_path(oldmain), memfile, NULL, BLO_READ_SKIP_NONE, NULL);
 
 	if (bfd) {
 		bmain_undo = bfd->main;
@@ -137,15 +329,89 @@ struct Main *BLO_memfile_main_get(struct MemFile *memfile, struct Main *oldmain,
 }
 
 
+/**
+ * Copy all chunks of \a memfile into a single buffer owned by the returned #MemFile.
+ *
+ * The copy doesn't share any memory with the undo stack,
+ * so it can be written out from a thread while undo steps are added or freed.
+ */
+MemFile *BLO_memfile_flatten(const MemFile *memfile)
+{
+	MemFile *memfile_flat = MEM_callocN(sizeof(MemFile), __func__);
+	MemFileChunk *chunk_flat;
+	const MemFileChunk *chunk;
+	size_t size = 0;
+	char *buf;
+
+	for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
+		size += chunk->size;
+	}
+
+	/* chunk size is an unsigned int, copy the original chunks for (unlikely) bigger files */
+	if (size > UINT_MAX) {
+		MemFileWriteData mem_data;
+		BLO_memfile_write_init(&mem_data, memfile_flat, NULL);
+		for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
+			BLO_memfile_chunk_add(&mem_data, chunk->buf, chunk->size);
+		}
+		BLO_memfile_write_finalize(&mem_data);
+		return memfile_flat;
+	}
+
+	buf = memfile_chunk_buffer_alloc(size);
+	chunk_flat = MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk");
+	chunk_flat->buf = buf;
+	chunk_flat->size = (uint)size;
+	chunk_flat->hash = 0;
+	chunk_flat->is_identical = false;
+	BLI_addtail(&memfile_flat->chunks, chunk_flat);
+	memfile_flat->size = size;
+
+	for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
+		memcpy(buf, chunk->buf, chunk->size);
+		buf += chunk->size;
+	}
+
+	return memfile_flat;
+}
+
+/* Chunks are mostly tiny (one per BHead), gather them so each write call is a reasonable size. */
+#define MEMFILE_WRITE_BUFFER_SIZE (1 << 20)
+
+static bool memfile_write_buffered(int file, char *buf, size_t *buf_used, const char *data, size_t size)
+{
+	if (*buf_used + size > MEMFILE_WRITE_BUFFER_SIZE) {
+		if ((size_t)write(file, buf, *buf_used) != *buf_used) {
+			return false;
+		}
+		*buf_used = 0;
+	}
+
+	if (size >= MEMFILE_WRITE_BUFFER_SIZE) {
+		return ((size_t)write(file, data, size) == size);
+	}
+
+	memcpy(buf + *buf_used, data, size);
+	*buf_used += size;
+	return true;
+}
+
 /**
  * Saves .blend using undo buffer.
  *
+ * The file is written next to \a filename and renamed once it's synced to disk,
+ * so an interrupted save never leaves a truncated file behind.
+ *
  * \return success.
  */
 bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename)
 {
 	MemFileChunk *chunk;
+	char tempname[FILE_MAX + 1];
+	char *buf;
+	size_t buf_used = 0;
 	int file, oflags;
+	bool ok = true;
 
 	/* note: This is currently used for autosave and 'quit.blend', where _not_ following symlinks is OK,
 	 * however if this is ever executed explicitly by the user, we may want to allow writing to symlinks.
@@ -161,7 +427,8 @@ bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename)
 #    warning "Symbolic links will be followed on undo save, possibly causing CVE-2008-1103"
 #  endif
 #endif
-	file = BLI_open(filename,  oflags, 0666);
+	BLI_snprintf(tempname, sizeof(tempname), "%s@", filename);
+	file = BLI_open(tempname, oflags, 0666);
 
 	if (file == -1) {
 		fprintf(stderr, "Unable to save '%s': %s\n",
@@ -169,17 +436,40 @@ bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename)
 		return false;
 	}
 
+	buf = MEM_mallocN(MEMFILE_WRITE_BUFFER_SIZE, __func__);
+
 	for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
-		if ((size_t)write(file, chunk->buf, chunk->size) != chunk->size) {
+		if (!memfile_write_buffered(file, buf, &buf_used, chunk->buf, chunk->size)) {
+			ok = false;
 			break;
 		}
 	}
 
+	if (ok && buf_used) {
+		ok = ((size_t)write(file, buf, buf_used) == buf_used);
+	}
+
+	MEM_freeN(buf);
+
+	/* single sync for the whole file, so the rename below never exposes unwritten data */
+	if (ok) {
+#ifdef WIN32
+		ok = (_commit(file) == 0);
+#else
+		ok = (fsync(file) == 0);
+#endif
+	}
+
 	close(file);
 
-	if (chunk) {
+	if (ok) {
+		ok = (BLI_rename(tempname, filename) == 0);
+	}
+
+	if (!ok) {
 		fprintf(stderr, "Unable to save '%s': %s\n",
 		        filename, errno ? strerror(errno) : "Unknown error writing file");
+		BLI_delete(tempname, false, false);
 		return false;
 	}
 	return true;
@@ -274,12 +274,7 @@ typedef struct {
 	bool error;
 
 	/** #MemFile writing (used for undo). */
-	struct {
-		MemFile      *current;
-		MemFile      *compare;
-		/** Use to de-duplicate chunks when writing. */
-		MemFileChunk *compare_chunk;
-	} mem;
+	MemFileWriteData mem;
 	/** When true, write to #WriteData.current, could also call 'is_undo'. */
 	bool use_memfile;
 
@@ -320,7 +315,7 @@ static void writedata_do_write(WriteData *wd, const void *mem, int memlen)
 
 	/* memory based save */
 	if (wd->use_memfile) {
-		memfile_chunk_add(wd->mem.current, mem, memlen, &wd->mem.compare_chunk);
+		BLO_memfile_chunk_add(&wd->mem, mem, memlen);
 	}
 	else {
 		if (wd->ww->write(wd->ww, mem, memlen) != memlen) {
@@ -414,9 +409,7 @@ static WriteData *mywrite_begin(WriteWrap *ww, MemFile *compare, MemFile *curren
 	WriteData *wd = writedata_new(ww);
 
 	if (current != NULL) {
-		wd->mem.current = current;
-		wd->mem.compare = compare;
-		wd->mem.compare_chunk = compare ? compare->chunks.first : NULL;
+		BLO_memfile_write_init(&wd->mem, current, compare);
 		wd->use_memfile = true;
 	}
 
@@ -436,6 +429,10 @@ static bool mywrite_end(WriteData *wd)
 		wd->buf_used_len = 0;
 	}
 
+	if (wd->use_memfile) {
+		BLO_memfile_write_finalize(&wd->mem);
+	}
+
 	const bool err = wd->error;
 	writedata_free(wd);
 
@@ -1806,6 +1803,10 @@ static bool write_file_handle(
 			/* We should never attempt to write non-regular IDs (i.e. all kind of temp/runtime ones). */
 			BLI_assert((id->tag & (LIB_TAG_NO_MAIN | LIB_TAG_NO_USER_REFCOUNT | LIB_TAG_NOT_ALLOCATED)) == 0);
 
+			if (wd->use_memfile) {
+				BLO_memfile_write_id_begin(&wd->mem);
+			}
+
 			switch ((ID_Type)GS(id->name)) {
 				case ID_WM:
 					write_windowmanager(wd, (wmWindowManager *)id);
@@ -1864,6 +1865,13 @@ static bool write_file_handle(
 					BLI_assert(0);
 					break;
 			}
+
+			/* Segment undo data per ID, so adding or removing an ID
+			 * doesn't shift the data of the following ones into different chunks. */
+			if (wd->use_memfile) {
+				mywrite_flush(wd);
+				BLO_memfile_write_id_end(&wd->mem, id->name);
+			}
 		}
 
 		mywrite_flush(wd);
@@ -76,7 +76,7 @@ static void bm_mempool_init_ex(
 	if (r_lpool) {
 		*r_lpool = BLI_mempool_create(
 		        loop_size, allocsize->totloop,
-		        bm_mesh_chunksize_default.totloop, BLI_MEMPOOL_NOP);
+		        bm_mesh_chunksize_default.totloop, BLI_MEMPOOL_ALLOW_THREADS);
 	}
 	if (r_fpool) {
 		*r_fpool = BLI_mempool_create(
@@ -72,6 +72,8 @@
 #include "BLI_listbase.h"
 #include "BLI_alloca.h"
 #include "BLI_math_vector.h"
+#include "BLI_mempool.h"
+#include "BLI_task.h"
 
 #include "BKE_mesh.h"
 #include "BKE_customdata.h"
@@ -201,6 +203,421 @@ static BMFace *bm_face_create_from_mpoly(
 }
 
 
+/* -------------------------------------------------------------------- */
+/** \name Mesh -> BMesh (Threaded)
+ *
+ * Used when converting a large mesh into a new BMesh.
+ *
+ * Vertices, edges & faces are allocated up-front in order
+ * (so iterating over the BMesh matches the mesh order),
+ * then filled in parallel ranges.
+ *
+ * The disk and radial cycles are stitched per vertex and per edge, from adjacency arrays
+ * built in mesh order, so they match what #BM_edge_create & #BM_face_create would have created.
+ *
+ * Loops and custom-data blocks are never iterated over,
+ * so they're allocated from thread-local pools (see #BLI_mempool_local).
+ * \{ */
+
+#ifndef USE_BMESH_HOLES
+
+typedef struct BMFromMeshThreadedData {
+	BMesh *bm;
+	Mesh *me;
+	bool calc_face_normal;
+
+	BMVert **vtable;
+	BMEdge **etable;
+	BMFace **ftable;
+	BMLoop **ltable;
+
+	/* edges using each vertex, in edge order */
+	int *vert_edge_offs, *vert_edges;
+	/* loops using each edge, in loop order */
+	int *edge_loop_offs, *edge_loops;
+
+	int cd_vert_bweight_offset;
+	int cd_edge_bweight_offset;
+	int cd_edge_crease_offset;
+} BMFromMeshThreadedData;
+
+typedef struct BMFromMeshThreadedTLS {
+	BLI_mempool_local cd_local;
+	/* faces only */
+	BLI_mempool_local cd_loop_local;
+	BLI_mempool_local loop_local;
+} BMFromMeshThreadedTLS;
+
+static void bm_from_me_tls_init(BLI_mempool *pool, BLI_mempool_local *local)
+{
+	if (pool) {
+		BLI_mempool_local_init(pool, local);
+	}
+	else {
+		memset(local, 0, sizeof(*local));
+	}
+}
+
+static void bm_from_me_tls_finalize(void *__restrict UNUSED(userdata), void *__restrict userdata_chunk)
+{
+	BMFromMeshThreadedTLS *tls = userdata_chunk;
+
+	if (tls->cd_local.pool) {
+		BLI_mempool_local_finalize(&tls->cd_local);
+	}
+	if (tls->cd_loop_local.pool) {
+		BLI_mempool_local_finalize(&tls->cd_loop_local);
+	}
+	if (tls->loop_local.pool) {
+		BLI_mempool_local_finalize(&tls->loop_local);
+	}
+}
+
+/**
+ * Thread-safe version of #CustomData_to_bmesh_block for new elements.
+ */
+BLI_INLINE void bm_from_me_cd_block_copy(
+        const CustomData *source, CustomData *dest, BLI_mempool_local *local,
+        int src_index, void **r_block)
+{
+	*r_block = local->pool ? BLI_mempool_local_alloc(local) : NULL;
+	CustomData_to_bmesh_block(source, dest, src_index, r_block, true);
+}
+
+static void bm_from_me_verts_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict tls_range)
+{
+	BMFromMeshThreadedData *data = userdata;
+	BMFromMeshThreadedTLS *tls = tls_range->userdata_chunk;
+	BMesh *bm = data->bm;
+	Mesh *me = data->me;
+	const MVert *mvert = &me->mvert[i];
+	BMVert *v = data->vtable[i];
+	const int *vert_edges = &data->vert_edges[data->vert_edge_offs[i]];
+	const int vert_edges_len = data->vert_edge_offs[i + 1] - data->vert_edge_offs[i];
+	int j;
+
+	v->head.htype = BM_VERT;
+	v->head.hflag = BM_vert_flag_from_mflag(mvert->flag);
+	v->head.api_flag = 0;
+	BM_elem_index_set(v, i); /* set_ok */
+
+	/* hidden elements can't be selected, see #BM_vert_select_set */
+	if (BM_elem_flag_test(v, BM_ELEM_HIDDEN)) {
+		BM_elem_flag_disable(v, BM_ELEM_SELECT);
+	}
+
+	copy_v3_v3(v->co, mvert->co);
+	normal_short_to_float_v3(v->no, mvert->no);
+
+	bm_from_me_cd_block_copy(&me->vdata, &bm->vdata, &tls->cd_local, i, &v->head.data);
+
+	if (data->cd_vert_bweight_offset != -1) BM_ELEM_CD_SET_FLOAT(v, data->cd_vert_bweight_offset, (float)mvert->bweight / 255.0f);
+
+	/* stitch the disk cycle, ordered as #bmesh_disk_edge_append would. */
+	v->e = vert_edges_len ? data->etable[vert_edges[0]] : NULL;
+	for (j = 0; j < vert_edges_len; j++) {
+		const int e_index = vert_edges[j];
+		BMEdge *e = data->etable[e_index];
+		BMDiskLink *dl = ((int)me->medge[e_index].v1 == i) ? &e->v1_disk_link : &e->v2_disk_link;
+
+		dl->next = data->etable[vert_edges[(j + 1) % vert_edges_len]];
+		dl->prev = data->etable[vert_edges[(j + vert_edges_len - 1) % vert_edges_len]];
+	}
+}
+
+static void bm_from_me_faces_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict tls_range)
+{
+	BMFromMeshThreadedData *data = userdata;
+	BMFromMeshThreadedTLS *tls = tls_range->userdata_chunk;
+	BMesh *bm = data->bm;
+	Mesh *me = data->me;
+	const MPoly *mp = &me->mpoly[i];
+	const MLoop *ml = &me->mloop[mp->loopstart];
+	BMFace *f = data->ftable[i];
+	BMLoop *l, *l_prev = NULL;
+	int j;
+
+	f->head.htype = BM_FACE;
+	f->head.hflag = BM_face_flag_from_mflag(mp->flag);
+	f->head.api_flag = 0;
+	BM_elem_index_set(f, i); /* set_ok */
+
+	if (BM_elem_flag_test(f, BM_ELEM_HIDDEN)) {
+		BM_elem_flag_disable(f, BM_ELEM_SELECT);
+	}
+
+	f->len = mp->totloop;
+	f->mat_nr = mp->mat_nr;
+
+	for (j = 0; j < mp->totloop; j++, ml++) {
+		const int l_index = mp->loopstart + j;
+
+		l = data->ltable[l_index] = BLI_mempool_local_alloc(&tls->loop_local);
+
+		l->head.htype = BM_LOOP;
+		l->head.hflag = 0;
+		l->head.api_flag = 0;
+		BM_elem_index_set(l, l_index); /* set_ok */
+
+		l->v = data->vtable[ml->v];
+		l->e = data->etable[ml->e];
+		l->f = f;
+
+		/* 'radial_next' & 'radial_prev' are set from the edges */
+		if (l_prev) {
+			l->prev = l_prev;
+			l_prev->next = l;
+		}
+		else {
+			f->l_first = l;
+		}
+		l_prev = l;
+
+		bm_from_me_cd_block_copy(&me->ldata, &bm->ldata, &tls->cd_loop_local, l_index, &l->head.data);
+	}
+	f->l_first->prev = l_prev;
+	l_prev->next = f->l_first;
+
+	bm_from_me_cd_block_copy(&me->pdata, &bm->pdata, &tls->cd_local, i, &f->head.data);
+
+	if (data->calc_face_normal) {
+		BM_face_normal_update(f);
+	}
+	else {
+		zero_v3(f->no);
+	}
+}
+
+static void bm_from_me_edges_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict tls_range)
+{
+	BMFromMeshThreadedData *data = userdata;
+	BMFromMeshThreadedTLS *tls = tls_range->userdata_chunk;
+	BMesh *bm = data->bm;
+	Mesh *me = data->me;
+	const MEdge *medge = &me->medge[i];
+	BMEdge *e = data->etable[i];
+	const int *edge_loops = &data->edge_loops[data->edge_loop_offs[i]];
+	const int edge_loops_len = data->edge_loop_offs[i + 1] - data->edge_loop_offs[i];
+	int j;
+
+	e->head.htype = BM_EDGE;
+	e->head.hflag = BM_edge_flag_from_mflag(medge->flag);
+	e->head.api_flag = 0;
+	BM_elem_index_set(e, i); /* set_ok */
+
+	if (BM_elem_flag_test(e, BM_ELEM_HIDDEN)) {
+		BM_elem_flag_disable(e, BM_ELEM_SELECT);
+	}
+
+	/* disk links are set from the vertices */
+	e->v1 = data->vtable[medge->v1];
+	e->v2 = data->vtable[medge->v2];
+
+	bm_from_me_cd_block_copy(&me->edata, &bm->edata, &tls->cd_local, i, &e->head.data);
+
+	if (data->cd_edge_bweight_offset != -1) BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
+	if (data->cd_edge_crease_offset  != -1) BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_crease_offset,  (float)medge->crease  / 255.0f);
+
+	/* stitch the radial cycle, ordered as #bmesh_radial_loop_append would
+	 * (which leaves the last loop added in 'e->l'). */
+	e->l = edge_loops_len ? data->ltable[edge_loops[edge_loops_len - 1]] : NULL;
+	for (j = 0; j < edge_loops_len; j++) {
+		BMLoop *l = data->ltable[edge_loops[j]];
+
+		l->radial_next = data->ltable[edge_loops[(j + 1) % edge_loops_len]];
+		l->radial_prev = data->ltable[edge_loops[(j + edge_loops_len - 1) % edge_loops_len]];
+	}
+}
+
+/**
+ * Store the users of each element contiguously (in order of use).
+ *
+ * \param elem_index: Element index for each user, read every \a elem_index_stride integers.
+ */
+static void bm_from_me_adjacency_build(
+        const unsigned int *elem_index, const int elem_index_stride,
+        const int users_len, const int users_per_index, const int elem_len,
+        int **r_offs, int **r_users)
+{
+	const int index_len = users_len * users_per_index;
+	int *offs = MEM_callocN(sizeof(*offs) * (size_t)(elem_len + 1), __func__);
+	int *users = MEM_mallocN(sizeof(*users) * (size_t)MAX2(index_len, 1), __func__);
+	int i;
+
+	for (i = 0; i < index_len; i++) {
+		offs[elem_index[(i / users_per_index) * elem_index_stride + (i % users_per_index)]]++;
+	}
+	/* inclusive prefix sum, filling backwards leaves the start of each range in offs */
+	for (i = 0; i < elem_len; i++) {
+		offs[i + 1] += offs[i];
+	}
+	for (i = index_len - 1; i >= 0; i--) {
+		const unsigned int index = elem_index[(i / users_per_index) * elem_index_stride + (i % users_per_index)];
+		users[--offs[index]] = i / users_per_index;
+	}
+
+	*r_offs = offs;
+	*r_users = users;
+}
+
+/**
+ * \return false when the mesh can't be converted this way (the caller falls back to creating elements one by one).
+ */
+static bool bm_mesh_bm_from_me_threaded(
+        BMesh *bm, Mesh *me,
+        const struct BMeshFromMeshParams *params,
+        BMVert **vtable, BMEdge **etable, BMFace **ftable)
+{
+	BMFromMeshThreadedData data;
+	BMFromMeshThreadedTLS tls;
+	ParallelRangeSettings settings;
+	const MPoly *mp;
+	int i;
+
+	/* empty faces are skipped when creating one by one, keep it simple and don't support them. */
+	for (i = 0, mp = me->mpoly; i < me->totpoly; i++, mp++) {
+		if (UNLIKELY(mp->totloop == 0)) {
+			return false;
+		}
+	}
+
+	BLI_assert(bm->totvert == 0 && bm->totedge == 0 && bm->totface == 0);
+
+	/* Allocate in order, the rest of the members are filled in parallel. */
+	for (i = 0; i < me->totvert; i++) {
+		BMVert *v = vtable[i] = BLI_mempool_alloc(bm->vpool);
+		if (bm->use_toolflags) {
+			((BMVert_OFlag *)v)->oflags = bm->vtoolflagpool ? BLI_mempool_calloc(bm->vtoolflagpool) : NULL;
+		}
+	}
+	for (i = 0; i < me->totedge; i++) {
+		BMEdge *e = etable[i] = BLI_mempool_alloc(bm->epool);
+		if (bm->use_toolflags) {
+			((BMEdge_OFlag *)e)->oflags = bm->etoolflagpool ? BLI_mempool_calloc(bm->etoolflagpool) : NULL;
+		}
+	}
+	for (i = 0; i < me->totpoly; i++) {
+		BMFace *f = ftable[i] = BLI_mempool_alloc(bm->fpool);
+		if (bm->use_toolflags) {
+			((BMFace_OFlag *)f)->oflags = bm->ftoolflagpool ? BLI_mempool_calloc(bm->ftoolflagpool) : NULL;
+		}
+	}
+
+	data.bm = bm;
+	data.me = me;
+	data.calc_face_normal = params->calc_face_normal;
+	data.vtable = vtable;
+	data.etable = etable;
+	data.ftable = ftable;
+	data.ltable = MEM_mallocN(sizeof(*data.ltable) * (size_t)MAX2(me->totloop, 1), __func__);
+
+	bm_from_me_adjacency_build(
+	        &me->medge->v1, sizeof(*me->medge) / sizeof(int), me->totedge, 2, me->totvert,
+	        &data.vert_edge_offs, &data.vert_edges);
+	bm_from_me_adjacency_build(
+	        &me->mloop->e, sizeof(*me->mloop) / sizeof(int), me->totloop, 1, me->totedge,
+	        &data.edge_loop_offs, &data.edge_loops);
+
+	data.cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
+	data.cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
+	data.cd_edge_crease_offset  = CustomData_get_offset(&bm->edata, CD_CREASE);
+
+	BLI_parallel_range_settings_defaults(&settings);
+	settings.userdata_chunk = &tls;
+	settings.userdata_chunk_size = sizeof(tls);
+	settings.func_finalize = bm_from_me_tls_finalize;
+
+	/* vertices first, face normals need their coordinates. */
+	bm_from_me_tls_init(bm->vdata.pool, &tls.cd_local);
+	bm_from_me_tls_init(NULL, &tls.cd_loop_local);
+	bm_from_me_tls_init(NULL, &tls.loop_local);
+	settings.use_threading = (me->totvert >= BM_OMP_LIMIT);
+	BLI_task_parallel_range(0, me->totvert, &data, bm_from_me_verts_cb, &settings);
+
+	bm_from_me_tls_init(bm->pdata.pool, &tls.cd_local);
+	bm_from_me_tls_init(bm->ldata.pool, &tls.cd_loop_local);
+	bm_from_me_tls_init(bm->lpool, &tls.loop_local);
+	settings.use_threading = (me->totpoly >= BM_OMP_LIMIT);
+	BLI_task_parallel_range(0, me->totpoly, &data, bm_from_me_faces_cb, &settings);
+
+	/* edges last, loops are needed for the radial cycles. */
+	bm_from_me_tls_init(bm->edata.pool, &tls.cd_local);
+	bm_from_me_tls_init(NULL, &tls.cd_loop_local);
+	bm_from_me_tls_init(NULL, &tls.loop_local);
+	settings.use_threading = (me->totedge >= BM_OMP_LIMIT);
+	BLI_task_parallel_range(0, me->totedge, &data, bm_from_me_edges_cb, &settings);
+
+	bm->totvert = me->totvert;
+	bm->totedge = me->totedge;
+	bm->totloop = me->totloop;
+	bm->totface = me->totpoly;
+
+	bm->elem_index_dirty &= ~BM_ALL;
+	bm->elem_table_dirty |= BM_ALL_NOLOOP;
+
+	if ((me->act_face >= 0) && (me->act_face < me->totpoly)) {
+		bm->act_face = ftable[me->act_face];
+	}
+
+	/* Selection: flush down to vertices & edges (as #BM_face_select_set does), then count. */
+	bm->totvertsel = bm->totedgesel = bm->totfacesel = 0;
+	for (i = 0; i < me->totpoly; i++) {
+		BMFace *f = ftable[i];
+		if (BM_elem_flag_test(f, BM_ELEM_SELECT)) {
+			BMLoop *l_iter, *l_first;
+			l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+			do {
+				if (!BM_elem_flag_test(l_iter->v, BM_ELEM_HIDDEN)) {
+					BM_elem_flag_enable(l_iter->v, BM_ELEM_SELECT);
+				}
+				if (!BM_elem_flag_test(l_iter->e, BM_ELEM_HIDDEN)) {
+					BM_elem_flag_enable(l_iter->e, BM_ELEM_SELECT);
+				}
+			} while ((l_iter = l_iter->next) != l_first);
+			bm->totfacesel += 1;
+		}
+	}
+	for (i = 0; i < me->totedge; i++) {
+		BMEdge *e = etable[i];
+		if (BM_elem_flag_test(e, BM_ELEM_SELECT)) {
+			if (!BM_elem_flag_test(e->v1, BM_ELEM_HIDDEN)) {
+				BM_elem_flag_enable(e->v1, BM_ELEM_SELECT);
+			}
+			if (!BM_elem_flag_test(e->v2, BM_ELEM_HIDDEN)) {
+				BM_elem_flag_enable(e->v2, BM_ELEM_SELECT);
+			}
+			bm->totedgesel += 1;
+		}
+	}
+	for (i = 0; i < me->totvert; i++) {
+		if (BM_elem_flag_test(vtable[i], BM_ELEM_SELECT)) {
+			bm->totvertsel += 1;
+		}
+	}
+
+	MEM_freeN(data.ltable);
+	MEM_freeN(data.vert_edge_offs);
+	MEM_freeN(data.vert_edges);
+	MEM_freeN(data.edge_loop_offs);
+	MEM_freeN(data.edge_loops);
+
+	return true;
+}
+
+#endif  /* USE_BMESH_HOLES */
+
+/** \} */
+
+
 /**
  * \brief Mesh -> BMesh
  * \param bm: The mesh to write into, while this is typically a newly created BMesh,
@@ -272,6 +689,18 @@ void BM_mesh_bm_from_me(
 	const int cd_edge_crease_offset  = CustomData_get_offset(&bm->edata, CD_CREASE);
 
 	vtable = MEM_mallocN(sizeof(BMVert **) * me->totvert, __func__);
+	etable = MEM_mallocN(sizeof(BMEdge **) * me->totedge, __func__);
+
+#ifndef USE_BMESH_HOLES
+	if (is_new && (me->totpoly >= BM_OMP_LIMIT || me->totvert >= BM_OMP_LIMIT)) {
+		ftable = MEM_mallocN(sizeof(BMFace **) * me->totpoly, __func__);
+		if (bm_mesh_bm_from_me_threaded(bm, me, params, vtable, etable, ftable)) {
+			goto finally;
+		}
+		MEM_freeN(ftable);
+		ftable = NULL;
+	}
+#endif
 
 	for (i = 0, mvert = me->mvert; i < me->totvert; i++, mvert++) {
 		v = vtable[i] = BM_vert_create(bm, keyco ? keyco[i] : mvert->co, NULL, BM_CREATE_SKIP_CD);
@@ -296,8 +725,6 @@ void BM_mesh_bm_from_me(
 		bm->elem_index_dirty &= ~BM_VERT; /* added in order, clear dirty flag */
 	}
 
-	etable = MEM_mallocN(sizeof(BMEdge **) * me->totedge, __func__);
-
 	medge = me->medge;
 	for (i = 0; i < me->totedge; i++, medge++) {
 		e = etable[i] = BM_edge_create(bm, vtable[medge->v1], vtable[medge->v2], NULL, BM_CREATE_SKIP_CD);
@@ -381,6 +808,7 @@ void BM_mesh_bm_from_me(
 		bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* added in order, clear dirty flag */
 	}
 
+finally:
 	/* -------------------------------------------------------------------- */
 	/* MSelect clears the array elements (avoid adding multiple times).
 	 *
@@ -484,6 +912,110 @@ BLI_INLINE void bmesh_quick_edgedraw_flag(MEdge *med, BMEdge *e)
 	}
 }
 
+typedef struct BMToMeshThreadedData {
+	BMesh *bm;
+	Mesh *me;
+
+	MVert *mvert;
+	MEdge *medge;
+	MPoly *mpoly;
+	MLoop *mloop;
+
+	int cd_vert_bweight_offset;
+	int cd_edge_bweight_offset;
+	int cd_edge_crease_offset;
+} BMToMeshThreadedData;
+
+static void bm_to_me_verts_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	BMToMeshThreadedData *data = userdata;
+	BMesh *bm = data->bm;
+	BMVert *v = bm->vtable[i];
+	MVert *mvert = &data->mvert[i];
+
+	copy_v3_v3(mvert->co, v->co);
+	normal_float_to_short_v3(mvert->no, v->no);
+
+	mvert->flag = BM_vert_flag_to_mflag(v);
+
+	/* copy over customdat */
+	CustomData_from_bmesh_block(&bm->vdata, &data->me->vdata, v->head.data, i);
+
+	if (data->cd_vert_bweight_offset != -1) mvert->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, data->cd_vert_bweight_offset);
+
+	BM_CHECK_ELEMENT(v);
+}
+
+static void bm_to_me_edges_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	BMToMeshThreadedData *data = userdata;
+	BMesh *bm = data->bm;
+	BMEdge *e = bm->etable[i];
+	MEdge *med = &data->medge[i];
+
+	med->v1 = BM_elem_index_get(e->v1);
+	med->v2 = BM_elem_index_get(e->v2);
+
+	med->flag = BM_edge_flag_to_mflag(e);
+
+	/* copy over customdata */
+	CustomData_from_bmesh_block(&bm->edata, &data->me->edata, e->head.data, i);
+
+	bmesh_quick_edgedraw_flag(med, e);
+
+	if (data->cd_edge_crease_offset  != -1) med->crease  = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, data->cd_edge_crease_offset);
+	if (data->cd_edge_bweight_offset != -1) med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, data->cd_edge_bweight_offset);
+
+	BM_CHECK_ELEMENT(e);
+}
+
+/**
+ * \note 'loopstart' is already set, since it depends on all previous faces.
+ */
+static void bm_to_me_faces_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	BMToMeshThreadedData *data = userdata;
+	BMesh *bm = data->bm;
+	BMFace *f = bm->ftable[i];
+	MPoly *mpoly = &data->mpoly[i];
+	BMLoop *l_iter, *l_first;
+	int j = mpoly->loopstart;
+	MLoop *mloop = &data->mloop[j];
+
+	mpoly->totloop = f->len;
+	mpoly->mat_nr = f->mat_nr;
+	mpoly->flag = BM_face_flag_to_mflag(f);
+
+	l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+	do {
+		mloop->e = BM_elem_index_get(l_iter->e);
+		mloop->v = BM_elem_index_get(l_iter->v);
+
+		/* copy over customdata */
+		CustomData_from_bmesh_block(&bm->ldata, &data->me->ldata, l_iter->head.data, j);
+
+		j++;
+		mloop++;
+		BM_CHECK_ELEMENT(l_iter);
+		BM_CHECK_ELEMENT(l_iter->e);
+		BM_CHECK_ELEMENT(l_iter->v);
+	} while ((l_iter = l_iter->next) != l_first);
+
+	/* copy over customdata */
+	CustomData_from_bmesh_block(&bm->pdata, &data->me->pdata, f->head.data, i);
+
+	BM_CHECK_ELEMENT(f);
+}
+
 /**
  *
  * \param bmain: May be NULL in case \a calc_object_remap parameter option is not set.
@@ -495,11 +1027,9 @@ void BM_mesh_bm_to_me(
 	MLoop *mloop;
 	MPoly *mpoly;
 	MVert *mvert, *oldverts;
-	MEdge *med, *medge;
-	BMVert *v, *eve;
-	BMEdge *e;
+	MEdge *medge;
+	BMVert *eve;
 	BMFace *f;
-	BMIter iter;
 	int i, j, ototvert;
 
 	const int cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
@@ -569,83 +1099,37 @@ void BM_mesh_bm_to_me(
 	/* this is called again, 'dotess' arg is used there */
 	BKE_mesh_update_customdata_pointers(me, 0);
 
-	i = 0;
-	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-		copy_v3_v3(mvert->co, v->co);
-		normal_float_to_short_v3(mvert->no, v->no);
+	/* Elements are written in parallel, from their tables. */
+	BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE | BM_FACE);
+	BM_mesh_elem_table_ensure(bm, BM_VERT | BM_EDGE | BM_FACE);
 
-		mvert->flag = BM_vert_flag_to_mflag(v);
-
-		BM_elem_index_set(v, i); /* set_inline */
-
-		/* copy over customdat */
-		CustomData_from_bmesh_block(&bm->vdata, &me->vdata, v->head.data, i);
-
-		if (cd_vert_bweight_offset != -1) mvert->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, cd_vert_bweight_offset);
-
-		i++;
-		mvert++;
-
-		BM_CHECK_ELEMENT(v);
-	}
-	bm->elem_index_dirty &= ~BM_VERT;
-
-	med = medge;
-	i = 0;
-	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-		med->v1 = BM_elem_index_get(e->v1);
-		med->v2 = BM_elem_index_get(e->v2);
-
-		med->flag = BM_edge_flag_to_mflag(e);
-
-		BM_elem_index_set(e, i); /* set_inline */
-
-		/* copy over customdata */
-		CustomData_from_bmesh_block(&bm->edata, &me->edata, e->head.data, i);
-
-		bmesh_quick_edgedraw_flag(med, e);
-
-		if (cd_edge_crease_offset  != -1) med->crease  = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_crease_offset);
-		if (cd_edge_bweight_offset != -1) med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_bweight_offset);
-
-		i++;
-		med++;
-		BM_CHECK_ELEMENT(e);
+	for (i = 0, j = 0; i < bm->totface; i++) {
+		f = bm->ftable[i];
+		mpoly[i].loopstart = j;
+		if (f == bm->act_face) me->act_face = i;
+		j += f->len;
 	}
-	bm->elem_index_dirty &= ~BM_EDGE;
 
-	i = 0;
-	j = 0;
-	BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
-		BMLoop *l_iter, *l_first;
-		mpoly->loopstart = j;
-		mpoly->totloop = f->len;
-		mpoly->mat_nr = f->mat_nr;
-		mpoly->flag = BM_face_flag_to_mflag(f);
-
-		l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-		do {
-			mloop->e = BM_elem_index_get(l_iter->e);
-			mloop->v = BM_elem_index_get(l_iter->v);
+	{
+		BMToMeshThreadedData data = {
+			.bm = bm, .me = me,
+			.mvert = mvert, .medge = medge, .mpoly = mpoly, .mloop = mloop,
+			.cd_vert_bweight_offset = cd_vert_bweight_offset,
+			.cd_edge_bweight_offset = cd_edge_bweight_offset,
+			.cd_edge_crease_offset = cd_edge_crease_offset,
+		};
+		ParallelRangeSettings settings;
 
-			/* copy over customdata */
-			CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
+		BLI_parallel_range_settings_defaults(&settings);
 
-			j++;
-			mloop++;
-			BM_CHECK_ELEMENT(l_iter);
-			BM_CHECK_ELEMENT(l_iter->e);
-			BM_CHECK_ELEMENT(l_iter->v);
-		} while ((l_iter = l_iter->next) != l_first);
+		settings.use_threading = (bm->totvert >= BM_OMP_LIMIT);
+		BLI_task_parallel_range(0, bm->totvert, &data, bm_to_me_verts_cb, &settings);
 
-		if (f == bm->act_face) me->act_face = i;
-
-		/* copy over customdata */
-		CustomData_from_bmesh_block(&bm->pdata, &me->pdata, f->head.data, i);
+		settings.use_threading = (bm->totedge >= BM_OMP_LIMIT);
+		BLI_task_parallel_range(0, bm->totedge, &data, bm_to_me_edges_cb, &settings);
 
-		i++;
-		mpoly++;
-		BM_CHECK_ELEMENT(f);
+		settings.use_threading = (bm->totface >= BM_OMP_LIMIT);
+		BLI_task_parallel_range(0, bm->totface, &data, bm_to_me_faces_cb, &settings);
 	}
 
 	/* patch hook indices and vertex parents */
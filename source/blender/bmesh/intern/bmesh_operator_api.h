@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #include "BLI_ghash.h"
+#include "BLI_ohash.h"
 
 #include <stdarg.h>
 
@@ -67,7 +68,7 @@ extern "C" {
  * \note only #BMLoop items can't be put into slots as with verts, edges & faces.
  */
 
-struct GHashIterator;
+struct OHashIterator;
 
 BLI_INLINE BMFlagLayer *BMO_elem_flag_from_header(BMHeader *ele_head)
 {
@@ -211,7 +212,7 @@ typedef struct BMOpSlot {
 		void *p;
 		float vec[3];
 		void **buf;
-		GHash *ghash;
+		OHash *ohash;
 	} data;
 } BMOpSlot;
 
@@ -222,7 +223,7 @@ typedef struct BMOpSlot {
 #define BMO_SLOT_AS_VECTOR(slot)       ((slot)->data.vec)
 #define BMO_SLOT_AS_MATRIX(slot )      ((float (*)[4])((slot)->data.p))
 #define BMO_SLOT_AS_BUFFER(slot )      ((slot)->data.buf)
-#define BMO_SLOT_AS_GHASH(slot )       ((slot)->data.ghash)
+#define BMO_SLOT_AS_OHASH(slot )       ((slot)->data.ohash)
 
 #define BMO_ASSERT_SLOT_IN_OP(slot, op) \
 	BLI_assert(((slot >= (op)->slots_in)  && (slot < &(op)->slots_in[BMO_OP_MAX_SLOTS])) || \
@@ -532,7 +533,7 @@ void BMO_slot_buffer_from_all(
 typedef struct BMOIter {
 	BMOpSlot *slot;
 	int cur; //for arrays
-	GHashIterator giter;
+	OHashIterator oiter;
 	void **val;
 	char restrictmask; /* bitwise '&' with BMHeader.htype */
 } BMOIter;
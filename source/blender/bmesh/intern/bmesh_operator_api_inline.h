@@ -144,14 +144,14 @@ ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1)
 BLI_INLINE bool BMO_slot_map_contains(BMOpSlot *slot, const void *element)
 {
 	BLI_assert(slot->slot_type == BMO_OP_SLOT_MAPPING);
-	return BLI_ghash_haskey(slot->data.ghash, element);
+	return BLI_ohash_haskey(slot->data.ohash, element);
 }
 
 ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1)
 BLI_INLINE void **BMO_slot_map_data_get(BMOpSlot *slot, const void *element)
 {
 
-	return BLI_ghash_lookup_p(slot->data.ghash, element);
+	return BLI_ohash_lookup_p(slot->data.ohash, element);
 }
 
 ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1)
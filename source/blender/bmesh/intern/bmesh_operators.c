@@ -132,7 +132,7 @@ static void bmo_op_slots_init(const BMOSlotType *slot_types, BMOpSlot *slot_args
 
 		switch (slot->slot_type) {
 			case BMO_OP_SLOT_MAPPING:
-				slot->data.ghash = BLI_ghash_ptr_new("bmesh slot map hash");
+				slot->data.ohash = BLI_ohash_ptr_new("bmesh slot map hash");
 				break;
 			default:
 				break;
@@ -148,7 +148,7 @@ static void bmo_op_slots_free(const BMOSlotType *slot_types, BMOpSlot *slot_args
 		slot = &slot_args[i];
 		switch (slot->slot_type) {
 			case BMO_OP_SLOT_MAPPING:
-				BLI_ghash_free(slot->data.ghash, NULL, NULL);
+				BLI_ohash_free(slot->data.ohash, NULL, NULL);
 				break;
 			default:
 				break;
@@ -342,11 +342,12 @@ void _bmo_slot_copy(
 		}
 	}
 	else if (slot_dst->slot_type == BMO_OP_SLOT_MAPPING) {
-		GHashIterator gh_iter;
-		GHASH_ITER (gh_iter, slot_src->data.ghash) {
-			void *key = BLI_ghashIterator_getKey(&gh_iter);
-			void *val = BLI_ghashIterator_getValue(&gh_iter);
-			BLI_ghash_insert(slot_dst->data.ghash, key, val);
+		OHashIterator oh_iter;
+		BLI_ohash_reserve(slot_dst->data.ohash, BLI_ohash_len(slot_dst->data.ohash) + BLI_ohash_len(slot_src->data.ohash));
+		OHASH_ITER (oh_iter, slot_src->data.ohash) {
+			void *key = BLI_ohashIterator_getKey(&oh_iter);
+			void *val = BLI_ohashIterator_getValue(&oh_iter);
+			BLI_ohash_reinsert(slot_dst->data.ohash, key, val, NULL, NULL);
 		}
 	}
 	else {
@@ -666,7 +667,7 @@ int BMO_slot_map_count(BMOpSlot slot_args[BMO_OP_MAX_SLOTS], const char *slot_na
 {
 	BMOpSlot *slot = BMO_slot_get(slot_args, slot_name);
 	BLI_assert(slot->slot_type == BMO_OP_SLOT_MAPPING);
-	return BLI_ghash_len(slot->data.ghash);
+	return BLI_ohash_len(slot->data.ohash);
 }
 
 /* inserts a key/value mapping into a mapping slot.  note that it copies the
@@ -681,7 +682,7 @@ void BMO_slot_map_insert(
 	BLI_assert(slot->slot_type == BMO_OP_SLOT_MAPPING);
 	BMO_ASSERT_SLOT_IN_OP(slot, op);
 
-	BLI_ghash_insert(slot->data.ghash, (void *)element, (void *)data);
+	BLI_ohash_reinsert(slot->data.ohash, (void *)element, (void *)data, NULL, NULL);
 }
 
 #if 0
@@ -731,15 +732,15 @@ void BMO_slot_map_to_flag(
         BMesh *bm, BMOpSlot slot_args[BMO_OP_MAX_SLOTS], const char *slot_name,
         const char htype, const short oflag)
 {
-	GHashIterator gh_iter;
+	OHashIterator oh_iter;
 	BMOpSlot *slot = BMO_slot_get(slot_args, slot_name);
 	BMElemF *ele_f;
 
 	BLI_assert(slot->slot_type == BMO_OP_SLOT_MAPPING);
 
 
-	GHASH_ITER (gh_iter, slot->data.ghash) {
-		ele_f = BLI_ghashIterator_getKey(&gh_iter);
+	OHASH_ITER (oh_iter, slot->data.ohash) {
+		ele_f = BLI_ohashIterator_getKey(&oh_iter);
 		if (ele_f->head.htype & htype) {
 			BMO_elem_flag_enable(bm, ele_f, oflag);
 		}
@@ -1385,7 +1386,7 @@ void *BMO_iter_new(
 	iter->restrictmask = restrictmask;
 
 	if (iter->slot->slot_type == BMO_OP_SLOT_MAPPING) {
-		BLI_ghashIterator_init(&iter->giter, slot->data.ghash);
+		BLI_ohashIterator_init(&iter->oiter, slot->data.ohash);
 	}
 	else if (iter->slot->slot_type == BMO_OP_SLOT_ELEMENT_BUF) {
 		BLI_assert(restrictmask & slot->slot_subtype.elem);
@@ -1425,11 +1426,11 @@ void *BMO_iter_step(BMOIter *iter)
 		void *ret;
 
 
-		if (BLI_ghashIterator_done(&iter->giter) == false) {
-			ret = BLI_ghashIterator_getKey(&iter->giter);
-			iter->val = BLI_ghashIterator_getValue_p(&iter->giter);
+		if (BLI_ohashIterator_done(&iter->oiter) == false) {
+			ret = BLI_ohashIterator_getKey(&iter->oiter);
+			iter->val = BLI_ohashIterator_getValue_p(&iter->oiter);
 
-			BLI_ghashIterator_step(&iter->giter);
+			BLI_ohashIterator_step(&iter->oiter);
 		}
 		else {
 			ret = NULL;
@@ -607,10 +607,8 @@ static void bm_edgering_pair_interpolate(
 
 		coord_array_main = MEM_mallocN(dims * (resolu) * sizeof(float), __func__);
 
-		for (i = 0; i < dims; i++) {
-			BKE_curve_forward_diff_bezier(el_store_a_co[i], handle_a[i], handle_b[i], el_store_b_co[i],
-			                              ((float *)coord_array_main) + i, resolu - 1, sizeof(float) * dims);
-		}
+		BKE_curve_forward_diff_bezier_v3(el_store_a_co, handle_a, handle_b, el_store_b_co,
+		                                 (float *)coord_array_main, resolu - 1, sizeof(float) * dims);
 	}
 
 	switch (interp_mode) {
@@ -780,10 +778,8 @@ static void bm_edgering_pair_interpolate(
 				add_v3_v3(handle_a, co_a);
 				add_v3_v3(handle_b, co_b);
 
-				for (i = 0; i < dims; i++) {
-					BKE_curve_forward_diff_bezier(co_a[i], handle_a[i], handle_b[i], co_b[i],
-					                              ((float *)coord_array) + i, resolu - 1, sizeof(float) * dims);
-				}
+				BKE_curve_forward_diff_bezier_v3(co_a, handle_a, handle_b, co_b,
+				                                 (float *)coord_array, resolu - 1, sizeof(float) * dims);
 
 				/* skip first and last */
 				for (v_iter = ((LinkData *)lb_ring->first)->next, i = 1;
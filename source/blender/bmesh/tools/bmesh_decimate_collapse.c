@@ -34,6 +34,7 @@
 #include "BLI_edgehash.h"
 #include "BLI_polyfill_2d.h"
 #include "BLI_polyfill_2d_beautify.h"
+#include "BLI_task.h"
 #include "BLI_utildefines_stack.h"
 
 
@@ -77,6 +78,18 @@ typedef enum CD_UseFlag {
 /* BMesh Helper Functions
  * ********************** */
 
+static void bm_decim_build_face_plane_cb(void *userdata, MempoolIterData *mp_f)
+{
+	double (*fplanes)[4] = userdata;
+	BMFace *f = (BMFace *)mp_f;
+	double *plane_db = fplanes[BM_elem_index_get(f)];
+	float center[3];
+
+	BM_face_calc_center_median(f, center);
+	copy_v3db_v3fl(plane_db, f->no);
+	plane_db[3] = -dot_v3db_v3fl(plane_db, center);
+}
+
 /**
  * \param vquadrics: must be calloc'd
  */
@@ -85,20 +98,20 @@ static void bm_decim_build_quadrics(BMesh *bm, Quadric *vquadrics)
 	BMIter iter;
 	BMFace *f;
 	BMEdge *e;
+	double (*fplanes)[4] = MEM_mallocN(sizeof(*fplanes) * (size_t)bm->totface, __func__);
+
+	/* face planes are calculated in parallel,
+	 * accumulate the quadrics in face order so the sums don't depend on threading */
+	BM_mesh_elem_index_ensure(bm, BM_FACE);
+	BM_iter_parallel(bm, BM_FACES_OF_MESH, bm_decim_build_face_plane_cb, fplanes, bm->totface >= BM_OMP_LIMIT);
 
 	BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
 		BMLoop *l_first;
 		BMLoop *l_iter;
 
-		float center[3];
-		double plane_db[4];
 		Quadric q;
 
-		BM_face_calc_center_median(f, center);
-		copy_v3db_v3fl(plane_db, f->no);
-		plane_db[3] = -dot_v3db_v3fl(plane_db, center);
-
-		BLI_quadric_from_plane(&q, plane_db);
+		BLI_quadric_from_plane(&q, fplanes[BM_elem_index_get(f)]);
 
 		l_iter = l_first = BM_FACE_FIRST_LOOP(f);
 		do {
@@ -133,6 +146,8 @@ static void bm_decim_build_quadrics(BMesh *bm, Quadric *vquadrics)
 			}
 		}
 	}
+
+	MEM_freeN(fplanes);
 }
 
 
@@ -242,11 +257,16 @@ static float bm_decim_build_edge_cost_single__topology(BMEdge *e)
 
 #endif  /* USE_TOPOLOGY_FALLBACK */
 
-static void bm_decim_build_edge_cost_single(
+/**
+ * Calculate the collapse cost of \a e, only reads the mesh so it's safe to run from threads.
+ *
+ * \return false when the edge can't be collapsed (it must not be in the heap).
+ */
+static bool bm_decim_calc_edge_cost(
         BMEdge *e,
         const Quadric *vquadrics,
         const float *vweights, const float vweight_factor,
-        Heap *eheap, HeapNode **eheap_table)
+        float *r_cost)
 {
 	float cost;
 
@@ -331,10 +351,26 @@ static void bm_decim_build_edge_cost_single(
 		}
 	}
 
-	BLI_heap_insert_or_update(eheap, &eheap_table[BM_elem_index_get(e)], cost, e);
-	return;
+	*r_cost = cost;
+	return true;
 
 clear:
+	return false;
+}
+
+static void bm_decim_build_edge_cost_single(
+        BMEdge *e,
+        const Quadric *vquadrics,
+        const float *vweights, const float vweight_factor,
+        Heap *eheap, HeapNode **eheap_table)
+{
+	float cost;
+
+	if (bm_decim_calc_edge_cost(e, vquadrics, vweights, vweight_factor, &cost)) {
+		BLI_heap_insert_or_update(eheap, &eheap_table[BM_elem_index_get(e)], cost, e);
+		return;
+	}
+
 	if (eheap_table[BM_elem_index_get(e)]) {
 		BLI_heap_remove(eheap, eheap_table[BM_elem_index_get(e)]);
 	}
@@ -352,6 +388,30 @@ static void bm_decim_invalid_edge_cost_single(
 	eheap_table[BM_elem_index_get(e)] = BLI_heap_insert(eheap, COST_INVALID, e);
 }
 
+typedef struct DecimEdgeCost {
+	float cost;
+	bool is_valid;
+} DecimEdgeCost;
+
+typedef struct DecimEdgeCostData {
+	/* Read-only data. */
+	const Quadric *vquadrics;
+	const float *vweights;
+	float vweight_factor;
+
+	/* Edge index aligned, each thread only writes to its own edges. */
+	DecimEdgeCost *ecosts;
+} DecimEdgeCostData;
+
+static void bm_decim_build_edge_cost_cb(void *userdata, MempoolIterData *mp_e)
+{
+	DecimEdgeCostData *data = userdata;
+	BMEdge *e = (BMEdge *)mp_e;
+	DecimEdgeCost *ecost = &data->ecosts[BM_elem_index_get(e)];
+
+	ecost->is_valid = bm_decim_calc_edge_cost(e, data->vquadrics, data->vweights, data->vweight_factor, &ecost->cost);
+}
+
 static void bm_decim_build_edge_cost(
         BMesh *bm,
         const Quadric *vquadrics,
@@ -362,10 +422,23 @@ static void bm_decim_build_edge_cost(
 	BMEdge *e;
 	uint i;
 
+	/* costs are calculated in parallel, then added to the heap in edge order,
+	 * giving the same heap (and so the same collapse order) as adding them one at a time */
+	DecimEdgeCostData data = {
+		.vquadrics = vquadrics,
+		.vweights = vweights,
+		.vweight_factor = vweight_factor,
+		.ecosts = MEM_mallocN(sizeof(*data.ecosts) * (size_t)bm->totedge, __func__),
+	};
+
+	BM_iter_parallel(bm, BM_EDGES_OF_MESH, bm_decim_build_edge_cost_cb, &data, bm->totedge >= BM_OMP_LIMIT);
+
 	BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
-		eheap_table[i] = NULL;  /* keep sanity check happy */
-		bm_decim_build_edge_cost_single(e, vquadrics, vweights, vweight_factor, eheap, eheap_table);
+		const DecimEdgeCost *ecost = &data.ecosts[i];
+		eheap_table[i] = ecost->is_valid ? BLI_heap_insert(eheap, ecost->cost, e) : NULL;
 	}
+
+	MEM_freeN(data.ecosts);
 }
 
 #ifdef USE_SYMMETRY
@@ -1340,7 +1413,11 @@ void BM_mesh_decimate_collapse(
 	if (CustomData_has_math(&bm->ldata))    customdata_flag |= CD_DO_LOOP;
 #endif
 
-	/* iterative edge collapse and maintain the eheap */
+	/* iterative edge collapse and maintain the eheap
+	 *
+	 * Only building the quadrics and initial costs (above) is threaded, collapsing is not:
+	 * each collapse frees elements from the meshes shared pools and changes the costs of
+	 * its neighbors in the one global heap, which decides the order of all collapses. */
 #ifdef USE_SYMMETRY
 	if (use_symmetry == false)
 #endif
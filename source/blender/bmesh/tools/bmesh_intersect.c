@@ -26,6 +26,11 @@
  * - Non-planar faces.
  * - Custom-data (UV's etc).
  *
+ * The threaded BVH overlap prefilters candidate triangle pairs,
+ * rejecting those which can't interact (conservative double precision plane test).
+ * This is only an optimization, the intersection itself is unchanged:
+ * it uses float precision and runs single threaded.
+ *
  * Unsupported:
  * - Intersecting between different meshes.
  * - No support for holes (cutting a hole into a single face).
@@ -76,6 +81,8 @@
 // #define USE_PARANOID
 /* use accelerated overlap check */
 #define USE_BVH
+/* prefilter triangle pairs that can't intersect while calculating the (threaded) overlap */
+#define USE_BVH_PREFILTER
 
 // #define USE_BOOLEAN_RAYCAST_DRAW
 
@@ -294,6 +301,77 @@ static void vert_dissolve_add(
 }
 #endif
 
+/**
+ * Exact check that \a p is on the (infinite) line through \a l1, \a l2,
+ * which is the case when the points are co-linear in all three axis aligned projections.
+ */
+static bool is_point_on_line_exact_v3(const float p[3], const float l1[3], const float l2[3])
+{
+	uint i;
+	for (i = 0; i < 3; i++) {
+		const uint j = (i + 1) % 3;
+		const float p_proj[2] = {p[i], p[j]}, l1_proj[2] = {l1[i], l1[j]}, l2_proj[2] = {l2[i], l2[j]};
+		if (orient2d_exact_v2(l1_proj, l2_proj, p_proj) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Check if the segment (\a p0, \a p1) passes through the inside of the triangle,
+ * using exact orientation tests so rounding can't make the result depend on the order of the input.
+ *
+ * Only a segment crossing the triangles plane (one point on each side) through its interior is accepted.
+ * Co-planar segments and segments touching the plane, or passing exactly through
+ * an edge or vertex of the triangle are degenerate cases, which are handled by the edge & vertex tests.
+ *
+ * \param r_fac: The factor along the segment where it crosses the triangles plane.
+ */
+static bool isect_line_segment_tri_exact_v3(
+        const float p0[3], const float p1[3],
+        const float *t_cos[3],
+        float *r_fac)
+{
+	const int side_p0 = orient3d_exact_v3(UNPACK3(t_cos), p0);
+	const int side_p1 = orient3d_exact_v3(UNPACK3(t_cos), p1);
+	int side_edge[3];
+	double e1[3], e2[3], nor[3], dist_p0, dist_p1;
+	uint i;
+
+	if ((side_p0 == 0) || (side_p0 != -side_p1)) {
+		return false;
+	}
+
+	/* the line passes on the same side of all triangle edges */
+	side_edge[0] = orient3d_exact_v3(p0, p1, t_cos[0], t_cos[1]);
+	side_edge[1] = orient3d_exact_v3(p0, p1, t_cos[1], t_cos[2]);
+	side_edge[2] = orient3d_exact_v3(p0, p1, t_cos[2], t_cos[0]);
+	if ((side_edge[0] == 0) || (side_edge[0] != side_edge[1]) || (side_edge[0] != side_edge[2])) {
+		return false;
+	}
+
+	for (i = 0; i < 3; i++) {
+		e1[i] = (double)t_cos[1][i] - (double)t_cos[0][i];
+		e2[i] = (double)t_cos[2][i] - (double)t_cos[0][i];
+	}
+
+	nor[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	nor[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	nor[2] = e1[0] * e2[1] - e1[1] * e2[0];
+
+	dist_p0 = dist_p1 = 0.0;
+	for (i = 0; i < 3; i++) {
+		dist_p0 += ((double)p0[i] - (double)t_cos[0][i]) * nor[i];
+		dist_p1 += ((double)p1[i] - (double)t_cos[0][i]) * nor[i];
+	}
+
+	/* the sides are exact, the distances aren't, keep the factor in range */
+	*r_fac = (dist_p0 != dist_p1) ? (float)(dist_p0 / (dist_p0 - dist_p1)) : 0.5f;
+	CLAMP(*r_fac, 0.0f, 1.0f);
+	return true;
+}
+
 static enum ISectType intersect_line_tri(
         const float p0[3], const float p1[3],
         const float *t_cos[3], const float t_nor[3],
@@ -313,7 +391,10 @@ static enum ISectType intersect_line_tri(
 
 		sub_v3_v3v3(te_dir, t_cos[i_t0], t_cos[i_t1]);
 		normalize_v3(te_dir);
-		if (fabsf(dot_v3v3(p_dir, te_dir)) >= 1.0f - e->eps) {
+		if ((fabsf(dot_v3v3(p_dir, te_dir)) >= 1.0f - e->eps) ||
+		    (is_point_on_line_exact_v3(t_cos[i_t0], p0, p1) &&
+		     is_point_on_line_exact_v3(t_cos[i_t1], p0, p1)))
+		{
 			/* co-linear */
 		}
 		else {
@@ -345,7 +426,7 @@ static enum ISectType intersect_line_tri(
 
 	/* check ray isn't planar with tri */
 	if (fabsf(dot_v3v3(p_dir, t_nor)) >= e->eps) {
-		if (isect_line_segment_tri_epsilon_v3(p0, p1, t_cos[0], t_cos[1], t_cos[2], &fac, NULL, 0.0f)) {
+		if (isect_line_segment_tri_exact_v3(p0, p1, t_cos, &fac)) {
 			if ((fac >= e->eps_margin) && (fac <= 1.0f - e->eps_margin)) {
 				interp_v3_v3v3(r_ix, p0, p1, fac);
 				if (min_fff(len_squared_v3v3(t_cos[0], r_ix),
@@ -854,6 +935,87 @@ finally:
 
 #ifdef USE_BVH
 
+#ifdef USE_BVH_PREFILTER
+
+struct OverlapPrefilterData {
+	BMLoop *(*looptris)[3];
+	/* distance from a triangles plane past which no intersection test can succeed */
+	double margin;
+};
+
+/**
+ * Check if all points of \a tri_a are on one side of the plane of \a tri_b,
+ * further away than \a margin.
+ *
+ * Computed in double precision from the single precision input,
+ * so rounding can't reject a pair the intersection code would still consider touching.
+ * Degenerate triangles are never considered separated.
+ */
+static bool isect_tri_tri_plane_separated(
+        const float *tri_a[3], const float *tri_b[3],
+        const double margin)
+{
+	double e1[3], e2[3], nor[3], dist[3];
+	double len;
+	uint i;
+
+	for (i = 0; i < 3; i++) {
+		e1[i] = (double)tri_b[1][i] - (double)tri_b[0][i];
+		e2[i] = (double)tri_b[2][i] - (double)tri_b[0][i];
+	}
+
+	nor[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	nor[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	nor[2] = e1[0] * e2[1] - e1[1] * e2[0];
+
+	len = sqrt(nor[0] * nor[0] + nor[1] * nor[1] + nor[2] * nor[2]);
+	if (len == 0.0) {
+		return false;
+	}
+
+	for (i = 0; i < 3; i++) {
+		dist[i] = (((double)tri_a[i][0] - (double)tri_b[0][0]) * nor[0] +
+		           ((double)tri_a[i][1] - (double)tri_b[0][1]) * nor[1] +
+		           ((double)tri_a[i][2] - (double)tri_b[0][2]) * nor[2]) / len;
+	}
+
+	return (((dist[0] >  margin) && (dist[1] >  margin) && (dist[2] >  margin)) ||
+	        ((dist[0] < -margin) && (dist[1] < -margin) && (dist[2] < -margin)));
+}
+
+/**
+ * Runs from the threads of #BLI_bvhtree_overlap, only reads the mesh.
+ *
+ * Rejects pairs #bm_isect_tri_tri would skip without making any changes,
+ * so the remaining pairs (and their order) are unchanged.
+ */
+static bool bm_isect_overlap_prefilter_cb(void *userdata, int index_a, int index_b, int UNUSED(thread))
+{
+	struct OverlapPrefilterData *data = userdata;
+	BMLoop **a = data->looptris[index_a];
+	BMLoop **b = data->looptris[index_b];
+	const float *f_a_cos[3] = {UNPACK3_EX(, a, ->v->co)};
+	const float *f_b_cos[3] = {UNPACK3_EX(, b, ->v->co)};
+
+	/* triangles sharing vertices are skipped, this includes a triangle overlapping with its self */
+	if (UNLIKELY(ELEM(a[0]->v, b[0]->v, b[1]->v, b[2]->v) ||
+	             ELEM(a[1]->v, b[0]->v, b[1]->v, b[2]->v) ||
+	             ELEM(a[2]->v, b[0]->v, b[1]->v, b[2]->v)))
+	{
+		return false;
+	}
+
+	if (isect_tri_tri_plane_separated(f_a_cos, f_b_cos, data->margin) ||
+	    isect_tri_tri_plane_separated(f_b_cos, f_a_cos, data->margin))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+#endif  /* USE_BVH_PREFILTER */
+
 struct RaycastData {
 	const float **looptris;
 	BLI_Buffer *z_buffer;
@@ -1110,7 +1272,19 @@ bool BM_mesh_intersect(
 		tree_b = tree_a;
 	}
 
+#ifdef USE_BVH_PREFILTER
+	{
+		/* All tests in #bm_isect_tri_tri need the triangles within 'eps_margin' of each other,
+		 * double it to account for rounding in the single precision intersection code. */
+		struct OverlapPrefilterData prefilter_data = {
+			.looptris = looptris,
+			.margin = (double)s.epsilon.eps_margin * 2.0,
+		};
+		overlap = BLI_bvhtree_overlap(tree_b, tree_a, &tree_overlap_tot, bm_isect_overlap_prefilter_cb, &prefilter_data);
+	}
+#else
 	overlap = BLI_bvhtree_overlap(tree_b, tree_a, &tree_overlap_tot, NULL, NULL);
+#endif
 
 	if (overlap) {
 		uint i;
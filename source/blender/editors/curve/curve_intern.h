@@ -87,6 +87,8 @@ void FONT_OT_unlink(struct wmOperatorType *ot);
 void FONT_OT_textbox_add(struct wmOperatorType *ot);
 void FONT_OT_textbox_remove(struct wmOperatorType *ot);
 
+void FONT_OT_batch_from_file(struct wmOperatorType *ot);
+
 
 /* editcurve.c */
 void CURVE_OT_hide(struct wmOperatorType *ot);
@@ -72,6 +72,8 @@ void ED_operatortypes_curve(void)
 	WM_operatortype_append(FONT_OT_textbox_add);
 	WM_operatortype_append(FONT_OT_textbox_remove);
 
+	WM_operatortype_append(FONT_OT_batch_from_file);
+
 	WM_operatortype_append(CURVE_OT_hide);
 	WM_operatortype_append(CURVE_OT_reveal);
 
@@ -5153,12 +5153,10 @@ static int curve_dissolve_exec(bContext *C, wmOperator *UNUSED(op))
 						BezTriple *bezt_a = &nu->bezt[mod_i((span_step[0] + segment) - 1, nu->pntsu)];
 						BezTriple *bezt_b = &nu->bezt[mod_i((span_step[0] + segment),     nu->pntsu)];
 
-						for (int axis = 0; axis < dims; axis++) {
-							BKE_curve_forward_diff_bezier(
-							        bezt_a->vec[1][axis], bezt_a->vec[2][axis],
-							        bezt_b->vec[0][axis], bezt_b->vec[1][axis],
-							        points_stride + axis, points_stride_len, dims * sizeof(float));
-						}
+						BKE_curve_forward_diff_bezier_v3(
+						        bezt_a->vec[1], bezt_a->vec[2],
+						        bezt_b->vec[0], bezt_b->vec[1],
+						        points_stride, points_stride_len, dims * sizeof(float));
 
 						points_stride += dims * points_stride_len;
 					}
@@ -46,8 +46,10 @@
 #include "BKE_font.h"
 #include "BKE_library.h"
 #include "BKE_main.h"
+#include "BKE_material.h"
 #include "BKE_object.h"
 #include "BKE_report.h"
+#include "BKE_scene.h"
 
 #include "RNA_access.h"
 #include "RNA_define.h"
@@ -516,6 +518,214 @@ void ED_text_to_object(bContext *C, Text *text, const bool split_lines)
 	}
 }
 
+/******************* batch from file operator ********************/
+
+/* Field \a field (1 based) of a comma separated line, terminated in place,
+ * without the quotes around it (and with doubled quotes in it as one). */
+static char *batch_line_field(char *line, const int field)
+{
+	char *str = line;
+	int i;
+
+	for (i = 1; ; i++) {
+		char *field_start = str, *dst = str;
+
+		if (*str == '"') {
+			str++;
+			while (*str) {
+				if (*str == '"') {
+					if (str[1] != '"') {
+						str++;
+						break;
+					}
+					str++;
+				}
+				*dst++ = *str++;
+			}
+		}
+		while (*str && *str != ',') {
+			*dst++ = *str++;
+		}
+
+		if (i == field) {
+			*dst = '\0';
+			return field_start;
+		}
+		if (*str == '\0') {
+			return NULL;
+		}
+		str++;
+	}
+}
+
+static int batch_from_file_exec(bContext *C, wmOperator *op)
+{
+	Main *bmain = CTX_data_main(C);
+	Scene *scene = CTX_data_scene(C);
+	Object *ob = ED_object_active_context(C);
+	Curve *cu = ob->data;
+	Curve *cu_new;
+	Object *ob_new;
+	Base *base_new;
+	ListBase nubase = {NULL, NULL};
+	const int field = RNA_int_get(op->ptr, "field");
+	const bool use_header = RNA_boolean_get(op->ptr, "use_header");
+	char filepath[FILE_MAX];
+	char *strp, *line, *line_next;
+	const char **strings;
+	int strings_len = 0, strings_skip_len = 0, lines_len = 0;
+	size_t filelen;
+	bool ok;
+
+	RNA_string_get(op->ptr, "filepath", filepath);
+
+	strp = BLI_file_read_text_as_mem(filepath, 1, &filelen);
+	if (strp == NULL) {
+		BKE_reportf(op->reports, RPT_ERROR, "Failed to open file '%s'", filepath);
+		return OPERATOR_CANCELLED;
+	}
+	strp[filelen] = 0;
+
+	for (line = strp; *line; line++) {
+		if (*line == '\n') {
+			lines_len++;
+		}
+	}
+	strings = MEM_malloc_arrayN(lines_len + 1, sizeof(*strings), __func__);
+
+	for (line = strp; line; line = line_next) {
+		char *str;
+		size_t line_len;
+
+		line_next = strchr(line, '\n');
+		if (line_next) {
+			*line_next = '\0';
+			line_next++;
+		}
+		/* windows line endings */
+		line_len = strlen(line);
+		if (line_len && line[line_len - 1] == '\r') {
+			line[line_len - 1] = '\0';
+		}
+
+		if (use_header && line == strp) {
+			continue;
+		}
+
+		str = (field != 0) ? batch_line_field(line, field) : line;
+		if (str == NULL || str[0] == '\0') {
+			continue;
+		}
+		if (strlen(str) >= MAXTEXT || BLI_utf8_invalid_byte(str, strlen(str)) != -1) {
+			strings_skip_len++;
+			continue;
+		}
+		strings[strings_len++] = str;
+	}
+
+	if (strings_len == 0) {
+		BKE_reportf(op->reports, RPT_ERROR, "No text found in '%s'", filepath);
+		MEM_freeN(strings);
+		MEM_freeN(strp);
+		return OPERATOR_CANCELLED;
+	}
+
+	ok = BKE_vfont_to_curve_batch(
+	        ob, cu, strings, strings_len,
+	        RNA_int_get(op->ptr, "columns"), RNA_float_get(op->ptr, "margin"), &nubase);
+
+	MEM_freeN(strings);
+	MEM_freeN(strp);
+
+	if (!ok) {
+		BKE_nurbList_free(&nubase);
+		BKE_report(op->reports, RPT_ERROR, "Failed to load the font");
+		return OPERATOR_CANCELLED;
+	}
+
+	/* a curve with the settings of the text, like converting the text */
+	cu_new = BKE_curve_copy(bmain, cu);
+	BKE_nurbList_free(&cu_new->nurb);
+	cu_new->nurb = nubase;
+	cu_new->type = OB_CURVE;
+
+	if (cu_new->vfont) {
+		id_us_min(&cu_new->vfont->id);
+		cu_new->vfont = NULL;
+	}
+	if (cu_new->vfontb) {
+		id_us_min(&cu_new->vfontb->id);
+		cu_new->vfontb = NULL;
+	}
+	if (cu_new->vfonti) {
+		id_us_min(&cu_new->vfonti->id);
+		cu_new->vfonti = NULL;
+	}
+	if (cu_new->vfontbi) {
+		id_us_min(&cu_new->vfontbi->id);
+		cu_new->vfontbi = NULL;
+	}
+
+	ob_new = BKE_object_add_only_object(bmain, OB_CURVE, ob->id.name + 2);
+	ob_new->data = cu_new;
+	ob_new->lay = ob->lay;
+	BKE_object_transform_copy(ob_new, ob);
+	test_object_materials(bmain, ob_new, &cu_new->id);
+
+	base_new = BKE_scene_base_add(scene, ob_new);
+	BKE_scene_base_deselect_all(scene);
+	BKE_scene_base_select(scene, base_new);
+	BKE_object_where_is_calc(scene, ob_new);
+
+	if (strings_skip_len) {
+		BKE_reportf(op->reports, RPT_WARNING, "Skipped %d lines (text too long or not UTF-8)", strings_skip_len);
+	}
+	BKE_reportf(op->reports, RPT_INFO, "Made %d texts", strings_len);
+
+	WM_event_add_notifier(C, NC_SCENE | ND_OB_ACTIVE, scene);
+	WM_event_add_notifier(C, NC_OBJECT | NA_ADDED, ob_new);
+
+	return OPERATOR_FINISHED;
+}
+
+static int batch_from_file_invoke(bContext *C, wmOperator *op, const wmEvent *UNUSED(event))
+{
+	if (RNA_struct_property_is_set(op->ptr, "filepath"))
+		return batch_from_file_exec(C, op);
+
+	WM_event_add_fileselect(C, op);
+
+	return OPERATOR_RUNNING_MODAL;
+}
+
+void FONT_OT_batch_from_file(wmOperatorType *ot)
+{
+	/* identifiers */
+	ot->name = "Batch Text From File";
+	ot->description = "Make a curve with the active text for each line of a file (or field of a CSV file), "
+	                  "laid out in a grid";
+	ot->idname = "FONT_OT_batch_from_file";
+
+	/* api callbacks */
+	ot->exec = batch_from_file_exec;
+	ot->invoke = batch_from_file_invoke;
+	ot->poll = ED_operator_object_active_editable_font;
+
+	/* flags */
+	ot->flag = OPTYPE_REGISTER | OPTYPE_UNDO;
+
+	/* properties */
+	WM_operator_properties_filesel(
+	        ot, FILE_TYPE_FOLDER | FILE_TYPE_TEXT, FILE_SPECIAL, FILE_OPENFILE,
+	        WM_FILESEL_FILEPATH, FILE_DEFAULTDISPLAY, FILE_SORT_ALPHA);
+	RNA_def_int(ot->srna, "field", 0, 0, INT_MAX, "Field",
+	            "Comma separated field of each line to use (zero uses the whole line)", 0, 16);
+	RNA_def_boolean(ot->srna, "use_header", false, "Header", "Skip the first line (column names)");
+	RNA_def_int(ot->srna, "columns", 1, 1, INT_MAX, "Columns", "Number of texts in each row", 1, 100);
+	RNA_def_float_distance(ot->srna, "margin", 0.5f, 0.0f, FLT_MAX, "Margin",
+	                       "Distance between the texts", 0.0f, 10.0f);
+}
+
 /********************** utilities ***************************/
 
 static int kill_selection(Object *obedit, int ins)  /* 1 == new character */
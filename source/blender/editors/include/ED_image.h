@@ -44,6 +44,7 @@ void          ED_space_image_set_mask(struct bContext *C, struct SpaceImage *sim
 bool ED_space_image_color_sample(struct SpaceImage *sima, struct ARegion *ar, int mval[2], float r_col[3]);
 struct ImBuf *ED_space_image_acquire_buffer(struct SpaceImage *sima, void **r_lock);
 void ED_space_image_release_buffer(struct SpaceImage *sima, struct ImBuf *ibuf, void *lock);
+struct ImBuf *ED_space_image_acquire_buffer_tiled(struct SpaceImage *sima);
 bool ED_space_image_has_buffer(struct SpaceImage *sima);
 
 void ED_space_image_get_size(struct SpaceImage *sima, int *width, int *height);
@@ -0,0 +1,160 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software  Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file blender/editors/io/io_gcode.c
+ *  \ingroup editor/io
+ *
+ * Import of G-code programs as a mesh of the tool path (a backplot).
+ */
+
+#include "DNA_mesh_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_space_types.h"
+#include "DNA_view3d_types.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_math_vector.h"
+#include "BLI_path_util.h"
+#include "BLI_timecode.h"
+
+#include "BKE_context.h"
+#include "BKE_gcode.h"
+#include "BKE_report.h"
+#include "BKE_screen.h"
+
+#include "RNA_access.h"
+#include "RNA_define.h"
+
+#include "ED_object.h"
+
+#include "WM_api.h"
+#include "WM_types.h"
+
+#include "io_gcode.h"
+
+static int wm_gcode_import_exec(bContext *C, wmOperator *op)
+{
+	Scene *scene = CTX_data_scene(C);
+	View3D *v3d = CTX_wm_view3d(C);
+	GCodeParseSettings settings;
+	GCodeMachineSettings machine;
+	GCodeEstimate estimate;
+	GCodePath *path;
+	Object *ob;
+	char filepath[FILE_MAX];
+	char duration_str[32];
+
+	if (!RNA_struct_property_is_set(op->ptr, "filepath")) {
+		BKE_report(op->reports, RPT_ERROR, "No filename given");
+		return OPERATOR_CANCELLED;
+	}
+
+	RNA_string_get(op->ptr, "filepath", filepath);
+
+	BKE_gcode_parse_settings_defaults(&settings);
+	settings.arc_tolerance = RNA_float_get(op->ptr, "arc_tolerance");
+
+	WM_cursor_wait(1);
+	path = BKE_gcode_path_from_file(filepath, &settings);
+	WM_cursor_wait(0);
+
+	if (path == NULL) {
+		BKE_reportf(op->reports, RPT_ERROR, "Cannot read file '%s'", filepath);
+		return OPERATOR_CANCELLED;
+	}
+
+	/* machine coordinates are kept, so the object stays at the origin */
+	ob = ED_object_add_type(
+	        C, OB_MESH, BLI_path_basename(filepath), NULL, NULL, false,
+	        BKE_screen_view3d_layer_active(v3d, scene));
+	BKE_gcode_path_to_mesh(
+	        path, ob->data,
+	        RNA_float_get(op->ptr, "scale"), RNA_boolean_get(op->ptr, "use_rapid"));
+
+	BKE_gcode_machine_settings_defaults(&machine);
+	copy_v3_fl(machine.max_rate, RNA_float_get(op->ptr, "max_rate"));
+	copy_v3_fl(machine.acceleration, RNA_float_get(op->ptr, "acceleration"));
+	machine.junction_deviation = RNA_float_get(op->ptr, "junction_deviation");
+
+	BKE_gcode_path_estimate(path, &machine, NULL, &estimate);
+	BLI_timecode_string_from_time_simple(duration_str, sizeof(duration_str), estimate.duration);
+
+	if (path->blocks_skipped_len != 0) {
+		BKE_reportf(op->reports, RPT_WARNING,
+		            "Skipped %d of %d lines using unsupported features (parameters, expressions or subroutines), "
+		            "estimated machine time %s",
+		            path->blocks_skipped_len, path->lines_len, duration_str);
+	}
+	else {
+		BKE_reportf(op->reports, RPT_INFO, "Imported %d moves from %d lines, estimated machine time %s",
+		            path->moves_len, path->lines_len, duration_str);
+	}
+
+	BKE_gcode_path_free(path);
+
+	WM_event_add_notifier(C, NC_GEOM | ND_DATA, ob->data);
+
+	return OPERATOR_FINISHED;
+}
+
+static int wm_gcode_import_invoke(bContext *C, wmOperator *op, const wmEvent *UNUSED(event))
+{
+	if (RNA_struct_property_is_set(op->ptr, "filepath")) {
+		return wm_gcode_import_exec(C, op);
+	}
+
+	WM_event_add_fileselect(C, op);
+
+	return OPERATOR_RUNNING_MODAL;
+}
+
+void WM_OT_gcode_import(wmOperatorType *ot)
+{
+	/* identifiers */
+	ot->name = "Import G-code";
+	ot->description = "Load the tool path of a G-code (CNC) program as a mesh";
+	ot->idname = "WM_OT_gcode_import";
+
+	/* api callbacks */
+	ot->invoke = wm_gcode_import_invoke;
+	ot->exec = wm_gcode_import_exec;
+	ot->poll = WM_operator_winactive;
+
+	/* flags */
+	ot->flag = OPTYPE_REGISTER | OPTYPE_UNDO;
+
+	/* properties */
+	WM_operator_properties_filesel(
+	        ot, FILE_TYPE_FOLDER | FILE_TYPE_TEXT, FILE_SPECIAL, FILE_OPENFILE,
+	        WM_FILESEL_FILEPATH, FILE_DEFAULTDISPLAY, FILE_SORT_ALPHA);
+
+	RNA_def_float(ot->srna, "scale", 0.001f, 0.0f, FLT_MAX, "Scale",
+	              "Size of a millimeter of the program in the scene (0.001 for meters)", 0.0001f, 1.0f);
+	RNA_def_float(ot->srna, "arc_tolerance", 0.002f, 0.0001f, 1.0f, "Arc Tolerance",
+	              "Maximum distance of the edges of arcs from the arc (millimeters)", 0.0001f, 0.1f);
+	RNA_def_boolean(ot->srna, "use_rapid", true, "Rapid Moves",
+	                "Include the rapid (non-cutting) moves, marked as seams");
+
+	/* machine, for the time estimate (defaults from grbl) */
+	RNA_def_float(ot->srna, "max_rate", 500.0f, 1.0f, FLT_MAX, "Maximum Rate",
+	              "Maximum speed of each axis (millimeters per minute), used by rapid moves", 1.0f, 50000.0f);
+	RNA_def_float(ot->srna, "acceleration", 10.0f, 0.1f, FLT_MAX, "Acceleration",
+	              "Acceleration of each axis (millimeters per second squared)", 0.1f, 10000.0f);
+	RNA_def_float(ot->srna, "junction_deviation", 0.01f, 0.0f, 10.0f, "Junction Deviation",
+	              "How far the tool may leave the path at corners (millimeters), sets the cornering speed",
+	              0.0f, 1.0f);
+}
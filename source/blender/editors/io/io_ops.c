@@ -26,9 +26,12 @@
 #include "WM_api.h"
 
 #include "io_cache.h"
+#include "io_gcode.h"
 
 void ED_operatortypes_io(void)
 {
 	WM_operatortype_append(CACHEFILE_OT_open);
 	WM_operatortype_append(CACHEFILE_OT_reload);
+
+	WM_operatortype_append(WM_OT_gcode_import);
 }
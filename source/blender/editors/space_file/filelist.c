@@ -1964,7 +1964,9 @@ int ED_path_extension_type(const char *path)
 	else if (BLI_path_extension_check(path, ".py")) {
 		return FILE_TYPE_PYSCRIPT;
 	}
-	else if (BLI_path_extension_check_n(path, ".txt", ".glsl", ".osl", ".data", ".pov", ".ini", ".mcr", ".inc", NULL)) {
+	else if (BLI_path_extension_check_n(path, ".txt", ".glsl", ".osl", ".data", ".pov", ".ini", ".mcr", ".inc",
+	                                   ".gcode", ".gco", ".ngc", ".nc", ".tap", NULL))
+	{
 		return FILE_TYPE_TEXT;
 	}
 	else if (BLI_path_extension_check_n(path, ".ttf", ".ttc", ".pfb", ".otf", ".otc", NULL)) {
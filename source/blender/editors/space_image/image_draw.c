@@ -40,6 +40,7 @@
 #include "BLI_rect.h"
 #include "BLI_threads.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "IMB_imbuf.h"
@@ -567,6 +568,93 @@ static void draw_image_buffer_tiled(SpaceImage *sima, ARegion *ar, Scene *scene,
 	MEM_freeN(rect);
 }
 
+typedef struct TileCacheDrawData {
+	ImBuf *ibuf;
+	unsigned char *rect;
+	int x0, y0, width;
+} TileCacheDrawData;
+
+typedef struct TileCacheDrawChunk {
+	struct ImTileSampler *sampler;
+} TileCacheDrawChunk;
+
+static void draw_image_buffer_tilecache_row(
+        void *__restrict userdata,
+        const int iter,
+        const ParallelRangeTLS *__restrict tls)
+{
+	TileCacheDrawData *data = userdata;
+	TileCacheDrawChunk *chunk = tls->userdata_chunk;
+	unsigned char *cp = data->rect + (size_t)iter * data->width * 4;
+	float col[4];
+	int i;
+
+	if (chunk->sampler == NULL) {
+		chunk->sampler = IMB_tile_sampler_new();
+	}
+
+	for (i = 0; i < data->width; i++, cp += 4) {
+		IMB_tile_sampler_bilinear(chunk->sampler, data->ibuf, data->x0 + i, data->y0 + iter, col);
+		rgba_float_to_uchar(cp, col);
+	}
+}
+
+static void draw_image_buffer_tilecache_finalize(void *__restrict UNUSED(userdata), void *__restrict userdata_chunk)
+{
+	TileCacheDrawChunk *chunk = userdata_chunk;
+
+	if (chunk->sampler) {
+		IMB_tile_sampler_free(chunk->sampler);
+	}
+}
+
+/* Huge images that aren't loaded (see ED_space_image_acquire_buffer_tiled): only the visible
+ * part is read, from the mipmap level that's about screen resolution. The values are drawn as
+ * they're stored in the file, without color management. */
+static void draw_image_buffer_tilecache(ARegion *ar, ImBuf *ibuf, float zoomx, float zoomy)
+{
+	TileCacheDrawData data;
+	TileCacheDrawChunk chunk = {NULL};
+	ParallelRangeSettings settings;
+	ImBuf *mbuf;
+	int level = 0, x1, y1, x, y;
+	const float zoom = min_ff(zoomx, zoomy);
+
+	if (zoom < 1.0f && ibuf->miptot > 1) {
+		level = min_ii((int)log2f(1.0f / zoom), ibuf->miptot - 1);
+	}
+	mbuf = IMB_getmipmap(ibuf, level);
+
+	/* visible pixels of the level */
+	data.x0 = max_ii((int)floorf(ar->v2d.cur.xmin * mbuf->x), 0);
+	data.y0 = max_ii((int)floorf(ar->v2d.cur.ymin * mbuf->y), 0);
+	x1 = min_ii((int)ceilf(ar->v2d.cur.xmax * mbuf->x), mbuf->x);
+	y1 = min_ii((int)ceilf(ar->v2d.cur.ymax * mbuf->y), mbuf->y);
+	if (x1 <= data.x0 || y1 <= data.y0) {
+		return;
+	}
+
+	data.ibuf = mbuf;
+	data.width = x1 - data.x0;
+	data.rect = MEM_mallocN((size_t)data.width * (y1 - data.y0) * 4, "tile cache draw rect");
+
+	BLI_parallel_range_settings_defaults(&settings);
+	settings.userdata_chunk = &chunk;
+	settings.userdata_chunk_size = sizeof(chunk);
+	settings.func_finalize = draw_image_buffer_tilecache_finalize;
+	BLI_task_parallel_range(0, y1 - data.y0, &data, draw_image_buffer_tilecache_row, &settings);
+
+	glaDefine2DArea(&ar->winrct);
+	glPixelZoom(zoomx * ibuf->x / mbuf->x, zoomy * ibuf->y / mbuf->y);
+
+	UI_view2d_view_to_region(&ar->v2d, data.x0 / (float)mbuf->x, data.y0 / (float)mbuf->y, &x, &y);
+	glaDrawPixelsSafe(x, y, data.width, y1 - data.y0, data.width, GL_RGBA, GL_UNSIGNED_BYTE, data.rect);
+
+	glPixelZoom(1.0f, 1.0f);
+
+	MEM_freeN(data.rect);
+}
+
 static void draw_image_buffer_repeated(const bContext *C, SpaceImage *sima, ARegion *ar, Scene *scene, Image *ima, ImBuf *ibuf, float zoomx, float zoomy)
 {
 	const double time_current = PIL_check_seconds_timer();
@@ -643,6 +731,15 @@ void draw_image_main(const bContext *C, ARegion *ar)
 		 */
 		BLI_thread_lock(LOCK_DRAW_IMAGE);
 	}
+	else {
+		/* huge images that aren't loaded are read per tile */
+		ibuf = ED_space_image_acquire_buffer_tiled(sima);
+		if (ibuf) {
+			draw_image_buffer_tilecache(ar, ibuf, zoomx, zoomy);
+			ED_space_image_release_buffer(sima, ibuf, NULL);
+			return;
+		}
+	}
 
 	ibuf = ED_space_image_acquire_buffer(sima, &lock);
 
@@ -24,6 +24,7 @@
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
+#include "BLI_path_util.h"
 #include "BLI_rect.h"
 
 #include "BKE_colortools.h"
@@ -34,6 +35,7 @@
 #include "BKE_library.h"
 #include "BKE_main.h"
 
+#include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
 #include "ED_image.h"  /* own include */
@@ -45,6 +47,9 @@
 #include "WM_api.h"
 #include "WM_types.h"
 
+/* images with more pixels than this are viewed through the tile cache while they aren't loaded */
+#define IMAGE_TILED_VIEW_PIXELS (8192 * 8192)
+
 /* note; image_panel_properties() uses pointer to sima->image directly */
 Image *ED_space_image(SpaceImage *sima)
 {
@@ -102,6 +107,52 @@ void ED_space_image_release_buffer(SpaceImage *sima, ImBuf *ibuf, void *lock)
 		BKE_image_release_ibuf(sima->image, ibuf, lock);
 }
 
+/**
+ * Buffer of a huge file image that's read per tile as it's drawn (see BKE_image_acquire_ibuf_tiled),
+ * so viewing it doesn't load the whole image. NULL for images that are small enough to be loaded,
+ * already loaded, packed, not PNG files, and outside of the view mode.
+ * Release with ED_space_image_release_buffer(sima, ibuf, NULL).
+ */
+ImBuf *ED_space_image_acquire_buffer_tiled(SpaceImage *sima)
+{
+	Image *ima = sima ? sima->image : NULL;
+
+	if (ima == NULL || ima->source != IMA_SRC_FILE || ima->type != IMA_TYPE_IMAGE ||
+	    sima->mode != SI_MODE_VIEW || BKE_image_has_packedfile(ima) || BKE_image_has_loaded_ibuf(ima))
+	{
+		return NULL;
+	}
+
+	if (ima->tiled_ibuf) {
+		/* also read for modifiers */
+		if ((size_t)ima->tiled_ibuf->x * (size_t)ima->tiled_ibuf->y <= (size_t)IMAGE_TILED_VIEW_PIXELS) {
+			return NULL;
+		}
+	}
+	else {
+		/* only read the header to decide */
+		char filepath[FILE_MAX];
+		ImBuf *ibuf;
+		bool is_huge;
+
+		BKE_image_user_file_path(&sima->iuser, ima, filepath);
+		ibuf = IMB_testiffname(filepath, 0);
+		if (ibuf == NULL) {
+			return NULL;
+		}
+		/* other formats would be read entirely anyway */
+		is_huge = ((ibuf->ftype == IMB_FTYPE_PNG) &&
+		           (size_t)ibuf->x * (size_t)ibuf->y > (size_t)IMAGE_TILED_VIEW_PIXELS);
+		IMB_freeImBuf(ibuf);
+
+		if (!is_huge) {
+			return NULL;
+		}
+	}
+
+	return BKE_image_acquire_ibuf_tiled(ima);
+}
+
 bool ED_space_image_has_buffer(SpaceImage *sima)
 {
 	ImBuf *ibuf;
@@ -118,9 +169,12 @@ bool ED_space_image_has_buffer(SpaceImage *sima)
 void ED_space_image_get_size(SpaceImage *sima, int *width, int *height)
 {
 	ImBuf *ibuf;
-	void *lock;
+	void *lock = NULL;
 
-	ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	ibuf = ED_space_image_acquire_buffer_tiled(sima);
+	if (ibuf == NULL) {
+		ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	}
 
 	if (ibuf && ibuf->x > 0 && ibuf->y > 0) {
 		*width = ibuf->x;
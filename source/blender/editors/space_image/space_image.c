@@ -704,13 +704,15 @@ static void image_tools_region_draw(const bContext *C, ARegion *ar)
 {
 	SpaceImage *sima = CTX_wm_space_image(C);
 	Scene *scene = CTX_data_scene(C);
-	void *lock;
-	ImBuf *ibuf = ED_space_image_acquire_buffer(sima, &lock);
 	/* XXX performance regression if name of scopes category changes! */
 	PanelCategoryStack *category = UI_panel_category_active_find(ar, "Scopes");
 
-	/* only update scopes if scope category is active */
+	/* only update scopes if scope category is active, the buffer is only acquired
+	 * for them so other panels don't load huge images that are drawn per tile */
 	if (category) {
+		void *lock;
+		ImBuf *ibuf = ED_space_image_acquire_buffer(sima, &lock);
+
 		if (ibuf) {
 			if (!sima->scopes.ok) {
 				BKE_histogram_update_sample_line(&sima->sample_line_hist, ibuf, &scene->view_settings, &scene->display_settings);
@@ -720,8 +722,8 @@ static void image_tools_region_draw(const bContext *C, ARegion *ar)
 			else
 				ED_space_image_scopes_update(C, sima, ibuf, false);
 		}
+		ED_space_image_release_buffer(sima, ibuf, lock);
 	}
-	ED_space_image_release_buffer(sima, ibuf, lock);
 
 	ED_region_panels(C, ar, NULL, -1, true);
 }
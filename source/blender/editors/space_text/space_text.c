@@ -632,4 +632,5 @@ void ED_spacetype_text(void)
 	ED_text_format_register_lua();
 	ED_text_format_register_pov();
 	ED_text_format_register_pov_ini();
+	ED_text_format_register_gcode();
 }
@@ -26,6 +26,7 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "DNA_text_types.h"
 #include "DNA_space_types.h"
@@ -102,18 +103,74 @@ static int text_font_draw_character_utf8(const TextDrawContext *tdc, int x, int
 	return tdc->cwidth * columns;
 }
 
-#if 0
-/* Formats every line of the current text */
-static void txt_format_text(SpaceText *st)
+/******************** syntax formatting ******************/
+
+/* Formatting starts from the last formatted line above the view (instead of checking every line
+ * from the start of the text), formats which can continue a line onto the next need all unformatted
+ * lines above the view formatted first, line independent formats only need the lines in view. */
+
+/* Lines below the view formatted ahead when lines can be formatted in parallel. */
+#define TXT_FORMAT_LOOKAHEAD_LINES 2048
+
+typedef struct TextFormatLinesData {
+	SpaceText *st;
+	TextFormatType *tft;
+	TextLine **lines;
+} TextFormatLinesData;
+
+static void text_format_lines_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
 {
-	TextLine *linep;
+	TextFormatLinesData *data = userdata;
+	data->tft->format_line(data->st, data->lines[i], false);
+}
 
-	if (!st->text) return;
+/* Formats \a lines_num lines starting at \a line_first (when not formatted yet). */
+static void text_format_lines_ensure(SpaceText *st, TextFormatType *tft, TextLine *line_first, int lines_num)
+{
+	TextLine *line;
+	int i;
+
+	if (tft->is_line_independent) {
+		const int lines_max = lines_num + TXT_FORMAT_LOOKAHEAD_LINES;
+		TextLine **lines = MEM_mallocN(sizeof(*lines) * lines_max, __func__);
+		int lines_len = 0;
+
+		for (line = line_first, i = 0; line && i < lines_max; line = line->next, i++) {
+			if (line->format == NULL) {
+				lines[lines_len++] = line;
+			}
+		}
+
+		if (lines_len != 0) {
+			TextFormatLinesData data = {.st = st, .tft = tft, .lines = lines};
+
+			ParallelRangeSettings settings;
+			BLI_parallel_range_settings_defaults(&settings);
+			settings.use_threading = (lines_len > 256);
+			BLI_task_parallel_range(0, lines_len, &data, text_format_lines_cb, &settings);
+		}
+
+		MEM_freeN(lines);
+	}
+	else {
+		/* each line continues from the format of the previous one (multi-line strings and comments),
+		 * so format forward from the last formatted line, which carries the state of the lines above it
+		 * (edits update the following lines until their state is unchanged, see 'do_next'). */
+		line = line_first;
+		for (i = 0; line->prev && line->prev->format == NULL; i++) {
+			line = line->prev;
+		}
 
-	for (linep = st->text->lines.first; linep; linep = linep->next)
-		txt_format_line(st, linep, 0);
+		for (lines_num += i; line && lines_num > 0; line = line->next, lines_num--) {
+			if (line->format == NULL) {
+				tft->format_line(st, line, false);
+			}
+		}
+	}
 }
-#endif
 
 /* Sets the current drawing color based on the format character specified */
 static void format_draw_color(char formatchar)
@@ -772,6 +829,9 @@ int text_get_span_wrap(const SpaceText *st, ARegion *ar, TextLine *from, TextLin
 
 		return ret;
 	}
+	else if (from == st->text->lines.first) {
+		return txt_get_line_index(st->text, to);
+	}
 	else {
 		return txt_get_span(from, to);
 	}
@@ -1042,7 +1102,7 @@ static void draw_suggestion_list(const SpaceText *st, const TextDrawContext *tdc
 	top = texttool_suggest_top();
 
 	wrap_offset(st, ar, st->text->curl, st->text->curc, &offl, &offc);
-	vcurl = txt_get_span(st->text->lines.first, st->text->curl) - st->top + offl;
+	vcurl = txt_get_line_index(st->text, st->text->curl) - st->top + offl;
 	vcurc = text_get_char_pos(st, st->text->curl->line, st->text->curc) - st->left + offc;
 
 	x = st->showlinenrs ? TXT_OFFSET + TEXTXLOC : TXT_OFFSET;
@@ -1105,10 +1165,10 @@ static void draw_cursor(SpaceText *st, ARegion *ar)
 		int offl, offc;
 		/* Convert all to view space character coordinates */
 		wrap_offset(st, ar, text->curl, text->curc, &offl, &offc);
-		vcurl = txt_get_span(text->lines.first, text->curl) - st->top + offl;
+		vcurl = txt_get_line_index(text, text->curl) - st->top + offl;
 		vcurc = text_get_char_pos(st, text->curl->line, text->curc) - st->left + offc;
 		wrap_offset(st, ar, text->sell, text->selc, &offl, &offc);
-		vsell = txt_get_span(text->lines.first, text->sell) - st->top + offl;
+		vsell = txt_get_line_index(text, text->sell) - st->top + offl;
 		vselc = text_get_char_pos(st, text->sell->line, text->selc) - st->left + offc;
 
 		if (vcurc < 0) {
@@ -1158,7 +1218,7 @@ static void draw_cursor(SpaceText *st, ARegion *ar)
 	else {
 		int offl, offc;
 		wrap_offset(st, ar, text->sell, text->selc, &offl, &offc);
-		vsell = txt_get_span(text->lines.first, text->sell) - st->top + offl;
+		vsell = txt_get_line_index(text, text->sell) - st->top + offl;
 		vselc = text_get_char_pos(st, text->sell->line, text->selc) - st->left + offc;
 
 		if (vselc < 0) {
@@ -1328,7 +1388,7 @@ static void draw_brackets(const SpaceText *st, const TextDrawContext *tdc, ARegi
 	viewc = text_get_char_pos(st, startl->line, startc) - st->left + offc;
 
 	if (viewc >= 0) {
-		viewl = txt_get_span(text->lines.first, startl) - st->top + offl;
+		viewl = txt_get_line_index(text, startl) - st->top + offl;
 
 		text_font_draw_character(tdc, x + viewc * st->cwidth, y - viewl * (st->lheight_dpi + TXT_LINE_SPACING), ch);
 		text_font_draw_character(tdc, x + viewc * st->cwidth + 1, y - viewl * (st->lheight_dpi + TXT_LINE_SPACING), ch);
@@ -1340,7 +1400,7 @@ static void draw_brackets(const SpaceText *st, const TextDrawContext *tdc, ARegi
 	viewc = text_get_char_pos(st, endl->line, endc) - st->left + offc;
 
 	if (viewc >= 0) {
-		viewl = txt_get_span(text->lines.first, endl) - st->top + offl;
+		viewl = txt_get_line_index(text, endl) - st->top + offl;
 
 		text_font_draw_character(tdc, x + viewc * st->cwidth, y - viewl * (st->lheight_dpi + TXT_LINE_SPACING), ch);
 		text_font_draw_character(tdc, x + viewc * st->cwidth + 1, y - viewl * (st->lheight_dpi + TXT_LINE_SPACING), ch);
@@ -1384,15 +1444,11 @@ void draw_text_main(SpaceText *st, ARegion *ar)
 	/* update rects for scroll */
 	calc_text_rcts(st, ar, &scroll, &back); /* scroll will hold the entire bar size */
 
-	/* update syntax formatting if needed */
-	tft = ED_text_format_get(text);
-	tmp = text->lines.first;
-	lineno = 0;
-	for (i = 0; i < st->top && tmp; i++) {
-		if (st->showsyntax && !tmp->format)
-			tft->format_line(st, tmp, false);
-
-		if (st->wordwrap) {
+	/* find the first visible line */
+	if (st->wordwrap) {
+		tmp = text->lines.first;
+		lineno = 0;
+		for (i = 0; i < st->top && tmp; i++) {
 			int lines = text_get_visible_lines_no(st, lineno);
 
 			if (wraplinecount + lines > st->top) {
@@ -1404,13 +1460,19 @@ void draw_text_main(SpaceText *st, ARegion *ar)
 				tmp = tmp->next;
 				linecount++;
 			}
+
+			lineno++;
 		}
-		else {
-			tmp = tmp->next;
-			linecount++;
-		}
+	}
+	else {
+		tmp = txt_get_line_from_index(text, st->top);
+		linecount = st->top;
+	}
 
-		lineno++;
+	/* update syntax formatting if needed */
+	tft = ED_text_format_get(text);
+	if (st->showsyntax && tmp) {
+		text_format_lines_ensure(st, tft, tmp, st->viewlines);
 	}
 
 
@@ -1440,9 +1502,6 @@ void draw_text_main(SpaceText *st, ARegion *ar)
 	UI_ThemeColor(TH_TEXT);
 
 	for (i = 0; y > clip_min_y && i < st->viewlines && tmp; i++, tmp = tmp->next) {
-		if (st->showsyntax && !tmp->format)
-			tft->format_line(st, tmp, false);
-
 		if (st->showlinenrs && !wrap_skip) {
 			/* draw line number */
 			if (tmp == text->curl)
@@ -1523,7 +1582,7 @@ void text_scroll_to_cursor(SpaceText *st, ARegion *ar, const bool center)
 
 	text_update_character_width(st);
 
-	i = txt_get_span(text->lines.first, text->sell);
+	i = txt_get_line_index(text, text->sell);
 	if (st->wordwrap) {
 		int offl, offc;
 		wrap_offset(st, ar, text->sell, text->selc, &offl, &offc);
@@ -73,6 +73,10 @@ typedef struct TextFormatType {
 	void (*format_line)(SpaceText *st, TextLine *line, const bool do_next);
 
 	const char **ext;  /* NULL terminated extensions */
+
+	/* Lines never continue onto the next (no multi-line strings or comments),
+	 * so they can be formatted in any order, in parallel. */
+	bool is_line_independent;
 } TextFormatType;
 
 enum {
@@ -107,6 +111,7 @@ void ED_text_format_register_osl(void);
 void ED_text_format_register_lua(void);
 void ED_text_format_register_pov(void);
 void ED_text_format_register_pov_ini(void);
+void ED_text_format_register_gcode(void);
 
 #define STR_LITERAL_STARTSWITH(str, str_literal, len_var) \
 	(strncmp(str, str_literal, len_var = (sizeof(str_literal) - 1)) == 0)
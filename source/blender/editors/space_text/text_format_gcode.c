@@ -0,0 +1,196 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file blender/editors/space_text/text_format_gcode.c
+ *  \ingroup sptext
+ */
+
+#include <string.h>
+
+#include "BLI_blenlib.h"
+
+#include "DNA_text_types.h"
+#include "DNA_space_types.h"
+
+#include "BKE_text.h"
+
+#include "text_format.h"
+
+/* *** G-code Words (for format_line) *** */
+
+/* G-code (RS-274) as written by CAM software and slicers is a sequence of words,
+ * a letter followed by a number (`G1 X10.5 F1200`), with comments after ';' or in
+ * parentheses. There are no multi-line constructs, so each line is formatted on its own.
+ *
+ * See:
+ * https://www.nist.gov/publications/nist-rs274ngc-interpreter-version-3
+ */
+
+/* Checks the specified source string for a number (with an optional sign).
+ *
+ * If a number is found, the length of it is returned.
+ * Otherwise, 0 is returned.
+ */
+static int txtfmt_gcode_find_number(const char *string)
+{
+	int i = 0;
+	bool has_digit = false;
+
+	if (ELEM(string[i], '+', '-')) {
+		i++;
+	}
+
+	for (; text_check_digit(string[i]) || string[i] == '.'; i++) {
+		if (string[i] != '.') {
+			has_digit = true;
+		}
+	}
+
+	return has_digit ? i : 0;
+}
+
+/* Checks the specified source string for a G/M command or N line number word
+ * (the letter and its number, which are formatted as one).
+ *
+ * If a word is found, the length of the matching word is returned
+ * and the format type is written to \a r_type.
+ * Otherwise, -1 is returned.
+ */
+static int txtfmt_gcode_find_command(const char *string, char *r_type)
+{
+	int i;
+
+	switch (string[0]) {
+		case 'G': case 'g':
+		case 'M': case 'm':
+			*r_type = FMT_TYPE_KEYWORD;
+			break;
+		case 'N': case 'n':
+		case 'O': case 'o':
+			*r_type = FMT_TYPE_DIRECTIVE;
+			break;
+		default:
+			return -1;
+	}
+
+	/* signs are only valid for axis and parameter values */
+	if (ELEM(string[1], '+', '-')) {
+		return -1;
+	}
+
+	i = txtfmt_gcode_find_number(string + 1);
+	return (i == 0) ? -1 : i + 1;
+}
+
+/* Tool, spindle speed and feed rate letters (followed by their value). */
+static bool txtfmt_gcode_is_specialvar(const char *string)
+{
+	return ELEM(string[0], 'T', 't', 'S', 's', 'F', 'f') && txtfmt_gcode_find_number(string + 1) != 0;
+}
+
+static char txtfmt_gcode_format_identifier(const char *str)
+{
+	char fmt;
+	/* keep in sync with 'txtfmt_gcode_format_line()' */
+	if (txtfmt_gcode_find_command(str, &fmt) == -1) {
+		fmt = txtfmt_gcode_is_specialvar(str) ? FMT_TYPE_SPECIAL : FMT_TYPE_DEFAULT;
+	}
+	return fmt;
+}
+
+static void txtfmt_gcode_format_line(SpaceText *st, TextLine *line, const bool UNUSED(do_next))
+{
+	FlattenString fs;
+	const char *str;
+	char *fmt;
+	char type;
+	int len, i;
+
+	len = flatten_string(st, &fs, line->line);
+	str = fs.buf;
+	if (!text_check_format_len(line, len)) {
+		flatten_string_free(&fs);
+		return;
+	}
+	fmt = line->format;
+
+	while (*str) {
+		/* Single line comment */
+		if (*str == ';') {
+			text_format_fill(&str, &fmt, FMT_TYPE_COMMENT, len - (int)(fmt - line->format));
+		}
+		/* Comment up to the closing parenthesis (or the end of the line) */
+		else if (*str == '(') {
+			while (true) {
+				*fmt = FMT_TYPE_COMMENT;
+				if (*str == ')' || *(str + BLI_str_utf8_size_safe(str)) == '\0') {
+					break;
+				}
+				str += BLI_str_utf8_size_safe(str);
+				fmt++;
+			}
+			str += BLI_str_utf8_size_safe(str) - 1;
+		}
+		/* Whitespace (all ws. has been converted to spaces) */
+		else if (*str == ' ') {
+			*fmt = FMT_TYPE_WHITESPACE;
+		}
+		/* Program start/end marker */
+		else if (*str == '%') {
+			*fmt = FMT_TYPE_DIRECTIVE;
+		}
+		/* G/M commands and line numbers, including their number */
+		else if ((i = txtfmt_gcode_find_command(str, &type)) != -1) {
+			text_format_fill_ascii(&str, &fmt, type, i);
+		}
+		/* Numbers (axis values, parameters) */
+		else if ((i = txtfmt_gcode_find_number(str)) != 0) {
+			text_format_fill_ascii(&str, &fmt, FMT_TYPE_NUMERAL, i);
+		}
+		/* Tool, speed and feed letters */
+		else if (txtfmt_gcode_is_specialvar(str)) {
+			*fmt = FMT_TYPE_SPECIAL;
+		}
+		/* Punctuation (expressions, parameters, block delete) */
+		else if (text_check_delim(*str)) {
+			*fmt = FMT_TYPE_SYMBOL;
+		}
+		/* Axis letters and other text */
+		else {
+			str += BLI_str_utf8_size_safe(str) - 1;
+			*fmt = FMT_TYPE_DEFAULT;
+		}
+		fmt++; str++;
+	}
+
+	/* Terminate and add continuation char (never continues) */
+	*fmt = '\0'; fmt++;
+	*fmt = FMT_CONT_NOP;
+
+	flatten_string_free(&fs);
+}
+
+void ED_text_format_register_gcode(void)
+{
+	static TextFormatType tft = {NULL};
+	static const char *ext[] = {"gcode", "gco", "ngc", "nc", "tap", NULL};
+
+	tft.format_identifier = txtfmt_gcode_format_identifier;
+	tft.format_line       = txtfmt_gcode_format_line;
+	tft.ext = ext;
+	tft.is_line_independent = true;
+
+	ED_text_format_register(&tft);
+}
@@ -1887,7 +1887,7 @@ static int text_jump_exec(bContext *C, wmOperator *op)
 {
 	Text *text = CTX_data_edit_text(C);
 	int line = RNA_int_get(op->ptr, "line");
-	short nlines = txt_get_span(text->lines.first, text->lines.last) + 1;
+	short nlines = txt_get_line_index(text, text->lines.last) + 1;
 
 	if (line < 1)
 		txt_move_toline(text, 1, 0);
@@ -2576,7 +2576,7 @@ static void text_cursor_set_to_pos(SpaceText *st, ARegion *ar, int x, int y, con
 		if (sel) { linep = &text->sell; charp = &text->selc; }
 		else     { linep = &text->curl; charp = &text->curc; }
 
-		y -= txt_get_span(text->lines.first, *linep) - st->top;
+		y -= txt_get_line_index(text, *linep) - st->top;
 
 		if (y > 0) {
 			while (y-- != 0) {
@@ -2693,7 +2693,7 @@ static int text_set_selection_invoke(bContext *C, wmOperator *op, const wmEvent
 	ssel->old[0] = event->mval[0];
 	ssel->old[1] = event->mval[1];
 
-	ssel->sell = txt_get_span(st->text->lines.first, st->text->sell);
+	ssel->sell = txt_get_line_index(st->text, st->text->sell);
 	ssel->selc = st->text->selc;
 
 	WM_event_add_modal_handler(C, op);
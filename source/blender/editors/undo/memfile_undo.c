@@ -77,7 +77,15 @@ static bool memfile_undosys_step_encode(struct bContext *C, UndoStep *us_p)
 static void memfile_undosys_step_decode(struct bContext *C, UndoStep *us_p, int UNUSED(dir))
 {
 	MemFileUndoStep *us = (MemFileUndoStep *)us_p;
-	BKE_memfile_undo_decode(us->data, C);
+	UndoStack *ustack = ED_undo_stack_get();
+
+	/* The active step is only changed after decoding, when it's a global undo step
+	 * the main database is in sync with the data it holds (no edit-mode data), unchanged data can be kept. */
+	const bool use_id_reuse = (
+	        ustack->step_active && (ustack->step_active != us_p) &&
+	        (ustack->step_active->type == BKE_UNDOSYS_TYPE_MEMFILE));
+
+	BKE_memfile_undo_decode(us->data, use_id_reuse, C);
 
 	WM_event_add_notifier(C, NC_SCENE | ND_LAYER_CONTENT, CTX_data_scene(C));
 }
@@ -281,6 +281,11 @@ void IMB_tile_cache_params(int totthread, int maxmem);
 unsigned int *IMB_gettile(struct ImBuf *ibuf, int tx, int ty, int thread);
 void IMB_tiles_to_rect(struct ImBuf *ibuf);
 
+struct ImTileSampler;
+struct ImTileSampler *IMB_tile_sampler_new(void);
+void IMB_tile_sampler_free(struct ImTileSampler *sampler);
+void IMB_tile_sampler_bilinear(struct ImTileSampler *sampler, struct ImBuf *ibuf, float u, float v, float r_col[4]);
+
 /**
  *
  * \attention Defined in filter.c
@@ -168,6 +168,7 @@ typedef struct ImBuf {
 	int tilex, tiley;
 	int xtiles, ytiles;
 	unsigned int **tiles;
+	int tilechannels;		/* 0 for byte RGBA tiles, otherwise the 16 bit (unsigned short) channels per pixel, 1 or 4 */
 
 	/* zbuffer */
 	int	*zbuf;				/* z buffer data, original zbuffer */
@@ -179,6 +180,7 @@ typedef struct ImBuf {
 	/* mipmapping */
 	struct ImBuf *mipmap[IMB_MIPMAP_LEVELS]; /* MipMap levels, a series of halved images */
 	int miptot, miplevel;
+	struct ImBuf *mipparent;	/* level the tiles are reduced from, for tile cached levels not in the file */
 
 	/* externally used data */
 	int index;						/* reference index for ImBuf lists */
@@ -56,6 +56,9 @@ void imb_tile_cache_exit(void);
 
 void imb_loadtile(struct ImBuf *ibuf, int tx, int ty, unsigned int *rect);
 void imb_tile_cache_tile_free(struct ImBuf *ibuf, int tx, int ty);
+void imb_tile_cache_tile_offer(struct ImBuf *ibuf, int tx, int ty, const unsigned int *rect);
+size_t imb_tile_cache_tile_size(const struct ImBuf *ibuf);
+void imb_tile_cache_add_mipmaps(struct ImBuf *ibuf);
 
 /* Type Specific Functions */
 
@@ -63,6 +66,8 @@ void imb_tile_cache_tile_free(struct ImBuf *ibuf, int tx, int ty);
 int imb_is_a_png(const unsigned char *buf);
 struct ImBuf *imb_loadpng(const unsigned char *mem, size_t size, int flags, char colorspace[IM_MAX_SPACE]);
 int imb_savepng(struct ImBuf *ibuf, const char *name, int flags);
+void imb_loadtilepng(struct ImBuf *ibuf, const unsigned char *mem, size_t size,
+                     int tx, int ty, unsigned int *rect);
 
 /* targa */
 int imb_is_a_targa(const unsigned char *buf);
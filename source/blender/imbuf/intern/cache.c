@@ -18,11 +18,18 @@
  *  \ingroup imbuf
  */
 
+#include <math.h>
+
 #include "MEM_guardedalloc.h"
+#include "MEM_CacheLimiterC-Api.h"
 
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
+#include "BLI_math_color.h"
+#include "BLI_math_interp.h"
+#include "BLI_math_vector.h"
 #include "BLI_memarena.h"
 #include "BLI_threads.h"
 
@@ -39,10 +46,25 @@
  *
  * The per-thread cache should be big enough that one might hope to not fall
  * back to the global cache every pixel, but not to big to keep too many tiles
- * locked and using memory. */
+ * locked and using memory.
+ *
+ * Without a memory limit set through IMB_tile_cache_params, the global cache
+ * stays within the limit of the MEM_CacheLimiter (the memory cache limit user
+ * preference), unloading the least recently used tiles first.
+ *
+ * Mipmap levels that aren't stored in the file (see imb_tile_cache_add_mipmaps)
+ * have their tiles reduced from the tiles of the level above, so only the parts
+ * of the levels that are sampled get built.
+ *
+ * Tiles are byte RGBA, or 16 bit (see ImBuf.tilechannels) for images with more
+ * precision, using a single channel for grayscale, so 16 bit heightmaps keep their
+ * precision at two bytes per pixel. */
 
 #define IB_THREAD_CACHE_SIZE    100
 
+/* number of tiles a sampler keeps referenced, enough for a bilinear lookup on a tile corner */
+#define IB_SAMPLER_TILES        4
+
 typedef struct ImGlobalTile {
 	struct ImGlobalTile *next, *prev;
 
@@ -83,8 +105,23 @@ typedef struct ImGlobalTileCache {
 	int initialized;
 } ImGlobalTileCache;
 
+typedef struct ImTileSampler {
+	ImGlobalTile *tiles[IB_SAMPLER_TILES];
+	int tiles_len;
+	/* next tile to replace */
+	int tiles_next;
+} ImTileSampler;
+
 static ImGlobalTileCache GLOBAL_CACHE;
 
+static ImGlobalTile *imb_global_cache_tile_new(size_t tilemem);
+static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGlobalTile *replacetile);
+
+static uintptr_t imb_global_cache_maxmem(void)
+{
+	return GLOBAL_CACHE.maxmem ? GLOBAL_CACHE.maxmem : MEM_CacheLimiter_get_maximum();
+}
+
 /***************************** Hash Functions ********************************/
 
 static unsigned int imb_global_tile_hash(const void *gtile_p)
@@ -123,14 +160,108 @@ static bool imb_thread_tile_cmp(const void *a_p, const void *b_p)
 
 /******************************** Load/Unload ********************************/
 
+static void imb_global_cache_tile_release(ImGlobalTile *gtile)
+{
+	BLI_mutex_lock(&GLOBAL_CACHE.mutex);
+	gtile->refcount--;
+	BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
+}
+
+/* size in bytes of the tiles of \a ibuf, byte RGBA or 16 bit channels (see ImBuf.tilechannels) */
+size_t imb_tile_cache_tile_size(const ImBuf *ibuf)
+{
+	const size_t pixel_size = ibuf->tilechannels ? sizeof(unsigned short) * ibuf->tilechannels : sizeof(unsigned int);
+	return pixel_size * (size_t)ibuf->tilex * (size_t)ibuf->tiley;
+}
+
+/* box filter the (up to) four pixels of the level above for each pixel in the tile,
+ * at the precision of the tiles */
+static void imb_global_cache_tile_reduce(ImGlobalTile *gtile, unsigned int *rect)
+{
+	ImBuf *ibuf = gtile->ibuf;
+	ImBuf *pbuf = ibuf->mipparent;
+	const int channels = ibuf->tilechannels ? ibuf->tilechannels : 4;
+	const int x0 = gtile->tx * ibuf->tilex;
+	const int y0 = gtile->ty * ibuf->tiley;
+	const int w = min_ii(ibuf->tilex, ibuf->x - x0);
+	const int h = min_ii(ibuf->tiley, ibuf->y - y0);
+	/* pixels of the level above covered by the tile */
+	const int px0 = 2 * x0, px1 = min_ii(2 * (x0 + w), pbuf->x);
+	const int py0 = 2 * y0, py1 = min_ii(2 * (y0 + h), pbuf->y);
+	unsigned int *sum = MEM_callocN(sizeof(*sum) * (size_t)channels * (size_t)w * (size_t)h, __func__);
+	int ptx, pty, x, y, c;
+
+	for (pty = py0 / pbuf->tiley; pty <= (py1 - 1) / pbuf->tiley; pty++) {
+		for (ptx = px0 / pbuf->tilex; ptx <= (px1 - 1) / pbuf->tilex; ptx++) {
+			ImGlobalTile *ptile = imb_global_cache_get_tile(pbuf, ptx, pty, NULL);
+			const unsigned int *prect = pbuf->tiles[pbuf->xtiles * pty + ptx];
+			const int tx0 = max_ii(px0, ptx * pbuf->tilex), tx1 = min_ii(px1, (ptx + 1) * pbuf->tilex);
+			const int ty0 = max_ii(py0, pty * pbuf->tiley), ty1 = min_ii(py1, (pty + 1) * pbuf->tiley);
+
+			for (y = ty0; y < ty1; y++) {
+				const size_t from_offs = (size_t)channels * ((size_t)(y - pty * pbuf->tiley) * pbuf->tilex +
+				                                             (size_t)(tx0 - ptx * pbuf->tilex));
+				unsigned int *to = sum + (size_t)channels * (size_t)(y / 2 - y0) * w;
+
+				if (ibuf->tilechannels) {
+					const unsigned short *from = (const unsigned short *)prect + from_offs;
+					for (x = tx0; x < tx1; x++, from += channels) {
+						unsigned int *s = to + channels * (x / 2 - x0);
+						for (c = 0; c < channels; c++)
+							s[c] += from[c];
+					}
+				}
+				else {
+					const unsigned char *from = (const unsigned char *)prect + from_offs;
+					for (x = tx0; x < tx1; x++, from += channels) {
+						unsigned int *s = to + channels * (x / 2 - x0);
+						for (c = 0; c < channels; c++)
+							s[c] += from[c];
+					}
+				}
+			}
+
+			imb_global_cache_tile_release(ptile);
+		}
+	}
+
+	for (y = 0; y < h; y++) {
+		/* fewer than four pixels at the edges of odd sized levels */
+		const int ny = min_ii(2 * (y0 + y) + 2, pbuf->y) - 2 * (y0 + y);
+		const unsigned int *from = sum + (size_t)channels * (size_t)y * w;
+		const size_t to_offs = (size_t)channels * (size_t)y * ibuf->tilex;
+
+		for (x = 0; x < w; x++, from += channels) {
+			const int nx = min_ii(2 * (x0 + x) + 2, pbuf->x) - 2 * (x0 + x);
+			const unsigned int n = (unsigned int)(nx * ny);
+
+			if (ibuf->tilechannels) {
+				unsigned short *to = (unsigned short *)rect + to_offs + (size_t)channels * x;
+				for (c = 0; c < channels; c++)
+					to[c] = (unsigned short)((from[c] + n / 2) / n);
+			}
+			else {
+				unsigned char *to = (unsigned char *)rect + to_offs + (size_t)channels * x;
+				for (c = 0; c < channels; c++)
+					to[c] = (unsigned char)((from[c] + n / 2) / n);
+			}
+		}
+	}
+
+	MEM_freeN(sum);
+}
+
 static void imb_global_cache_tile_load(ImGlobalTile *gtile)
 {
 	ImBuf *ibuf = gtile->ibuf;
 	int toffs = ibuf->xtiles * gtile->ty + gtile->tx;
 	unsigned int *rect;
 
-	rect = MEM_callocN(sizeof(unsigned int) * ibuf->tilex * ibuf->tiley, "imb_tile");
-	imb_loadtile(ibuf, gtile->tx, gtile->ty, rect);
+	rect = MEM_callocN(imb_tile_cache_tile_size(ibuf), "imb_tile");
+	if (ibuf->mipparent)
+		imb_global_cache_tile_reduce(gtile, rect);
+	else
+		imb_loadtile(ibuf, gtile->tx, gtile->ty, rect);
 	ibuf->tiles[toffs] = rect;
 }
 
@@ -142,7 +273,7 @@ static void imb_global_cache_tile_unload(ImGlobalTile *gtile)
 	MEM_freeN(ibuf->tiles[toffs]);
 	ibuf->tiles[toffs] = NULL;
 
-	GLOBAL_CACHE.totmem -= sizeof(unsigned int) * ibuf->tilex * ibuf->tiley;
+	GLOBAL_CACHE.totmem -= imb_tile_cache_tile_size(ibuf);
 }
 
 /* external free */
@@ -165,11 +296,88 @@ void imb_tile_cache_tile_free(ImBuf *ibuf, int tx, int ty)
 		BLI_ghash_remove(GLOBAL_CACHE.tilehash, gtile, NULL, NULL);
 		BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
 		BLI_addtail(&GLOBAL_CACHE.unused, gtile);
+
+		GLOBAL_CACHE.totmem -= imb_tile_cache_tile_size(ibuf);
 	}
 
 	BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
 }
 
+/* Add a tile decoded on the way to another one, for formats that can only be read
+ * in order. Unloads least recently used tiles like loading does, so the last tiles
+ * offered (the ones read just before the requested tile) are kept, it's skipped when
+ * the tiles in use leave no room for it. */
+void imb_tile_cache_tile_offer(ImBuf *ibuf, int tx, int ty, const unsigned int *rect)
+{
+	const size_t tilemem = imb_tile_cache_tile_size(ibuf);
+	const uintptr_t maxmem = imb_global_cache_maxmem();
+	ImGlobalTile *gtile, lookuptile;
+
+	BLI_mutex_lock(&GLOBAL_CACHE.mutex);
+
+	lookuptile.ibuf = ibuf;
+	lookuptile.tx = tx;
+	lookuptile.ty = ty;
+
+	if (!BLI_ghash_haskey(GLOBAL_CACHE.tilehash, &lookuptile)) {
+		gtile = imb_global_cache_tile_new(tilemem);
+
+		if (maxmem && GLOBAL_CACHE.totmem + tilemem > maxmem) {
+			BLI_addtail(&GLOBAL_CACHE.unused, gtile);
+			BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
+			return;
+		}
+
+		gtile->ibuf = ibuf;
+		gtile->tx = tx;
+		gtile->ty = ty;
+		gtile->refcount = 0;
+		gtile->loading = 0;
+
+		ibuf->tiles[ibuf->xtiles * ty + tx] = MEM_mallocN(tilemem, "imb_tile");
+		memcpy(ibuf->tiles[ibuf->xtiles * ty + tx], rect, tilemem);
+
+		BLI_ghash_insert(GLOBAL_CACHE.tilehash, gtile, gtile);
+		BLI_addhead(&GLOBAL_CACHE.tiles, gtile);
+
+		GLOBAL_CACHE.totmem += tilemem;
+	}
+
+	BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
+}
+
+/* Add mipmap levels to an image read with IB_tilecache, down to two by two pixels.
+ * Their tiles are reduced from the level above when first used. */
+void imb_tile_cache_add_mipmaps(ImBuf *ibuf)
+{
+	ImBuf *hbuf = ibuf;
+	int curmap = 0;
+
+	ibuf->miptot = 1;
+
+	while (curmap < IMB_MIPMAP_LEVELS && !(hbuf->x <= 2 && hbuf->y <= 2)) {
+		ImBuf *nbuf = IMB_allocImBuf(max_ii(hbuf->x / 2, 1), max_ii(hbuf->y / 2, 1), 32, 0);
+
+		nbuf->flags |= IB_tilecache;
+		nbuf->ftype = ibuf->ftype;
+		nbuf->tilechannels = ibuf->tilechannels;
+		nbuf->miplevel = curmap + 1;
+		nbuf->mipparent = hbuf;
+
+		nbuf->tilex = min_ii(ibuf->tilex, nbuf->x);
+		nbuf->tiley = min_ii(ibuf->tiley, nbuf->y);
+		nbuf->xtiles = (nbuf->x + nbuf->tilex - 1) / nbuf->tilex;
+		nbuf->ytiles = (nbuf->y + nbuf->tiley - 1) / nbuf->tiley;
+
+		imb_addtilesImBuf(nbuf);
+
+		ibuf->mipmap[curmap] = nbuf;
+		ibuf->miptot = curmap + 2;
+		hbuf = nbuf;
+		curmap++;
+	}
+}
+
 /******************************* Init/Exit ***********************************/
 
 static void imb_thread_cache_init(ImThreadTileCache *cache)
@@ -200,7 +408,7 @@ void imb_tile_cache_init(void)
 	BLI_mutex_init(&GLOBAL_CACHE.mutex);
 
 	/* initialize for one thread, for places that access textures
-	 * outside of rendering (displace modifier, painting, ..) */
+	 * outside of rendering (painting, ..), task pools use samplers */
 	IMB_tile_cache_params(0, 0);
 
 	GLOBAL_CACHE.initialized = 1;
@@ -239,7 +447,7 @@ void IMB_tile_cache_params(int totthread, int maxmem)
 	totthread++;
 
 	/* lazy initialize cache */
-	if (GLOBAL_CACHE.totthread == totthread && GLOBAL_CACHE.maxmem == maxmem)
+	if (GLOBAL_CACHE.totthread == totthread && GLOBAL_CACHE.maxmem == (uintptr_t)maxmem * 1024 * 1024)
 		return;
 
 	imb_tile_cache_exit();
@@ -251,17 +459,56 @@ void IMB_tile_cache_params(int totthread, int maxmem)
 	GLOBAL_CACHE.memarena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "ImTileCache arena");
 	BLI_memarena_use_calloc(GLOBAL_CACHE.memarena);
 
-	GLOBAL_CACHE.maxmem = maxmem * 1024 * 1024;
+	GLOBAL_CACHE.maxmem = (uintptr_t)maxmem * 1024 * 1024;
 
 	GLOBAL_CACHE.totthread = totthread;
 	for (a = 0; a < totthread; a++)
 		imb_thread_cache_init(&GLOBAL_CACHE.thread_cache[a]);
 
 	BLI_mutex_init(&GLOBAL_CACHE.mutex);
+
+	GLOBAL_CACHE.initialized = 1;
 }
 
 /***************************** Global Cache **********************************/
 
+/* Get a tile to set up, first unloading least recently used tiles while adding
+ * \a tilemem bytes would exceed the memory limit. Called with the cache locked. */
+static ImGlobalTile *imb_global_cache_tile_new(size_t tilemem)
+{
+	const uintptr_t maxmem = imb_global_cache_maxmem();
+	ImGlobalTile *gtile, *gtile_prev, *gtile_new = NULL;
+
+	if (maxmem) {
+		for (gtile = GLOBAL_CACHE.tiles.last; gtile && GLOBAL_CACHE.totmem + tilemem > maxmem; gtile = gtile_prev) {
+			gtile_prev = gtile->prev;
+
+			if (gtile->refcount == 0 && gtile->loading == 0) {
+				imb_global_cache_tile_unload(gtile);
+				BLI_ghash_remove(GLOBAL_CACHE.tilehash, gtile, NULL, NULL);
+				BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
+
+				if (gtile_new == NULL)
+					gtile_new = gtile;
+				else
+					BLI_addtail(&GLOBAL_CACHE.unused, gtile);
+			}
+		}
+	}
+
+	if (gtile_new == NULL) {
+		/* allocate a new tile or reuse unused */
+		if (GLOBAL_CACHE.unused.first) {
+			gtile_new = GLOBAL_CACHE.unused.first;
+			BLI_remlink(&GLOBAL_CACHE.unused, gtile_new);
+		}
+		else
+			gtile_new = BLI_memarena_alloc(GLOBAL_CACHE.memarena, sizeof(ImGlobalTile));
+	}
+
+	return gtile_new;
+}
+
 static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGlobalTile *replacetile)
 {
 	ImGlobalTile *gtile, lookuptile;
@@ -283,6 +530,10 @@ static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGl
 		 * for the other thread to load the tile */
 		gtile->refcount++;
 
+		/* keep recently used tiles at the head, unloading starts at the tail */
+		BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
+		BLI_addhead(&GLOBAL_CACHE.tiles, gtile);
+
 		BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
 
 		while (gtile->loading)
@@ -290,30 +541,7 @@ static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGl
 	}
 	else {
 		/* not found, let's load it from disk */
-
-		/* first check if we hit the memory limit */
-		if (GLOBAL_CACHE.maxmem && GLOBAL_CACHE.totmem > GLOBAL_CACHE.maxmem) {
-			/* find an existing tile to unload */
-			for (gtile = GLOBAL_CACHE.tiles.last; gtile; gtile = gtile->prev)
-				if (gtile->refcount == 0 && gtile->loading == 0)
-					break;
-		}
-
-		if (gtile) {
-			/* found a tile to unload */
-			imb_global_cache_tile_unload(gtile);
-			BLI_ghash_remove(GLOBAL_CACHE.tilehash, gtile, NULL, NULL);
-			BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
-		}
-		else {
-			/* allocate a new tile or reuse unused */
-			if (GLOBAL_CACHE.unused.first) {
-				gtile = GLOBAL_CACHE.unused.first;
-				BLI_remlink(&GLOBAL_CACHE.unused, gtile);
-			}
-			else
-				gtile = BLI_memarena_alloc(GLOBAL_CACHE.memarena, sizeof(ImGlobalTile));
-		}
+		gtile = imb_global_cache_tile_new(imb_tile_cache_tile_size(ibuf));
 
 		/* setup new tile */
 		gtile->ibuf = ibuf;
@@ -326,7 +554,7 @@ static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGl
 		BLI_addhead(&GLOBAL_CACHE.tiles, gtile);
 
 		/* mark as being loaded and unlock to allow other threads to load too */
-		GLOBAL_CACHE.totmem += sizeof(unsigned int) * ibuf->tilex * ibuf->tiley;
+		GLOBAL_CACHE.totmem += imb_tile_cache_tile_size(ibuf);
 
 		BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
 
@@ -403,14 +631,14 @@ void IMB_tiles_to_rect(ImBuf *ibuf)
 	ImBuf *mipbuf;
 	ImGlobalTile *gtile;
 	unsigned int *to, *from;
-	int a, tx, ty, y, w, h;
+	int a, tx, ty, x, y, w, h;
 
 	for (a = 0; a < ibuf->miptot; a++) {
 		mipbuf = IMB_getmipmap(ibuf, a);
 
 		/* don't call imb_addrectImBuf, it frees all mipmaps */
 		if (!mipbuf->rect) {
-			if ((mipbuf->rect = MEM_mapallocN(ibuf->x * ibuf->y * sizeof(unsigned int), "imb_addrectImBuf"))) {
+			if ((mipbuf->rect = MEM_mapallocN((size_t)mipbuf->x * mipbuf->y * sizeof(unsigned int), "imb_addrectImBuf"))) {
 				mipbuf->mall |= IB_rect;
 				mipbuf->flags |= IB_rect;
 			}
@@ -432,17 +660,164 @@ void IMB_tiles_to_rect(ImBuf *ibuf)
 				w = (tx == mipbuf->xtiles - 1) ? mipbuf->x - tx * mipbuf->tilex : mipbuf->tilex;
 				h = (ty == mipbuf->ytiles - 1) ? mipbuf->y - ty * mipbuf->tiley : mipbuf->tiley;
 
-				for (y = 0; y < h; y++) {
-					memcpy(to, from, sizeof(unsigned int) * w);
-					from += mipbuf->tilex;
-					to += mipbuf->x;
+				if (mipbuf->tilechannels) {
+					/* 16 bit tiles are reduced to bytes */
+					const int channels = mipbuf->tilechannels;
+					const unsigned short *from_us = (const unsigned short *)from;
+
+					for (y = 0; y < h; y++) {
+						for (x = 0; x < w; x++) {
+							const unsigned short *us = from_us + ((size_t)y * mipbuf->tilex + x) * channels;
+							unsigned char *uc = (unsigned char *)(to + (size_t)y * mipbuf->x + x);
+
+							if (channels == 1) {
+								uc[0] = uc[1] = uc[2] = (unsigned char)((us[0] + 128) / 257);
+								uc[3] = 255;
+							}
+							else {
+								uc[0] = (unsigned char)((us[0] + 128) / 257);
+								uc[1] = (unsigned char)((us[1] + 128) / 257);
+								uc[2] = (unsigned char)((us[2] + 128) / 257);
+								uc[3] = (unsigned char)((us[3] + 128) / 257);
+							}
+						}
+					}
+				}
+				else {
+					for (y = 0; y < h; y++) {
+						memcpy(to, from, sizeof(unsigned int) * w);
+						from += mipbuf->tilex;
+						to += mipbuf->x;
+					}
 				}
 
 				/* decrease refcount for tile again */
-				BLI_mutex_lock(&GLOBAL_CACHE.mutex);
-				gtile->refcount--;
-				BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
+				imb_global_cache_tile_release(gtile);
 			}
 		}
 	}
 }
+
+/******************************** Sampling ***********************************/
+
+/* Samplers keep the last few tiles they used referenced, like the per-thread
+ * caches, but belong to the caller so they can be used from task pools where
+ * there's no fixed thread number. */
+
+ImTileSampler *IMB_tile_sampler_new(void)
+{
+	return MEM_callocN(sizeof(ImTileSampler), "ImTileSampler");
+}
+
+void IMB_tile_sampler_free(ImTileSampler *sampler)
+{
+	int a;
+
+	BLI_mutex_lock(&GLOBAL_CACHE.mutex);
+	for (a = 0; a < sampler->tiles_len; a++)
+		sampler->tiles[a]->refcount--;
+	BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
+
+	MEM_freeN(sampler);
+}
+
+/* copies the pixel as floats in [0, 1], the tile may be replaced by the next lookup */
+static void imb_tile_sampler_pixel(ImTileSampler *sampler, ImBuf *ibuf, int x, int y, float r_pixel[4])
+{
+	const unsigned int *tile;
+	size_t offs;
+	const int tx = x / ibuf->tilex, ty = y / ibuf->tiley;
+	ImGlobalTile *gtile;
+	int a;
+
+	for (a = 0; a < sampler->tiles_len; a++) {
+		gtile = sampler->tiles[a];
+		if (gtile->ibuf == ibuf && gtile->tx == tx && gtile->ty == ty)
+			break;
+	}
+
+	if (a == sampler->tiles_len) {
+		if (sampler->tiles_len < IB_SAMPLER_TILES) {
+			a = sampler->tiles_len++;
+			gtile = imb_global_cache_get_tile(ibuf, tx, ty, NULL);
+		}
+		else {
+			a = sampler->tiles_next;
+			sampler->tiles_next = (sampler->tiles_next + 1) % IB_SAMPLER_TILES;
+			gtile = imb_global_cache_get_tile(ibuf, tx, ty, sampler->tiles[a]);
+		}
+		sampler->tiles[a] = gtile;
+	}
+
+	tile = ibuf->tiles[ibuf->xtiles * ty + tx];
+	offs = (size_t)(y - ty * ibuf->tiley) * ibuf->tilex + (size_t)(x - tx * ibuf->tilex);
+
+	if (ibuf->tilechannels == 0) {
+		rgba_uchar_to_float(r_pixel, (const unsigned char *)(tile + offs));
+	}
+	else if (ibuf->tilechannels == 1) {
+		const unsigned short *us = (const unsigned short *)tile + offs;
+		r_pixel[0] = r_pixel[1] = r_pixel[2] = us[0] * (1.0f / 65535.0f);
+		r_pixel[3] = 1.0f;
+	}
+	else {
+		const unsigned short *us = (const unsigned short *)tile + offs * 4;
+		r_pixel[0] = us[0] * (1.0f / 65535.0f);
+		r_pixel[1] = us[1] * (1.0f / 65535.0f);
+		r_pixel[2] = us[2] * (1.0f / 65535.0f);
+		r_pixel[3] = us[3] * (1.0f / 65535.0f);
+	}
+}
+
+/**
+ * Bilinear lookup at pixel coordinates \a u, \a v of an image read with IB_tilecache
+ * (or one of its mipmap levels), clamped to the edge pixels. The color is the values
+ * as they're stored in the file (byte or 16 bit) in [0, 1], without color space conversion.
+ *
+ * Images that aren't tiled (formats that can't be read per tile) are sampled from
+ * their float or byte buffer as is. To get the same values for both, read the image
+ * as non-color data (see BKE_image_acquire_ibuf_tiled), float buffers are otherwise
+ * converted to scene linear.
+ */
+void IMB_tile_sampler_bilinear(ImTileSampler *sampler, ImBuf *ibuf, float u, float v, float r_col[4])
+{
+	float row1[2][4], row2[2][4];
+	float a, b;
+	int x1, y1, x2, y2, i;
+
+	u = clamp_f(u, 0.0f, (float)(ibuf->x - 1));
+	v = clamp_f(v, 0.0f, (float)(ibuf->y - 1));
+
+	if (ibuf->tiles == NULL) {
+		if (ibuf->rect_float && ibuf->channels == 4) {
+			BLI_bilinear_interpolation_fl(ibuf->rect_float, r_col, ibuf->x, ibuf->y, 4, u, v);
+		}
+		else if (ibuf->rect) {
+			unsigned char col[4];
+			BLI_bilinear_interpolation_char((unsigned char *)ibuf->rect, col, ibuf->x, ibuf->y, 4, u, v);
+			rgba_uchar_to_float(r_col, col);
+		}
+		else {
+			zero_v4(r_col);
+		}
+		return;
+	}
+
+	x1 = (int)u;
+	y1 = (int)v;
+	x2 = min_ii(x1 + 1, ibuf->x - 1);
+	y2 = min_ii(y1 + 1, ibuf->y - 1);
+
+	a = u - (float)x1;
+	b = v - (float)y1;
+
+	imb_tile_sampler_pixel(sampler, ibuf, x1, y1, row1[0]);
+	imb_tile_sampler_pixel(sampler, ibuf, x2, y1, row1[1]);
+	imb_tile_sampler_pixel(sampler, ibuf, x1, y2, row2[0]);
+	imb_tile_sampler_pixel(sampler, ibuf, x2, y2, row2[1]);
+
+	for (i = 0; i < 4; i++) {
+		r_col[i] = ((1.0f - b) * ((1.0f - a) * row1[0][i] + a * row1[1][i]) +
+		            b * ((1.0f - a) * row2[0][i] + a * row2[1][i]));
+	}
+}
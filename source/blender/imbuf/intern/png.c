@@ -44,6 +44,9 @@
 #include "IMB_colormanagement.h"
 #include "IMB_colormanagement_intern.h"
 
+/* pixels per tile for images read with IB_tilecache, tiles are bands of whole rows */
+#define PNG_TILE_PIXELS (1 << 18)
+
 typedef struct PNGReadStruct {
 	const unsigned char *data;
 	unsigned int size;
@@ -617,7 +620,28 @@ ImBuf *imb_loadpng(const unsigned char *mem, size_t size, int flags, char colors
 		printf("Couldn't allocate memory for PNG image\n");
 	}
 
-	if (ibuf && ((flags & IB_test) == 0)) {
+	/* leave reading pixels to the tile cache, rows can be read in order so interlaced
+	 * images are read entirely */
+	if (ibuf && (flags & IB_tilecache) && ((flags & IB_test) == 0) &&
+	    (png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE))
+	{
+		ibuf->flags |= IB_tilecache;
+
+		/* 16 bit images keep their precision in 16 bit tiles, grayscale in a single channel */
+		if (bit_depth == 16) {
+			ibuf->tilechannels = (channels == 1) ? 1 : 4;
+		}
+
+		ibuf->tilex = ibuf->x;
+		ibuf->tiley = min_ii(max_ii(PNG_TILE_PIXELS / ibuf->x, 1), ibuf->y);
+		ibuf->xtiles = 1;
+		ibuf->ytiles = (ibuf->y + ibuf->tiley - 1) / ibuf->tiley;
+
+		imb_addtilesImBuf(ibuf);
+		imb_tile_cache_add_mipmaps(ibuf);
+	}
+
+	if (ibuf && ((flags & IB_test) == 0) && ((ibuf->flags & IB_tilecache) == 0)) {
 		if (bit_depth == 16) {
 			imb_addrectfloatImBuf(ibuf);
 			png_set_swap(png_ptr);
@@ -772,3 +796,117 @@ ImBuf *imb_loadpng(const unsigned char *mem, size_t size, int flags, char colors
 
 	return(ibuf);
 }
+
+void imb_loadtilepng(ImBuf *ibuf, const unsigned char *mem, size_t size, int UNUSED(tx), int ty, unsigned int *rect)
+{
+	png_structp png_ptr;
+	png_infop info_ptr;
+	png_uint_32 width, height;
+	int bit_depth, color_type;
+	PNGReadStruct ps;
+	unsigned int *band;
+	/* bytes per row of a tile, which is all pixels of an image row */
+	const size_t row_size = imb_tile_cache_tile_size(ibuf) / (size_t)ibuf->tiley;
+	int band_ty, y;
+
+	if (imb_is_a_png(mem) == 0) return;
+
+	png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+	                                 NULL, NULL, NULL);
+	if (png_ptr == NULL) {
+		printf("Cannot png_create_read_struct\n");
+		return;
+	}
+
+	png_set_error_fn(png_ptr, NULL, imb_png_error, imb_png_warning);
+
+	info_ptr = png_create_info_struct(png_ptr);
+	if (info_ptr == NULL) {
+		png_destroy_read_struct(&png_ptr, (png_infopp)NULL,
+		                        (png_infopp)NULL);
+		printf("Cannot png_create_info_struct\n");
+		return;
+	}
+
+	ps.size = size; /* XXX, 4gig limit! */
+	ps.data = mem;
+	ps.seek = 0;
+
+	png_set_read_fn(png_ptr, (void *) &ps, ReadData);
+
+	/* bands decoded on the way to the requested one */
+	band = MEM_mallocN(imb_tile_cache_tile_size(ibuf), __func__);
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+		MEM_freeN(band);
+		return;
+	}
+
+	png_read_info(png_ptr, info_ptr);
+	png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth,
+	             &color_type, NULL, NULL, NULL);
+
+	if ((int)width != ibuf->x || (int)height != ibuf->y) {
+		printf("imb_loadtilepng: image has unexpected size %ux%u instead of %dx%d\n", width, height, ibuf->x, ibuf->y);
+		longjmp(png_jmpbuf(png_ptr), 1);
+	}
+
+	if ((bit_depth == 16) != (ibuf->tilechannels != 0)) {
+		printf("imb_loadtilepng: image has unexpected bit depth %d\n", bit_depth);
+		longjmp(png_jmpbuf(png_ptr), 1);
+	}
+
+	if (bit_depth == 16) {
+		/* let libpng expand 16 bit formats to RGBA, except grayscale which is kept in one channel,
+		 * transparency isn't used like when reading the entire image */
+		png_set_swap(png_ptr);
+		if (ibuf->tilechannels == 4) {
+			if (ELEM(color_type, PNG_COLOR_TYPE_GRAY, PNG_COLOR_TYPE_GRAY_ALPHA)) {
+				png_set_gray_to_rgb(png_ptr);
+			}
+			png_set_filler(png_ptr, 0xffff, PNG_FILLER_AFTER);
+		}
+	}
+	else {
+		/* let libpng expand all formats to 8 bit RGBA */
+		if (color_type == PNG_COLOR_TYPE_PALETTE) {
+			png_set_palette_to_rgb(png_ptr);
+		}
+		if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
+			png_set_expand_gray_1_2_4_to_8(png_ptr);
+		}
+		if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
+			png_set_tRNS_to_alpha(png_ptr);
+		}
+		if (ELEM(color_type, PNG_COLOR_TYPE_GRAY, PNG_COLOR_TYPE_GRAY_ALPHA)) {
+			png_set_gray_to_rgb(png_ptr);
+		}
+		png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+	}
+	png_read_update_info(png_ptr, info_ptr);
+
+	if (png_get_rowbytes(png_ptr, info_ptr) != row_size) {
+		printf("imb_loadtilepng: PNG format not supported\n");
+		longjmp(png_jmpbuf(png_ptr), 1);
+	}
+
+	/* rows are stored top to bottom and tiles are bottom to top, so reading starts
+	 * at the top row of the last band, the bands before the requested one are offered
+	 * to the cache */
+	for (band_ty = ibuf->ytiles - 1; band_ty >= ty; band_ty--) {
+		unsigned int *to = (band_ty == ty) ? rect : band;
+		const int h = min_ii(ibuf->tiley, ibuf->y - band_ty * ibuf->tiley);
+
+		for (y = h - 1; y >= 0; y--) {
+			png_read_row(png_ptr, (png_bytep)to + (size_t)y * row_size, NULL);
+		}
+
+		if (band_ty != ty) {
+			imb_tile_cache_tile_offer(ibuf, 0, band_ty, band);
+		}
+	}
+
+	png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+	MEM_freeN(band);
+}
@@ -23,7 +23,14 @@
  */
 
 
+#include <string.h>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 #include "BLI_utildefines.h"
+#include "BLI_math_base.h"
 #include "BLI_math_color.h"
 #include "BLI_math_interp.h"
 #include "MEM_guardedalloc.h"
@@ -867,151 +874,408 @@ static bool q_scale_linear_interpolation(
 	return true;
 }
 
-static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+/* ******** box filter and linear scaling ******** */
+
+/* The scaledown and scaleup functions step a sample position along the rows (or columns)
+ * of the image. The steps only depend on the sizes, so they're computed once and shared by
+ * all rows, which are then scaled in parallel bands of scanlines, four channels at a time. */
+
+#define SCALE_THREADED_MIN_PIXELS (256 * 256)
+
+#ifdef __SSE2__
+
+typedef __m128 ScalePixel;
+
+BLI_INLINE ScalePixel scale_pixel_zero(void)
 {
-	const int do_rect = (ibuf->rect != NULL);
-	const int do_float = (ibuf->rect_float != NULL);
-	const size_t rect_size = ibuf->x * ibuf->y * 4;
+	return _mm_setzero_ps();
+}
 
-	uchar *rect, *_newrect, *newrect;
-	float *rectf, *_newrectf, *newrectf;
-	float sample, add, val[4], nval[4], valf[4], nvalf[4];
-	int x, y;
+/* Pixels are read from the float buffer when there's one, from the byte buffer otherwise. */
+BLI_INLINE ScalePixel scale_pixel_load(const uchar *rect, const float *rectf, const size_t ofs)
+{
+	if (rectf) {
+		return _mm_loadu_ps(rectf + ofs);
+	}
+	else {
+		const __m128i zero = _mm_setzero_si128();
+		int value;
+		__m128i v;
+
+		memcpy(&value, rect + ofs, sizeof(value));
+		v = _mm_cvtsi32_si128(value);
+		v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+		return _mm_cvtepi32_ps(v);
+	}
+}
 
-	rectf = _newrectf = newrectf = NULL;
-	rect = _newrect = newrect = NULL;
-	nval[0] =  nval[1] = nval[2] = nval[3] = 0.0f;
-	nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
+/* byte values are truncated, callers add 0.5 to round */
+BLI_INLINE void scale_pixel_store(ScalePixel a, uchar *rect, float *rectf, const size_t ofs)
+{
+	if (rectf) {
+		_mm_storeu_ps(rectf + ofs, a);
+	}
+	else {
+		__m128i v = _mm_cvttps_epi32(a);
+		int value;
 
-	if (!do_rect && !do_float) return (ibuf);
+		v = _mm_packs_epi32(v, v);
+		v = _mm_packus_epi16(v, v);
+		value = _mm_cvtsi128_si32(v);
+		memcpy(rect + ofs, &value, sizeof(value));
+	}
+}
 
-	if (do_rect) {
-		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(uchar) * 4, "scaledownx");
-		if (_newrect == NULL) return(ibuf);
+BLI_INLINE ScalePixel scale_pixel_add(ScalePixel a, ScalePixel b)
+{
+	return _mm_add_ps(a, b);
+}
+
+BLI_INLINE ScalePixel scale_pixel_sub(ScalePixel a, ScalePixel b)
+{
+	return _mm_sub_ps(a, b);
+}
+
+BLI_INLINE ScalePixel scale_pixel_add_fl(ScalePixel a, const float f)
+{
+	return _mm_add_ps(a, _mm_set1_ps(f));
+}
+
+BLI_INLINE ScalePixel scale_pixel_mul_fl(ScalePixel a, const float f)
+{
+	return _mm_mul_ps(a, _mm_set1_ps(f));
+}
+
+BLI_INLINE ScalePixel scale_pixel_div_fl(ScalePixel a, const float f)
+{
+	return _mm_div_ps(a, _mm_set1_ps(f));
+}
+
+/* a + b * f */
+BLI_INLINE ScalePixel scale_pixel_madd_fl(ScalePixel a, ScalePixel b, const float f)
+{
+	return _mm_add_ps(a, _mm_mul_ps(b, _mm_set1_ps(f)));
+}
+
+#else  /* __SSE2__ */
+
+typedef struct ScalePixel {
+	float v[4];
+} ScalePixel;
+
+BLI_INLINE ScalePixel scale_pixel_zero(void)
+{
+	ScalePixel r = {{0.0f, 0.0f, 0.0f, 0.0f}};
+	return r;
+}
+
+BLI_INLINE ScalePixel scale_pixel_load(const uchar *rect, const float *rectf, const size_t ofs)
+{
+	ScalePixel r;
+	if (rectf) {
+		rectf += ofs;
+		r.v[0] = rectf[0]; r.v[1] = rectf[1]; r.v[2] = rectf[2]; r.v[3] = rectf[3];
 	}
-	if (do_float) {
-		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaledownxf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
+	else {
+		rect += ofs;
+		r.v[0] = rect[0]; r.v[1] = rect[1]; r.v[2] = rect[2]; r.v[3] = rect[3];
+	}
+	return r;
+}
+
+/* byte values are truncated, callers add 0.5 to round */
+BLI_INLINE void scale_pixel_store(ScalePixel a, uchar *rect, float *rectf, const size_t ofs)
+{
+	if (rectf) {
+		rectf += ofs;
+		rectf[0] = a.v[0]; rectf[1] = a.v[1]; rectf[2] = a.v[2]; rectf[3] = a.v[3];
+	}
+	else {
+		rect += ofs;
+		rect[0] = a.v[0]; rect[1] = a.v[1]; rect[2] = a.v[2]; rect[3] = a.v[3];
+	}
+}
+
+BLI_INLINE ScalePixel scale_pixel_add(ScalePixel a, ScalePixel b)
+{
+	a.v[0] += b.v[0]; a.v[1] += b.v[1]; a.v[2] += b.v[2]; a.v[3] += b.v[3];
+	return a;
+}
+
+BLI_INLINE ScalePixel scale_pixel_sub(ScalePixel a, ScalePixel b)
+{
+	a.v[0] -= b.v[0]; a.v[1] -= b.v[1]; a.v[2] -= b.v[2]; a.v[3] -= b.v[3];
+	return a;
+}
+
+BLI_INLINE ScalePixel scale_pixel_add_fl(ScalePixel a, const float f)
+{
+	a.v[0] += f; a.v[1] += f; a.v[2] += f; a.v[3] += f;
+	return a;
+}
+
+BLI_INLINE ScalePixel scale_pixel_mul_fl(ScalePixel a, const float f)
+{
+	a.v[0] *= f; a.v[1] *= f; a.v[2] *= f; a.v[3] *= f;
+	return a;
+}
+
+BLI_INLINE ScalePixel scale_pixel_div_fl(ScalePixel a, const float f)
+{
+	a.v[0] /= f; a.v[1] /= f; a.v[2] /= f; a.v[3] /= f;
+	return a;
+}
+
+/* a + b * f */
+BLI_INLINE ScalePixel scale_pixel_madd_fl(ScalePixel a, ScalePixel b, const float f)
+{
+	a.v[0] += b.v[0] * f; a.v[1] += b.v[1] * f; a.v[2] += b.v[2] * f; a.v[3] += b.v[3] * f;
+	return a;
+}
+
+#endif  /* __SSE2__ */
+
+/* Source pixels averaged into one pixel when scaling down. */
+typedef struct ScaleDownSample {
+	/* first source pixel that's covered entirely, and the number of them */
+	int start, len;
+	/* weight of the pixel before 'start', shared with the previous sample (unused for the first),
+	 * and of the pixel after the covered ones, shared with the next sample */
+	float carry, last;
+} ScaleDownSample;
+
+/* Source pixels interpolated into one pixel when scaling up. */
+typedef struct ScaleUpSample {
+	/* the pixel and the one after it */
+	int index, index_next;
+	float fac;
+} ScaleUpSample;
+
+typedef struct ScaleThreadScanlineData {
+	const ImBuf *ibuf;
+	int newsize;
+	const void *samples;
+	/* source pixels per destination pixel, when scaling down */
+	float add;
+
+	uchar *newrect;
+	float *newrectf;
+} ScaleThreadScanlineData;
+
+static ScaleDownSample *scaledown_samples(int size, int newsize, float *r_add)
+{
+	ScaleDownSample *samples = MEM_mallocN(sizeof(*samples) * newsize, __func__);
+	const float add = (size - 0.01) / newsize;
+	float sample = 0.0f;
+	int i, pos = 0;
+
+	for (i = 0; i < newsize; i++) {
+		ScaleDownSample *s = &samples[i];
+
+		s->carry = -sample;
+		s->start = pos;
+
+		sample += add;
+		while (sample >= 1.0f) {
+			sample -= 1.0f;
+			pos++;
 		}
+
+		s->len = pos - s->start;
+		s->last = sample;
+
+		pos++;
+		sample -= 1.0f;
 	}
 
-	add = (ibuf->x - 0.01) / newx;
+	BLI_assert(pos == size); /* see bug [#26502] */
+	(void)size; /* UNUSED in release builds */
 
-	if (do_rect) {
-		rect = (uchar *) ibuf->rect;
-		newrect = _newrect;
+	*r_add = add;
+	return samples;
+}
+
+static ScaleUpSample *scaleup_samples(int size, int newsize)
+{
+	ScaleUpSample *samples = MEM_mallocN(sizeof(*samples) * newsize, __func__);
+	const float add = (size - 1.001) / (newsize - 1.0);
+	float sample = 0.0f;
+	int i, pos = 0;
+
+	for (i = 0; i < newsize; i++) {
+		ScaleUpSample *s = &samples[i];
+
+		if (sample >= 1.0f) {
+			sample -= 1.0f;
+			pos++;
+		}
+
+		/* a single pixel is stretched over the whole size */
+		s->index = min_ii(pos, size - 1);
+		s->index_next = min_ii(pos + 1, size - 1);
+		s->fac = sample;
+
+		sample += add;
 	}
-	if (do_float) {
-		rectf = ibuf->rect_float;
-		newrectf = _newrectf;
+
+	return samples;
+}
+
+static void scale_apply_threaded_scanlines(
+        int total_scanlines, size_t total_pixels, ScanlineThreadFunc do_thread, void *custom_data)
+{
+	if (total_pixels < SCALE_THREADED_MIN_PIXELS) {
+		do_thread(custom_data, 0, total_scanlines);
+	}
+	else {
+		IMB_processor_apply_threaded_scanlines(total_scanlines, do_thread, custom_data);
 	}
+}
 
-	for (y = ibuf->y; y > 0; y--) {
-		sample = 0.0f;
-		val[0] =  val[1] = val[2] = val[3] = 0.0f;
-		valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
+/* \a ofs is the first pixel of the row (or column), \a step the distance between its pixels */
+BLI_INLINE ScalePixel scaledown_pixel(
+        const uchar *rect, const float *rectf, size_t ofs, const size_t step,
+        const ScaleDownSample *s, const float add)
+{
+	ScalePixel acc = scale_pixel_zero();
+	int i;
 
-		for (x = newx; x > 0; x--) {
-			if (do_rect) {
-				nval[0] = -val[0] * sample;
-				nval[1] = -val[1] * sample;
-				nval[2] = -val[2] * sample;
-				nval[3] = -val[3] * sample;
-			}
-			if (do_float) {
-				nvalf[0] = -valf[0] * sample;
-				nvalf[1] = -valf[1] * sample;
-				nvalf[2] = -valf[2] * sample;
-				nvalf[3] = -valf[3] * sample;
-			}
+	ofs += step * s->start;
+	if (s->start != 0) {
+		acc = scale_pixel_mul_fl(scale_pixel_load(rect, rectf, ofs - step), s->carry);
+	}
+	for (i = 0; i < s->len; i++, ofs += step) {
+		acc = scale_pixel_add(acc, scale_pixel_load(rect, rectf, ofs));
+	}
+	acc = scale_pixel_madd_fl(acc, scale_pixel_load(rect, rectf, ofs), s->last);
+	acc = scale_pixel_div_fl(acc, add);
 
-			sample += add;
-
-			while (sample >= 1.0f) {
-				sample -= 1.0f;
-
-				if (do_rect) {
-					nval[0] += rect[0];
-					nval[1] += rect[1];
-					nval[2] += rect[2];
-					nval[3] += rect[3];
-					rect += 4;
-				}
-				if (do_float) {
-					nvalf[0] += rectf[0];
-					nvalf[1] += rectf[1];
-					nvalf[2] += rectf[2];
-					nvalf[3] += rectf[3];
-					rectf += 4;
-				}
-			}
+	return rectf ? acc : scale_pixel_add_fl(acc, 0.5f);
+}
 
-			if (do_rect) {
-				val[0] = rect[0]; val[1] = rect[1]; val[2] = rect[2]; val[3] = rect[3];
-				rect += 4;
+static void scaledownx_rows(
+        const uchar *rect, const float *rectf, uchar *newrect, float *newrectf,
+        const ScaleThreadScanlineData *data, int start_scanline, int num_scanlines)
+{
+	const ScaleDownSample *samples = data->samples;
+	const int x = data->ibuf->x, newx = data->newsize;
+	int y, i;
 
-				newrect[0] = ((nval[0] + sample * val[0]) / add + 0.5f);
-				newrect[1] = ((nval[1] + sample * val[1]) / add + 0.5f);
-				newrect[2] = ((nval[2] + sample * val[2]) / add + 0.5f);
-				newrect[3] = ((nval[3] + sample * val[3]) / add + 0.5f);
+	for (y = start_scanline; y < start_scanline + num_scanlines; y++) {
+		const size_t ofs = (size_t)4 * x * y, newofs = (size_t)4 * newx * y;
 
-				newrect += 4;
-			}
-			if (do_float) {
+		for (i = 0; i < newx; i++) {
+			scale_pixel_store(
+			        scaledown_pixel(rect, rectf, ofs, 4, &samples[i], data->add),
+			        newrect, newrectf, newofs + 4 * i);
+		}
+	}
+}
 
-				valf[0] = rectf[0]; valf[1] = rectf[1]; valf[2] = rectf[2]; valf[3] = rectf[3];
-				rectf += 4;
+static void scaledownx_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+	ScaleThreadScanlineData *data = data_v;
 
-				newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-				newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-				newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-				newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
+	if (data->newrect) {
+		scaledownx_rows((uchar *)data->ibuf->rect, NULL, data->newrect, NULL, data, start_scanline, num_scanlines);
+	}
+	if (data->newrectf) {
+		scaledownx_rows(NULL, data->ibuf->rect_float, NULL, data->newrectf, data, start_scanline, num_scanlines);
+	}
+}
 
-				newrectf += 4;
-			}
+static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+{
+	const int do_rect = (ibuf->rect != NULL);
+	const int do_float = (ibuf->rect_float != NULL);
+	ScaleThreadScanlineData data = {NULL};
+	ScaleDownSample *samples;
 
-			sample -= 1.0f;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
+
+	if (!do_rect && !do_float) return (ibuf);
+
+	if (do_rect) {
+		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(uchar) * 4, "scaledownx");
+		if (_newrect == NULL) return(ibuf);
+	}
+	if (do_float) {
+		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaledownxf");
+		if (_newrectf == NULL) {
+			if (_newrect) MEM_freeN(_newrect);
+			return(ibuf);
 		}
 	}
 
+	samples = scaledown_samples(ibuf->x, newx, &data.add);
+
+	data.ibuf = ibuf;
+	data.newsize = newx;
+	data.samples = samples;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
+
+	scale_apply_threaded_scanlines(ibuf->y, (size_t)ibuf->x * ibuf->y, scaledownx_thread_do, &data);
+
+	MEM_freeN(samples);
+
 	if (do_rect) {
-		// printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-		BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
 		imb_freerectImBuf(ibuf);
 		ibuf->mall |= IB_rect;
 		ibuf->rect = (unsigned int *) _newrect;
 	}
 	if (do_float) {
-		// printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-		BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
 		imb_freerectfloatImBuf(ibuf);
 		ibuf->mall |= IB_rectfloat;
 		ibuf->rect_float = _newrectf;
 	}
-	(void)rect_size; /* UNUSED in release builds */
 
 	ibuf->x = newx;
 	return(ibuf);
 }
 
+/* Scanlines of the scaled image, which read all the source rows a sample covers
+ * side by side. */
+static void scaledowny_rows(
+        const uchar *rect, const float *rectf, uchar *newrect, float *newrectf,
+        const ScaleThreadScanlineData *data, int start_scanline, int num_scanlines)
+{
+	const ScaleDownSample *samples = data->samples;
+	const size_t skipx = (size_t)4 * data->ibuf->x;
+	size_t i;
+	int y;
+
+	for (y = start_scanline; y < start_scanline + num_scanlines; y++) {
+		for (i = 0; i < skipx; i += 4) {
+			scale_pixel_store(
+			        scaledown_pixel(rect, rectf, i, skipx, &samples[y], data->add),
+			        newrect, newrectf, skipx * y + i);
+		}
+	}
+}
+
+static void scaledowny_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+	ScaleThreadScanlineData *data = data_v;
+
+	if (data->newrect) {
+		scaledowny_rows((uchar *)data->ibuf->rect, NULL, data->newrect, NULL, data, start_scanline, num_scanlines);
+	}
+	if (data->newrectf) {
+		scaledowny_rows(NULL, data->ibuf->rect_float, NULL, data->newrectf, data, start_scanline, num_scanlines);
+	}
+}
 
 static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
 {
 	const int do_rect = (ibuf->rect != NULL);
 	const int do_float = (ibuf->rect_float != NULL);
-	const size_t rect_size = ibuf->x * ibuf->y * 4;
+	ScaleThreadScanlineData data = {NULL};
+	ScaleDownSample *samples;
 
-	uchar *rect, *_newrect, *newrect;
-	float *rectf, *_newrectf, *newrectf;
-	float sample, add, val[4], nval[4], valf[4], nvalf[4];
-	int x, y, skipx;
-
-	rectf = _newrectf = newrectf = NULL;
-	rect = _newrect = newrect = NULL;
-	nval[0] =  nval[1] = nval[2] = nval[3] = 0.0f;
-	nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
 
 	if (!do_rect && !do_float) return (ibuf);
 
@@ -1027,127 +1291,85 @@ static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
 		}
 	}
 
-	add = (ibuf->y - 0.01) / newy;
-	skipx = 4 * ibuf->x;
+	samples = scaledown_samples(ibuf->y, newy, &data.add);
 
-	for (x = skipx - 4; x >= 0; x -= 4) {
-		if (do_rect) {
-			rect = ((uchar *) ibuf->rect) + x;
-			newrect = _newrect + x;
-		}
-		if (do_float) {
-			rectf = ibuf->rect_float + x;
-			newrectf = _newrectf + x;
-		}
+	data.ibuf = ibuf;
+	data.newsize = newy;
+	data.samples = samples;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
 
-		sample = 0.0f;
-		val[0] =  val[1] = val[2] = val[3] = 0.0f;
-		valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
+	scale_apply_threaded_scanlines(newy, (size_t)ibuf->x * ibuf->y, scaledowny_thread_do, &data);
 
-		for (y = newy; y > 0; y--) {
-			if (do_rect) {
-				nval[0] = -val[0] * sample;
-				nval[1] = -val[1] * sample;
-				nval[2] = -val[2] * sample;
-				nval[3] = -val[3] * sample;
-			}
-			if (do_float) {
-				nvalf[0] = -valf[0] * sample;
-				nvalf[1] = -valf[1] * sample;
-				nvalf[2] = -valf[2] * sample;
-				nvalf[3] = -valf[3] * sample;
-			}
-
-			sample += add;
-
-			while (sample >= 1.0f) {
-				sample -= 1.0f;
-
-				if (do_rect) {
-					nval[0] += rect[0];
-					nval[1] += rect[1];
-					nval[2] += rect[2];
-					nval[3] += rect[3];
-					rect += skipx;
-				}
-				if (do_float) {
-					nvalf[0] += rectf[0];
-					nvalf[1] += rectf[1];
-					nvalf[2] += rectf[2];
-					nvalf[3] += rectf[3];
-					rectf += skipx;
-				}
-			}
-
-			if (do_rect) {
-				val[0] = rect[0]; val[1] = rect[1]; val[2] = rect[2]; val[3] = rect[3];
-				rect += skipx;
-
-				newrect[0] = ((nval[0] + sample * val[0]) / add + 0.5f);
-				newrect[1] = ((nval[1] + sample * val[1]) / add + 0.5f);
-				newrect[2] = ((nval[2] + sample * val[2]) / add + 0.5f);
-				newrect[3] = ((nval[3] + sample * val[3]) / add + 0.5f);
-
-				newrect += skipx;
-			}
-			if (do_float) {
-
-				valf[0] = rectf[0]; valf[1] = rectf[1]; valf[2] = rectf[2]; valf[3] = rectf[3];
-				rectf += skipx;
-
-				newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-				newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-				newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-				newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
-
-				newrectf += skipx;
-			}
-
-			sample -= 1.0f;
-		}
-	}
+	MEM_freeN(samples);
 
 	if (do_rect) {
-		// printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-		BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
 		imb_freerectImBuf(ibuf);
 		ibuf->mall |= IB_rect;
 		ibuf->rect = (unsigned int *) _newrect;
 	}
 	if (do_float) {
-		// printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-		BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
 		imb_freerectfloatImBuf(ibuf);
 		ibuf->mall |= IB_rectfloat;
 		ibuf->rect_float = (float *) _newrectf;
 	}
-	(void)rect_size; /* UNUSED in release builds */
 
 	ibuf->y = newy;
 	return(ibuf);
 }
 
+BLI_INLINE ScalePixel scaleup_pixel(
+        const uchar *rect, const float *rectf, const size_t ofs, const size_t ofs_next, const float fac)
+{
+	ScalePixel val = scale_pixel_load(rect, rectf, ofs);
+	ScalePixel diff = scale_pixel_sub(scale_pixel_load(rect, rectf, ofs_next), val);
+
+	if (!rectf) {
+		val = scale_pixel_add_fl(val, 0.5f);
+	}
+	return scale_pixel_madd_fl(val, diff, fac);
+}
+
+static void scaleupx_rows(
+        const uchar *rect, const float *rectf, uchar *newrect, float *newrectf,
+        const ScaleThreadScanlineData *data, int start_scanline, int num_scanlines)
+{
+	const ScaleUpSample *samples = data->samples;
+	const int x = data->ibuf->x, newx = data->newsize;
+	int y, i;
+
+	for (y = start_scanline; y < start_scanline + num_scanlines; y++) {
+		const size_t ofs = (size_t)4 * x * y, newofs = (size_t)4 * newx * y;
+
+		for (i = 0; i < newx; i++) {
+			const ScaleUpSample *s = &samples[i];
+			scale_pixel_store(
+			        scaleup_pixel(rect, rectf, ofs + 4 * s->index, ofs + 4 * s->index_next, s->fac),
+			        newrect, newrectf, newofs + 4 * i);
+		}
+	}
+}
+
+static void scaleupx_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+	ScaleThreadScanlineData *data = data_v;
+
+	if (data->newrect) {
+		scaleupx_rows((uchar *)data->ibuf->rect, NULL, data->newrect, NULL, data, start_scanline, num_scanlines);
+	}
+	if (data->newrectf) {
+		scaleupx_rows(NULL, data->ibuf->rect_float, NULL, data->newrectf, data, start_scanline, num_scanlines);
+	}
+}
 
 static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
 {
-	uchar *rect, *_newrect = NULL, *newrect;
-	float *rectf, *_newrectf = NULL, *newrectf;
-	float sample, add;
-	float val_a, nval_a, diff_a;
-	float val_b, nval_b, diff_b;
-	float val_g, nval_g, diff_g;
-	float val_r, nval_r, diff_r;
-	float val_af, nval_af, diff_af;
-	float val_bf, nval_bf, diff_bf;
-	float val_gf, nval_gf, diff_gf;
-	float val_rf, nval_rf, diff_rf;
-	int x, y;
+	ScaleThreadScanlineData data = {NULL};
+	ScaleUpSample *samples;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
 	bool do_rect = false, do_float = false;
 
-	val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
-	val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
-	val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
-	val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
 	if (ibuf == NULL) return(NULL);
 	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
 
@@ -1165,121 +1387,17 @@ static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
 		}
 	}
 
-	add = (ibuf->x - 1.001) / (newx - 1.0);
-
-	rect = (uchar *) ibuf->rect;
-	rectf = (float *) ibuf->rect_float;
-	newrect = _newrect;
-	newrectf = _newrectf;
-
-	for (y = ibuf->y; y > 0; y--) {
+	samples = scaleup_samples(ibuf->x, newx);
 
-		sample = 0;
-
-		if (do_rect) {
-			val_a = rect[0];
-			nval_a = rect[4];
-			diff_a = nval_a - val_a;
-			val_a += 0.5f;
-
-			val_b = rect[1];
-			nval_b = rect[5];
-			diff_b = nval_b - val_b;
-			val_b += 0.5f;
-
-			val_g = rect[2];
-			nval_g = rect[6];
-			diff_g = nval_g - val_g;
-			val_g += 0.5f;
-
-			val_r = rect[3];
-			nval_r = rect[7];
-			diff_r = nval_r - val_r;
-			val_r += 0.5f;
-
-			rect += 8;
-		}
-		if (do_float) {
-			val_af = rectf[0];
-			nval_af = rectf[4];
-			diff_af = nval_af - val_af;
+	data.ibuf = ibuf;
+	data.newsize = newx;
+	data.samples = samples;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
 
-			val_bf = rectf[1];
-			nval_bf = rectf[5];
-			diff_bf = nval_bf - val_bf;
+	scale_apply_threaded_scanlines(ibuf->y, (size_t)newx * ibuf->y, scaleupx_thread_do, &data);
 
-			val_gf = rectf[2];
-			nval_gf = rectf[6];
-			diff_gf = nval_gf - val_gf;
-
-			val_rf = rectf[3];
-			nval_rf = rectf[7];
-			diff_rf = nval_rf - val_rf;
-
-			rectf += 8;
-		}
-		for (x = newx; x > 0; x--) {
-			if (sample >= 1.0f) {
-				sample -= 1.0f;
-
-				if (do_rect) {
-					val_a = nval_a;
-					nval_a = rect[0];
-					diff_a = nval_a - val_a;
-					val_a += 0.5f;
-
-					val_b = nval_b;
-					nval_b = rect[1];
-					diff_b = nval_b - val_b;
-					val_b += 0.5f;
-
-					val_g = nval_g;
-					nval_g = rect[2];
-					diff_g = nval_g - val_g;
-					val_g += 0.5f;
-
-					val_r = nval_r;
-					nval_r = rect[3];
-					diff_r = nval_r - val_r;
-					val_r += 0.5f;
-					rect += 4;
-				}
-				if (do_float) {
-					val_af = nval_af;
-					nval_af = rectf[0];
-					diff_af = nval_af - val_af;
-
-					val_bf = nval_bf;
-					nval_bf = rectf[1];
-					diff_bf = nval_bf - val_bf;
-
-					val_gf = nval_gf;
-					nval_gf = rectf[2];
-					diff_gf = nval_gf - val_gf;
-
-					val_rf = nval_rf;
-					nval_rf = rectf[3];
-					diff_rf = nval_rf - val_rf;
-					rectf += 4;
-				}
-			}
-			if (do_rect) {
-				newrect[0] = val_a + sample * diff_a;
-				newrect[1] = val_b + sample * diff_b;
-				newrect[2] = val_g + sample * diff_g;
-				newrect[3] = val_r + sample * diff_r;
-				newrect += 4;
-			}
-			if (do_float) {
-				newrectf[0] = val_af + sample * diff_af;
-				newrectf[1] = val_bf + sample * diff_bf;
-				newrectf[2] = val_gf + sample * diff_gf;
-				newrectf[3] = val_rf + sample * diff_rf;
-				newrectf += 4;
-			}
-			sample += add;
-		}
-	}
+	MEM_freeN(samples);
 
 	if (do_rect) {
 		imb_freerectImBuf(ibuf);
@@ -1296,26 +1414,47 @@ static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
 	return(ibuf);
 }
 
+static void scaleupy_rows(
+        const uchar *rect, const float *rectf, uchar *newrect, float *newrectf,
+        const ScaleThreadScanlineData *data, int start_scanline, int num_scanlines)
+{
+	const ScaleUpSample *samples = data->samples;
+	const size_t skipx = (size_t)4 * data->ibuf->x;
+	size_t i;
+	int y;
+
+	for (y = start_scanline; y < start_scanline + num_scanlines; y++) {
+		const ScaleUpSample *s = &samples[y];
+		const size_t ofs = skipx * s->index, ofs_next = skipx * s->index_next;
+
+		for (i = 0; i < skipx; i += 4) {
+			scale_pixel_store(
+			        scaleup_pixel(rect, rectf, ofs + i, ofs_next + i, s->fac),
+			        newrect, newrectf, skipx * y + i);
+		}
+	}
+}
+
+static void scaleupy_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+	ScaleThreadScanlineData *data = data_v;
+
+	if (data->newrect) {
+		scaleupy_rows((uchar *)data->ibuf->rect, NULL, data->newrect, NULL, data, start_scanline, num_scanlines);
+	}
+	if (data->newrectf) {
+		scaleupy_rows(NULL, data->ibuf->rect_float, NULL, data->newrectf, data, start_scanline, num_scanlines);
+	}
+}
+
 static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
 {
-	uchar *rect, *_newrect = NULL, *newrect;
-	float *rectf, *_newrectf = NULL, *newrectf;
-	float sample, add;
-	float val_a, nval_a, diff_a;
-	float val_b, nval_b, diff_b;
-	float val_g, nval_g, diff_g;
-	float val_r, nval_r, diff_r;
-	float val_af, nval_af, diff_af;
-	float val_bf, nval_bf, diff_bf;
-	float val_gf, nval_gf, diff_gf;
-	float val_rf, nval_rf, diff_rf;
-	int x, y, skipx;
+	ScaleThreadScanlineData data = {NULL};
+	ScaleUpSample *samples;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
 	bool do_rect = false, do_float = false;
 
-	val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
-	val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
-	val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
-	val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
 	if (ibuf == NULL) return(NULL);
 	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
 
@@ -1333,128 +1472,17 @@ static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
 		}
 	}
 
-	add = (ibuf->y - 1.001) / (newy - 1.0);
-	skipx = 4 * ibuf->x;
+	samples = scaleup_samples(ibuf->y, newy);
 
-	rect = (uchar *) ibuf->rect;
-	rectf = (float *) ibuf->rect_float;
-	newrect = _newrect;
-	newrectf = _newrectf;
+	data.ibuf = ibuf;
+	data.newsize = newy;
+	data.samples = samples;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
 
-	for (x = ibuf->x; x > 0; x--) {
+	scale_apply_threaded_scanlines(newy, (size_t)ibuf->x * newy, scaleupy_thread_do, &data);
 
-		sample = 0;
-		if (do_rect) {
-			rect = ((uchar *)ibuf->rect) + 4 * (x - 1);
-			newrect = _newrect + 4 * (x - 1);
-
-			val_a = rect[0];
-			nval_a = rect[skipx];
-			diff_a = nval_a - val_a;
-			val_a += 0.5f;
-
-			val_b = rect[1];
-			nval_b = rect[skipx + 1];
-			diff_b = nval_b - val_b;
-			val_b += 0.5f;
-
-			val_g = rect[2];
-			nval_g = rect[skipx + 2];
-			diff_g = nval_g - val_g;
-			val_g += 0.5f;
-
-			val_r = rect[3];
-			nval_r = rect[skipx + 3];
-			diff_r = nval_r - val_r;
-			val_r += 0.5f;
-
-			rect += 2 * skipx;
-		}
-		if (do_float) {
-			rectf = ibuf->rect_float + 4 * (x - 1);
-			newrectf = _newrectf + 4 * (x - 1);
-
-			val_af = rectf[0];
-			nval_af = rectf[skipx];
-			diff_af = nval_af - val_af;
-
-			val_bf = rectf[1];
-			nval_bf = rectf[skipx + 1];
-			diff_bf = nval_bf - val_bf;
-
-			val_gf = rectf[2];
-			nval_gf = rectf[skipx + 2];
-			diff_gf = nval_gf - val_gf;
-
-			val_rf = rectf[3];
-			nval_rf = rectf[skipx + 3];
-			diff_rf = nval_rf - val_rf;
-
-			rectf += 2 * skipx;
-		}
-
-		for (y = newy; y > 0; y--) {
-			if (sample >= 1.0f) {
-				sample -= 1.0f;
-
-				if (do_rect) {
-					val_a = nval_a;
-					nval_a = rect[0];
-					diff_a = nval_a - val_a;
-					val_a += 0.5f;
-
-					val_b = nval_b;
-					nval_b = rect[1];
-					diff_b = nval_b - val_b;
-					val_b += 0.5f;
-
-					val_g = nval_g;
-					nval_g = rect[2];
-					diff_g = nval_g - val_g;
-					val_g += 0.5f;
-
-					val_r = nval_r;
-					nval_r = rect[3];
-					diff_r = nval_r - val_r;
-					val_r += 0.5f;
-					rect += skipx;
-				}
-				if (do_float) {
-					val_af = nval_af;
-					nval_af = rectf[0];
-					diff_af = nval_af - val_af;
-
-					val_bf = nval_bf;
-					nval_bf = rectf[1];
-					diff_bf = nval_bf - val_bf;
-
-					val_gf = nval_gf;
-					nval_gf = rectf[2];
-					diff_gf = nval_gf - val_gf;
-
-					val_rf = nval_rf;
-					nval_rf = rectf[3];
-					diff_rf = nval_rf - val_rf;
-					rectf += skipx;
-				}
-			}
-			if (do_rect) {
-				newrect[0] = val_a + sample * diff_a;
-				newrect[1] = val_b + sample * diff_b;
-				newrect[2] = val_g + sample * diff_g;
-				newrect[3] = val_r + sample * diff_r;
-				newrect += skipx;
-			}
-			if (do_float) {
-				newrectf[0] = val_af + sample * diff_af;
-				newrectf[1] = val_bf + sample * diff_bf;
-				newrectf[2] = val_gf + sample * diff_gf;
-				newrectf[3] = val_rf + sample * diff_rf;
-				newrectf += skipx;
-			}
-			sample += add;
-		}
-	}
+	MEM_freeN(samples);
 
 	if (do_rect) {
 		imb_freerectImBuf(ibuf);
@@ -325,6 +325,10 @@ enum {
 	/* Datablock was not allocated by standard system (BKE_libblock_alloc), do not free its memory
 	 * (usual type-specific freeing is called though). */
 	LIB_TAG_NOT_ALLOCATED     = 1 << 14,
+
+	/* RESET_AFTER_USE Used internally in readfile.c,
+	 * tag datablock kept from old main when reading an undo step, as it did not change. */
+	LIB_TAG_UNDO_REUSED       = 1 << 15,
 };
 
 /* To filter ID types (filter_id) */
@@ -211,6 +211,10 @@ typedef struct Curve {
 
 	char pad2[2];
 
+	/* with CU_RESOLU_ADAPTIVE, the distance bezier segments may leave the curve */
+	float resolu_tolerance;
+	int pad3;
+
 } Curve;
 
 #define CURVE_VFONT_ANY(cu) \
@@ -251,6 +255,8 @@ enum {
 	CU_FILL_CAPS          = 1 << 14,
 	/** map taper object to beveled area */
 	CU_MAP_TAPER          = 1 << 15,
+	/** bezier segments use as much of the resolution as their curvature needs */
+	CU_RESOLU_ADAPTIVE    = 1 << 16,
 };
 
 /* Curve.twist_mode */
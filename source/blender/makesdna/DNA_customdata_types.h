@@ -183,6 +183,8 @@ enum {
 	CD_FLAG_EXTERNAL  = (1 << 3),
 	/* Indicates external data is read into memory */
 	CD_FLAG_IN_MEMORY = (1 << 4),
+	/* Indicates (BMesh only) layer data is stored as an array indexed by element, see CustomData_bmesh_soa_begin */
+	CD_FLAG_SOA       = (1 << 5),
 };
 
 /* Limits */
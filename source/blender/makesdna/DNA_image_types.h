@@ -29,6 +29,7 @@
 #include "DNA_color_types.h"  /* for color management */
 
 struct GPUTexture;
+struct ImBuf;
 struct MovieCache;
 struct PackedFile;
 struct RenderResult;
@@ -94,6 +95,7 @@ typedef struct Image {
 	char name[1024];			/* file path, 1024 = FILE_MAX */
 
 	struct MovieCache *cache;	/* not written in file */
+	struct ImBuf *tiled_ibuf;	/* not written in file, read per tile, see BKE_image_acquire_ibuf_tiled */
 	struct GPUTexture *gputexture[2]; /* not written in file 2 = TEXTARGET_COUNT */
 
 	/* sources from: */
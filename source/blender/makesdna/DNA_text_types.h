@@ -52,6 +52,8 @@ typedef struct Text {
 	int curc, selc;
 
 	double mtime;
+
+	void *line_index; /* runtime only, line lookup table owned by BKE_text */
 } Text;
 
 #define TXT_TABSIZE	4
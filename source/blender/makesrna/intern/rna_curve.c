@@ -1369,6 +1369,21 @@ static void rna_def_curve(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Render Resolution V",
 	                         "Surface resolution in V direction used while rendering (zero uses preview resolution)");
 
+	prop = RNA_def_property(srna, "use_resolution_adaptive", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", CU_RESOLU_ADAPTIVE);
+	RNA_def_property_ui_text(prop, "Adaptive Resolution",
+	                         "Use less of the resolution on flat Bezier segments, "
+	                         "so they stay within the tolerance of the curve");
+	RNA_def_property_update(prop, 0, "rna_Curve_update_data");
+
+	prop = RNA_def_property(srna, "resolution_tolerance", PROP_FLOAT, PROP_DISTANCE);
+	RNA_def_property_float_sdna(prop, NULL, "resolu_tolerance");
+	RNA_def_property_range(prop, 0.0f, FLT_MAX);
+	RNA_def_property_ui_range(prop, 0.0001f, 1.0f, 0.01, 4);
+	RNA_def_property_ui_text(prop, "Resolution Tolerance",
+	                         "Maximum distance of adaptive Bezier segments from the curve");
+	RNA_def_property_update(prop, 0, "rna_Curve_update_data");
+
 
 	prop = RNA_def_property(srna, "eval_time", PROP_FLOAT, PROP_NONE);
 	RNA_def_property_float_sdna(prop, NULL, "ctime");
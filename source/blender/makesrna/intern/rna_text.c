@@ -76,7 +76,7 @@ static bool rna_Text_modified_get(PointerRNA *ptr)
 static int rna_Text_current_line_index_get(PointerRNA *ptr)
 {
 	Text *text = (Text *)ptr->data;
-	return BLI_findindex(&text->lines, text->curl);
+	return txt_get_line_index(text, text->curl);
 }
 
 static void rna_Text_current_line_index_set(PointerRNA *ptr, int value)
@@ -26,6 +26,8 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math.h"
+#include "BLI_kdtree.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_curve_types.h"
@@ -81,37 +83,47 @@ static void foreachObjectLink(
 	walk(userData, ob, &amd->offset_ob, IDWALK_CB_NOP);
 }
 
-BLI_INLINE float sum_v3(const float v[3])
+typedef struct MapDoublesData {
+	const MVert *mverts;
+	const KDTree *tree;
+	const int *doubles_map;
+	int *nearest_map;
+	int source_start;
+	float dist, dist_sq;
+} MapDoublesData;
+
+typedef struct MapDoublesNearest {
+	int index;
+	float dist_sq;
+} MapDoublesNearest;
+
+static bool dm_mvert_map_doubles_nearest_range_cb(void *user_data, int index, const float UNUSED(co[3]), float dist_sq)
 {
-	return v[0] + v[1] + v[2];
-}
-
-/* Structure used for sorting vertices, when processing doubles */
-typedef struct SortVertsElem {
-	int vertex_num;     /* The original index of the vertex, prior to sorting */
-	float co[3];        /* Its coordinates */
-	float sum_co;       /* sum_v3(co), just so we don't do the sum many times.  */
-} SortVertsElem;
-
-
-static int svert_sum_cmp(const void *e1, const void *e2)
-{
-	const SortVertsElem *sv1 = e1;
-	const SortVertsElem *sv2 = e2;
-
-	if      (sv1->sum_co > sv2->sum_co) return  1;
-	else if (sv1->sum_co < sv2->sum_co) return -1;
-	else                                return  0;
+	MapDoublesNearest *nearest = user_data;
+	if (dist_sq <= nearest->dist_sq) {
+		nearest->index = index;
+		nearest->dist_sq = dist_sq;
+	}
+	return true;
 }
 
-static void svert_from_mvert(SortVertsElem *sv, const MVert *mv, const int i_begin, const int i_end)
+static void dm_mvert_map_doubles_nearest_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
 {
-	int i;
-	for (i = i_begin; i < i_end; i++, sv++, mv++) {
-		sv->vertex_num = i;
-		copy_v3_v3(sv->co, mv->co);
-		sv->sum_co = sum_v3(mv->co);
+	MapDoublesData *data = userdata;
+	MapDoublesNearest nearest = {-1, data->dist_sq};
+
+	/* If source has already been assigned to a target (in an earlier call, with other chunks) */
+	if (data->doubles_map[data->source_start + i] == -1) {
+		/* a range search (instead of a nearest search) skips distant vertices early. */
+		BLI_kdtree_range_search_cb(
+		        data->tree, data->mverts[data->source_start + i].co, data->dist,
+		        dm_mvert_map_doubles_nearest_range_cb, &nearest);
 	}
+
+	data->nearest_map[i] = nearest.index;
 }
 
 /**
@@ -119,6 +131,9 @@ static void svert_from_mvert(SortVertsElem *sv, const MVert *mv, const int i_beg
  * Each set of verts is defined by its start within mverts array and its num_verts;
  * It builds a mapping for all vertices within source, to vertices within target, or -1 if no double found
  * The int doubles_map[num_verts_source] array must have been allocated by caller.
+ *
+ * The closest target of each source vertex is searched in parallel (using a KD-tree of the target vertices),
+ * chains of doubles are then followed in order since they depend on the mapping of previous vertices.
  */
 static void dm_mvert_map_doubles(
         int *doubles_map,
@@ -129,112 +144,60 @@ static void dm_mvert_map_doubles(
         const int source_num_verts,
         const float dist)
 {
-	const float dist3 = ((float)M_SQRT3 + 0.00005f) * dist;   /* Just above sqrt(3) */
-	int i_source, i_target, i_target_low_bound, target_end, source_end;
-	SortVertsElem *sorted_verts_target, *sorted_verts_source;
-	SortVertsElem *sve_source, *sve_target, *sve_target_low_bound;
-	bool target_scan_completed;
-
-	target_end = target_start + target_num_verts;
-	source_end = source_start + source_num_verts;
-
-	/* build array of MVerts to be tested for merging */
-	sorted_verts_target = MEM_malloc_arrayN(target_num_verts, sizeof(SortVertsElem), __func__);
-	sorted_verts_source = MEM_malloc_arrayN(source_num_verts, sizeof(SortVertsElem), __func__);
-
-	/* Copy target vertices index and cos into SortVertsElem array */
-	svert_from_mvert(sorted_verts_target, mverts + target_start, target_start, target_end);
-
-	/* Copy source vertices index and cos into SortVertsElem array */
-	svert_from_mvert(sorted_verts_source, mverts + source_start, source_start, source_end);
-
-	/* sort arrays according to sum of vertex coordinates (sumco) */
-	qsort(sorted_verts_target, target_num_verts, sizeof(SortVertsElem), svert_sum_cmp);
-	qsort(sorted_verts_source, source_num_verts, sizeof(SortVertsElem), svert_sum_cmp);
-
-	sve_target_low_bound = sorted_verts_target;
-	i_target_low_bound = 0;
-	target_scan_completed = false;
-
-	/* Scan source vertices, in SortVertsElem sorted array, */
-	/* all the while maintaining the lower bound of possible doubles in target vertices */
-	for (i_source = 0, sve_source = sorted_verts_source;
-	     i_source < source_num_verts;
-	     i_source++, sve_source++)
-	{
-		int best_target_vertex = -1;
-		float best_dist_sq = dist * dist;
-		float sve_source_sumco;
-
-		/* If source has already been assigned to a target (in an earlier call, with other chunks) */
-		if (doubles_map[sve_source->vertex_num] != -1) {
-			continue;
-		}
-
-		/* If target fully scanned already, then all remaining source vertices cannot have a double */
-		if (target_scan_completed) {
-			doubles_map[sve_source->vertex_num] = -1;
-			continue;
-		}
+	MapDoublesData data;
+	ParallelRangeSettings settings;
+	KDTree *tree;
+	int *nearest_map;
+	int i;
 
-		sve_source_sumco = sum_v3(sve_source->co);
+	if ((target_num_verts == 0) || (source_num_verts == 0)) {
+		return;
+	}
 
-		/* Skip all target vertices that are more than dist3 lower in terms of sumco */
-		/* and advance the overall lower bound, applicable to all remaining vertices as well. */
-		while ((i_target_low_bound < target_num_verts) &&
-		       (sve_target_low_bound->sum_co < sve_source_sumco - dist3))
-		{
-			i_target_low_bound++;
-			sve_target_low_bound++;
-		}
-		/* If end of target list reached, then no more possible doubles */
-		if (i_target_low_bound >= target_num_verts) {
-			doubles_map[sve_source->vertex_num] = -1;
-			target_scan_completed = true;
-			continue;
-		}
-		/* Test target candidates starting at the low bound of possible doubles, ordered in terms of sumco */
-		i_target = i_target_low_bound;
-		sve_target = sve_target_low_bound;
-
-		/* i_target will scan vertices in the [v_source_sumco - dist3;  v_source_sumco + dist3] range */
-
-		while ((i_target < target_num_verts) &&
-		       (sve_target->sum_co <= sve_source_sumco + dist3))
-		{
-			/* Testing distance for candidate double in target */
-			/* v_target is within dist3 of v_source in terms of sumco;  check real distance */
-			float dist_sq;
-			if ((dist_sq = len_squared_v3v3(sve_source->co, sve_target->co)) <= best_dist_sq) {
-				/* Potential double found */
-				best_dist_sq = dist_sq;
-				best_target_vertex = sve_target->vertex_num;
-
-				/* If target is already mapped, we only follow that mapping if final target remains
-				 * close enough from current vert (otherwise no mapping at all).
-				 * Note that if we later find another target closer than this one, then we check it. But if other
-				 * potential targets are farther, then there will be no mapping at all for this source. */
-				while (best_target_vertex != -1 && !ELEM(doubles_map[best_target_vertex], -1, best_target_vertex)) {
-					if (compare_len_v3v3(mverts[sve_source->vertex_num].co,
-					                     mverts[doubles_map[best_target_vertex]].co,
-					                     dist))
-					{
-						best_target_vertex = doubles_map[best_target_vertex];
-					}
-					else {
-						best_target_vertex = -1;
-					}
-				}
+	tree = BLI_kdtree_new(target_num_verts);
+	for (i = 0; i < target_num_verts; i++) {
+		BLI_kdtree_insert(tree, target_start + i, mverts[target_start + i].co);
+	}
+	BLI_kdtree_balance(tree);
+
+	nearest_map = MEM_malloc_arrayN(source_num_verts, sizeof(int), __func__);
+
+	data.mverts = mverts;
+	data.tree = tree;
+	data.doubles_map = doubles_map;
+	data.nearest_map = nearest_map;
+	data.source_start = source_start;
+	data.dist = dist;
+	data.dist_sq = dist * dist;
+
+	BLI_parallel_range_settings_defaults(&settings);
+	settings.use_threading = (source_num_verts > 10000);
+	BLI_task_parallel_range(0, source_num_verts, &data, dm_mvert_map_doubles_nearest_cb, &settings);
+
+	for (i = 0; i < source_num_verts; i++) {
+		int best_target_vertex = nearest_map[i];
+
+		/* If target is already mapped, we only follow that mapping if final target remains
+		 * close enough from current vert (otherwise no mapping at all). */
+		while (best_target_vertex != -1 && !ELEM(doubles_map[best_target_vertex], -1, best_target_vertex)) {
+			if (compare_len_v3v3(mverts[source_start + i].co,
+			                     mverts[doubles_map[best_target_vertex]].co,
+			                     dist))
+			{
+				best_target_vertex = doubles_map[best_target_vertex];
+			}
+			else {
+				best_target_vertex = -1;
 			}
-			i_target++;
-			sve_target++;
 		}
-		/* End of candidate scan: if none found then no doubles */
-		doubles_map[sve_source->vertex_num] = best_target_vertex;
+
+		if (best_target_vertex != -1) {
+			doubles_map[source_start + i] = best_target_vertex;
+		}
 	}
 
-	MEM_freeN(sorted_verts_source);
-	MEM_freeN(sorted_verts_target);
+	MEM_freeN(nearest_map);
+	BLI_kdtree_free(tree);
 }
 
 
@@ -318,6 +281,102 @@ static void dm_merge_transform(
 	}
 }
 
+typedef struct ArrayCopyData {
+	DerivedMesh *result;
+	MVert *mvert;
+	MEdge *medge;
+	MLoop *mloop;
+	MPoly *mpoly;
+
+	/* cumulative offset of each copy */
+	float (*offsets)[4][4];
+	float uv_offset[2];
+
+	int chunk_nverts, chunk_nedges, chunk_nloops, chunk_npolys;
+	bool use_recalc_normals;
+} ArrayCopyData;
+
+/**
+ * Copy the first chunk into chunk \a c, the destination of each copy is known up-front
+ * so all copies can be written in parallel.
+ */
+static void array_copy_chunk_cb(
+        void *__restrict userdata,
+        const int c,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const ArrayCopyData *data = userdata;
+	DerivedMesh *result = data->result;
+	float (*current_offset)[4] = data->offsets[c];
+	const int chunk_nverts = data->chunk_nverts;
+	const int chunk_nedges = data->chunk_nedges;
+	const int chunk_nloops = data->chunk_nloops;
+	const int chunk_npolys = data->chunk_npolys;
+	MVert *mv;
+	MEdge *me;
+	MLoop *ml;
+	MPoly *mp;
+	int i;
+
+	/* copy customdata to new geometry */
+	DM_copy_vert_data(result, result, 0, c * chunk_nverts, chunk_nverts);
+	DM_copy_edge_data(result, result, 0, c * chunk_nedges, chunk_nedges);
+	DM_copy_loop_data(result, result, 0, c * chunk_nloops, chunk_nloops);
+	DM_copy_poly_data(result, result, 0, c * chunk_npolys, chunk_npolys);
+
+	/* apply offset to all new verts */
+	mv = data->mvert + c * chunk_nverts;
+	for (i = 0; i < chunk_nverts; i++, mv++) {
+		mul_m4_v3(current_offset, mv->co);
+
+		/* We have to correct normals too, if we do not tag them as dirty! */
+		if (!data->use_recalc_normals) {
+			float no[3];
+			normal_short_to_float_v3(no, mv->no);
+			mul_mat3_m4_v3(current_offset, no);
+			normalize_v3(no);
+			normal_float_to_short_v3(mv->no, no);
+		}
+	}
+
+	/* adjust edge vertex indices */
+	me = data->medge + c * chunk_nedges;
+	for (i = 0; i < chunk_nedges; i++, me++) {
+		me->v1 += c * chunk_nverts;
+		me->v2 += c * chunk_nverts;
+	}
+
+	mp = data->mpoly + c * chunk_npolys;
+	for (i = 0; i < chunk_npolys; i++, mp++) {
+		mp->loopstart += c * chunk_nloops;
+	}
+
+	/* adjust loop vertex and edge indices */
+	ml = data->mloop + c * chunk_nloops;
+	for (i = 0; i < chunk_nloops; i++, ml++) {
+		ml->v += c * chunk_nverts;
+		ml->e += c * chunk_nedges;
+	}
+
+	/* handle UVs */
+	if (chunk_nloops > 0 && (data->uv_offset[0] != 0.0f || data->uv_offset[1] != 0.0f)) {
+		const int totuv = CustomData_number_of_layers(&result->loopData, CD_MLOOPUV);
+		const float uv_offset[2] = {
+			data->uv_offset[0] * (float)c,
+			data->uv_offset[1] * (float)c,
+		};
+		int j;
+		for (j = 0; j < totuv; j++) {
+			MLoopUV *dmloopuv = CustomData_get_layer_n(&result->loopData, CD_MLOOPUV, j);
+			dmloopuv += c * chunk_nloops;
+			for (i = 0; i < chunk_nloops; i++, dmloopuv++) {
+				dmloopuv->uv[0] += uv_offset[0];
+				dmloopuv->uv[1] += uv_offset[1];
+			}
+		}
+	}
+}
+
 static DerivedMesh *arrayModifier_doArray(
         ArrayModifierData *amd,
         Scene *scene, Object *ob, DerivedMesh *dm,
@@ -325,11 +384,8 @@ static DerivedMesh *arrayModifier_doArray(
 {
 	const float eps = 1e-6f;
 	const MVert *src_mvert;
-	MVert *mv, *mv_prev, *result_dm_verts;
+	MVert *result_dm_verts;
 
-	MEdge *me;
-	MLoop *ml;
-	MPoly *mp;
 	int i, j, c, count;
 	float length = amd->length;
 	/* offset matrix */
@@ -338,6 +394,7 @@ static DerivedMesh *arrayModifier_doArray(
 	bool offset_has_scale;
 	float current_offset[4][4];
 	float final_offset[4][4];
+	float (*offsets)[4][4];
 	int *full_doubles_map = NULL;
 	int tot_doubles;
 
@@ -504,55 +561,42 @@ static DerivedMesh *arrayModifier_doArray(
 	first_chunk_start = 0;
 	first_chunk_nverts = chunk_nverts;
 
-	unit_m4(current_offset);
+	/* calculate the cumulative offset of each copy */
+	offsets = MEM_malloc_arrayN(count, sizeof(*offsets), __func__);
+	unit_m4(offsets[0]);
 	for (c = 1; c < count; c++) {
-		/* copy customdata to new geometry */
-		DM_copy_vert_data(result, result, 0, c * chunk_nverts, chunk_nverts);
-		DM_copy_edge_data(result, result, 0, c * chunk_nedges, chunk_nedges);
-		DM_copy_loop_data(result, result, 0, c * chunk_nloops, chunk_nloops);
-		DM_copy_poly_data(result, result, 0, c * chunk_npolys, chunk_npolys);
-
-		mv_prev = result_dm_verts;
-		mv = mv_prev + c * chunk_nverts;
-
-		/* recalculate cumulative offset here */
-		mul_m4_m4m4(current_offset, current_offset, offset);
-
-		/* apply offset to all new verts */
-		for (i = 0; i < chunk_nverts; i++, mv++, mv_prev++) {
-			mul_m4_v3(current_offset, mv->co);
-
-			/* We have to correct normals too, if we do not tag them as dirty! */
-			if (!use_recalc_normals) {
-				float no[3];
-				normal_short_to_float_v3(no, mv->no);
-				mul_mat3_m4_v3(current_offset, no);
-				normalize_v3(no);
-				normal_float_to_short_v3(mv->no, no);
-			}
-		}
-
-		/* adjust edge vertex indices */
-		me = CDDM_get_edges(result) + c * chunk_nedges;
-		for (i = 0; i < chunk_nedges; i++, me++) {
-			me->v1 += c * chunk_nverts;
-			me->v2 += c * chunk_nverts;
-		}
-
-		mp = CDDM_get_polys(result) + c * chunk_npolys;
-		for (i = 0; i < chunk_npolys; i++, mp++) {
-			mp->loopstart += c * chunk_nloops;
-		}
+		mul_m4_m4m4(offsets[c], offsets[c - 1], offset);
+	}
+	copy_m4_m4(current_offset, offsets[count - 1]);
+
+	if (count > 1) {
+		ArrayCopyData data = {
+			.result = result,
+			.mvert = result_dm_verts,
+			.medge = CDDM_get_edges(result),
+			.mloop = CDDM_get_loops(result),
+			.mpoly = CDDM_get_polys(result),
+			.offsets = offsets,
+			.chunk_nverts = chunk_nverts,
+			.chunk_nedges = chunk_nedges,
+			.chunk_nloops = chunk_nloops,
+			.chunk_npolys = chunk_npolys,
+			.use_recalc_normals = use_recalc_normals,
+		};
+		ParallelRangeSettings settings;
+
+		copy_v2_v2(data.uv_offset, amd->uv_offset);
+
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (result_nverts > 10000);
+		BLI_task_parallel_range(1, count, &data, array_copy_chunk_cb, &settings);
+	}
 
-		/* adjust loop vertex and edge indices */
-		ml = CDDM_get_loops(result) + c * chunk_nloops;
-		for (i = 0; i < chunk_nloops; i++, ml++) {
-			ml->v += c * chunk_nverts;
-			ml->e += c * chunk_nedges;
-		}
+	MEM_freeN(offsets);
 
-		/* Handle merge between chunk n and n-1 */
-		if (use_merge && (c >= 1)) {
+	/* Handle merge between chunk n and n-1 */
+	if (use_merge) {
+		for (c = 1; c < count; c++) {
 			if (!offset_has_scale && (c >= 2)) {
 				/* Mapping chunk 3 to chunk 2 is a translation of mapping 2 to 1
 				 * ... that is except if scaling makes the distance grow */
@@ -593,26 +637,6 @@ static DerivedMesh *arrayModifier_doArray(
 		}
 	}
 
-	/* handle UVs */
-	if (chunk_nloops > 0 && is_zero_v2(amd->uv_offset) == false) {
-		const int totuv = CustomData_number_of_layers(&result->loopData, CD_MLOOPUV);
-		for (i = 0; i < totuv; i++) {
-			MLoopUV *dmloopuv = CustomData_get_layer_n(&result->loopData, CD_MLOOPUV, i);
-			dmloopuv += chunk_nloops;
-			for (c = 1; c < count; c++) {
-				const float uv_offset[2] = {
-					amd->uv_offset[0] * (float)c,
-					amd->uv_offset[1] * (float)c,
-				};
-				int l_index = chunk_nloops;
-				for (; l_index-- != 0; dmloopuv++) {
-					dmloopuv->uv[0] += uv_offset[0];
-					dmloopuv->uv[1] += uv_offset[1];
-				}
-			}
-		}
-	}
-
 	last_chunk_start = (count - 1) * chunk_nverts;
 	last_chunk_nverts = chunk_nverts;
 
@@ -745,7 +769,8 @@ ModifierTypeInfo modifierType_Array = {
 	                        eModifierTypeFlag_SupportsMapping |
 	                        eModifierTypeFlag_SupportsEditmode |
 	                        eModifierTypeFlag_EnableInEditmode |
-	                        eModifierTypeFlag_AcceptsCVs,
+	                        eModifierTypeFlag_AcceptsCVs |
+	                        eModifierTypeFlag_CacheResult,
 
 	/* copyData */          modifier_copyData_generic,
 	/* deformVerts */       NULL,
@@ -319,7 +319,8 @@ ModifierTypeInfo modifierType_Boolean = {
 	/* structSize */        sizeof(BooleanModifierData),
 	/* type */              eModifierTypeType_Nonconstructive,
 	/* flags */             eModifierTypeFlag_AcceptsMesh |
-	                        eModifierTypeFlag_UsesPointCache,
+	                        eModifierTypeFlag_UsesPointCache |
+	                        eModifierTypeFlag_CacheResult,
 
 	/* copyData */          modifier_copyData_generic,
 	/* deformVerts */       NULL,
@@ -22,8 +22,10 @@
  */
 
 
+#include "DNA_image_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
+#include "DNA_texture_types.h"
 
 #include "BLI_utildefines.h"
 #include "BLI_math.h"
@@ -41,6 +43,9 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
 #include "MOD_util.h"
 
 /* Displace */
@@ -138,12 +143,74 @@ typedef struct DisplaceUserdata {
 	float local_mat[4][4];
 	MVert *mvert;
 	float (*vert_clnors)[3];
+	/* image texture and the mipmap level it's sampled at */
+	struct ImBuf *ibuf;
+	struct ImBuf *ibuf_level;
 } DisplaceUserdata;
 
+typedef struct DisplaceUserdataChunk {
+	struct ImTileSampler *sampler;
+} DisplaceUserdataChunk;
+
+/* Image textures are read per tile as they're sampled, large images (height maps)
+ * don't have to be loaded entirely. Mapping is flat, like image textures with
+ * their default settings. */
+static void displace_image_sample(
+        const DisplaceUserdata *data, DisplaceUserdataChunk *chunk, const float co[3], float r_col[4])
+{
+	const Tex *tex = data->dmd->texture;
+	ImBuf *ibuf = data->ibuf_level;
+	float fx = (co[0] + 1.0f) * 0.5f;
+	float fy = (co[1] + 1.0f) * 0.5f;
+
+	if (tex->extend == TEX_REPEAT) {
+		fx -= floorf(fx);
+		fy -= floorf(fy);
+	}
+	else if (tex->extend == TEX_CLIP) {
+		if (fx < 0.0f || fx > 1.0f || fy < 0.0f || fy > 1.0f) {
+			zero_v4(r_col);
+			return;
+		}
+	}
+
+	if (chunk->sampler == NULL) {
+		chunk->sampler = IMB_tile_sampler_new();
+	}
+
+	IMB_tile_sampler_bilinear(chunk->sampler, ibuf, fx * ibuf->x - 0.5f, fy * ibuf->y - 0.5f, r_col);
+}
+
+/* Mipmap level with about one pixel between vertices, from the area of the image they cover. */
+static ImBuf *displace_image_level(ImBuf *ibuf, const float (*tex_co)[3], const int numVerts)
+{
+	float min[2] = {FLT_MAX, FLT_MAX}, max[2] = {-FLT_MAX, -FLT_MAX};
+	float pixels_per_vert;
+	int i;
+
+	if (ibuf->miptot <= 1) {
+		return ibuf;
+	}
+
+	for (i = 0; i < numVerts; i++) {
+		minmax_v2v2_v2(min, max, tex_co[i]);
+	}
+
+	/* texture coordinates are -1..1 over the image */
+	pixels_per_vert = sqrtf(min_ff(max[0] - min[0], 2.0f) * 0.5f * ibuf->x *
+	                        min_ff(max[1] - min[1], 2.0f) * 0.5f * ibuf->y / (float)numVerts);
+
+	if (pixels_per_vert < 2.0f) {
+		return ibuf;
+	}
+
+	return IMB_getmipmap(ibuf, (int)log2f(pixels_per_vert));
+}
+
 static void displaceModifier_do_task(
         void *__restrict userdata,
         const int iter,
-        const ParallelRangeTLS *__restrict UNUSED(tls))
+        const ParallelRangeTLS *__restrict tls)
 {
 	DisplaceUserdata *data = (DisplaceUserdata *)userdata;
 	DisplaceModifierData *dmd = data->dmd;
@@ -160,6 +227,8 @@ static void displaceModifier_do_task(
 
 	float strength = dmd->strength;
 	float delta;
+	float col[4];
+	float local_vec[3];
 
 	if (dvert) {
 		weight = defvert_find_weight(dvert + iter, defgrp_index);
@@ -168,7 +237,13 @@ static void displaceModifier_do_task(
 		}
 	}
 
-	delta = delta_fixed;  /* (1.0f - dmd->midlevel) */  /* never changes */
+	if (data->ibuf) {
+		displace_image_sample(data, tls->userdata_chunk, data->tex_co[iter], col);
+		delta = (col[0] + col[1] + col[2]) * (1.0f / 3.0f) - dmd->midlevel;
+	}
+	else {
+		delta = delta_fixed;  /* (1.0f - dmd->midlevel) */  /* never changes */
+	}
 
 	if (dvert) {
 		strength *= weight;
@@ -216,6 +291,28 @@ static void displaceModifier_do_task(
 		case MOD_DISP_DIR_CLNOR:
 			madd_v3_v3fl(vertexCos[iter], vert_clnors[iter], delta);
 			break;
+		case MOD_DISP_DIR_RGB_XYZ:
+			if (data->ibuf == NULL) {
+				break;
+			}
+			local_vec[0] = col[0] - dmd->midlevel;
+			local_vec[1] = col[1] - dmd->midlevel;
+			local_vec[2] = col[2] - dmd->midlevel;
+			if (use_global_direction) {
+				mul_transposed_mat3_m4_v3(data->local_mat, local_vec);
+			}
+			mul_v3_fl(local_vec, strength);
+			add_v3_v3(vertexCos[iter], local_vec);
+			break;
+	}
+}
+
+static void displaceModifier_do_finalize(void *__restrict UNUSED(userdata), void *__restrict userdata_chunk)
+{
+	DisplaceUserdataChunk *chunk = userdata_chunk;
+
+	if (chunk->sampler) {
+		IMB_tile_sampler_free(chunk->sampler);
 	}
 }
 
@@ -291,15 +388,31 @@ static void displaceModifier_do(
 	if (dmd->texture != NULL) {
 		data.pool = BKE_image_pool_new();
 		BKE_texture_fetch_images_for_pool(dmd->texture, data.pool);
+
+		if (dmd->texture->type == TEX_IMAGE && dmd->texture->ima) {
+			data.ibuf = BKE_image_acquire_ibuf_tiled(dmd->texture->ima);
+			if (data.ibuf) {
+				data.ibuf_level = displace_image_level(data.ibuf, (const float (*)[3])tex_co, numVerts);
+			}
+		}
 	}
+
+	DisplaceUserdataChunk chunk = {NULL};
 	ParallelRangeSettings settings;
 	BLI_parallel_range_settings_defaults(&settings);
 	settings.use_threading = (numVerts > 512);
+	settings.userdata_chunk = &chunk;
+	settings.userdata_chunk_size = sizeof(chunk);
+	settings.func_finalize = displaceModifier_do_finalize;
 	BLI_task_parallel_range(0, numVerts,
 	                        &data,
 	                        displaceModifier_do_task,
 	                        &settings);
 
+	if (data.ibuf != NULL) {
+		BKE_image_release_ibuf(dmd->texture->ima, data.ibuf, NULL);
+	}
+
 	if (data.pool != NULL) {
 		BKE_image_pool_free(data.pool);
 	}
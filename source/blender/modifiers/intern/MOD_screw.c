@@ -30,6 +30,7 @@
 
 #include "BLI_math.h"
 #include "BLI_alloca.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_cdderivedmesh.h"
@@ -98,57 +99,381 @@ static void screwvert_iter_step(ScrewVertIter *iter)
 	}
 }
 
+typedef struct ScrewMergeData {
+	MVert *mvert_new;
+	const float *axis_vec;
+	const float *axis_offset;
+	float merge_threshold_sq;
+} ScrewMergeData;
+
+static void dm_remove_doubles_on_axis_tag_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const ScrewMergeData *data = userdata;
+	MVert *mv = &data->mvert_new[i];
+	float axis_co[3];
+
+	if (data->axis_offset) {
+		float offset_co[3];
+		sub_v3_v3v3(offset_co, mv->co, data->axis_offset);
+		project_v3_v3v3_normalized(axis_co, offset_co, data->axis_vec);
+		add_v3_v3(axis_co, data->axis_offset);
+	}
+	else {
+		project_v3_v3v3_normalized(axis_co, mv->co, data->axis_vec);
+	}
+	const float dist_sq = len_squared_v3v3(axis_co, mv->co);
+	if (dist_sq <= data->merge_threshold_sq) {
+		mv->flag |= ME_VERT_TMP_TAG;
+		copy_v3_v3(mv->co, axis_co);
+	}
+}
+
+typedef struct ScrewDoublesMapData {
+	int *full_doubles_map;
+	const uint *doubles;
+	uint tot_doubles;
+	uint totvert;
+} ScrewDoublesMapData;
+
+static void dm_remove_doubles_on_axis_map_cb(
+        void *__restrict userdata,
+        const int step,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const ScrewDoublesMapData *data = userdata;
+	int *doubles_map = &data->full_doubles_map[data->totvert * (uint)step];
+
+	for (uint i = 0; i < data->tot_doubles; i += 1) {
+		const uint v = data->doubles[i];
+		doubles_map[v] = (int)v;
+	}
+}
+
 static DerivedMesh *dm_remove_doubles_on_axis(
         DerivedMesh *result, MVert *mvert_new, const uint totvert, const uint step_tot,
         const float axis_vec[3], const float axis_offset[3], const float merge_threshold)
 {
-	const float merge_threshold_sq = SQUARE(merge_threshold);
-	const bool use_offset = axis_offset != NULL;
+	ScrewMergeData data = {
+	    .mvert_new = mvert_new,
+	    .axis_vec = axis_vec,
+	    .axis_offset = axis_offset,
+	    .merge_threshold_sq = SQUARE(merge_threshold),
+	};
 	uint tot_doubles = 0;
+
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (totvert > 10000);
+		BLI_task_parallel_range(0, (int)totvert, &data, dm_remove_doubles_on_axis_tag_cb, &settings);
+	}
+
 	for (uint i = 0; i < totvert; i += 1) {
-		float axis_co[3];
-		if (use_offset) {
-			float offset_co[3];
-			sub_v3_v3v3(offset_co, mvert_new[i].co, axis_offset);
-			project_v3_v3v3_normalized(axis_co, offset_co, axis_vec);
-			add_v3_v3(axis_co, axis_offset);
-		}
-		else {
-			project_v3_v3v3_normalized(axis_co, mvert_new[i].co, axis_vec);
-		}
-		const float dist_sq = len_squared_v3v3(axis_co, mvert_new[i].co);
-		if (dist_sq <= merge_threshold_sq) {
-			mvert_new[i].flag |= ME_VERT_TMP_TAG;
+		if (mvert_new[i].flag & ME_VERT_TMP_TAG) {
 			tot_doubles += 1;
-			copy_v3_v3(mvert_new[i].co, axis_co);
 		}
 	}
 
 	if (tot_doubles != 0) {
 		uint tot = totvert * step_tot;
 		int *full_doubles_map = MEM_malloc_arrayN(tot, sizeof(int), __func__);
+		uint *doubles = MEM_malloc_arrayN(tot_doubles, sizeof(*doubles), __func__);
 		copy_vn_i(full_doubles_map, (int)tot, -1);
 
-		uint tot_doubles_left = tot_doubles;
-		for (uint i = 0; i < totvert; i += 1) {
+		for (uint i = 0, i_double = 0; i_double < tot_doubles; i += 1) {
 			if (mvert_new[i].flag & ME_VERT_TMP_TAG) {
-				int *doubles_map = &full_doubles_map[totvert + i] ;
-				for (uint step = 1; step < step_tot; step += 1) {
-					*doubles_map = (int)i;
-					doubles_map += totvert;
-				}
-				tot_doubles_left -= 1;
-				if (tot_doubles_left == 0) {
-					break;
-				}
+				doubles[i_double++] = i;
 			}
 		}
+
+		ScrewDoublesMapData map_data = {
+		    .full_doubles_map = full_doubles_map,
+		    .doubles = doubles,
+		    .tot_doubles = tot_doubles,
+		    .totvert = totvert,
+		};
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = ((size_t)tot_doubles * step_tot > 10000);
+		BLI_task_parallel_range(1, (int)step_tot, &map_data, dm_remove_doubles_on_axis_map_cb, &settings);
+
+		MEM_freeN(doubles);
 		result = CDDM_merge_verts(result, full_doubles_map, (int)(tot_doubles * (step_tot - 1)), CDDM_MERGE_VERTS_DUMP_IF_MAPPED);
 		MEM_freeN(full_doubles_map);
 	}
 	return result;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Threaded Step Generation
+ *
+ * Once the profile edges are ordered, the output offsets of every step
+ * (vertex slices) and every profile edge (quad cylinders) are known up-front,
+ * so they can be written in parallel.
+ * \{ */
+
+typedef struct ScrewThreadData {
+	DerivedMesh *dm, *result;
+	MVert *mvert_new;
+	MEdge *medge_new;
+	MPoly *mpoly_new;
+	MLoop *mloop_new;
+	int *origindex;
+
+	unsigned int totvert, totedge, step_tot, step_last;
+	unsigned int edge_offset;
+	bool close;
+
+	/* vertex slices */
+	const ScrewVertConnect *vert_connect;
+	bool use_ob_axis;
+	char axis_char;
+	float angle, screw_ofs;
+	const float *axis_vec;
+	float (*mtx_tx)[4];
+
+	/* polygons */
+	const unsigned int *edge_poly_map;
+	const unsigned int *vert_loop_map;
+	const int *quad_ord, *quad_ord_ofs;
+	char mpoly_flag;
+
+	MLoopUV **mloopuv_layers;
+	unsigned int mloopuv_layers_tot;
+	float uv_u_scale;
+	const float *uv_axis_plane;
+	const float *uv_v_minmax;
+	float uv_v_range_inv;
+	bool use_uv_stretch_v;
+} ScrewThreadData;
+
+static void screw_step_verts_cb(
+        void *__restrict userdata,
+        const int iter,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const ScrewThreadData *data = userdata;
+	const unsigned int step = (unsigned int)iter;
+	const unsigned int totvert = data->totvert;
+	const unsigned int varray_stride = totvert * step;
+	const MVert *mv_new_base = data->mvert_new;
+	MVert *mv_new = &data->mvert_new[varray_stride];
+	MEdge *med_new = &data->medge_new[data->totedge + (totvert * (step - 1))];
+	float step_angle;
+	float nor_tx[3];
+	float mat3[3][3];
+	float mat[4][4];
+	unsigned int j;
+
+	/* Rotation Matrix */
+	step_angle = (data->angle / (float)(data->step_tot - (!data->close))) * (float)step;
+
+	if (data->use_ob_axis) {
+		axis_angle_normalized_to_mat3(mat3, data->axis_vec, step_angle);
+	}
+	else {
+		axis_angle_to_mat3_single(mat3, data->axis_char, step_angle);
+	}
+	copy_m4_m3(mat, mat3);
+
+	if (data->screw_ofs)
+		madd_v3_v3fl(mat[3], data->axis_vec, data->screw_ofs * ((float)step / (float)(data->step_tot - 1)));
+
+	/* copy a slice */
+	DM_copy_vert_data(data->dm, data->result, 0, (int)varray_stride, (int)totvert);
+
+	for (j = 0; j < totvert; j++, mv_new_base++, mv_new++) {
+		/* set normal */
+		if (data->vert_connect) {
+			mul_v3_m3v3(nor_tx, mat3, data->vert_connect[j].no);
+
+			/* set the normal now its transformed */
+			normal_float_to_short_v3(mv_new->no, nor_tx);
+		}
+
+		/* set location */
+		copy_v3_v3(mv_new->co, mv_new_base->co);
+
+		/* only need to set these if using non cleared memory */
+		/*mv_new->mat_nr = mv_new->flag = 0;*/
+
+		if (data->use_ob_axis) {
+			sub_v3_v3(mv_new->co, data->mtx_tx[3]);
+
+			mul_m4_v3(mat, mv_new->co);
+
+			add_v3_v3(mv_new->co, data->mtx_tx[3]);
+		}
+		else {
+			mul_m4_v3(mat, mv_new->co);
+		}
+
+		/* add the new edge */
+		med_new->v1 = varray_stride + j;
+		med_new->v2 = med_new->v1 - totvert;
+		med_new->flag = ME_EDGEDRAW | ME_EDGERENDER;
+		med_new++;
+	}
+}
+
+/**
+ * For one profile edge, make a cylinder of quads,
+ * the polys, loops and vertical edges of each profile edge are contiguous.
+ */
+static void screw_edge_polys_cb(
+        void *__restrict userdata,
+        const int iter,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const ScrewThreadData *data = userdata;
+	const unsigned int i = (unsigned int)iter;
+	const unsigned int totvert = data->totvert;
+	const unsigned int totedge = data->totedge;
+	const unsigned int step_tot = data->step_tot;
+	const unsigned int step_last = data->step_last;
+	const unsigned int edge_offset = data->edge_offset;
+	const int *quad_ord = data->quad_ord;
+	const int *quad_ord_ofs = data->quad_ord_ofs;
+
+	const MEdge *med_new_firstloop = &data->medge_new[i];
+	const unsigned int mpoly_index_orig = data->edge_poly_map ? data->edge_poly_map[i] : UINT_MAX;
+	const bool has_mpoly_orig = (mpoly_index_orig != UINT_MAX);
+	float uv_v_offset_a = 0.0f, uv_v_offset_b = 0.0f;
+
+	const unsigned int mloop_index_orig[2] = {
+	    data->vert_loop_map ? data->vert_loop_map[med_new_firstloop->v1] : UINT_MAX,
+	    data->vert_loop_map ? data->vert_loop_map[med_new_firstloop->v2] : UINT_MAX,
+	};
+	const bool has_mloop_orig = mloop_index_orig[0] != UINT_MAX;
+
+	/* precomputed offsets, each edge makes (step_last + 1) quads and (step_tot - 1) vertical edges */
+	unsigned int mpoly_index = i * (step_last + 1);
+	MPoly *mp_new = &data->mpoly_new[mpoly_index];
+	MLoop *ml_new = &data->mloop_new[mpoly_index * 4];
+	MEdge *med_new = &data->medge_new[edge_offset + (i * (step_tot - 1))];
+	unsigned int i1 = med_new_firstloop->v1;
+	unsigned int i2 = med_new_firstloop->v2;
+	unsigned int step;
+
+	if (has_mloop_orig == false && data->mloopuv_layers_tot) {
+		uv_v_offset_a = dist_signed_to_plane_v3(data->mvert_new[med_new_firstloop->v1].co, data->uv_axis_plane);
+		uv_v_offset_b = dist_signed_to_plane_v3(data->mvert_new[med_new_firstloop->v2].co, data->uv_axis_plane);
+
+		if (data->use_uv_stretch_v) {
+			uv_v_offset_a = (uv_v_offset_a - data->uv_v_minmax[0]) * data->uv_v_range_inv;
+			uv_v_offset_b = (uv_v_offset_b - data->uv_v_minmax[0]) * data->uv_v_range_inv;
+		}
+	}
+
+	for (step = 0; step <= step_last; step++) {
+		const int l_index = (int)(mpoly_index * 4);
+
+		/* Polygon */
+		if (has_mpoly_orig) {
+			DM_copy_poly_data(data->dm, data->result, (int)mpoly_index_orig, (int)mpoly_index, 1);
+			data->origindex[mpoly_index] = (int)mpoly_index_orig;
+		}
+		else {
+			data->origindex[mpoly_index] = ORIGINDEX_NONE;
+			mp_new->flag = data->mpoly_flag;
+			mp_new->mat_nr = 0;
+		}
+		mp_new->loopstart = l_index;
+		mp_new->totloop = 4;
+
+
+		/* Loop-Custom-Data */
+		if (has_mloop_orig) {
+			DM_copy_loop_data(data->dm, data->result, (int)mloop_index_orig[0], l_index + 0, 1);
+			DM_copy_loop_data(data->dm, data->result, (int)mloop_index_orig[1], l_index + 1, 1);
+			DM_copy_loop_data(data->dm, data->result, (int)mloop_index_orig[1], l_index + 2, 1);
+			DM_copy_loop_data(data->dm, data->result, (int)mloop_index_orig[0], l_index + 3, 1);
+
+			if (data->mloopuv_layers_tot) {
+				unsigned int uv_lay;
+				const float uv_u_offset_a = (float)(step)     * data->uv_u_scale;
+				const float uv_u_offset_b = (float)(step + 1) * data->uv_u_scale;
+				for (uv_lay = 0; uv_lay < data->mloopuv_layers_tot; uv_lay++) {
+					MLoopUV *mluv = &data->mloopuv_layers[uv_lay][l_index];
+
+					mluv[quad_ord[0]].uv[0] += uv_u_offset_a;
+					mluv[quad_ord[1]].uv[0] += uv_u_offset_a;
+					mluv[quad_ord[2]].uv[0] += uv_u_offset_b;
+					mluv[quad_ord[3]].uv[0] += uv_u_offset_b;
+				}
+			}
+		}
+		else {
+			if (data->mloopuv_layers_tot) {
+				unsigned int uv_lay;
+				const float uv_u_offset_a = (float)(step)     * data->uv_u_scale;
+				const float uv_u_offset_b = (float)(step + 1) * data->uv_u_scale;
+				for (uv_lay = 0; uv_lay < data->mloopuv_layers_tot; uv_lay++) {
+					MLoopUV *mluv = &data->mloopuv_layers[uv_lay][l_index];
+
+					copy_v2_fl2(mluv[quad_ord[0]].uv, uv_u_offset_a, uv_v_offset_a);
+					copy_v2_fl2(mluv[quad_ord[1]].uv, uv_u_offset_a, uv_v_offset_b);
+					copy_v2_fl2(mluv[quad_ord[2]].uv, uv_u_offset_b, uv_v_offset_b);
+					copy_v2_fl2(mluv[quad_ord[3]].uv, uv_u_offset_b, uv_v_offset_a);
+				}
+			}
+		}
+
+		/* Loop-Data */
+		if (!(data->close && step == step_last)) {
+			/* regular segments */
+			ml_new[quad_ord[0]].v = i1;
+			ml_new[quad_ord[1]].v = i2;
+			ml_new[quad_ord[2]].v = i2 + totvert;
+			ml_new[quad_ord[3]].v = i1 + totvert;
+
+			ml_new[quad_ord_ofs[0]].e = step == 0 ? i : (edge_offset + step + (i * (step_tot - 1))) - 1;
+			ml_new[quad_ord_ofs[1]].e = totedge + i2;
+			ml_new[quad_ord_ofs[2]].e = edge_offset + step + (i * (step_tot - 1));
+			ml_new[quad_ord_ofs[3]].e = totedge + i1;
+
+
+			/* new vertical edge */
+			if (step) { /* The first set is already done */
+				med_new->v1 = i1;
+				med_new->v2 = i2;
+				med_new->flag = med_new_firstloop->flag;
+				med_new->crease = med_new_firstloop->crease;
+				med_new++;
+			}
+			i1 += totvert;
+			i2 += totvert;
+		}
+		else {
+			/* last segment */
+			ml_new[quad_ord[0]].v = i1;
+			ml_new[quad_ord[1]].v = i2;
+			ml_new[quad_ord[2]].v = med_new_firstloop->v2;
+			ml_new[quad_ord[3]].v = med_new_firstloop->v1;
+
+			ml_new[quad_ord_ofs[0]].e = (edge_offset + step + (i * (step_tot - 1))) - 1;
+			ml_new[quad_ord_ofs[1]].e = totedge + i2;
+			ml_new[quad_ord_ofs[2]].e = i;
+			ml_new[quad_ord_ofs[3]].e = totedge + i1;
+		}
+
+		mp_new++;
+		ml_new += 4;
+		mpoly_index++;
+	}
+
+	/* new vertical edge */
+	med_new->v1 = i1;
+	med_new->v2 = i2;
+	med_new->flag = med_new_firstloop->flag & ~ME_LOOSEEDGE;
+	med_new->crease = med_new_firstloop->crease;
+}
+
+/** \} */
+
 static void initData(ModifierData *md)
 {
 	ScrewModifierData *ltmd = (ScrewModifierData *) md;
@@ -173,10 +498,7 @@ static DerivedMesh *applyModifier(
 	const bool use_render_params = (flag & MOD_APPLY_RENDER) != 0;
 
 	int *origindex;
-	int mpoly_index = 0;
-	unsigned int step;
 	unsigned int i, j;
-	unsigned int i1, i2;
 	unsigned int step_tot = use_render_params ? ltmd->render_steps : ltmd->steps;
 	const bool do_flip = (ltmd->flag & MOD_SCREW_NORMAL_FLIP) != 0;
 
@@ -206,7 +528,7 @@ static DerivedMesh *applyModifier(
 	MLoopUV **mloopuv_layers = BLI_array_alloca(mloopuv_layers, mloopuv_layers_tot);
 	float uv_u_scale;
 	float uv_v_minmax[2] = {FLT_MAX, -FLT_MAX};
-	float uv_v_range_inv;
+	float uv_v_range_inv = 0.0f;
 	float uv_axis_plane[4];
 
 	char axis_char = 'X';
@@ -215,7 +537,6 @@ static DerivedMesh *applyModifier(
 	float screw_ofs = ltmd->screw_ofs;
 	float axis_vec[3] = {0.0f, 0.0f, 0.0f};
 	float tmp_vec1[3], tmp_vec2[3];
-	float mat3[3][3];
 	float mtx_tx[4][4]; /* transform the coords by an object relative to this objects transformation */
 	float mtx_tx_inv[4][4]; /* inverted */
 	float mtx_tmp_a[4][4];
@@ -226,13 +547,15 @@ static DerivedMesh *applyModifier(
 
 	unsigned int edge_offset;
 
-	MPoly *mpoly_orig, *mpoly_new, *mp_new;
-	MLoop *mloop_orig, *mloop_new, *ml_new;
-	MEdge *medge_orig, *med_orig, *med_new, *med_new_firstloop, *medge_new;
-	MVert *mvert_new, *mvert_orig, *mv_orig, *mv_new, *mv_new_base;
+	MPoly *mpoly_orig, *mpoly_new;
+	MLoop *mloop_orig, *mloop_new;
+	MEdge *medge_orig, *med_orig, *med_new, *medge_new;
+	MVert *mvert_new, *mvert_orig, *mv_orig, *mv_new;
 
 	ScrewVertConnect *vc, *vc_tmp, *vert_connect = NULL;
 
+	ScrewThreadData tdata;
+
 	const char mpoly_flag = (ltmd->flag & MOD_SCREW_SMOOTH_SHADING) ? ME_SMOOTH : 0;
 
 	/* don't do anything? */
@@ -816,65 +1139,34 @@ static DerivedMesh *applyModifier(
 	}
 	/* done with edge connectivity based normal flipping */
 
-	/* Add Faces */
-	for (step = 1; step < step_tot; step++) {
-		const unsigned int varray_stride = totvert * step;
-		float step_angle;
-		float nor_tx[3];
-		float mat[4][4];
-		/* Rotation Matrix */
-		step_angle = (angle / (float)(step_tot - (!close))) * (float)step;
-
-		if (ltmd->ob_axis) {
-			axis_angle_normalized_to_mat3(mat3, axis_vec, step_angle);
-		}
-		else {
-			axis_angle_to_mat3_single(mat3, axis_char, step_angle);
-		}
-		copy_m4_m3(mat, mat3);
-
-		if (screw_ofs)
-			madd_v3_v3fl(mat[3], axis_vec, screw_ofs * ((float)step / (float)(step_tot - 1)));
-
-		/* copy a slice */
-		DM_copy_vert_data(dm, result, 0, (int)varray_stride, (int)totvert);
-
-		mv_new_base = mvert_new;
-		mv_new = &mvert_new[varray_stride]; /* advance to the next slice */
-
-		for (j = 0; j < totvert; j++, mv_new_base++, mv_new++) {
-			/* set normal */
-			if (vert_connect) {
-				mul_v3_m3v3(nor_tx, mat3, vert_connect[j].no);
-
-				/* set the normal now its transformed */
-				normal_float_to_short_v3(mv_new->no, nor_tx);
-			}
-
-			/* set location */
-			copy_v3_v3(mv_new->co, mv_new_base->co);
-
-			/* only need to set these if using non cleared memory */
-			/*mv_new->mat_nr = mv_new->flag = 0;*/
-
-			if (ltmd->ob_axis) {
-				sub_v3_v3(mv_new->co, mtx_tx[3]);
-
-				mul_m4_v3(mat, mv_new->co);
-
-				add_v3_v3(mv_new->co, mtx_tx[3]);
-			}
-			else {
-				mul_m4_v3(mat, mv_new->co);
-			}
-
-			/* add the new edge */
-			med_new->v1 = varray_stride + j;
-			med_new->v2 = med_new->v1 - totvert;
-			med_new->flag = ME_EDGEDRAW | ME_EDGERENDER;
-			med_new++;
-		}
+	tdata.dm = dm;
+	tdata.result = result;
+	tdata.mvert_new = mvert_new;
+	tdata.medge_new = medge_new;
+	tdata.mpoly_new = mpoly_new;
+	tdata.mloop_new = mloop_new;
+	tdata.origindex = origindex;
+	tdata.totvert = totvert;
+	tdata.totedge = totedge;
+	tdata.step_tot = step_tot;
+	tdata.step_last = step_tot - (close ? 1 : 2);
+	tdata.close = close;
+	tdata.vert_connect = vert_connect;
+	tdata.use_ob_axis = (ltmd->ob_axis != NULL);
+	tdata.axis_char = axis_char;
+	tdata.angle = angle;
+	tdata.screw_ofs = screw_ofs;
+	tdata.axis_vec = axis_vec;
+	tdata.mtx_tx = mtx_tx;
+
+	/* Add Verts, edges between the slices are ordered by step so each step is independent */
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (maxVerts > 10000);
+		BLI_task_parallel_range(1, (int)step_tot, &tdata, screw_step_verts_cb, &settings);
 	}
+	tdata.vert_connect = NULL;
 
 	/* we can avoid if using vert alloc trick */
 	if (vert_connect) {
@@ -886,6 +1178,7 @@ static DerivedMesh *applyModifier(
 		/* last loop of edges, previous loop doesn't account for the last set of edges */
 		const unsigned int varray_stride = (step_tot - 1) * totvert;
 
+		med_new = &medge_new[totedge + varray_stride];
 		for (i = 0; i < totvert; i++) {
 			med_new->v1 = i;
 			med_new->v2 = varray_stride + i;
@@ -894,153 +1187,29 @@ static DerivedMesh *applyModifier(
 		}
 	}
 
-	mp_new = mpoly_new;
-	ml_new = mloop_new;
-	med_new_firstloop = medge_new;
-
 	/* more of an offset in this case */
 	edge_offset = totedge + (totvert * (step_tot - (close ? 0 : 1)));
 
-	for (i = 0; i < totedge; i++, med_new_firstloop++) {
-		const unsigned int step_last = step_tot - (close ? 1 : 2);
-		const unsigned int mpoly_index_orig = totpoly ? edge_poly_map[i] : UINT_MAX;
-		const bool has_mpoly_orig = (mpoly_index_orig != UINT_MAX);
-		float uv_v_offset_a, uv_v_offset_b;
-
-		const unsigned int mloop_index_orig[2] = {
-		    vert_loop_map ? vert_loop_map[medge_new[i].v1] : UINT_MAX,
-		    vert_loop_map ? vert_loop_map[medge_new[i].v2] : UINT_MAX,
-		};
-		const bool has_mloop_orig = mloop_index_orig[0] != UINT_MAX;
-
-		short mat_nr;
-
-		/* for each edge, make a cylinder of quads */
-		i1 = med_new_firstloop->v1;
-		i2 = med_new_firstloop->v2;
-
-		if (has_mpoly_orig) {
-			mat_nr = mpoly_orig[mpoly_index_orig].mat_nr;
-		}
-		else {
-			mat_nr = 0;
-		}
-
-		if (has_mloop_orig == false && mloopuv_layers_tot) {
-			uv_v_offset_a = dist_signed_to_plane_v3(mvert_new[medge_new[i].v1].co, uv_axis_plane);
-			uv_v_offset_b = dist_signed_to_plane_v3(mvert_new[medge_new[i].v2].co, uv_axis_plane);
-
-			if (ltmd->flag & MOD_SCREW_UV_STRETCH_V) {
-				uv_v_offset_a = (uv_v_offset_a - uv_v_minmax[0]) * uv_v_range_inv;
-				uv_v_offset_b = (uv_v_offset_b - uv_v_minmax[0]) * uv_v_range_inv;
-			}
-		}
-
-		for (step = 0; step <= step_last; step++) {
-
-			/* Polygon */
-			if (has_mpoly_orig) {
-				DM_copy_poly_data(dm, result, (int)mpoly_index_orig, (int)mpoly_index, 1);
-				origindex[mpoly_index] = (int)mpoly_index_orig;
-			}
-			else {
-				origindex[mpoly_index] = ORIGINDEX_NONE;
-				mp_new->flag = mpoly_flag;
-				mp_new->mat_nr = mat_nr;
-			}
-			mp_new->loopstart = mpoly_index * 4;
-			mp_new->totloop = 4;
-
-
-			/* Loop-Custom-Data */
-			if (has_mloop_orig) {
-				int l_index = (int)(ml_new - mloop_new);
-				DM_copy_loop_data(dm, result, (int)mloop_index_orig[0], l_index + 0, 1);
-				DM_copy_loop_data(dm, result, (int)mloop_index_orig[1], l_index + 1, 1);
-				DM_copy_loop_data(dm, result, (int)mloop_index_orig[1], l_index + 2, 1);
-				DM_copy_loop_data(dm, result, (int)mloop_index_orig[0], l_index + 3, 1);
-
-				if (mloopuv_layers_tot) {
-					unsigned int uv_lay;
-					const float uv_u_offset_a = (float)(step)     * uv_u_scale;
-					const float uv_u_offset_b = (float)(step + 1) * uv_u_scale;
-					for (uv_lay = 0; uv_lay < mloopuv_layers_tot; uv_lay++) {
-						MLoopUV *mluv = &mloopuv_layers[uv_lay][l_index];
-
-						mluv[quad_ord[0]].uv[0] += uv_u_offset_a;
-						mluv[quad_ord[1]].uv[0] += uv_u_offset_a;
-						mluv[quad_ord[2]].uv[0] += uv_u_offset_b;
-						mluv[quad_ord[3]].uv[0] += uv_u_offset_b;
-					}
-				}
-			}
-			else {
-				if (mloopuv_layers_tot) {
-					int l_index = (int)(ml_new - mloop_new);
-
-					unsigned int uv_lay;
-					const float uv_u_offset_a = (float)(step)     * uv_u_scale;
-					const float uv_u_offset_b = (float)(step + 1) * uv_u_scale;
-					for (uv_lay = 0; uv_lay < mloopuv_layers_tot; uv_lay++) {
-						MLoopUV *mluv = &mloopuv_layers[uv_lay][l_index];
-
-						copy_v2_fl2(mluv[quad_ord[0]].uv, uv_u_offset_a, uv_v_offset_a);
-						copy_v2_fl2(mluv[quad_ord[1]].uv, uv_u_offset_a, uv_v_offset_b);
-						copy_v2_fl2(mluv[quad_ord[2]].uv, uv_u_offset_b, uv_v_offset_b);
-						copy_v2_fl2(mluv[quad_ord[3]].uv, uv_u_offset_b, uv_v_offset_a);
-					}
-				}
-			}
-
-			/* Loop-Data */
-			if (!(close && step == step_last)) {
-				/* regular segments */
-				ml_new[quad_ord[0]].v = i1;
-				ml_new[quad_ord[1]].v = i2;
-				ml_new[quad_ord[2]].v = i2 + totvert;
-				ml_new[quad_ord[3]].v = i1 + totvert;
-
-				ml_new[quad_ord_ofs[0]].e = step == 0 ? i : (edge_offset + step + (i * (step_tot - 1))) - 1;
-				ml_new[quad_ord_ofs[1]].e = totedge + i2;
-				ml_new[quad_ord_ofs[2]].e = edge_offset + step + (i * (step_tot - 1));
-				ml_new[quad_ord_ofs[3]].e = totedge + i1;
-
-
-				/* new vertical edge */
-				if (step) { /* The first set is already done */
-					med_new->v1 = i1;
-					med_new->v2 = i2;
-					med_new->flag = med_new_firstloop->flag;
-					med_new->crease = med_new_firstloop->crease;
-					med_new++;
-				}
-				i1 += totvert;
-				i2 += totvert;
-			}
-			else {
-				/* last segment */
-				ml_new[quad_ord[0]].v = i1;
-				ml_new[quad_ord[1]].v = i2;
-				ml_new[quad_ord[2]].v = med_new_firstloop->v2;
-				ml_new[quad_ord[3]].v = med_new_firstloop->v1;
-
-				ml_new[quad_ord_ofs[0]].e = (edge_offset + step + (i * (step_tot - 1))) - 1;
-				ml_new[quad_ord_ofs[1]].e = totedge + i2;
-				ml_new[quad_ord_ofs[2]].e = i;
-				ml_new[quad_ord_ofs[3]].e = totedge + i1;
-			}
+	tdata.edge_offset = edge_offset;
+	tdata.edge_poly_map = edge_poly_map;
+	tdata.vert_loop_map = vert_loop_map;
+	tdata.quad_ord = quad_ord;
+	tdata.quad_ord_ofs = quad_ord_ofs;
+	tdata.mpoly_flag = mpoly_flag;
+	tdata.mloopuv_layers = mloopuv_layers;
+	tdata.mloopuv_layers_tot = mloopuv_layers_tot;
+	tdata.uv_u_scale = uv_u_scale;
+	tdata.uv_axis_plane = uv_axis_plane;
+	tdata.uv_v_minmax = uv_v_minmax;
+	tdata.uv_v_range_inv = uv_v_range_inv;
+	tdata.use_uv_stretch_v = (ltmd->flag & MOD_SCREW_UV_STRETCH_V) != 0;
 
-			mp_new++;
-			ml_new += 4;
-			mpoly_index++;
-		}
-
-		/* new vertical edge */
-		med_new->v1 = i1;
-		med_new->v2 = i2;
-		med_new->flag = med_new_firstloop->flag & ~ME_LOOSEEDGE;
-		med_new->crease = med_new_firstloop->crease;
-		med_new++;
+	/* Add Faces */
+	{
+		ParallelRangeSettings settings;
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (maxPolys > 10000);
+		BLI_task_parallel_range(0, (int)totedge, &tdata, screw_edge_polys_cb, &settings);
 	}
 
 	/* validate loop edges */
@@ -1115,7 +1284,8 @@ ModifierTypeInfo modifierType_Screw = {
 	/* flags */             eModifierTypeFlag_AcceptsMesh |
 	                        eModifierTypeFlag_AcceptsCVs |
 	                        eModifierTypeFlag_SupportsEditmode |
-	                        eModifierTypeFlag_EnableInEditmode,
+	                        eModifierTypeFlag_EnableInEditmode |
+	                        eModifierTypeFlag_CacheResult,
 
 	/* copyData */          modifier_copyData_generic,
 	/* deformVerts */       NULL,
@@ -31,6 +31,7 @@
 #include "BLI_utildefines_stack.h"
 #include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BKE_cdderivedmesh.h"
 #include "BKE_mesh.h"
@@ -59,10 +60,63 @@ BLI_INLINE bool edgeref_is_init(const EdgeFaceRef *edge_ref)
 	return !((edge_ref->f1 == 0) && (edge_ref->f2 == 0));
 }
 
+typedef struct CalcNormalData {
+	const EdgeFaceRef *edge_ref_array;
+	const float (*face_nors)[3];
+	float (*edge_nors)[3];
+	const MVert *mvert;
+	float (*vert_nors)[3];
+} CalcNormalData;
+
+static void dm_calc_normal_edge_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const CalcNormalData *data = userdata;
+	const EdgeFaceRef *edge_ref = &data->edge_ref_array[i];
+	float *edge_normal = data->edge_nors[i];
+
+	if (edgeref_is_init(edge_ref) && (edge_ref->f1 != -1)) {
+		if (edge_ref->f2 != -1) {
+			/* We have 2 faces using this edge, calculate the edges normal
+			 * using the angle between the 2 faces as a weighting */
+#if 0
+			add_v3_v3v3(edge_normal, data->face_nors[edge_ref->f1], data->face_nors[edge_ref->f2]);
+			normalize_v3_length(
+			        edge_normal,
+			        angle_normalized_v3v3(data->face_nors[edge_ref->f1], data->face_nors[edge_ref->f2]));
+#else
+			mid_v3_v3v3_angle_weighted(edge_normal, data->face_nors[edge_ref->f1], data->face_nors[edge_ref->f2]);
+#endif
+		}
+		else {
+			/* only one face attached to that edge */
+			/* an edge without another attached- the weight on this is undefined */
+			copy_v3_v3(edge_normal, data->face_nors[edge_ref->f1]);
+		}
+	}
+}
+
+static void dm_calc_normal_vert_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const CalcNormalData *data = userdata;
+
+	if (normalize_v3(data->vert_nors[i]) == 0.0f) {
+		normal_short_to_float_v3(data->vert_nors[i], data->mvert[i].no);
+	}
+}
+
 /**
  * \param dm: Mesh to calculate normals for.
  * \param face_nors: Precalculated face normals.
  * \param r_vert_nors: Return vert normals.
+ *
+ * Edge normals are calculated in parallel, then accumulated into the vertices in edge order
+ * so the result doesn't depend on the number of threads.
  */
 static void dm_calc_normal(DerivedMesh *dm, float (*face_nors)[3], float (*r_vert_nors)[3])
 {
@@ -70,7 +124,8 @@ static void dm_calc_normal(DerivedMesh *dm, float (*face_nors)[3], float (*r_ver
 	MPoly *mpoly, *mp;
 	MLoop *mloop, *ml;
 	MEdge *medge, *ed;
-	MVert *mvert, *mv;
+	MVert *mvert;
+	ParallelRangeSettings settings;
 
 	numVerts = dm->getNumVerts(dm);
 	numEdges = dm->getNumEdges(dm);
@@ -88,13 +143,17 @@ static void dm_calc_normal(DerivedMesh *dm, float (*face_nors)[3], float (*r_ver
 	cddm->mvert = mv;
 #endif
 
-	mv = mvert;
 	mp = mpoly;
 
 	{
 		EdgeFaceRef *edge_ref_array = MEM_calloc_arrayN((size_t)numEdges, sizeof(EdgeFaceRef), "Edge Connectivity");
+		float (*edge_nors)[3] = MEM_malloc_arrayN((size_t)numEdges, sizeof(*edge_nors), __func__);
 		EdgeFaceRef *edge_ref;
-		float edge_normal[3];
+		CalcNormalData data = {
+			.edge_ref_array = edge_ref_array,
+			.face_nors = (const float (*)[3])face_nors,
+			.edge_nors = edge_nors,
+		};
 
 		/* Add an edge reference if it's not there, pointing back to the face index. */
 		for (i = 0; i < numFaces; i++, mp++) {
@@ -123,39 +182,31 @@ static void dm_calc_normal(DerivedMesh *dm, float (*face_nors)[3], float (*r_ver
 			}
 		}
 
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (numEdges > 10000);
+		BLI_task_parallel_range(0, numEdges, &data, dm_calc_normal_edge_cb, &settings);
+
 		for (i = 0, ed = medge, edge_ref = edge_ref_array; i < numEdges; i++, ed++, edge_ref++) {
 			/* Get the edge vert indices, and edge value (the face indices that use it) */
-
 			if (edgeref_is_init(edge_ref) && (edge_ref->f1 != -1)) {
-				if (edge_ref->f2 != -1) {
-					/* We have 2 faces using this edge, calculate the edges normal
-					 * using the angle between the 2 faces as a weighting */
-#if 0
-					add_v3_v3v3(edge_normal, face_nors[edge_ref->f1], face_nors[edge_ref->f2]);
-					normalize_v3_length(
-					        edge_normal,
-					        angle_normalized_v3v3(face_nors[edge_ref->f1], face_nors[edge_ref->f2]));
-#else
-					mid_v3_v3v3_angle_weighted(edge_normal, face_nors[edge_ref->f1], face_nors[edge_ref->f2]);
-#endif
-				}
-				else {
-					/* only one face attached to that edge */
-					/* an edge without another attached- the weight on this is undefined */
-					copy_v3_v3(edge_normal, face_nors[edge_ref->f1]);
-				}
-				add_v3_v3(r_vert_nors[ed->v1], edge_normal);
-				add_v3_v3(r_vert_nors[ed->v2], edge_normal);
+				add_v3_v3(r_vert_nors[ed->v1], edge_nors[i]);
+				add_v3_v3(r_vert_nors[ed->v2], edge_nors[i]);
 			}
 		}
+		MEM_freeN(edge_nors);
 		MEM_freeN(edge_ref_array);
 	}
 
 	/* normalize vertex normals and assign */
-	for (i = 0; i < numVerts; i++, mv++) {
-		if (normalize_v3(r_vert_nors[i]) == 0.0f) {
-			normal_short_to_float_v3(r_vert_nors[i], mv->no);
-		}
+	{
+		CalcNormalData data = {
+			.mvert = mvert,
+			.vert_nors = r_vert_nors,
+		};
+
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (numVerts > 10000);
+		BLI_task_parallel_range(0, numVerts, &data, dm_calc_normal_vert_cb, &settings);
 	}
 }
 
@@ -186,6 +237,369 @@ BLI_INLINE void madd_v3v3short_fl(float r[3], const short a[3], const float f)
 	r[2] += (float)a[2] * f;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Threaded Passes
+ *
+ * Each pass writes to its own elements only,
+ * anything accumulated into shared vertices is gathered afterwards in a fixed order,
+ * so the result matches the single threaded output exactly.
+ * \{ */
+
+typedef struct SolidifyThreadData {
+	DerivedMesh *dm, *result;
+	MVert *mvert;
+	MEdge *medge;
+	const MEdge *orig_medge;
+	MLoop *mloop;
+	MPoly *mpoly;
+
+	unsigned int numVerts, numEdges, numLoops, numFaces;
+	unsigned int stride, newEdges;
+	bool do_shell;
+
+	short mat_ofs, mat_ofs_rim, mat_nr_max;
+	unsigned char crease_outer, crease_inner;
+
+	/* rim */
+	const unsigned int *new_vert_arr;
+	const unsigned int *old_vert_arr;
+	const unsigned int *new_edge_arr;
+	const unsigned int *edge_users;
+	const char *edge_order;
+	float (*rim_nors)[3];
+
+	/* offset, (mv_ofs, do_shell_align) are set from #INIT_VERT_ARRAY_OFFSETS */
+	MVert *mv_ofs;
+	bool do_shell_align;
+	float scalar;
+	const float *vert_lens;
+	float offset, offset_sq;
+	MDeformVert *dvert;
+	int defgrp_index;
+	bool defgrp_invert;
+	float offset_fac_vg, offset_fac_vg_inv;
+
+	/* even thickness */
+	const float (*vert_nors)[3];
+	const float (*face_nors)[3];
+	float *vert_angles, *vert_accum;
+	float *loop_angles, *loop_dists;
+#ifdef USE_NONMANIFOLD_WORKAROUND
+	bool check_non_manifold;
+#endif
+} SolidifyThreadData;
+
+/**
+ * Reverse the winding of the copied shell face.
+ */
+static void solidify_flip_poly_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const SolidifyThreadData *data = userdata;
+	MPoly *mp = &data->mpoly[data->numFaces + (unsigned int)i];
+	const int loop_end = mp->totloop - 1;
+	const int numLoops = (int)data->numLoops;
+	MLoop *ml2;
+	unsigned int e;
+	int j;
+
+	/* reverses the loop direction (MLoop.v as well as custom-data)
+	 * MLoop.e also needs to be corrected too, done in a separate loop below. */
+	ml2 = data->mloop + mp->loopstart + numLoops;
+#if 0
+	for (j = 0; j < mp->totloop; j++) {
+		CustomData_copy_data(&data->dm->loopData, &data->result->loopData, mp->loopstart + j,
+		                     mp->loopstart + (loop_end - j) + numLoops, 1);
+	}
+#else
+	/* slightly more involved, keep the first vertex the same for the copy,
+	 * ensures the diagonals in the new face match the original. */
+	j = 0;
+	for (int j_prev = loop_end; j < mp->totloop; j_prev = j++) {
+		CustomData_copy_data(&data->dm->loopData, &data->result->loopData, mp->loopstart + j,
+		                     mp->loopstart + (loop_end - j_prev) + numLoops, 1);
+	}
+#endif
+
+	if (data->mat_ofs) {
+		mp->mat_nr += data->mat_ofs;
+		CLAMP(mp->mat_nr, 0, data->mat_nr_max);
+	}
+
+	e = ml2[0].e;
+	for (j = 0; j < loop_end; j++) {
+		ml2[j].e = ml2[j + 1].e;
+	}
+	ml2[loop_end].e = e;
+
+	mp->loopstart += numLoops;
+
+	for (j = 0; j < mp->totloop; j++) {
+		ml2[j].e += data->numEdges;
+		ml2[j].v += data->numVerts;
+	}
+}
+
+/**
+ * Offset along the vertex normal (no even thickness).
+ */
+static void solidify_offset_cb(
+        void *__restrict userdata,
+        const int i_orig,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const SolidifyThreadData *data = userdata;
+	const unsigned int i = data->do_shell_align ? (unsigned int)i_orig : data->new_vert_arr[i_orig];
+	MVert *mv = &data->mv_ofs[i_orig];
+	float scalar_short_vgroup = data->scalar;
+
+	if (data->dvert) {
+		MDeformVert *dv = &data->dvert[i];
+		if (data->defgrp_invert) scalar_short_vgroup = 1.0f - defvert_find_weight(dv, data->defgrp_index);
+		else scalar_short_vgroup = defvert_find_weight(dv, data->defgrp_index);
+		scalar_short_vgroup = (data->offset_fac_vg + (scalar_short_vgroup * data->offset_fac_vg_inv)) * data->scalar;
+	}
+	if (data->vert_lens) {
+		if (data->vert_lens[i] < data->offset_sq) {
+			float scalar = sqrtf(data->vert_lens[i]) / data->offset;
+			scalar_short_vgroup *= scalar;
+		}
+	}
+	madd_v3v3short_fl(mv->co, mv->no, scalar_short_vgroup);
+}
+
+/**
+ * Calculate the corner angle and the shell distance of each loop,
+ * these are accumulated into the vertices afterwards.
+ */
+static void solidify_even_poly_angles_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const SolidifyThreadData *data = userdata;
+	const MVert *mvert = data->mvert;
+	const MPoly *mp = &data->mpoly[i];
+	const MLoop *ml = &data->mloop[mp->loopstart];
+	float *loop_angles = &data->loop_angles[mp->loopstart];
+	float *loop_dists = &data->loop_dists[mp->loopstart];
+
+	/* #BKE_mesh_calc_poly_angles logic is inlined here */
+	float nor_prev[3];
+	float nor_next[3];
+
+	int i_curr = mp->totloop - 1;
+	int i_next = 0;
+
+	sub_v3_v3v3(nor_prev, mvert[ml[i_curr - 1].v].co, mvert[ml[i_curr].v].co);
+	normalize_v3(nor_prev);
+
+	while (i_next < mp->totloop) {
+		unsigned int vidx;
+		float angle;
+		sub_v3_v3v3(nor_next, mvert[ml[i_curr].v].co, mvert[ml[i_next].v].co);
+		normalize_v3(nor_next);
+		angle = angle_normalized_v3v3(nor_prev, nor_next);
+
+
+		/* --- not related to angle calc --- */
+		if (angle < FLT_EPSILON) {
+			angle = FLT_EPSILON;
+		}
+
+		vidx = ml[i_curr].v;
+		loop_angles[i_curr] = angle;
+
+#ifdef USE_NONMANIFOLD_WORKAROUND
+		/* skip 3+ face user edges */
+		if ((data->check_non_manifold == false) ||
+		    LIKELY(((data->orig_medge[ml[i_curr].e].flag & ME_EDGE_TMP_TAG) == 0) &&
+		           ((data->orig_medge[ml[i_next].e].flag & ME_EDGE_TMP_TAG) == 0)))
+		{
+			loop_dists[i_curr] = shell_v3v3_normalized_to_dist(data->vert_nors[vidx], data->face_nors[i]) * angle;
+		}
+		else {
+			loop_dists[i_curr] = angle;
+		}
+#else
+		loop_dists[i_curr] = shell_v3v3_normalized_to_dist(data->vert_nors[vidx], data->face_nors[i]) * angle;
+#endif
+		/* --- end non-angle-calc section --- */
+
+
+		/* step */
+		copy_v3_v3(nor_prev, nor_next);
+		i_curr = i_next;
+		i_next++;
+	}
+}
+
+/**
+ * Apply vertex group weights and clamping to the accumulated even thickness.
+ */
+static void solidify_even_vert_scale_cb(
+        void *__restrict userdata,
+        const int i,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const SolidifyThreadData *data = userdata;
+
+	/* vertex group support */
+	if (data->dvert) {
+		float scalar;
+		if (data->defgrp_invert) scalar = 1.0f - defvert_find_weight(&data->dvert[i], data->defgrp_index);
+		else scalar = defvert_find_weight(&data->dvert[i], data->defgrp_index);
+		scalar = data->offset_fac_vg + (scalar * data->offset_fac_vg_inv);
+		data->vert_angles[i] *= scalar;
+	}
+
+	if (data->vert_lens) {
+		if (data->vert_lens[i] < data->offset_sq) {
+			float scalar = sqrtf(data->vert_lens[i]) / data->offset;
+			data->vert_angles[i] *= scalar;
+		}
+	}
+}
+
+/**
+ * Offset along the vertex normal (even thickness).
+ */
+static void solidify_offset_even_cb(
+        void *__restrict userdata,
+        const int i_orig,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const SolidifyThreadData *data = userdata;
+	const unsigned int i_other = data->do_shell_align ? (unsigned int)i_orig : data->new_vert_arr[i_orig];
+	MVert *mv = &data->mv_ofs[i_orig];
+
+	if (data->vert_accum[i_other]) { /* zero if unselected */
+		madd_v3_v3fl(mv->co, data->vert_nors[i_other], data->scalar * (data->vert_angles[i_other] / data->vert_accum[i_other]));
+	}
+}
+
+/**
+ * Create the rim face for a boundary edge, the side normal is written to `rim_nors`
+ * to be accumulated into the edge vertices afterwards.
+ */
+static void solidify_rim_face_cb(
+        void *__restrict userdata,
+        const int i_rim,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const SolidifyThreadData *data = userdata;
+	const unsigned int numVerts = data->numVerts;
+	const unsigned int numEdges = data->numEdges;
+	const unsigned int numLoops = data->numLoops;
+	const unsigned int numFaces = data->numFaces;
+	const unsigned int stride = data->stride;
+	const unsigned int newEdges = data->newEdges;
+	const unsigned int *old_vert_arr = data->old_vert_arr;
+	const bool do_shell = data->do_shell;
+	const unsigned int i = (unsigned int)i_rim;
+	MPoly *mpoly = data->mpoly;
+	MEdge *medge = data->medge;
+	MPoly *mp = &mpoly[(numFaces * stride) + i];
+	MLoop *ml = data->mloop + (numLoops * stride);
+	/* rim faces are all quads */
+	unsigned int j = i * 4;
+	unsigned int eidx = data->new_edge_arr[i];
+	unsigned int fidx = data->edge_users[eidx];
+	MEdge *ed;
+	int k1, k2;
+	bool flip;
+
+	if (fidx >= numFaces) {
+		fidx -= numFaces;
+		flip = true;
+	}
+	else {
+		flip = false;
+	}
+
+	ed = medge + eidx;
+
+	/* copy most of the face settings */
+	DM_copy_poly_data(data->dm, data->result, (int)fidx, (int)((numFaces * stride) + i), 1);
+	mp->loopstart = (int)(j + (numLoops * stride));
+	mp->flag = mpoly[fidx].flag;
+
+	/* notice we use 'mp->totloop' which is later overwritten,
+	 * we could lookup the original face but there's no point since this is a copy
+	 * and will have the same value, just take care when changing order of assignment */
+	k1 = mpoly[fidx].loopstart + (((data->edge_order[eidx] - 1) + mp->totloop) % mp->totloop);  /* prev loop */
+	k2 = mpoly[fidx].loopstart +   (data->edge_order[eidx]);
+
+	mp->totloop = 4;
+
+	CustomData_copy_data(&data->dm->loopData, &data->result->loopData, k2, (int)((numLoops * stride) + j + 0), 1);
+	CustomData_copy_data(&data->dm->loopData, &data->result->loopData, k1, (int)((numLoops * stride) + j + 1), 1);
+	CustomData_copy_data(&data->dm->loopData, &data->result->loopData, k1, (int)((numLoops * stride) + j + 2), 1);
+	CustomData_copy_data(&data->dm->loopData, &data->result->loopData, k2, (int)((numLoops * stride) + j + 3), 1);
+
+	if (flip == false) {
+		ml[j].v = ed->v1;
+		ml[j++].e = eidx;
+
+		ml[j].v = ed->v2;
+		ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v2] + newEdges;
+
+		ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + numVerts;
+		ml[j++].e = (do_shell ? eidx : i) + numEdges;
+
+		ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + numVerts;
+		ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v1] + newEdges;
+	}
+	else {
+		ml[j].v = ed->v2;
+		ml[j++].e = eidx;
+
+		ml[j].v = ed->v1;
+		ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v1] + newEdges;
+
+		ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + numVerts;
+		ml[j++].e = (do_shell ? eidx : i) + numEdges;
+
+		ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + numVerts;
+		ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v2] + newEdges;
+	}
+
+	/* note, the edges along the rim (ml[j - 3].e, ml[j - 1].e) are shared between rim faces,
+	 * their ORIGINDEX_NONE is set when the rim edges are created. */
+
+	/* use the next material index if option enabled */
+	if (data->mat_ofs_rim) {
+		mp->mat_nr += data->mat_ofs_rim;
+		CLAMP(mp->mat_nr, 0, data->mat_nr_max);
+	}
+	if (data->crease_outer) {
+		/* crease += crease_outer; without wrapping */
+		char *cr = &(ed->crease);
+		int tcr = *cr + data->crease_outer;
+		*cr = tcr > 255 ? 255 : tcr;
+	}
+
+	if (data->crease_inner) {
+		/* crease += crease_inner; without wrapping */
+		char *cr = &(medge[numEdges + (do_shell ? eidx : i)].crease);
+		int tcr = *cr + data->crease_inner;
+		*cr = tcr > 255 ? 255 : tcr;
+	}
+
+	if (data->rim_nors) {
+		const MVert *mvert = data->mvert;
+		normal_quad_v3(data->rim_nors[i],
+		               mvert[ml[j - 4].v].co,
+		               mvert[ml[j - 3].v].co,
+		               mvert[ml[j - 2].v].co,
+		               mvert[ml[j - 1].v].co);
+	}
+}
+
+/** \} */
+
 static DerivedMesh *applyModifier(
         ModifierData *md, Object *ob,
         DerivedMesh *dm,
@@ -243,6 +657,9 @@ static DerivedMesh *applyModifier(
 	/* array size is doubled in case of using a shell */
 	const unsigned int stride = do_shell ? 2 : 1;
 
+	SolidifyThreadData tdata;
+	ParallelRangeSettings settings;
+
 	modifier_get_vgroup(ob, dm, smd->defgrp_name, &dvert, &defgrp_index);
 
 	orig_mvert = dm->getVertArray(dm);
@@ -363,6 +780,19 @@ static DerivedMesh *applyModifier(
 	medge = CDDM_get_edges(result);
 	mvert = CDDM_get_verts(result);
 
+	tdata = (SolidifyThreadData){
+		.dm = dm, .result = result,
+		.mvert = mvert, .medge = medge, .orig_medge = orig_medge, .mloop = mloop, .mpoly = mpoly,
+		.numVerts = numVerts, .numEdges = numEdges, .numLoops = numLoops, .numFaces = numFaces,
+		.stride = stride, .newEdges = newEdges, .do_shell = do_shell,
+		.mat_ofs = mat_ofs, .mat_ofs_rim = mat_ofs_rim, .mat_nr_max = mat_nr_max,
+		.new_vert_arr = new_vert_arr, .old_vert_arr = old_vert_arr, .new_edge_arr = new_edge_arr,
+		.edge_users = edge_users, .edge_order = edge_order,
+		.dvert = dvert, .defgrp_index = defgrp_index, .defgrp_invert = defgrp_invert,
+		.offset_fac_vg = offset_fac_vg, .offset_fac_vg_inv = offset_fac_vg_inv,
+		.face_nors = (const float (*)[3])face_nors,
+	};
+
 	if (do_shell) {
 		DM_copy_vert_data(dm, result, 0, 0, (int)numVerts);
 		DM_copy_vert_data(dm, result, 0, (int)numVerts, (int)numVerts);
@@ -435,49 +865,9 @@ static DerivedMesh *applyModifier(
 	if (do_shell) {
 		unsigned int i;
 
-		mp = mpoly + numFaces;
-		for (i = 0; i < dm->numPolyData; i++, mp++) {
-			const int loop_end = mp->totloop - 1;
-			MLoop *ml2;
-			unsigned int e;
-			int j;
-
-			/* reverses the loop direction (MLoop.v as well as custom-data)
-			 * MLoop.e also needs to be corrected too, done in a separate loop below. */
-			ml2 = mloop + mp->loopstart + dm->numLoopData;
-#if 0
-			for (j = 0; j < mp->totloop; j++) {
-				CustomData_copy_data(&dm->loopData, &result->loopData, mp->loopstart + j,
-				                     mp->loopstart + (loop_end - j) + dm->numLoopData, 1);
-			}
-#else
-			/* slightly more involved, keep the first vertex the same for the copy,
-			 * ensures the diagonals in the new face match the original. */
-			j = 0;
-			for (int j_prev = loop_end; j < mp->totloop; j_prev = j++) {
-				CustomData_copy_data(&dm->loopData, &result->loopData, mp->loopstart + j,
-				                     mp->loopstart + (loop_end - j_prev) + dm->numLoopData, 1);
-			}
-#endif
-
-			if (mat_ofs) {
-				mp->mat_nr += mat_ofs;
-				CLAMP(mp->mat_nr, 0, mat_nr_max);
-			}
-
-			e = ml2[0].e;
-			for (j = 0; j < loop_end; j++) {
-				ml2[j].e = ml2[j + 1].e;
-			}
-			ml2[loop_end].e = e;
-
-			mp->loopstart += dm->numLoopData;
-
-			for (j = 0; j < mp->totloop; j++) {
-				ml2[j].e += numEdges;
-				ml2[j].v += numVerts;
-			}
-		}
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (numLoops > 10000);
+		BLI_task_parallel_range(0, (int)numFaces, &tdata, solidify_flip_poly_cb, &settings);
 
 		for (i = 0, ed = medge + numEdges; i < numEdges; i++, ed++) {
 			ed->v1 += numVerts;
@@ -488,8 +878,6 @@ static DerivedMesh *applyModifier(
 	/* note, copied vertex layers don't have flipped normals yet. do this after applying offset */
 	if ((smd->flag & MOD_SOLIDIFY_EVEN) == 0) {
 		/* no even thickness, very simple */
-		float scalar_short;
-		float scalar_short_vgroup;
 
 		/* for clamping */
 		float *vert_lens = NULL;
@@ -508,65 +896,39 @@ static DerivedMesh *applyModifier(
 			}
 		}
 
+		tdata.vert_lens = vert_lens;
+		tdata.offset = offset;
+		tdata.offset_sq = offset_sq;
+
 		if (ofs_new != 0.0f) {
-			unsigned int i_orig, i_end;
+			unsigned int i_end;
 			bool do_shell_align;
 
-			scalar_short = scalar_short_vgroup = ofs_new / 32767.0f;
-
 			INIT_VERT_ARRAY_OFFSETS(false);
 
-			for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-				const unsigned int i = do_shell_align ? i_orig : new_vert_arr[i_orig];
-				if (dvert) {
-					MDeformVert *dv = &dvert[i];
-					if (defgrp_invert) scalar_short_vgroup = 1.0f - defvert_find_weight(dv, defgrp_index);
-					else scalar_short_vgroup = defvert_find_weight(dv, defgrp_index);
-					scalar_short_vgroup = (offset_fac_vg + (scalar_short_vgroup * offset_fac_vg_inv)) * scalar_short;
-				}
-				if (do_clamp) {
-					/* always reset becaise we may have set before */
-					if (dvert == NULL) {
-						scalar_short_vgroup = scalar_short;
-					}
-					if (vert_lens[i] < offset_sq) {
-						float scalar = sqrtf(vert_lens[i]) / offset;
-						scalar_short_vgroup *= scalar;
-					}
-				}
-				madd_v3v3short_fl(mv->co, mv->no, scalar_short_vgroup);
-			}
+			tdata.mv_ofs = mv;
+			tdata.do_shell_align = do_shell_align;
+			tdata.scalar = ofs_new / 32767.0f;
+
+			BLI_parallel_range_settings_defaults(&settings);
+			settings.use_threading = (i_end > 10000);
+			BLI_task_parallel_range(0, (int)i_end, &tdata, solidify_offset_cb, &settings);
 		}
 
 		if (ofs_orig != 0.0f) {
-			unsigned int i_orig, i_end;
+			unsigned int i_end;
 			bool do_shell_align;
 
-			scalar_short = scalar_short_vgroup = ofs_orig / 32767.0f;
-
 			/* as above but swapped */
 			INIT_VERT_ARRAY_OFFSETS(true);
 
-			for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-				const unsigned int i = do_shell_align ? i_orig : new_vert_arr[i_orig];
-				if (dvert) {
-					MDeformVert *dv = &dvert[i];
-					if (defgrp_invert) scalar_short_vgroup = 1.0f - defvert_find_weight(dv, defgrp_index);
-					else scalar_short_vgroup = defvert_find_weight(dv, defgrp_index);
-					scalar_short_vgroup = (offset_fac_vg + (scalar_short_vgroup * offset_fac_vg_inv)) * scalar_short;
-				}
-				if (do_clamp) {
-					/* always reset becaise we may have set before */
-					if (dvert == NULL) {
-						scalar_short_vgroup = scalar_short;
-					}
-					if (vert_lens[i] < offset_sq) {
-						float scalar = sqrtf(vert_lens[i]) / offset;
-						scalar_short_vgroup *= scalar;
-					}
-				}
-				madd_v3v3short_fl(mv->co, mv->no, scalar_short_vgroup);
-			}
+			tdata.mv_ofs = mv;
+			tdata.do_shell_align = do_shell_align;
+			tdata.scalar = ofs_orig / 32767.0f;
+
+			BLI_parallel_range_settings_defaults(&settings);
+			settings.use_threading = (i_end > 10000);
+			BLI_task_parallel_range(0, (int)i_end, &tdata, solidify_offset_cb, &settings);
 		}
 
 		if (do_clamp) {
@@ -580,7 +942,8 @@ static DerivedMesh *applyModifier(
 		/* same as EM_solidify() in editmesh_lib.c */
 		float *vert_angles = MEM_calloc_arrayN(numVerts, 2 * sizeof(float), "mod_solid_pair"); /* 2 in 1 */
 		float *vert_accum = vert_angles + numVerts;
-		unsigned int vidx;
+		float *loop_angles = MEM_malloc_arrayN(numLoops, 2 * sizeof(float), "mod_solid_loop_pair"); /* 2 in 1 */
+		float *loop_dists = loop_angles + numLoops;
 		unsigned int i;
 
 		if (vert_nors == NULL) {
@@ -590,78 +953,38 @@ static DerivedMesh *applyModifier(
 			}
 		}
 
-		for (i = 0, mp = mpoly; i < numFaces; i++, mp++) {
-			/* #BKE_mesh_calc_poly_angles logic is inlined here */
-			float nor_prev[3];
-			float nor_next[3];
+		tdata.vert_nors = (const float (*)[3])vert_nors;
+		tdata.vert_angles = vert_angles;
+		tdata.vert_accum = vert_accum;
+		tdata.loop_angles = loop_angles;
+		tdata.loop_dists = loop_dists;
+#ifdef USE_NONMANIFOLD_WORKAROUND
+		tdata.check_non_manifold = check_non_manifold;
+#endif
+
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (numLoops > 10000);
+		BLI_task_parallel_range(0, (int)numFaces, &tdata, solidify_even_poly_angles_cb, &settings);
 
+		/* accumulate in the same order the angles are calculated in */
+		for (i = 0, mp = mpoly; i < numFaces; i++, mp++) {
 			int i_curr = mp->totloop - 1;
 			int i_next = 0;
 
 			ml = &mloop[mp->loopstart];
 
-			sub_v3_v3v3(nor_prev, mvert[ml[i_curr - 1].v].co, mvert[ml[i_curr].v].co);
-			normalize_v3(nor_prev);
-
 			while (i_next < mp->totloop) {
-				float angle;
-				sub_v3_v3v3(nor_next, mvert[ml[i_curr].v].co, mvert[ml[i_next].v].co);
-				normalize_v3(nor_next);
-				angle = angle_normalized_v3v3(nor_prev, nor_next);
-
-
-				/* --- not related to angle calc --- */
-				if (angle < FLT_EPSILON) {
-					angle = FLT_EPSILON;
-				}
+				const unsigned int vidx = ml[i_curr].v;
+				const unsigned int lidx = (unsigned int)(mp->loopstart + i_curr);
+				vert_accum[vidx] += loop_angles[lidx];
+				vert_angles[vidx] += loop_dists[lidx];
 
-				vidx = ml[i_curr].v;
-				vert_accum[vidx] += angle;
-
-#ifdef USE_NONMANIFOLD_WORKAROUND
-				/* skip 3+ face user edges */
-				if ((check_non_manifold == false) ||
-				    LIKELY(((orig_medge[ml[i_curr].e].flag & ME_EDGE_TMP_TAG) == 0) &&
-				           ((orig_medge[ml[i_next].e].flag & ME_EDGE_TMP_TAG) == 0)))
-				{
-					vert_angles[vidx] += shell_v3v3_normalized_to_dist(vert_nors[vidx], face_nors[i]) * angle;
-				}
-				else {
-					vert_angles[vidx] += angle;
-				}
-#else
-				vert_angles[vidx] += shell_v3v3_normalized_to_dist(vert_nors[vidx], face_nors[i]) * angle;
-#endif
-				/* --- end non-angle-calc section --- */
-
-
-				/* step */
-				copy_v3_v3(nor_prev, nor_next);
 				i_curr = i_next;
 				i_next++;
 			}
 		}
 
-		/* vertex group support */
-		if (dvert) {
-			MDeformVert *dv = dvert;
-			float scalar;
-
-			if (defgrp_invert) {
-				for (i = 0; i < numVerts; i++, dv++) {
-					scalar = 1.0f - defvert_find_weight(dv, defgrp_index);
-					scalar = offset_fac_vg + (scalar * offset_fac_vg_inv);
-					vert_angles[i] *= scalar;
-				}
-			}
-			else {
-				for (i = 0; i < numVerts; i++, dv++) {
-					scalar = defvert_find_weight(dv, defgrp_index);
-					scalar = offset_fac_vg + (scalar * offset_fac_vg_inv);
-					vert_angles[i] *= scalar;
-				}
-			}
-		}
+		MEM_freeN(loop_angles);
 
 		if (do_clamp) {
 			float *vert_lens_sq = MEM_malloc_arrayN(numVerts, sizeof(float), "vert_lens");
@@ -673,42 +996,52 @@ static DerivedMesh *applyModifier(
 				vert_lens_sq[medge[i].v1] = min_ff(vert_lens_sq[medge[i].v1], ed_len);
 				vert_lens_sq[medge[i].v2] = min_ff(vert_lens_sq[medge[i].v2], ed_len);
 			}
-			for (i = 0; i < numVerts; i++) {
-				if (vert_lens_sq[i] < offset_sq) {
-					float scalar = sqrtf(vert_lens_sq[i]) / offset;
-					vert_angles[i] *= scalar;
-				}
-			}
-			MEM_freeN(vert_lens_sq);
+			tdata.vert_lens = vert_lens_sq;
+			tdata.offset = offset;
+			tdata.offset_sq = offset_sq;
+		}
+
+		/* vertex group support & clamping */
+		if (dvert || do_clamp) {
+			BLI_parallel_range_settings_defaults(&settings);
+			settings.use_threading = (numVerts > 10000);
+			BLI_task_parallel_range(0, (int)numVerts, &tdata, solidify_even_vert_scale_cb, &settings);
+		}
+
+		if (do_clamp) {
+			MEM_freeN((void *)tdata.vert_lens);
+			tdata.vert_lens = NULL;
 		}
 
 		if (ofs_new != 0.0f) {
-			unsigned int i_orig, i_end;
+			unsigned int i_end;
 			bool do_shell_align;
 
 			INIT_VERT_ARRAY_OFFSETS(false);
 
-			for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-				const unsigned int i_other = do_shell_align ? i_orig : new_vert_arr[i_orig];
-				if (vert_accum[i_other]) { /* zero if unselected */
-					madd_v3_v3fl(mv->co, vert_nors[i_other], ofs_new * (vert_angles[i_other] / vert_accum[i_other]));
-				}
-			}
+			tdata.mv_ofs = mv;
+			tdata.do_shell_align = do_shell_align;
+			tdata.scalar = ofs_new;
+
+			BLI_parallel_range_settings_defaults(&settings);
+			settings.use_threading = (i_end > 10000);
+			BLI_task_parallel_range(0, (int)i_end, &tdata, solidify_offset_even_cb, &settings);
 		}
 
 		if (ofs_orig != 0.0f) {
-			unsigned int i_orig, i_end;
+			unsigned int i_end;
 			bool do_shell_align;
 
 			/* same as above but swapped, intentional use of 'ofs_new' */
 			INIT_VERT_ARRAY_OFFSETS(true);
 
-			for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-				const unsigned int i_other = do_shell_align ? i_orig : new_vert_arr[i_orig];
-				if (vert_accum[i_other]) { /* zero if unselected */
-					madd_v3_v3fl(mv->co, vert_nors[i_other], ofs_orig * (vert_angles[i_other] / vert_accum[i_other]));
-				}
-			}
+			tdata.mv_ofs = mv;
+			tdata.do_shell_align = do_shell_align;
+			tdata.scalar = ofs_orig;
+
+			BLI_parallel_range_settings_defaults(&settings);
+			settings.use_threading = (i_end > 10000);
+			BLI_task_parallel_range(0, (int)i_end, &tdata, solidify_offset_even_cb, &settings);
 		}
 
 		MEM_freeN(vert_angles);
@@ -756,7 +1089,6 @@ static DerivedMesh *applyModifier(
 
 		int *origindex_edge;
 		int *orig_ed;
-		unsigned int j;
 
 		if (crease_rim || crease_outer || crease_inner) {
 			result->cd_flag |= ME_CDFLAG_EDGE_CREASE;
@@ -779,105 +1111,28 @@ static DerivedMesh *applyModifier(
 		}
 
 		/* faces */
-		mp = mpoly + (numFaces * stride);
-		ml = mloop + (numLoops * stride);
-		j = 0;
-		for (i = 0; i < newFaces; i++, mp++) {
-			unsigned int eidx = new_edge_arr[i];
-			unsigned int fidx = edge_users[eidx];
-			int k1, k2;
-			bool flip;
-
-			if (fidx >= numFaces) {
-				fidx -= numFaces;
-				flip = true;
-			}
-			else {
-				flip = false;
-			}
-
-			ed = medge + eidx;
-
-			/* copy most of the face settings */
-			DM_copy_poly_data(dm, result, (int)fidx, (int)((numFaces * stride) + i), 1);
-			mp->loopstart = (int)(j + (numLoops * stride));
-			mp->flag = mpoly[fidx].flag;
-
-			/* notice we use 'mp->totloop' which is later overwritten,
-			 * we could lookup the original face but there's no point since this is a copy
-			 * and will have the same value, just take care when changing order of assignment */
-			k1 = mpoly[fidx].loopstart + (((edge_order[eidx] - 1) + mp->totloop) % mp->totloop);  /* prev loop */
-			k2 = mpoly[fidx].loopstart +   (edge_order[eidx]);
-
-			mp->totloop = 4;
-
-			CustomData_copy_data(&dm->loopData, &result->loopData, k2, (int)((numLoops * stride) + j + 0), 1);
-			CustomData_copy_data(&dm->loopData, &result->loopData, k1, (int)((numLoops * stride) + j + 1), 1);
-			CustomData_copy_data(&dm->loopData, &result->loopData, k1, (int)((numLoops * stride) + j + 2), 1);
-			CustomData_copy_data(&dm->loopData, &result->loopData, k2, (int)((numLoops * stride) + j + 3), 1);
-
-			if (flip == false) {
-				ml[j].v = ed->v1;
-				ml[j++].e = eidx;
-
-				ml[j].v = ed->v2;
-				ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v2] + newEdges;
-
-				ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + numVerts;
-				ml[j++].e = (do_shell ? eidx : i) + numEdges;
-
-				ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + numVerts;
-				ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v1] + newEdges;
-			}
-			else {
-				ml[j].v = ed->v2;
-				ml[j++].e = eidx;
-
-				ml[j].v = ed->v1;
-				ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v1] + newEdges;
-
-				ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + numVerts;
-				ml[j++].e = (do_shell ? eidx : i) + numEdges;
-
-				ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + numVerts;
-				ml[j++].e = (numEdges * stride) + old_vert_arr[ed->v2] + newEdges;
-			}
-
-			origindex_edge[ml[j - 3].e] = ORIGINDEX_NONE;
-			origindex_edge[ml[j - 1].e] = ORIGINDEX_NONE;
-
-			/* use the next material index if option enabled */
-			if (mat_ofs_rim) {
-				mp->mat_nr += mat_ofs_rim;
-				CLAMP(mp->mat_nr, 0, mat_nr_max);
-			}
-			if (crease_outer) {
-				/* crease += crease_outer; without wrapping */
-				char *cr = &(ed->crease);
-				int tcr = *cr + crease_outer;
-				*cr = tcr > 255 ? 255 : tcr;
-			}
+		tdata.crease_outer = crease_outer;
+		tdata.crease_inner = crease_inner;
+#ifdef SOLIDIFY_SIDE_NORMALS
+		tdata.rim_nors = do_side_normals ? MEM_malloc_arrayN(newFaces, sizeof(*tdata.rim_nors), __func__) : NULL;
+#else
+		tdata.rim_nors = NULL;
+#endif
 
-			if (crease_inner) {
-				/* crease += crease_inner; without wrapping */
-				char *cr = &(medge[numEdges + (do_shell ? eidx : i)].crease);
-				int tcr = *cr + crease_inner;
-				*cr = tcr > 255 ? 255 : tcr;
-			}
+		BLI_parallel_range_settings_defaults(&settings);
+		settings.use_threading = (newFaces > 10000);
+		BLI_task_parallel_range(0, (int)newFaces, &tdata, solidify_rim_face_cb, &settings);
 
 #ifdef SOLIDIFY_SIDE_NORMALS
-			if (do_side_normals) {
-				normal_quad_v3(nor,
-				               mvert[ml[j - 4].v].co,
-				               mvert[ml[j - 3].v].co,
-				               mvert[ml[j - 2].v].co,
-				               mvert[ml[j - 1].v].co);
-
-				add_v3_v3(edge_vert_nos[ed->v1], nor);
-				add_v3_v3(edge_vert_nos[ed->v2], nor);
+		if (do_side_normals) {
+			for (i = 0; i < newFaces; i++) {
+				ed = medge + new_edge_arr[i];
+				add_v3_v3(edge_vert_nos[ed->v1], tdata.rim_nors[i]);
+				add_v3_v3(edge_vert_nos[ed->v2], tdata.rim_nors[i]);
 			}
-#endif
+			MEM_freeN(tdata.rim_nors);
 		}
+#endif
 
 #ifdef SOLIDIFY_SIDE_NORMALS
 		if (do_side_normals) {
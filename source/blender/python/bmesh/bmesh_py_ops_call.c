@@ -554,17 +554,17 @@ static PyObject *bpy_slot_to_py(BMesh *bm, BMOpSlot *slot)
 		}
 		case BMO_OP_SLOT_MAPPING:
 		{
-			GHash *slot_hash = BMO_SLOT_AS_GHASH(slot);
-			GHashIterator hash_iter;
+			OHash *slot_hash = BMO_SLOT_AS_OHASH(slot);
+			OHashIterator hash_iter;
 
 			switch (slot->slot_subtype.map) {
 				case BMO_OP_SLOT_SUBTYPE_MAP_ELEM:
 				{
-					item = _PyDict_NewPresized(slot_hash ? BLI_ghash_len(slot_hash) : 0);
+					item = _PyDict_NewPresized(slot_hash ? BLI_ohash_len(slot_hash) : 0);
 					if (slot_hash) {
-						GHASH_ITER (hash_iter, slot_hash) {
-							BMHeader *ele_key = BLI_ghashIterator_getKey(&hash_iter);
-							void     *ele_val = BLI_ghashIterator_getValue(&hash_iter);
+						OHASH_ITER (hash_iter, slot_hash) {
+							BMHeader *ele_key = BLI_ohashIterator_getKey(&hash_iter);
+							void     *ele_val = BLI_ohashIterator_getValue(&hash_iter);
 
 							PyObject *py_key =  BPy_BMElem_CreatePyObject(bm, ele_key);
 							PyObject *py_val =  BPy_BMElem_CreatePyObject(bm, ele_val);
@@ -578,11 +578,11 @@ static PyObject *bpy_slot_to_py(BMesh *bm, BMOpSlot *slot)
 				}
 				case BMO_OP_SLOT_SUBTYPE_MAP_FLT:
 				{
-					item = _PyDict_NewPresized(slot_hash ? BLI_ghash_len(slot_hash) : 0);
+					item = _PyDict_NewPresized(slot_hash ? BLI_ohash_len(slot_hash) : 0);
 					if (slot_hash) {
-						GHASH_ITER (hash_iter, slot_hash) {
-							BMHeader *ele_key = BLI_ghashIterator_getKey(&hash_iter);
-							void     *ele_val = BLI_ghashIterator_getValue(&hash_iter);
+						OHASH_ITER (hash_iter, slot_hash) {
+							BMHeader *ele_key = BLI_ohashIterator_getKey(&hash_iter);
+							void     *ele_val = BLI_ohashIterator_getValue(&hash_iter);
 
 							PyObject *py_key =  BPy_BMElem_CreatePyObject(bm,  ele_key);
 							PyObject *py_val =  PyFloat_FromDouble(*(float *)&ele_val);
@@ -596,11 +596,11 @@ static PyObject *bpy_slot_to_py(BMesh *bm, BMOpSlot *slot)
 				}
 				case BMO_OP_SLOT_SUBTYPE_MAP_INT:
 				{
-					item = _PyDict_NewPresized(slot_hash ? BLI_ghash_len(slot_hash) : 0);
+					item = _PyDict_NewPresized(slot_hash ? BLI_ohash_len(slot_hash) : 0);
 					if (slot_hash) {
-						GHASH_ITER (hash_iter, slot_hash) {
-							BMHeader *ele_key = BLI_ghashIterator_getKey(&hash_iter);
-							void     *ele_val = BLI_ghashIterator_getValue(&hash_iter);
+						OHASH_ITER (hash_iter, slot_hash) {
+							BMHeader *ele_key = BLI_ohashIterator_getKey(&hash_iter);
+							void     *ele_val = BLI_ohashIterator_getValue(&hash_iter);
 
 							PyObject *py_key =  BPy_BMElem_CreatePyObject(bm,  ele_key);
 							PyObject *py_val =  PyLong_FromLong(*(int *)&ele_val);
@@ -614,11 +614,11 @@ static PyObject *bpy_slot_to_py(BMesh *bm, BMOpSlot *slot)
 				}
 				case BMO_OP_SLOT_SUBTYPE_MAP_BOOL:
 				{
-					item = _PyDict_NewPresized(slot_hash ? BLI_ghash_len(slot_hash) : 0);
+					item = _PyDict_NewPresized(slot_hash ? BLI_ohash_len(slot_hash) : 0);
 					if (slot_hash) {
-						GHASH_ITER (hash_iter, slot_hash) {
-							BMHeader *ele_key = BLI_ghashIterator_getKey(&hash_iter);
-							void     *ele_val = BLI_ghashIterator_getValue(&hash_iter);
+						OHASH_ITER (hash_iter, slot_hash) {
+							BMHeader *ele_key = BLI_ohashIterator_getKey(&hash_iter);
+							void     *ele_val = BLI_ohashIterator_getValue(&hash_iter);
 
 							PyObject *py_key =  BPy_BMElem_CreatePyObject(bm,  ele_key);
 							PyObject *py_val =  PyBool_FromLong(*(bool *)&ele_val);
@@ -634,8 +634,8 @@ static PyObject *bpy_slot_to_py(BMesh *bm, BMOpSlot *slot)
 				{
 					item = PySet_New(NULL);
 					if (slot_hash) {
-						GHASH_ITER (hash_iter, slot_hash) {
-							BMHeader       *ele_key = BLI_ghashIterator_getKey(&hash_iter);
+						OHASH_ITER (hash_iter, slot_hash) {
+							BMHeader       *ele_key = BLI_ohashIterator_getKey(&hash_iter);
 
 							PyObject *py_key =  BPy_BMElem_CreatePyObject(bm,  ele_key);
 
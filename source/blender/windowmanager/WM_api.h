@@ -441,6 +441,7 @@ enum {
 	WM_JOB_TYPE_OBJECT_BAKE_TEXTURE,
 	WM_JOB_TYPE_OBJECT_BAKE,
 	WM_JOB_TYPE_FILESEL_READDIR,
+	WM_JOB_TYPE_AUTOSAVE,
 	/* add as needed, seq proxy build
 	 * if having hard coded values is a problem */
 };
@@ -1247,6 +1247,45 @@ void WM_autosave_init(wmWindowManager *wm)
 		wm->autosavetimer = WM_event_add_timer(wm, NULL, TIMERAUTOSAVE, U.savetime * 60.0);
 }
 
+/* The undo memfile is flattened on the main thread,
+ * writing (the slow part on SD cards & USB sticks) is done by a job. */
+typedef struct AutosaveJob {
+	MemFile *memfile;
+	char filepath[FILE_MAX];
+} AutosaveJob;
+
+static void wm_autosave_job_startjob(void *customdata, short *UNUSED(stop), short *UNUSED(do_update), float *UNUSED(progress))
+{
+	AutosaveJob *aj = customdata;
+
+	BLO_memfile_write_file(aj->memfile, aj->filepath);
+}
+
+static void wm_autosave_job_free(void *customdata)
+{
+	AutosaveJob *aj = customdata;
+
+	BLO_memfile_free(aj->memfile);
+	MEM_freeN(aj->memfile);
+	MEM_freeN(aj);
+}
+
+static void wm_autosave_job_start(wmWindowManager *wm, MemFile *memfile, const char *filepath)
+{
+	AutosaveJob *aj = MEM_callocN(sizeof(*aj), __func__);
+	wmJob *wm_job;
+
+	aj->memfile = BLO_memfile_flatten(memfile);
+	BLI_strncpy(aj->filepath, filepath, sizeof(aj->filepath));
+
+	wm_job = WM_jobs_get(wm, NULL, wm, "Auto Save", 0, WM_JOB_TYPE_AUTOSAVE);
+	WM_jobs_customdata_set(wm_job, aj, wm_autosave_job_free);
+	WM_jobs_timer(wm_job, 0.5, 0, 0);
+	WM_jobs_callbacks(wm_job, wm_autosave_job_startjob, NULL, NULL, NULL);
+
+	WM_jobs_start(wm, wm_job);
+}
+
 void wm_autosave_timer(const bContext *C, wmWindowManager *wm, wmTimer *UNUSED(wt))
 {
 	wmWindow *win;
@@ -1255,6 +1294,12 @@ void wm_autosave_timer(const bContext *C, wmWindowManager *wm, wmTimer *UNUSED(w
 
 	WM_event_remove_timer(wm, NULL, wm->autosavetimer);
 
+	/* previous autosave still being written (slow storage), try again in 10 seconds */
+	if (WM_jobs_test(wm, wm, WM_JOB_TYPE_AUTOSAVE)) {
+		wm->autosavetimer = WM_event_add_timer(wm, NULL, TIMERAUTOSAVE, 10.0);
+		return;
+	}
+
 	/* if a modal operator is running, don't autosave, but try again in 10 seconds */
 	for (win = wm->windows.first; win; win = win->next) {
 		for (handler = win->modalhandlers.first; handler; handler = handler->next) {
@@ -1271,10 +1316,10 @@ void wm_autosave_timer(const bContext *C, wmWindowManager *wm, wmTimer *UNUSED(w
 	wm_autosave_location(filepath);
 
 	if (U.uiflag & USER_GLOBALUNDO) {
-		/* fast save of last undobuffer, now with UI */
+		/* fast save of last undobuffer, now with UI, written in the background */
 		struct MemFile *memfile = ED_undosys_stack_memfile_get_active(wm->undo_stack);
 		if (memfile) {
-			BLO_memfile_write_file(memfile, filepath);
+			wm_autosave_job_start(wm, memfile, filepath);
 		}
 	}
 	else {
@@ -0,0 +1,264 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <string>
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "BKE_gcode.h"
+}
+
+/* parts of the buffer split into words at once are 256 KiB, this spans several */
+#define GCODE_PADDING_LEN (1 << 20)
+
+static GCodePath *gcode_path_from_string(const std::string &str, const bool use_threading = true)
+{
+	GCodeParseSettings settings;
+	BKE_gcode_parse_settings_defaults(&settings);
+	settings.use_threading = use_threading;
+	return BKE_gcode_path_from_buffer(str.c_str(), str.size(), &settings);
+}
+
+/* comment lines, so the modal state has to be carried over the parts of the buffer */
+static void gcode_append_padding(std::string &str)
+{
+	const size_t len_end = str.size() + GCODE_PADDING_LEN;
+	while (str.size() < len_end) {
+		str += "(padding X99 Y99 Z99) ; G0 X99\n";
+	}
+}
+
+static void gcode_expect_co(const GCodePath *path, const int index, const float x, const float y, const float z)
+{
+	const float co[3] = {x, y, z};
+	ASSERT_LT(index, path->co_len);
+	EXPECT_V3_NEAR(path->co[index], co, 1e-5f);
+}
+
+TEST(gcode, ModalStateAcrossChunks)
+{
+	std::string str = "G21 G90\nG1 F300\n";
+	gcode_append_padding(str);
+	str += "X10 Y5\n";
+	gcode_append_padding(str);
+	str += "Y-5\nG20 G91\n";
+	gcode_append_padding(str);
+	str += "X1\n";
+
+	for (int use_threading = 0; use_threading < 2; use_threading++) {
+		GCodePath *path = gcode_path_from_string(str, use_threading != 0);
+
+		ASSERT_EQ(path->co_len, 4);
+		gcode_expect_co(path, 0, 0.0f, 0.0f, 0.0f);
+		gcode_expect_co(path, 1, 10.0f, 5.0f, 0.0f);
+		gcode_expect_co(path, 2, 10.0f, -5.0f, 0.0f);
+		/* incremental inches */
+		gcode_expect_co(path, 3, 35.4f, -5.0f, 0.0f);
+
+		for (int i = 1; i < 4; i++) {
+			EXPECT_EQ(path->flag[i], 0);
+		}
+		/* the feed rate is in the units it's given in */
+		EXPECT_FLOAT_EQ(path->feed[1], 300.0f);
+		EXPECT_FLOAT_EQ(path->feed[3], 300.0f);
+
+		EXPECT_EQ(path->moves_len, 3);
+		EXPECT_EQ(path->blocks_skipped_len, 0);
+
+		BKE_gcode_path_free(path);
+	}
+}
+
+TEST(gcode, Comments)
+{
+	GCodePath *path = gcode_path_from_string(
+	        "%\n"
+	        "(header Z-10)\n"
+	        "G0 X1 (not Y9 here) Y2 ; Z5\n"
+	        "G1 Z-1 F100 *87\n"
+	        ";X100\n"
+	        "g1 x3(no closing parenthesis Y7\n"
+	        "G1 X#1\n"
+	        "%\n");
+
+	ASSERT_EQ(path->co_len, 4);
+	gcode_expect_co(path, 1, 1.0f, 2.0f, 0.0f);
+	EXPECT_EQ(path->flag[1], GCODE_POINT_RAPID);
+	gcode_expect_co(path, 2, 1.0f, 2.0f, -1.0f);
+	EXPECT_EQ(path->flag[2], 0);
+	gcode_expect_co(path, 3, 3.0f, 2.0f, -1.0f);
+
+	EXPECT_EQ(path->lines_len, 8);
+	EXPECT_EQ(path->moves_len, 3);
+	/* the parameter */
+	EXPECT_EQ(path->blocks_skipped_len, 1);
+
+	BKE_gcode_path_free(path);
+}
+
+/* all points after the first on the circle around \a center (XY plane) */
+static void gcode_expect_arc(const GCodePath *path, const float center[2], const float radius)
+{
+	for (int i = 1; i < path->co_len; i++) {
+		EXPECT_NEAR(len_v2v2(path->co[i], center), radius, 1e-4f);
+		EXPECT_EQ(path->flag[i], GCODE_POINT_ARC);
+	}
+}
+
+TEST(gcode, ArcRadius)
+{
+	/* from (0, 0) to (10, 10) clockwise, the short way around (10, 0) */
+	GCodePath *path = gcode_path_from_string("G17 G1 F100\nG2 X10 Y10 R10\n");
+	const float center_minor[2] = {10.0f, 0.0f};
+	float min[3], max[3];
+
+	EXPECT_GT(path->co_len, 3);
+	gcode_expect_arc(path, center_minor, 10.0f);
+	gcode_expect_co(path, path->co_len - 1, 10.0f, 10.0f, 0.0f);
+
+	INIT_MINMAX(min, max);
+	for (int i = 0; i < path->co_len; i++) {
+		minmax_v3v3_v3(min, max, path->co[i]);
+	}
+	EXPECT_NEAR(min[0], 0.0f, 1e-5f);
+	EXPECT_NEAR(min[1], 0.0f, 1e-5f);
+	BKE_gcode_path_free(path);
+
+	/* a negative radius is the arc over 180 degrees, three quarters around (0, 10) */
+	path = gcode_path_from_string("G17 G1 F100\nG2 X10 Y10 R-10\n");
+	const float center_major[2] = {0.0f, 10.0f};
+
+	gcode_expect_arc(path, center_major, 10.0f);
+	gcode_expect_co(path, path->co_len - 1, 10.0f, 10.0f, 0.0f);
+
+	INIT_MINMAX(min, max);
+	for (int i = 0; i < path->co_len; i++) {
+		minmax_v3v3_v3(min, max, path->co[i]);
+	}
+	EXPECT_NEAR(min[0], -10.0f, 1e-3f);
+	EXPECT_NEAR(max[1], 20.0f, 1e-3f);
+	BKE_gcode_path_free(path);
+}
+
+TEST(gcode, ArcFullCircle)
+{
+	/* ending where it starts is a full circle, not an empty arc */
+	GCodePath *path = gcode_path_from_string("G17 G1 F100\nG3 X0 Y0 I5 J0 Z-2\n");
+	const float center[2] = {5.0f, 0.0f};
+	float length = 0.0f, max_x = -FLT_MAX;
+
+	EXPECT_GT(path->co_len, 8);
+	gcode_expect_arc(path, center, 5.0f);
+	gcode_expect_co(path, path->co_len - 1, 0.0f, 0.0f, -2.0f);
+
+	for (int i = 1; i < path->co_len; i++) {
+		length += len_v2v2(path->co[i - 1], path->co[i]);
+		max_x = max_ff(max_x, path->co[i][0]);
+	}
+	/* segments are within the arc tolerance (0.002) of the circle */
+	EXPECT_NEAR(max_x, 10.0f, 0.005f);
+	EXPECT_NEAR(length, 2.0f * (float)M_PI * 5.0f, 0.01f);
+	EXPECT_EQ(path->moves_len, 1);
+
+	BKE_gcode_path_free(path);
+}
+
+/* -------------------------------------------------------------------- */
+/* Machine time, the expected durations are worked out by hand (in millimeters and seconds). */
+
+#define GCODE_TEST_FEED 600.0f          /* 10 mm/s */
+#define GCODE_TEST_ACCELERATION 100.0f  /* mm/s^2 */
+
+static void gcode_test_machine_settings(GCodeMachineSettings *machine)
+{
+	BKE_gcode_machine_settings_defaults(machine);
+	/* fast enough not to limit the feed rate */
+	copy_v3_fl(machine->max_rate, 6000.0f);
+	copy_v3_fl(machine->acceleration, GCODE_TEST_ACCELERATION);
+	machine->junction_deviation = 0.01f;
+}
+
+static void gcode_test_estimate(
+        float (*co)[3], const int co_len, float *r_feed_achieved, GCodeEstimate *r_estimate)
+{
+	GCodeMachineSettings machine;
+	GCodePath path = {NULL};
+	float feed[8];
+	char flag[8] = {0};
+
+	BLI_assert(co_len <= (int)ARRAY_SIZE(feed));
+	copy_vn_fl(feed, co_len, GCODE_TEST_FEED);
+
+	path.co = co;
+	path.feed = feed;
+	path.flag = flag;
+	path.co_len = path.co_alloc = co_len;
+
+	gcode_test_machine_settings(&machine);
+	BKE_gcode_path_estimate(&path, &machine, r_feed_achieved, r_estimate);
+}
+
+TEST(gcode, EstimateCruise)
+{
+	/* 100 mm at 10 mm/s: 0.1 s and 0.5 mm to accelerate, the same to stop,
+	 * 99 mm cruising take 9.9 s */
+	float co[2][3] = {{0.0f, 0.0f, 0.0f}, {100.0f, 0.0f, 0.0f}};
+	float feed_achieved[2];
+	GCodeEstimate estimate;
+
+	gcode_test_estimate(co, 2, feed_achieved, &estimate);
+
+	EXPECT_NEAR(estimate.duration, 10.1, 1e-6);
+	EXPECT_NEAR(estimate.length, 100.0, 1e-6);
+	EXPECT_EQ(estimate.duration_rapid, 0.0);
+	EXPECT_NEAR(feed_achieved[1], GCODE_TEST_FEED, 1e-3f);
+}
+
+TEST(gcode, EstimateShortMove)
+{
+	/* reaching 10 mm/s and stopping again takes 1 mm, so 0.5 mm is a triangle:
+	 * the peak speed is sqrt(100 * 0.5) mm/s, reached after 0.25 mm */
+	float co[2][3] = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.5f, 0.0f}};
+	const double peak_speed = sqrt(50.0);
+	float feed_achieved[2];
+	GCodeEstimate estimate;
+
+	gcode_test_estimate(co, 2, feed_achieved, &estimate);
+
+	EXPECT_NEAR(estimate.duration, 2.0 * peak_speed / 100.0, 1e-6);
+	EXPECT_NEAR(feed_achieved[1], (float)(peak_speed * 60.0), 1e-3f);
+}
+
+TEST(gcode, EstimateCorner)
+{
+	/* two 100 mm moves with a 90 degree corner: the junction deviation limits the corner speed
+	 * (grbl's 'planner.c') to v^2 = a * deviation * sin(theta / 2) / (1 - sin(theta / 2)),
+	 * the acceleration along the junction (diagonal) is sqrt(2) times the per axis limit */
+	float co[3][3] = {{0.0f, 0.0f, 0.0f}, {100.0f, 0.0f, 0.0f}, {100.0f, 100.0f, 0.0f}};
+	const double sin_theta_d2 = sqrt(0.5);
+	const double corner_speed_sqr = (100.0 * M_SQRT2) * 0.01 * sin_theta_d2 / (1.0 - sin_theta_d2);
+	const double corner_speed = sqrt(corner_speed_sqr);
+	/* accelerate 0 -> 10 mm/s, cruise, decelerate 10 mm/s -> corner speed */
+	const double accel_time = 10.0 / 100.0, accel_dist = 100.0 / 200.0;
+	const double decel_time = (10.0 - corner_speed) / 100.0;
+	const double decel_dist = (100.0 - corner_speed_sqr) / 200.0;
+	const double move_time = accel_time + decel_time + (100.0 - accel_dist - decel_dist) / 10.0;
+	float feed_achieved[3];
+	GCodeEstimate estimate;
+
+	gcode_test_estimate(co, 3, feed_achieved, &estimate);
+
+	/* the second move is the first one mirrored */
+	EXPECT_NEAR(estimate.duration, 2.0 * move_time, 1e-6);
+	EXPECT_NEAR(estimate.length, 200.0, 1e-6);
+	EXPECT_NEAR(feed_achieved[1], GCODE_TEST_FEED, 1e-3f);
+	EXPECT_NEAR(feed_achieved[2], GCODE_TEST_FEED, 1e-3f);
+
+	/* without a corner the machine doesn't slow down in the middle */
+	co[2][0] = 200.0f;
+	co[2][1] = 0.0f;
+	gcode_test_estimate(co, 3, NULL, &estimate);
+	EXPECT_NEAR(estimate.duration, 20.1, 1e-6);
+}
@@ -9,6 +9,7 @@ extern "C" {
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_ohash.h"
 #include "BLI_rand.h"
 #include "BLI_string.h"
 #include "PIL_time_utildefines.h"
@@ -38,6 +39,16 @@ extern "C" {
 	       BLI_ghash_len(_gh), q, var, lf, pempty * 100.0, poverloaded * 100.0, bigb); \
 } void (0)
 
+#define PRINTF_OHASH_STATS(_oh) \
+{ \
+	double lf, mean; \
+	unsigned int maxp; \
+	BLI_ohash_calc_quality_ex((_oh), &lf, &mean, &maxp); \
+	printf("OHash stats (%u entries):\n\t" \
+	       "Load: %f\n\tMean probe length (the lower the better): %f\n\tLongest probe length: %u\n", \
+	       BLI_ohash_len(_oh), lf, mean, maxp); \
+} void (0)
+
 /* Str: whole text, lines and words from a 'corpus' text. */
 
 static void str_ghash_tests(GHash *ghash, const char *id)
@@ -534,3 +545,219 @@ TEST(ghash, MultiRandIntMurmur2a200000)
 
 	multi_small_ghash_tests(ghash, "MultiSmall RandIntGHash - Murmur2a - 200000", 200000);
 }
+
+
+/* OHash: same integer tests as above, using the open-addressing hash, to compare with GHash. */
+
+static void int_ohash_tests(OHash *ohash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_ohash_reserve(ohash, nbr);
+#endif
+
+		while (i--) {
+			BLI_ohash_insert(ohash, POINTER_FROM_UINT(i), POINTER_FROM_UINT(i));
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_OHASH_STATS(ohash);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_lookup);
+
+		while (i--) {
+			void *v = BLI_ohash_lookup(ohash, POINTER_FROM_UINT(i));
+			EXPECT_EQ(POINTER_AS_UINT(v), i);
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	{
+		void *k, *v;
+
+		TIMEIT_START(int_pop);
+
+		OHashIterState pop_state = {0};
+
+		while (BLI_ohash_pop(ohash, &pop_state, &k, &v)) {
+			EXPECT_EQ(k, v);
+		}
+
+		TIMEIT_END(int_pop);
+	}
+	EXPECT_EQ(BLI_ohash_len(ohash), 0);
+
+	BLI_ohash_free(ohash, NULL, NULL);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ohash, IntOHash12000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	int_ohash_tests(ohash, "IntOHash - GHash - 12000", 12000);
+}
+
+#ifdef GHASH_RUN_BIG
+TEST(ohash, IntOHash100000000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	int_ohash_tests(ohash, "IntOHash - GHash - 100000000", 100000000);
+}
+#endif
+
+TEST(ohash, IntOHashMurmur2a12000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p_murmur, BLI_ghashutil_intcmp, __func__);
+
+	int_ohash_tests(ohash, "IntOHash - Murmur - 12000", 12000);
+}
+
+static void randint_ohash_tests(OHash *ohash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = nbr, dt = data; i--; dt++) {
+			*dt = BLI_rng_get_uint(rng);
+		}
+		BLI_rng_free(rng);
+	}
+
+	{
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_ohash_reserve(ohash, nbr);
+#endif
+
+		for (i = nbr, dt = data; i--; dt++) {
+			BLI_ohash_insert(ohash, POINTER_FROM_UINT(*dt), POINTER_FROM_UINT(*dt));
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_OHASH_STATS(ohash);
+
+	{
+		TIMEIT_START(int_lookup);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			void *v = BLI_ohash_lookup(ohash, POINTER_FROM_UINT(*dt));
+			EXPECT_EQ(POINTER_AS_UINT(v), *dt);
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+	MEM_freeN(data);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ohash, IntRandOHash12000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	randint_ohash_tests(ohash, "RandIntOHash - GHash - 12000", 12000);
+}
+
+#ifdef GHASH_RUN_BIG
+TEST(ohash, IntRandOHash50000000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	randint_ohash_tests(ohash, "RandIntOHash - GHash - 50000000", 50000000);
+}
+#endif
+
+TEST(ohash, IntRandNoHashOHash12000)
+{
+	OHash *ohash = BLI_ohash_new(ghashutil_tests_nohash_p, ghashutil_tests_cmp_p, __func__);
+
+	randint_ohash_tests(ohash, "RandIntOHash - No Hash - 12000", 12000);
+}
+
+static void multi_small_ohash_tests_one(OHash *ohash, RNG *rng, const unsigned int nbr)
+{
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	for (i = nbr, dt = data; i--; dt++) {
+		*dt = BLI_rng_get_uint(rng);
+	}
+
+#ifdef GHASH_RESERVE
+	BLI_ohash_reserve(ohash, nbr);
+#endif
+
+	for (i = nbr, dt = data; i--; dt++) {
+		BLI_ohash_insert(ohash, POINTER_FROM_UINT(*dt), POINTER_FROM_UINT(*dt));
+	}
+
+	for (i = nbr, dt = data; i--; dt++) {
+		void *v = BLI_ohash_lookup(ohash, POINTER_FROM_UINT(*dt));
+		EXPECT_EQ(POINTER_AS_UINT(v), *dt);
+	}
+
+	BLI_ohash_clear(ohash, NULL, NULL);
+	MEM_freeN(data);
+}
+
+static void multi_small_ohash_tests(OHash *ohash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	RNG *rng = BLI_rng_new(0);
+
+	TIMEIT_START(multi_small_ohash);
+
+	unsigned int i = nbr;
+	while (i--) {
+		const int nbr = 1 + (BLI_rng_get_int(rng) % TESTCASE_SIZE_SMALL) * (!(i % 100) ? 100 : (!(i % 10) ? 10 : 1));
+		multi_small_ohash_tests_one(ohash, rng, nbr);
+	}
+
+	TIMEIT_END(multi_small_ohash);
+
+	BLI_ohash_free(ohash, NULL, NULL);
+	BLI_rng_free(rng);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ohash, MultiRandIntOHash2000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	multi_small_ohash_tests(ohash, "MultiSmall RandIntOHash - GHash - 2000", 2000);
+}
+
+TEST(ohash, MultiRandIntOHash200000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	multi_small_ohash_tests(ohash, "MultiSmall RandIntOHash - GHash - 200000", 200000);
+}
@@ -7,6 +7,7 @@
 extern "C" {
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_ohash.h"
 #include "BLI_rand.h"
 }
 
@@ -198,3 +199,122 @@ TEST(ghash, Pop)
 
 	BLI_ghash_free(ghash, NULL, NULL);
 }
+
+/* Same tests as above, for the open-addressing OHash. */
+
+TEST(ohash, InsertLookup)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 0);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, POINTER_FROM_UINT(*k), POINTER_FROM_UINT(*k));
+	}
+
+	EXPECT_EQ(BLI_ohash_len(ohash), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_ohash_lookup(ohash, POINTER_FROM_UINT(*k));
+		EXPECT_EQ(POINTER_AS_UINT(v), *k);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+TEST(ohash, InsertRemove)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 10);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, POINTER_FROM_UINT(*k), POINTER_FROM_UINT(*k));
+	}
+
+	EXPECT_EQ(BLI_ohash_len(ohash), TESTCASE_SIZE);
+
+	/* Remove every other key, the remaining ones must still be found after backward shifting. */
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		if (i % 2) {
+			void *v = BLI_ohash_popkey(ohash, POINTER_FROM_UINT(*k), NULL);
+			EXPECT_EQ(POINTER_AS_UINT(v), *k);
+		}
+	}
+
+	EXPECT_EQ(BLI_ohash_len(ohash), TESTCASE_SIZE / 2);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_EQ(BLI_ohash_haskey(ohash, POINTER_FROM_UINT(*k)), (i % 2) == 0);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+TEST(ohash, Copy)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	OHash *ohash_copy;
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 30);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, POINTER_FROM_UINT(*k), POINTER_FROM_UINT(*k));
+	}
+
+	ohash_copy = BLI_ohash_copy(ohash, NULL, NULL);
+
+	EXPECT_EQ(BLI_ohash_len(ohash_copy), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_ohash_lookup(ohash_copy, POINTER_FROM_UINT(*k));
+		EXPECT_EQ(POINTER_AS_UINT(v), *k);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+	BLI_ohash_free(ohash_copy, NULL, NULL);
+}
+
+TEST(ohash, Pop)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 30);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, POINTER_FROM_UINT(*k), POINTER_FROM_UINT(*k));
+	}
+
+	OHashIterState pop_state = {0};
+
+	for (i = TESTCASE_SIZE / 2; i--; ) {
+		void *k, *v;
+		bool success = BLI_ohash_pop(ohash, &pop_state, &k, &v);
+		EXPECT_EQ(k, v);
+		EXPECT_TRUE(success);
+
+		if (i % 2) {
+			BLI_ohash_insert(ohash, POINTER_FROM_UINT(i * 4), POINTER_FROM_UINT(i * 4));
+		}
+	}
+
+	EXPECT_EQ(BLI_ohash_len(ohash), (TESTCASE_SIZE - TESTCASE_SIZE / 2 + TESTCASE_SIZE / 4));
+
+	{
+		void *k, *v;
+		while (BLI_ohash_pop(ohash, &pop_state, &k, &v)) {
+			EXPECT_EQ(k, v);
+		}
+	}
+	EXPECT_EQ(BLI_ohash_len(ohash), 0);
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
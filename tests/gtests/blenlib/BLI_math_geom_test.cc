@@ -23,3 +23,44 @@ TEST(math_geom, DistToLineSegment2DSimple)
 	float distance = dist_to_line_segment_v2(p, a, b);
 	EXPECT_NEAR(sqrtf(2.0f), distance, 1e-6);
 }
+
+TEST(math_geom, Orient2DExact)
+{
+	float a[2] = {0.0f, 0.0f},
+	      b[2] = {1.0f, 0.0f};
+	float c_above[2] = {0.5f, 1.0f},
+	      c_below[2] = {0.5f, -1.0f},
+	      c_on[2] = {7.0f, 0.0f};
+	EXPECT_EQ(1, orient2d_exact_v2(a, b, c_above));
+	EXPECT_EQ(-1, orient2d_exact_v2(a, b, c_below));
+	EXPECT_EQ(0, orient2d_exact_v2(a, b, c_on));
+}
+
+TEST(math_geom, Orient3DExact)
+{
+	float a[3] = {0.0f, 0.0f, 0.0f},
+	      b[3] = {1.0f, 0.0f, 0.0f},
+	      c[3] = {0.0f, 1.0f, 0.0f};
+	float d_above[3] = {0.2f, 0.2f, 1.0f},
+	      d_below[3] = {0.2f, 0.2f, -1.0f},
+	      d_on[3] = {3.0f, -5.0f, 0.0f};
+	EXPECT_EQ(1, orient3d_exact_v3(a, b, c, d_above));
+	EXPECT_EQ(-1, orient3d_exact_v3(a, b, c, d_below));
+	EXPECT_EQ(0, orient3d_exact_v3(a, b, c, d_on));
+}
+
+TEST(math_geom, Orient3DExactNearDegenerate)
+{
+	/* points on the plane 'x + y + z = 1', which isn't axis aligned */
+	float a[3] = {1.0f, 0.0f, 0.0f},
+	      b[3] = {0.0f, 1.0f, 0.0f},
+	      c[3] = {0.0f, 0.0f, 1.0f},
+	      d[3] = {0.125f, 0.375f, 0.5f};
+	EXPECT_EQ(0, orient3d_exact_v3(a, b, c, d));
+
+	/* the smallest possible step off the plane is still detected */
+	d[2] = nextafterf(0.5f, 1.0f);
+	EXPECT_EQ(1, orient3d_exact_v3(a, b, c, d));
+	d[2] = nextafterf(0.5f, 0.0f);
+	EXPECT_EQ(-1, orient3d_exact_v3(a, b, c, d));
+}